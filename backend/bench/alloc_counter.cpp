@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "alloc_counter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace
+{
+// 스레드마다 따로 세어 카운터가 측정 대상 사이의 경합을 만들지 않게 한다.
+constinit thread_local std::uint64_t allocations = 0;
+
+void *allocate(std::size_t size)
+{
+    ++allocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *allocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    ++allocations;
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc 은 크기가 정렬 단위의 배수여야 한다.
+    auto rounded = (size + align - 1) / align * align;
+    if (void *p = std::aligned_alloc(align, rounded ? rounded : align))
+        return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+namespace banchoo::bench
+{
+
+std::uint64_t threadAllocations()
+{
+    return allocations;
+}
+
+std::size_t heapInUse()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    // 큰 블록은 mmap 으로 따로 잡히므로 hblkhd 도 더한다.
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+} // namespace banchoo::bench
+
+void *operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    ++allocations;
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    ++allocations;
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
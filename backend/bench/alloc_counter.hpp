@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace banchoo::bench
+{
+
+// 현재 스레드가 지금까지 operator new 를 부른 횟수.
+// 벤치마크 실행 파일은 전역 operator new 를 바꿔 끼워 이를 센다.
+std::uint64_t threadAllocations();
+
+// 프로세스 힙에서 현재 사용 중인 바이트. 알 수 없는 플랫폼에서는 0.
+std::size_t heapInUse();
+
+} // namespace banchoo::bench
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "harness.hpp"
+#include "note/note.hpp"
+#include "repository/async_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+using banchoo::bench::Result;
+namespace note = banchoo::note;
+namespace repository = banchoo::repository;
+using Clock = std::chrono::steady_clock;
+
+// Crow 작업 스레드 수와 요청 흐름. 쓰기 한 번은 fsync 를 흉내 내어 잠든다.
+constexpr int FRONT_THREADS = 2;
+constexpr int RATE = 2000; // 초당 요청
+constexpr int WRITE_PERCENT = 10;
+constexpr auto FSYNC = std::chrono::milliseconds(5);
+constexpr auto DURATION = std::chrono::seconds(2);
+
+struct Request
+{
+    bool write = false;
+    Clock::time_point arrival;
+};
+
+// 도착 시각부터 응답을 끝낸 시각까지 (us)
+struct Latencies
+{
+    std::mutex mutex;
+    std::vector<double> reads;
+    std::vector<double> writes;
+
+    void record(bool write, Clock::time_point arrival)
+    {
+        double us = std::chrono::duration<double, std::micro>(Clock::now() -
+                                                              arrival)
+                        .count();
+        std::lock_guard<std::mutex> lock(mutex);
+        (write ? writes : reads).push_back(us);
+    }
+};
+
+double percentile(std::vector<double> &values, double q)
+{
+    if (values.empty())
+        return 0;
+    auto k = static_cast<std::size_t>(q * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+bool slowWrite(repository::BaseRepository &repo)
+{
+    repo.createMemo({.content = "async bench"});
+    std::this_thread::sleep_for(FSYNC);
+    return true;
+}
+
+// 일정한 간격으로 요청을 넣고(open loop) 앞단 스레드가 꺼내 처리한다.
+// io 가 없으면 앞단 스레드가 쓰기를 직접 하고, 있으면 넘기고 다음 요청을
+// 받는다.
+Result runMix(const std::string &name, std::size_t io_threads)
+{
+    auto repo =
+        std::make_shared<repository::InMemoryRepository>(nlohmann::json{});
+    for (int i = 0; i < 1000; ++i)
+        repo->createMemo({.content = "seed"});
+
+    Latencies latencies;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    bool closed = false;
+
+    auto start = Clock::now();
+    {
+        std::unique_ptr<repository::AsyncRepository> io;
+        if (io_threads > 0)
+            io = std::make_unique<repository::AsyncRepository>(repo,
+                                                               io_threads);
+
+        auto front = [&](int)
+        {
+            for (std::size_t i = 0;; ++i)
+            {
+                Request request;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return closed || !queue.empty(); });
+                    if (queue.empty())
+                        return;
+                    request = queue.front();
+                    queue.pop_front();
+                }
+
+                if (!request.write)
+                {
+                    banchoo::bench::doNotOptimize(
+                        repo->getNote(static_cast<note::Id>(i % 1000 + 1)));
+                    latencies.record(false, request.arrival);
+                }
+                else if (!io)
+                {
+                    slowWrite(*repo);
+                    latencies.record(true, request.arrival);
+                }
+                else
+                {
+                    io->then(slowWrite,
+                             [&latencies, arrival = request.arrival](
+                                 std::future<bool>)
+                             { latencies.record(true, arrival); });
+                }
+            }
+        };
+
+        std::vector<std::thread> fronts;
+        for (int t = 0; t < FRONT_THREADS; ++t)
+            fronts.emplace_back(front, t);
+
+        const auto total = RATE * DURATION.count();
+        const auto interval = std::chrono::nanoseconds(1'000'000'000 / RATE);
+        for (long i = 0; i < total; ++i)
+        {
+            auto arrival = start + i * interval;
+            std::this_thread::sleep_until(arrival);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back({i % 100 < WRITE_PERCENT, arrival});
+            }
+            cv.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        cv.notify_all();
+        for (auto &t : fronts)
+            t.join();
+    } // io 가 남은 쓰기를 끝낸다.
+
+    Result result;
+    result.name = name;
+    result.ops = latencies.reads.size() + latencies.writes.size();
+    result.seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    result.params["threads"] = FRONT_THREADS; // 앞단 스레드
+    result.params["io_threads"] = io_threads;
+    result.params["rate"] = RATE;
+    result.params["write_percent"] = WRITE_PERCENT;
+    result.params["fsync_ms"] = FSYNC.count();
+    result.counters["read_p50_us"] = percentile(latencies.reads, 0.5);
+    result.counters["read_p99_us"] = percentile(latencies.reads, 0.99);
+    result.counters["write_p50_us"] = percentile(latencies.writes, 0.5);
+    result.counters["write_p99_us"] = percentile(latencies.writes, 0.99);
+    return result;
+}
+
+void asyncSuite(Harness &harness)
+{
+    if (harness.selected("async/blocking"))
+        harness.add(runMix("async/blocking", 0));
+    for (std::size_t io_threads : {1, 4})
+    {
+        auto name = "async/executor_" + std::to_string(io_threads);
+        if (harness.selected(name))
+            harness.add(runMix(name, io_threads));
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("async", asyncSuite);
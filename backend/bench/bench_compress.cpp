@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "note/content_codec.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace note = banchoo::note;
+
+constexpr std::size_t PREVIEW_BYTES = 80 * 4;
+
+// 붙여 넣은 회의록처럼 화자, 시각, 자주 쓰는 낱말이 반복되는 본문
+std::string transcript(std::size_t size)
+{
+    const char *speakers[] = {"김민수", "이서연", "Park", "Jordan", "최지우"};
+    const char *words[] = {
+        "일정",    "배포",     "리뷰",   "회의록", "다음",   "분기",
+        "확인",    "했습니다", "진행",   "중",     "the",    "release",
+        "blocked", "on",       "review", "we",     "should", "update",
+        "roadmap", "action",   "item",   "노트",   "정리",   "부탁드립니다",
+    };
+
+    std::mt19937 rng(7);
+    std::string text;
+    text.reserve(size + 256);
+    for (int minute = 0; text.size() < size; ++minute)
+    {
+        text += '[';
+        text += std::to_string(10 + minute / 60);
+        text += ':';
+        text += std::to_string(minute % 60);
+        text += "] ";
+        text += speakers[rng() % std::size(speakers)];
+        text += ": ";
+        for (auto n = 5 + rng() % 20; n > 0; --n)
+        {
+            text += words[rng() % std::size(words)];
+            text += ' ';
+        }
+        text += '\n';
+    }
+    text.resize(size);
+    return text;
+}
+
+void compressSuite(Harness &harness)
+{
+    for (std::size_t size : {4 * 1024, 64 * 1024, 512 * 1024})
+    {
+        const auto text = transcript(size);
+        const auto packed = *note::pack_content(text);
+        const double ratio = static_cast<double>(text.size()) /
+                             static_cast<double>(packed.size());
+
+        auto run = [&](const std::string &name, std::size_t bytes, auto op)
+        {
+            if (!harness.selected(name))
+                return;
+            auto result = harness.adaptive(name, 1, [&](int) { op(); });
+            result.params["content_bytes"] = size;
+            result.counters["ratio"] = ratio;
+            result.counters["mb_per_s"] =
+                static_cast<double>(bytes) * static_cast<double>(result.ops) /
+                result.seconds / 1e6;
+            harness.add(std::move(result));
+        };
+
+        run("compress/pack",
+            size,
+            [&] { banchoo::bench::doNotOptimize(note::pack_content(text)); });
+        run("compress/unpack",
+            size,
+            [&]
+            { banchoo::bench::doNotOptimize(note::unpack_content(packed)); });
+        run("compress/unpack_preview",
+            PREVIEW_BYTES,
+            [&]
+            {
+                banchoo::bench::doNotOptimize(
+                    note::unpack_content(packed, PREVIEW_BYTES));
+            });
+        // 비교 기준: 압축하지 않은 본문을 복사하는 비용
+        run("compress/copy",
+            size,
+            [&] { banchoo::bench::doNotOptimize(std::string(text)); });
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("compress", compressSuite);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "alloc_counter.hpp"
+#include "dataset.hpp"
+#include "harness.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/repository_factory.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace repository = banchoo::repository;
+
+constexpr double MILLION = 1e6;
+
+// 노트 size 개를 담은 인메모리 저장소가 차지하는 힙 크기를 잰다.
+void benchFootprint(Harness &harness,
+                    const std::string &layout,
+                    std::size_t size)
+{
+    auto name = "footprint/" + layout;
+    if (!harness.selected(name) || size == 0)
+        return;
+
+    std::size_t content_bytes = 0;
+    for (std::size_t i = 0; i < size; ++i)
+        content_bytes += banchoo::bench::makeNote(i).content.size();
+
+    auto before = banchoo::bench::heapInUse();
+    std::shared_ptr<repository::BaseRepository> repo;
+    auto result =
+        harness.measure(name,
+                        1,
+                        1,
+                        [&](int, std::size_t)
+                        {
+                            repo = repository::RepositoryFactory::create(
+                                {{"type", "inmemory"},
+                                 {"layout", layout},
+                                 {"instrumented", false}});
+                            banchoo::bench::seed(*repo, size);
+                        });
+    auto bytes = static_cast<double>(banchoo::bench::heapInUse() - before);
+    auto per_note = bytes / static_cast<double>(size);
+
+    result.ops = size;
+    result.params["layout"] = layout;
+    result.params["dataset"] = size;
+    result.counters["allocs_per_op"] /= static_cast<double>(size);
+    result.counters["heap_bytes_per_note"] = per_note;
+    result.counters["content_bytes_per_note"] =
+        static_cast<double>(content_bytes) / static_cast<double>(size);
+    result.counters["heap_mb_per_million_notes"] =
+        per_note * MILLION / (1024.0 * 1024.0);
+    harness.add(std::move(result));
+}
+
+void footprintSuite(Harness &harness)
+{
+    for (auto size : harness.options().sizes)
+    {
+        benchFootprint(harness, "node", size);
+        benchFootprint(harness, "compact", size);
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("footprint", footprintSuite);
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "harness.hpp"
+#include "index/content_matcher.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/compact_inmemory_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace index = banchoo::index;
+namespace note = banchoo::note;
+namespace repository = banchoo::repository;
+
+// 1 KiB 노트 256K 개, 본문 합 256 MiB
+constexpr std::size_t NOTE_COUNT = 256 * 1024;
+constexpr std::size_t NOTE_BYTES = 1024;
+
+// 흔한 단어로 채운 본문. 드물게 찾을 거리를 끼워 둔다.
+std::vector<note::Note> makeNotes()
+{
+    const char *words[] = {"meeting", "notes",  "todo",  "review", "deploy",
+                           "회의",    "일정",   "버그",  "fix",    "the",
+                           "server",  "client", "build", "test",   "release"};
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<std::size_t> word(0, std::size(words) - 1);
+
+    std::vector<note::Note> notes;
+    notes.reserve(NOTE_COUNT);
+    for (std::size_t i = 0; i < NOTE_COUNT; ++i)
+    {
+        std::string content;
+        content.reserve(NOTE_BYTES + 16);
+        while (content.size() < NOTE_BYTES)
+        {
+            content += words[word(rng)];
+            content += content.size() % 9 == 0 ? '\n' : ' ';
+        }
+        if (i % 10007 == 0)
+            content += "error 4711 in module banchoo::index\n";
+        notes.push_back({.id = static_cast<note::Id>(i + 1),
+                         .type = note::NoteType::MEMO,
+                         .content = std::move(content)});
+    }
+    return notes;
+}
+
+struct Case
+{
+    const char *name;
+    const char *pattern;
+    bool regex;
+    std::size_t limit;
+};
+// rare 와 regex 는 끝까지 훑고, common 은 앞에서 limit 개를 찾고 멈춘다.
+const Case CASES[] = {
+    {"literal_rare", "banchoo::index", false, 1000},
+    {"literal_absent", "zzz-not-there", false, 1000},
+    {"literal_common", "deploy", false, 100},
+    {"regex_literal", "error \\d+ in module", true, 1000},
+    {"regex_class", "^[a-z]+ 회의 [0-9]", true, 1000},
+};
+const char *BACKENDS[] = {"inmemory", "inmemory-compact"};
+
+std::string caseName(const char *backend, const Case &c)
+{
+    return std::string("grep/") + backend + "/" + c.name;
+}
+
+void grepSuite(Harness &harness)
+{
+    // 본문을 만드는 데 오래 걸리므로 고른 경우가 없으면 바로 돌아간다.
+    bool any = false;
+    for (const auto *backend : BACKENDS)
+    {
+        for (const auto &c : CASES)
+            any = any || harness.selected(caseName(backend, c));
+    }
+    if (!any)
+        return;
+
+    auto notes = makeNotes();
+    std::size_t bytes = 0;
+    for (const auto &n : notes)
+        bytes += n.content.size();
+
+    struct Backend
+    {
+        const char *name;
+        std::shared_ptr<repository::BaseRepository> repo;
+    };
+    auto inmemory =
+        std::make_shared<repository::InMemoryRepository>(nlohmann::json{});
+    auto compact = std::make_shared<repository::CompactInMemoryRepository>(
+        nlohmann::json{});
+    {
+        auto copy = notes;
+        inmemory->createNotes(copy);
+    }
+    compact->createNotes(notes);
+    notes.clear();
+    notes.shrink_to_fit();
+    const Backend backends[] = {{BACKENDS[0], inmemory},
+                                {BACKENDS[1], compact}};
+
+    for (const auto &backend : backends)
+    {
+        for (const auto &c : CASES)
+        {
+            auto name = caseName(backend.name, c);
+            if (!harness.selected(name))
+                continue;
+
+            std::string error;
+            auto matcher =
+                *index::ContentMatcher::parse(c.pattern, c.regex, error);
+            std::size_t found = 0;
+            auto result = harness.adaptive(
+                name,
+                1,
+                [&](int)
+                {
+                    auto ids = backend.repo->grepNotes(matcher, c.limit);
+                    found = ids.size();
+                    banchoo::bench::doNotOptimize(ids);
+                });
+            result.params["backend"] = backend.name;
+            result.params["notes"] = NOTE_COUNT;
+            result.params["threads"] = 1;
+            result.counters["results"] = static_cast<double>(found);
+            result.counters["content_mb"] =
+                static_cast<double>(bytes) / (1024.0 * 1024.0);
+            if (result.seconds > 0)
+            {
+                // 끝까지 훑은 경우의 처리량
+                result.counters["gb_per_s"] = static_cast<double>(bytes) *
+                    static_cast<double>(result.ops) / result.seconds / 1e9;
+            }
+            harness.add(std::move(result));
+        }
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("grep", grepSuite);
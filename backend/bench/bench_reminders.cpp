@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "harness.hpp"
+#include "note/note.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "reminder/timing_wheel.hpp"
+#include "repository/inmemory_repository.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+using banchoo::bench::Result;
+namespace note = banchoo::note;
+namespace reminder = banchoo::reminder;
+namespace repository = banchoo::repository;
+using namespace std::chrono_literals;
+
+constexpr std::size_t TIMERS = 1'000'000;
+// 1초 틱으로 한 달 안에 고르게 흩어진 마감
+constexpr std::uint64_t SPREAD = 30 * 24 * 3600;
+
+std::vector<std::uint64_t> deadlines(std::size_t size)
+{
+    std::mt19937_64 rng(1);
+    std::vector<std::uint64_t> out(size);
+    for (auto &d : out)
+        d = 1 + rng() % SPREAD;
+    return out;
+}
+
+void wheelSuite(Harness &harness)
+{
+    auto ticks = deadlines(TIMERS);
+
+    if (harness.selected("reminders/schedule"))
+    {
+        reminder::TimingWheel wheel;
+        auto result = harness.measure(
+            "reminders/schedule",
+            1,
+            TIMERS,
+            [&](int, std::size_t i)
+            {
+                wheel.schedule({.id = static_cast<note::Id>(i)}, ticks[i]);
+            });
+        result.params["timers"] = TIMERS;
+        result.counters["bytes_per_timer"] =
+            static_cast<double>(wheel.memoryBytes()) / TIMERS;
+        harness.add(std::move(result));
+    }
+
+    reminder::TimingWheel wheel;
+    for (std::size_t i = 0; i < TIMERS; ++i)
+        wheel.schedule({.id = static_cast<note::Id>(i)}, ticks[i]);
+
+    if (harness.selected("reminders/reschedule"))
+    {
+        // 이미 걸린 알림의 시각을 옮기기 (마감 수정)
+        auto result = harness.measure(
+            "reminders/reschedule",
+            1,
+            TIMERS,
+            [&](int, std::size_t i)
+            {
+                wheel.schedule({.id = static_cast<note::Id>(i)},
+                               ticks[TIMERS - 1 - i]);
+            });
+        result.params["timers"] = TIMERS;
+        harness.add(std::move(result));
+    }
+
+    if (harness.selected("reminders/advance"))
+    {
+        // 한 달을 1초 틱으로 모두 보낸다. 틱 하나의 평균 비용이다.
+        std::vector<reminder::Reminder> due;
+        due.reserve(TIMERS);
+        auto start = std::chrono::steady_clock::now();
+        wheel.advance(SPREAD, due);
+        Result result;
+        result.name = "reminders/advance";
+        result.ops = SPREAD;
+        result.seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        result.params["threads"] = 1;
+        result.params["timers"] = TIMERS;
+        result.counters["fired"] = static_cast<double>(due.size());
+        harness.add(std::move(result));
+    }
+
+    if (harness.selected("reminders/cancel"))
+    {
+        reminder::TimingWheel full;
+        for (std::size_t i = 0; i < TIMERS; ++i)
+            full.schedule({.id = static_cast<note::Id>(i)}, ticks[i]);
+        auto result = harness.measure(
+            "reminders/cancel",
+            1,
+            TIMERS,
+            [&](int, std::size_t i)
+            { full.cancel(static_cast<note::Id>(i)); });
+        result.params["timers"] = TIMERS;
+        harness.add(std::move(result));
+    }
+
+    // 비교 기준: 틱마다 저장소의 할 일을 모두 훑어 마감이 된 것을 찾는다.
+    if (harness.selected("reminders/poll_scan"))
+    {
+        auto repo =
+            std::make_shared<repository::InMemoryRepository>(nlohmann::json{});
+        const auto now = std::chrono::system_clock::now();
+        std::vector<note::Note> notes(TIMERS);
+        for (std::size_t i = 0; i < TIMERS; ++i)
+        {
+            notes[i].type = note::NoteType::TASK;
+            notes[i].status = note::NoteStatus::TODO;
+            notes[i].due_date = now + std::chrono::seconds(ticks[i]);
+        }
+        repo->importNotes(notes);
+
+        auto result = harness.adaptive(
+            "reminders/poll_scan",
+            1,
+            [&](int)
+            {
+                auto tasks = repo->getAllTasks(
+                    {reminder::ReminderScheduler::FIELDS, 0});
+                std::size_t due = 0;
+                for (const auto &n : tasks)
+                    due += n->due_date && *n->due_date <= now;
+                banchoo::bench::doNotOptimize(due);
+            });
+        result.params["timers"] = TIMERS;
+        harness.add(std::move(result));
+    }
+}
+
+class LatenessRecorder : public reminder::ReminderSubscriber
+{
+ public:
+    void onReminder(const reminder::Reminder &r) override
+    {
+        auto late = std::chrono::duration<double, std::milli>(
+                        std::chrono::system_clock::now() - r.at)
+                        .count();
+        std::lock_guard<std::mutex> lock(mutex);
+        lateness.push_back(late);
+    }
+
+    std::mutex mutex;
+    std::vector<double> lateness;
+};
+
+// 스케줄러 스레드가 벽시계로 알림을 울릴 때 늦는 정도 (ms)
+void accuracySuite(Harness &harness)
+{
+    for (auto tick : {10ms, 100ms})
+    {
+        auto name = "reminders/accuracy/tick_" +
+                    std::to_string(tick.count()) + "ms";
+        if (!harness.selected(name))
+            continue;
+
+        constexpr std::size_t COUNT = 2000;
+        reminder::ReminderScheduler scheduler(tick);
+        auto recorder = std::make_shared<LatenessRecorder>();
+        scheduler.subscribe(recorder);
+
+        std::mt19937_64 rng(3);
+        const auto start = std::chrono::system_clock::now() + 50ms;
+        for (std::size_t i = 0; i < COUNT; ++i)
+        {
+            note::Note n{.id = static_cast<note::Id>(i + 1),
+                         .type = note::NoteType::TASK,
+                         .status = note::NoteStatus::TODO,
+                         .due_date = start + std::chrono::microseconds(
+                                                 rng() % 2'000'000)};
+            scheduler.update(n);
+        }
+        scheduler.start();
+        std::this_thread::sleep_until(start + 2s + 3 * tick);
+        scheduler.stop();
+
+        auto &late = recorder->lateness;
+        std::sort(late.begin(), late.end());
+        auto at = [&](double q)
+        { return late.empty() ? 0.0 : late[q * (late.size() - 1)]; };
+
+        Result result;
+        result.name = name;
+        result.ops = late.size();
+        result.seconds = 2;
+        result.params["threads"] = 1;
+        result.params["tick_ms"] = tick.count();
+        result.counters["fired"] = static_cast<double>(late.size());
+        result.counters["late_p50_ms"] = at(0.5);
+        result.counters["late_p99_ms"] = at(0.99);
+        result.counters["late_max_ms"] = at(1.0);
+        harness.add(std::move(result));
+    }
+}
+
+void remindersSuite(Harness &harness)
+{
+    wheelSuite(harness);
+    accuracySuite(harness);
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("reminders", remindersSuite);
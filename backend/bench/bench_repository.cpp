@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "app/note_serializer.hpp"
+#include "app/request_arena.hpp"
+#include "dataset.hpp"
+#include "harness.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/repository_factory.hpp"
+
+namespace
+{
+using banchoo::app::NoteSerializer;
+using banchoo::app::RequestArena;
+using banchoo::bench::doNotOptimize;
+using banchoo::bench::Harness;
+using banchoo::bench::makeNote;
+using banchoo::bench::Result;
+using banchoo::bench::seed;
+namespace note = banchoo::note;
+namespace repository = banchoo::repository;
+
+std::uint64_t nextRandom(std::uint64_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+std::shared_ptr<repository::BaseRepository>
+makeRepository(const Harness &harness, const std::string &backend)
+{
+    nlohmann::json config = {{"type", backend}, {"instrumented", false}};
+    if (backend == "inmemory-compact")
+    {
+        config["type"] = "inmemory";
+        config["layout"] = "compact";
+    }
+    if (backend == "sqlite")
+    {
+        const auto &path = harness.options().sqlite_path;
+        if (path != ":memory:")
+            std::filesystem::remove(path);
+        config["db_path"] = path;
+    }
+    return repository::RepositoryFactory::create(config);
+}
+
+void record(Harness &harness,
+            Result result,
+            const std::string &backend,
+            std::size_t size)
+{
+    result.params["backend"] = backend;
+    result.params["dataset"] = size;
+    harness.add(std::move(result));
+}
+
+void benchRepository(Harness &harness,
+                     const std::string &backend,
+                     std::size_t size,
+                     int threads)
+{
+    auto repo = makeRepository(harness, backend);
+    seed(*repo, size);
+
+    const auto point_ops = std::clamp<std::size_t>(size, 10000, 100000);
+    const auto id_range = static_cast<std::uint64_t>(size);
+    auto name = [&](const char *op) { return backend + "/" + op; };
+
+    if (harness.selected(name("getNote")))
+    {
+        record(harness,
+               harness.measure(name("getNote"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t i)
+                               {
+                                   std::uint64_t s = i * 2654435761ULL + 1;
+                                   auto id = static_cast<note::Id>(
+                                       1 + nextRandom(s) % id_range);
+                                   repo->getNote(id);
+                               }),
+               backend,
+               size);
+    }
+
+    struct ListOp
+    {
+        const char *name;
+        repository::NoteList (repository::BaseRepository::*fn)(
+            const note::Projection &, std::pmr::memory_resource *) const;
+    };
+    const ListOp list_ops[] = {
+        {"getAllNotes", &repository::BaseRepository::getAllNotes},
+        {"getAllMemos", &repository::BaseRepository::getAllMemos},
+        {"getAllTasks", &repository::BaseRepository::getAllTasks},
+        {"getAllEvents", &repository::BaseRepository::getAllEvents},
+    };
+    for (const auto &op : list_ops)
+    {
+        if (!harness.selected(name(op.name)))
+            continue;
+        record(harness,
+               harness.adaptive(name(op.name),
+                                threads,
+                                [&](int)
+                                {
+                                    ((*repo).*op.fn)(
+                                        {}, std::pmr::get_default_resource());
+                                }),
+               backend,
+               size);
+    }
+
+    if (harness.selected(name("updateNote")))
+    {
+        record(harness,
+               harness.measure(name("updateNote"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t i)
+                               {
+                                   auto n = makeNote(i);
+                                   n.id = static_cast<note::Id>(
+                                       1 + i % id_range);
+                                   n.type = note::NoteType::MEMO;
+                                   repo->updateNote(std::move(n));
+                               }),
+               backend,
+               size);
+    }
+
+    // 가장 잦은 쓰기: 작업 상태만 바꾼다.
+    if (harness.selected(name("patchStatus")))
+    {
+        record(harness,
+               harness.measure(name("patchStatus"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t i)
+                               {
+                                   note::Note values;
+                                   values.status = i % 2
+                                       ? note::NoteStatus::DONE
+                                       : note::NoteStatus::TODO;
+                                   repo->patchNote(
+                                       static_cast<note::Id>(1 + i % id_range),
+                                       std::move(values),
+                                       note::field::STATUS);
+                               }),
+               backend,
+               size);
+    }
+
+    if (harness.selected(name("createNote")))
+    {
+        record(harness,
+               harness.measure(name("createNote"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t i)
+                               { repo->createMemo(makeNote(i)); }),
+               backend,
+               size);
+    }
+
+    // 핸들러가 하는 일(조회/생성 + JSON 직렬화)을 그대로 흉내 낸다.
+    if (harness.selected(name("handler_getNote")))
+    {
+        record(harness,
+               harness.measure(name("handler_getNote"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t i)
+                               {
+                                   std::uint64_t s = i * 2654435761ULL + 1;
+                                   auto id = static_cast<note::Id>(
+                                       1 + nextRandom(s) % id_range);
+                                   std::string body;
+                                   if (auto n = repo->getNote(id))
+                                       NoteSerializer::writeNote(body, *n);
+                                   doNotOptimize(body);
+                               }),
+               backend,
+               size);
+    }
+
+    if (harness.selected(name("handler_getAllNotes")))
+    {
+        record(harness,
+               harness.adaptive(name("handler_getAllNotes"),
+                                threads,
+                                [&](int)
+                                {
+                                    doNotOptimize(NoteSerializer::writeNotes(
+                                        repo->getAllNotes()));
+                                }),
+               backend,
+               size);
+    }
+
+    // 실제 핸들러처럼 목록을 요청 단위 아레나에 받는다.
+    if (harness.selected(name("handler_getAllNotesArena")))
+    {
+        record(harness,
+               harness.adaptive(name("handler_getAllNotesArena"),
+                                threads,
+                                [&](int)
+                                {
+                                    RequestArena::Scope arena;
+                                    doNotOptimize(NoteSerializer::writeNotes(
+                                        repo->getAllNotes(
+                                            NoteSerializer::DEFAULT_VIEW,
+                                            arena.resource())));
+                                }),
+               backend,
+               size);
+    }
+
+    // 사이드바용 ?fields=id,type,status,preview 목록
+    if (harness.selected(name("handler_getAllNotesSidebar")))
+    {
+        const note::Projection view{
+            note::field::ID | note::field::TYPE | note::field::STATUS, 32};
+        record(harness,
+               harness.adaptive(name("handler_getAllNotesSidebar"),
+                                threads,
+                                [&](int)
+                                {
+                                    RequestArena::Scope arena;
+                                    doNotOptimize(NoteSerializer::writeNotes(
+                                        repo->getAllNotes(view,
+                                                          arena.resource()),
+                                        view));
+                                }),
+               backend,
+               size);
+    }
+
+    if (harness.selected(name("handler_createMemo4k")))
+    {
+        const std::string payload(4096, 'x');
+        record(harness,
+               harness.measure(name("handler_createMemo4k"),
+                               threads,
+                               point_ops,
+                               [&](int, std::size_t)
+                               {
+                                   note::Note n{};
+                                   n.content = payload; // 디코더가 만든 본문
+                                   auto created =
+                                       repo->createMemo(std::move(n));
+                                   std::string body;
+                                   NoteSerializer::writeNote(body, *created);
+                                   doNotOptimize(body);
+                               }),
+               backend,
+               size);
+    }
+
+    if (harness.selected(name("deleteNote")))
+    {
+        record(harness,
+               harness.measure(name("deleteNote"),
+                               threads,
+                               std::min<std::size_t>(point_ops, size),
+                               [&](int, std::size_t i) {
+                                   repo->deleteNote(
+                                       static_cast<note::Id>(1 + i));
+                               }),
+               backend,
+               size);
+    }
+}
+
+void repositorySuite(Harness &harness)
+{
+    for (const auto &backend : harness.options().backends)
+    {
+        for (auto size : harness.options().sizes)
+        {
+            for (auto threads : harness.options().threads)
+                benchRepository(harness, backend, size, threads);
+        }
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("repository", repositorySuite);
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "harness.hpp"
+#include "note/note.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/stats_repository.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace note = banchoo::note;
+namespace repository = banchoo::repository;
+
+// 1년에 걸쳐 만들어진 노트. 할 일은 마감이 있고 셋 중 하나는 끝났다.
+std::vector<note::Note> makeNotes(std::size_t size)
+{
+    using namespace std::chrono_literals;
+    const auto start = std::chrono::system_clock::now() - 365 * 24h;
+
+    std::vector<note::Note> notes(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto &n = notes[i];
+        n.type = static_cast<note::NoteType>(i % 3);
+        n.content = "stats #" + std::to_string(i);
+        n.created_at = start + std::chrono::minutes(i * 525600 / size);
+        if (n.type == note::NoteType::TASK)
+        {
+            n.status = static_cast<note::NoteStatus>(i % 9 / 3);
+            n.due_date = n.created_at + std::chrono::hours(i % 2000);
+        }
+    }
+    return notes;
+}
+
+void statsSuite(Harness &harness)
+{
+    for (std::size_t size : {10'000, 100'000, 1'000'000})
+    {
+        auto inner =
+            std::make_shared<repository::InMemoryRepository>(nlohmann::json{});
+        repository::StatsRepository repo(inner);
+        auto notes = makeNotes(size);
+        repo.importNotes(notes);
+
+        auto run = [&](const std::string &name, auto op)
+        {
+            if (!harness.selected(name))
+                return;
+            auto result = harness.adaptive(name, 1, [&](int) { op(); });
+            result.params["notes"] = size;
+            harness.add(std::move(result));
+        };
+
+        run("stats/materialized",
+            [&]
+            {
+                banchoo::bench::doNotOptimize(
+                    repo.noteStats(std::chrono::system_clock::now()));
+            });
+        // 비교 기준: 요청마다 목록 전체를 세는 기본 구현
+        run("stats/scan",
+            [&]
+            {
+                banchoo::bench::doNotOptimize(
+                    inner->noteStats(std::chrono::system_clock::now()));
+            });
+
+        // 쓰기마다 집계를 고치는 비용 (이전 값 읽기 포함)
+        note::Id id = 2; // 할 일
+        int flip = 0;
+        auto patch = [&](repository::BaseRepository &target)
+        {
+            note::Note values{.status = static_cast<note::NoteStatus>(
+                                  ++flip % 3)};
+            target.patchNote(id, std::move(values), note::field::STATUS);
+        };
+        run("stats/patch_status/materialized", [&] { patch(repo); });
+        run("stats/patch_status/plain", [&] { patch(*inner); });
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("stats", statsSuite);
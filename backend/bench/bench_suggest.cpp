@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "index/suggest_index.hpp"
+#include "note/note.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+using banchoo::bench::Result;
+namespace index = banchoo::index;
+namespace note = banchoo::note;
+
+constexpr std::size_t NOTE_COUNT = 1'000'000;
+constexpr std::size_t VOCABULARY = 50'000;
+constexpr std::size_t QUERIES = 20'000;
+
+// 영어처럼 보이는 단어와 한글 단어를 반씩 만든다.
+std::vector<std::string> makeWords(std::mt19937 &rng)
+{
+    const char *onsets[] = {"b", "c", "d", "f", "g", "h", "k", "l", "m",
+                            "n", "p", "r", "s", "t", "v", "st", "tr", "pl"};
+    const char *vowels[] = {"a", "e", "i", "o", "u", "ea", "io"};
+    std::uniform_int_distribution<int> syllables(1, 4);
+
+    std::vector<std::string> words;
+    words.reserve(VOCABULARY);
+    for (std::size_t i = 0; i < VOCABULARY; ++i)
+    {
+        std::string word;
+        for (int n = syllables(rng); n > 0; --n)
+        {
+            if (i % 2 == 0)
+            {
+                word += onsets[rng() % std::size(onsets)];
+                word += vowels[rng() % std::size(vowels)];
+                continue;
+            }
+            // 가..힣 중 흔한 음절만 쓰도록 초성, 중성, 종성을 줄여 고른다.
+            char32_t cp = 0xAC00 + (rng() % 14) * 588 + (rng() % 10) * 28 +
+                          (rng() % 3 == 0 ? rng() % 8 : 0);
+            word.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            word.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            word.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+void suggestSuite(Harness &harness)
+{
+    // 색인을 만드는 데 오래 걸리므로 고른 경우가 없으면 바로 돌아간다.
+    auto queryName = [](std::size_t chars)
+    { return "suggest/query/chars_" + std::to_string(chars); };
+    bool any = harness.selected("suggest/update");
+    for (std::size_t chars = 1; chars <= 4; ++chars)
+        any = any || harness.selected(queryName(chars));
+    if (!any)
+        return;
+
+    std::mt19937 rng(23);
+    const auto words = makeWords(rng);
+    // 단어 빈도는 zipf (순위 k 의 가중치 1/k)
+    std::vector<double> weights(words.size());
+    for (std::size_t k = 0; k < weights.size(); ++k)
+        weights[k] = 1.0 / static_cast<double>(k + 1);
+    std::discrete_distribution<std::size_t> pick(weights.begin(),
+                                                 weights.end());
+    std::uniform_int_distribution<int> length(8, 16);
+    auto content = [&]
+    {
+        std::string text;
+        for (int n = length(rng); n > 0; --n)
+            text += words[pick(rng)] + " ";
+        return text;
+    };
+
+    index::SuggestIndex suggest;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < NOTE_COUNT; ++i)
+    {
+        suggest.put(static_cast<note::Id>(i + 1),
+                    note::TimePoint(std::chrono::seconds(rng() % 100'000'000)),
+                    index::suggestTerms(content(), {}));
+    }
+    const double build_s = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    const double index_mb =
+        static_cast<double>(suggest.memoryBytes()) / (1024.0 * 1024.0);
+
+    auto report = [&](const std::string &name, std::vector<double> &us)
+    {
+        std::sort(us.begin(), us.end());
+        auto at = [&](double q) { return us[q * (us.size() - 1)]; };
+        double total = 0;
+        for (auto v : us)
+            total += v;
+
+        Result result;
+        result.name = name;
+        result.ops = us.size();
+        result.seconds = total / 1e6;
+        result.params["threads"] = 1;
+        result.params["notes"] = NOTE_COUNT;
+        result.counters["p50_us"] = at(0.5);
+        result.counters["p99_us"] = at(0.99);
+        result.counters["max_us"] = at(1.0);
+        result.counters["terms"] = static_cast<double>(suggest.termCount());
+        result.counters["index_mb"] = index_mb;
+        result.counters["build_s"] = build_s;
+        harness.add(std::move(result));
+    };
+
+    // 빈도대로 고른 단어의 앞 1~4 글자를 입력 중인 접두사로 쓴다.
+    for (std::size_t chars = 1; chars <= 4; ++chars)
+    {
+        auto name = queryName(chars);
+        if (!harness.selected(name))
+            continue;
+
+        std::vector<double> us;
+        us.reserve(QUERIES);
+        std::string prefix;
+        for (std::size_t q = 0; q < QUERIES; ++q)
+        {
+            const auto &word = words[pick(rng)];
+            std::size_t end = 0;
+            for (std::size_t c = 0; c < chars && end < word.size(); ++c)
+                end += static_cast<unsigned char>(word[end]) < 0x80 ? 1 : 3;
+            index::normalizePrefix(word.substr(0, end), prefix);
+
+            auto begin = std::chrono::steady_clock::now();
+            auto ids = suggest.suggest(prefix, 10);
+            us.push_back(std::chrono::duration<double, std::micro>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count());
+            banchoo::bench::doNotOptimize(ids);
+        }
+        report(name, us);
+    }
+
+    // 기존 노트의 본문을 바꾸는 쓰기 (단어 뽑기 포함)
+    if (harness.selected("suggest/update"))
+    {
+        std::uniform_int_distribution<note::Id> id(1, NOTE_COUNT);
+        std::vector<double> us;
+        us.reserve(QUERIES);
+        for (std::size_t q = 0; q < QUERIES; ++q)
+        {
+            auto text = content();
+            auto begin = std::chrono::steady_clock::now();
+            suggest.put(id(rng),
+                        note::TimePoint(std::chrono::seconds(100'000'000 + q)),
+                        index::suggestTerms(text, {}));
+            us.push_back(std::chrono::duration<double, std::micro>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count());
+        }
+        report("suggest/update", us);
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("suggest", suggestSuite);
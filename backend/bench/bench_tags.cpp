@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "index/tag_index.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace index = banchoo::index;
+namespace note = banchoo::note;
+
+constexpr std::size_t NOTE_COUNT = 1'000'000;
+constexpr std::size_t TAG_COUNT = 300;
+
+std::string tagName(std::size_t rank)
+{
+    return "t" + std::to_string(rank);
+}
+
+// 노트마다 1~5 개 태그를 zipf 분포(순위 k 의 가중치 1/k)로 뽑는다.
+std::vector<std::vector<std::string>> makeTags()
+{
+    std::vector<double> weights(TAG_COUNT);
+    for (std::size_t k = 0; k < TAG_COUNT; ++k)
+        weights[k] = 1.0 / static_cast<double>(k + 1);
+    std::discrete_distribution<std::size_t> pick(weights.begin(),
+                                                 weights.end());
+    std::uniform_int_distribution<int> count(1, 5);
+
+    std::mt19937 rng(11);
+    std::vector<std::vector<std::string>> tags(NOTE_COUNT);
+    for (auto &t : tags)
+    {
+        for (int n = count(rng); n > 0; --n)
+            t.push_back(tagName(pick(rng)));
+        note::normalize_tags(t);
+    }
+    return tags;
+}
+
+void tagsSuite(Harness &harness)
+{
+    const auto tags = makeTags();
+    index::TagIndex tag_index;
+    for (std::size_t i = 0; i < tags.size(); ++i)
+    {
+        tag_index.add(static_cast<note::Id>(i + 1),
+                      static_cast<note::NoteType>(i % 3),
+                      tags[i]);
+    }
+    const double index_mb =
+        static_cast<double>(tag_index.memoryBytes()) / (1024.0 * 1024.0);
+
+    struct Case
+    {
+        const char *name;
+        const char *expr;
+        std::optional<note::NoteType> type;
+    };
+    const Case cases[] = {
+        {"and", "t0 AND t1", std::nullopt},
+        {"and_not_type", "t0 NOT t2", note::NoteType::TASK},
+        {"or", "t5 OR t50 OR t200", std::nullopt},
+        {"rare_and", "t100 AND t250", std::nullopt},
+        {"nested", "(t0 OR t3) AND t1 NOT (t7 OR t8)", std::nullopt},
+    };
+
+    for (const auto &c : cases)
+    {
+        std::string error;
+        auto query = *index::TagQuery::parse(c.expr, error);
+        auto expected = tag_index.evaluate(query, c.type).cardinality();
+
+        auto run = [&](const std::string &name, auto op)
+        {
+            if (!harness.selected(name))
+                return;
+            auto result = harness.adaptive(name, 1, [&](int) { op(); });
+            result.params["notes"] = NOTE_COUNT;
+            result.params["tags"] = tag_index.tagCount();
+            result.counters["results"] = static_cast<double>(expected);
+            result.counters["index_mb"] = index_mb;
+            harness.add(std::move(result));
+        };
+
+        // 색인 평가 후 id 목록까지 (IndexedRepository::findNotes 의 색인 부분)
+        run(std::string("tags/index/") + c.name,
+            [&]
+            {
+                std::vector<note::Id> ids;
+                auto matched = tag_index.evaluate(query, c.type);
+                ids.reserve(matched.cardinality());
+                matched.forEach([&](std::uint32_t v)
+                                { ids.push_back(static_cast<note::Id>(v)); });
+                banchoo::bench::doNotOptimize(ids);
+            });
+        // 비교 기준: 색인 없이 노트마다 식을 평가한다.
+        run(std::string("tags/scan/") + c.name,
+            [&]
+            {
+                std::vector<note::Id> ids;
+                for (std::size_t i = 0; i < tags.size(); ++i)
+                {
+                    if (c.type && static_cast<note::NoteType>(i % 3) != *c.type)
+                        continue;
+                    if (query.matches(tags[i]))
+                        ids.push_back(static_cast<note::Id>(i + 1));
+                }
+                banchoo::bench::doNotOptimize(ids);
+            });
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("tags", tagsSuite);
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "note/time_codec.hpp"
+
+namespace
+{
+using banchoo::bench::Harness;
+namespace note = banchoo::note;
+
+constexpr std::size_t OPS = 200000;
+
+// 코덱 도입 전 note.hpp 의 구현 (비교 기준)
+std::string legacyFormat(const note::TimePoint &tp)
+{
+    std::time_t time = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm = *std::localtime(&time);
+
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+    return std::string(buffer);
+}
+
+note::TimePoint legacyParse(const std::string &s)
+{
+    std::istringstream ss(s);
+    std::tm t = {};
+    ss >> std::get_time(&t, "%Y-%m-%dT%H:%M:%S");
+    return std::chrono::system_clock::from_time_t(std::mktime(&t));
+}
+
+// 목록 응답처럼 대부분 같은 초 안에 몰린 시각들
+std::vector<note::TimePoint> samples()
+{
+    std::vector<note::TimePoint> out;
+    auto base = std::chrono::system_clock::now();
+    for (int i = 0; i < 1024; ++i)
+        out.push_back(base + std::chrono::microseconds(i * 997));
+    return out;
+}
+
+void timeCodecSuite(Harness &harness)
+{
+    const auto points = samples();
+    std::vector<std::string> rfc;
+    std::vector<std::string> iso; // 예전 parse_time 이 읽던 형식
+    for (const auto &tp : points)
+    {
+        std::string s;
+        note::append_timestamp(s, tp, 6);
+        iso.push_back(s.substr(0, 19));
+        rfc.push_back(std::move(s));
+    }
+
+    for (auto threads : harness.options().threads)
+    {
+        auto run = [&](const std::string &name, auto op)
+        {
+            if (!harness.selected(name))
+                return;
+            auto result = harness.measure(
+                name,
+                threads,
+                OPS,
+                [&](int, std::size_t i) { op(i % points.size()); });
+            harness.add(std::move(result));
+        };
+
+        run("time/format_legacy",
+            [&](std::size_t i)
+            {
+                banchoo::bench::doNotOptimize(legacyFormat(points[i]));
+            });
+        run("time/format",
+            [&](std::size_t i)
+            {
+                char buf[note::TIMESTAMP_MAX_LENGTH];
+                note::format_timestamp(points[i], buf, 6);
+                banchoo::bench::doNotOptimize(buf);
+            });
+        run("time/parse_legacy",
+            [&](std::size_t i)
+            {
+                banchoo::bench::doNotOptimize(legacyParse(iso[i]));
+            });
+        run("time/parse",
+            [&](std::size_t i)
+            {
+                banchoo::bench::doNotOptimize(note::parse_timestamp(rfc[i]));
+            });
+    }
+}
+} // namespace
+
+BANCHOO_BENCH_SUITE("time_codec", timeCodecSuite);
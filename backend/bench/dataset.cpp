@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "dataset.hpp"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::bench
+{
+
+note::Note makeNote(std::size_t i)
+{
+    note::Note n{};
+    n.content = "note #" + std::to_string(i) +
+        " - 오늘 회의에서 새로운 전략을 논의함. lorem ipsum dolor sit amet";
+    return n;
+}
+
+void seed(repository::BaseRepository &repo, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        auto n = makeNote(i);
+        switch (i % 3)
+        {
+        case 0:
+            repo.createMemo(std::move(n));
+            break;
+        case 1:
+            repo.createTask(std::move(n));
+            break;
+        default:
+            repo.createEvent(std::move(n));
+            break;
+        }
+    }
+}
+
+} // namespace banchoo::bench
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::bench
+{
+
+// i 번째 벤치마크용 노트 (본문 약 80바이트)
+note::Note makeNote(std::size_t i);
+
+// memo/task/event 를 번갈아 size 개 만든다.
+void seed(repository::BaseRepository &repo, std::size_t size);
+
+} // namespace banchoo::bench
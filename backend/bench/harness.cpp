@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "alloc_counter.hpp"
+
+namespace banchoo::bench
+{
+
+namespace
+{
+double secondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+}
+} // namespace
+
+Harness::Harness(Options options) : options_(std::move(options)) {}
+
+bool Harness::selected(const std::string &name) const
+{
+    return options_.filter.empty() ||
+        name.find(options_.filter) != std::string::npos;
+}
+
+Result Harness::measure(const std::string &name,
+                        int threads,
+                        std::size_t ops,
+                        const std::function<void(int, std::size_t)> &op)
+{
+    Result result;
+    result.name = name;
+    result.ops = ops;
+    result.params["threads"] = threads;
+
+    std::atomic<std::uint64_t> allocations{0};
+    auto run = [&](int t, std::size_t step)
+    {
+        auto before = threadAllocations();
+        for (auto i = static_cast<std::size_t>(t); i < ops; i += step)
+            op(t, i);
+        allocations += threadAllocations() - before;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    if (threads <= 1)
+    {
+        run(0, 1);
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back(run, t, static_cast<std::size_t>(threads));
+        for (auto &w : workers)
+            w.join();
+    }
+    result.seconds = secondsSince(start);
+    if (ops > 0)
+        result.counters["allocs_per_op"] =
+            static_cast<double>(allocations.load()) / static_cast<double>(ops);
+    return result;
+}
+
+Result Harness::adaptive(const std::string &name,
+                         int threads,
+                         const std::function<void(int)> &op)
+{
+    auto start = std::chrono::steady_clock::now();
+    op(0);
+    auto once = std::max(secondsSince(start), 1e-9);
+
+    auto min_seconds =
+        std::chrono::duration<double>(options_.min_time).count();
+    auto per_thread =
+        static_cast<std::size_t>(std::clamp(min_seconds / once, 1.0, 1e6));
+
+    return measure(name,
+                   threads,
+                   per_thread * std::max(threads, 1),
+                   [&](int t, std::size_t) { op(t); });
+}
+
+void Harness::add(Result result)
+{
+    double ns_per_op = result.ops ? result.seconds * 1e9 / result.ops : 0;
+    auto allocs = result.counters.find("allocs_per_op");
+    std::fprintf(stderr,
+                 "%-40s %8s %3s %10zu ops %14.1f ns/op %10.1f allocs/op\n",
+                 result.name.c_str(),
+                 result.params.count("dataset")
+                     ? result.params.at("dataset").dump().c_str()
+                     : "",
+                 result.params.at("threads").dump().c_str(),
+                 result.ops,
+                 ns_per_op,
+                 allocs != result.counters.end() ? allocs->second : 0.0);
+    results_.push_back(std::move(result));
+}
+
+nlohmann::json Harness::toJson() const
+{
+    auto benchmarks = nlohmann::json::array();
+    for (const auto &r : results_)
+    {
+        nlohmann::json entry = {
+            {"name", r.name},
+            {"ops", r.ops},
+            {"seconds", r.seconds},
+            {"ns_per_op", r.ops ? r.seconds * 1e9 / r.ops : 0.0},
+            {"ops_per_sec", r.seconds > 0 ? r.ops / r.seconds : 0.0},
+        };
+        for (const auto &[k, v] : r.params)
+            entry[k] = v;
+        for (const auto &[k, v] : r.counters)
+            entry[k] = v;
+        benchmarks.push_back(std::move(entry));
+    }
+
+    return {
+        {"context",
+         {{"hardware_concurrency", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+          {"build_type", "release"},
+#else
+          {"build_type", "debug"},
+#endif
+          {"min_time_ms", options_.min_time.count()}}},
+        {"benchmarks", std::move(benchmarks)},
+    };
+}
+
+SuiteRegistrar::SuiteRegistrar(const char *name, Suite suite)
+{
+    suites().emplace_back(name, std::move(suite));
+}
+
+std::vector<std::pair<std::string, Suite>> &suites()
+{
+    static std::vector<std::pair<std::string, Suite>> registered;
+    return registered;
+}
+
+} // namespace banchoo::bench
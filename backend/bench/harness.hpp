@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::bench
+{
+
+struct Options
+{
+    std::vector<std::size_t> sizes{1000, 100000, 1000000};
+    std::vector<int> threads{1, 4};
+    std::vector<std::string> backends{"inmemory", "inmemory-compact", "sqlite"};
+    std::string filter;
+    std::string sqlite_path = ":memory:";
+    std::chrono::milliseconds min_time{200};
+};
+
+struct Result
+{
+    std::string name;
+    std::map<std::string, nlohmann::json> params; // backend, dataset, ...
+    std::size_t ops = 0;
+    double seconds = 0;
+    std::map<std::string, double> counters; // 추가 지표 (bytes/op 등)
+};
+
+class Harness
+{
+ public:
+    explicit Harness(Options options);
+
+    const Options &options() const
+    {
+        return options_;
+    }
+
+    bool selected(const std::string &name) const;
+
+    // 총 ops 회의 op(thread, i) 를 threads 개 스레드에 나눠 실행하고 벽시계
+    // 시간을 잰다.
+    Result measure(const std::string &name,
+                   int threads,
+                   std::size_t ops,
+                   const std::function<void(int, std::size_t)> &op);
+
+    // 한 번이 무거운 연산용. 한 번 실행해 걸린 시간으로 반복 횟수를 정한 뒤
+    // min_time 을 채우도록 measure 한다.
+    Result adaptive(const std::string &name,
+                    int threads,
+                    const std::function<void(int)> &op);
+
+    void add(Result result);
+    nlohmann::json toJson() const;
+
+ private:
+    Options options_;
+    std::vector<Result> results_;
+};
+
+// 측정 대상 결과가 최적화로 사라지지 않게 한다.
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(value);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+using Suite = std::function<void(Harness &)>;
+
+// 정적 초기화 시점에 벤치마크 묶음을 등록한다.
+struct SuiteRegistrar
+{
+    SuiteRegistrar(const char *name, Suite suite);
+};
+
+std::vector<std::pair<std::string, Suite>> &suites();
+
+} // namespace banchoo::bench
+
+#define BANCHOO_BENCH_SUITE(name, fn)                                          \
+    static ::banchoo::bench::SuiteRegistrar banchoo_suite_##fn(name, fn)
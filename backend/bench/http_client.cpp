@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "http_client.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace banchoo::bench
+{
+
+namespace
+{
+constexpr std::size_t READ_CHUNK = 16 * 1024;
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    return a.size() == b.size() &&
+        std::equal(a.begin(),
+                   a.end(),
+                   b.begin(),
+                   [](char x, char y)
+                   {
+                       return std::tolower(static_cast<unsigned char>(x)) ==
+                           std::tolower(static_cast<unsigned char>(y));
+                   });
+}
+
+std::string_view trim(std::string_view s)
+{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+    return s;
+}
+} // namespace
+
+HttpClient::HttpClient(std::string host, std::uint16_t port)
+    : host_(std::move(host)), port_(port)
+{
+}
+
+HttpClient::~HttpClient()
+{
+    close();
+}
+
+bool HttpClient::connect()
+{
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo *addrs = nullptr;
+    auto port = std::to_string(port_);
+    if (::getaddrinfo(host_.c_str(), port.c_str(), &hints, &addrs) != 0)
+        return false;
+
+    for (auto *a = addrs; a != nullptr; a = a->ai_next)
+    {
+        int fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0)
+            continue;
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0)
+        {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            // 서버가 멈춰도 워커가 영원히 묶이지 않도록 한다.
+            timeval timeout{10, 0};
+            ::setsockopt(
+                fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            fd_ = fd;
+            break;
+        }
+        ::close(fd);
+    }
+    ::freeaddrinfo(addrs);
+    return fd_ >= 0;
+}
+
+void HttpClient::close()
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    buffer_.clear();
+}
+
+bool HttpClient::sendAll(const std::string &data)
+{
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        auto n =
+            ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        sent += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+bool HttpClient::readResponse(HttpResponse &out, bool &keep_alive)
+{
+    char chunk[READ_CHUNK];
+    auto fill = [&]
+    {
+        auto n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0)
+            return false;
+        buffer_.append(chunk, static_cast<std::size_t>(n));
+        return true;
+    };
+
+    std::size_t header_end;
+    while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos)
+    {
+        if (!fill())
+            return false;
+    }
+
+    std::string_view head(buffer_.data(), header_end);
+    auto line_end = head.find("\r\n");
+    auto status_line = head.substr(0, line_end);
+    // HTTP/1.1 200 OK
+    if (status_line.size() < 12 ||
+        std::from_chars(status_line.data() + 9, status_line.data() + 12,
+                        out.status)
+                .ec != std::errc())
+        return false;
+
+    std::size_t content_length = 0;
+    keep_alive = status_line.substr(0, 8) == "HTTP/1.1";
+    while (line_end != std::string_view::npos)
+    {
+        auto next = head.find("\r\n", line_end + 2);
+        auto line = head.substr(line_end + 2,
+                                next == std::string_view::npos
+                                    ? std::string_view::npos
+                                    : next - line_end - 2);
+        line_end = next;
+
+        auto colon = line.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        auto name = line.substr(0, colon);
+        auto value = trim(line.substr(colon + 1));
+        if (equalsIgnoreCase(name, "content-length"))
+            std::from_chars(
+                value.data(), value.data() + value.size(), content_length);
+        else if (equalsIgnoreCase(name, "connection"))
+            keep_alive = !equalsIgnoreCase(value, "close");
+    }
+
+    auto body_begin = header_end + 4;
+    while (buffer_.size() < body_begin + content_length)
+    {
+        if (!fill())
+            return false;
+    }
+
+    out.body.assign(buffer_, body_begin, content_length);
+    buffer_.erase(0, body_begin + content_length);
+    return true;
+}
+
+std::optional<HttpResponse> HttpClient::request(std::string_view method,
+                                                std::string_view path,
+                                                std::string_view body)
+{
+    if (fd_ < 0 && !connect())
+        return std::nullopt;
+
+    request_.clear();
+    request_.append(method).append(" ").append(path).append(" HTTP/1.1\r\n");
+    request_.append("Host: ").append(host_).append("\r\n");
+    if (!body.empty())
+    {
+        request_.append("Content-Type: application/json\r\n");
+        request_.append("Content-Length: ")
+            .append(std::to_string(body.size()))
+            .append("\r\n");
+    }
+    request_.append("\r\n").append(body);
+
+    HttpResponse response;
+    bool keep_alive = false;
+    if (!sendAll(request_) || !readResponse(response, keep_alive))
+    {
+        close();
+        return std::nullopt;
+    }
+    if (!keep_alive)
+        close();
+    return response;
+}
+
+} // namespace banchoo::bench
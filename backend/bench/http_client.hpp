@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace banchoo::bench
+{
+
+struct HttpResponse
+{
+    int status = 0;
+    std::string body;
+};
+
+// 부하 생성용 최소 HTTP/1.1 클라이언트.
+// 연결 하나를 keep-alive 로 재사용하고, 끊기면 다음 요청에서 다시 연결한다.
+class HttpClient
+{
+ public:
+    HttpClient(std::string host, std::uint16_t port);
+    ~HttpClient();
+
+    HttpClient(const HttpClient &) = delete;
+    HttpClient &operator=(const HttpClient &) = delete;
+
+    // 전송 오류나 응답 파싱 실패 시 std::nullopt
+    std::optional<HttpResponse> request(std::string_view method,
+                                        std::string_view path,
+                                        std::string_view body = {});
+
+ private:
+    bool connect();
+    void close();
+    bool sendAll(const std::string &data);
+    bool readResponse(HttpResponse &out, bool &keep_alive);
+
+    std::string host_;
+    std::uint16_t port_;
+    int fd_ = -1;
+    std::string request_;
+    std::string buffer_;
+};
+
+} // namespace banchoo::bench
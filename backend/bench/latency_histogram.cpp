@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::bench
+{
+
+namespace
+{
+constexpr int SUB_BITS = 5;
+constexpr std::uint64_t SUB_COUNT = 1ULL << SUB_BITS;
+constexpr std::size_t BUCKETS = (65 - SUB_BITS) * SUB_COUNT;
+
+std::size_t indexOf(std::uint64_t v)
+{
+    if (v < 2 * SUB_COUNT)
+        return static_cast<std::size_t>(v);
+    int shift = std::bit_width(v) - 1 - SUB_BITS;
+    return static_cast<std::size_t>(shift * SUB_COUNT + (v >> shift));
+}
+
+std::uint64_t upperBoundOf(std::size_t index)
+{
+    if (index < 2 * SUB_COUNT)
+        return index;
+    auto shift = index / SUB_COUNT - 1;
+    auto mantissa = index % SUB_COUNT + SUB_COUNT;
+    return ((mantissa + 1) << shift) - 1;
+}
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : buckets_(BUCKETS, 0) {}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+    ++buckets_[std::min(indexOf(value), BUCKETS - 1)];
+    ++count_;
+    max_ = std::max(max_, value);
+    sum_ += static_cast<double>(value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (std::size_t i = 0; i < BUCKETS; ++i)
+        buckets_[i] += other.buckets_[i];
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+double LatencyHistogram::mean() const
+{
+    return count_ ? sum_ / static_cast<double>(count_) : 0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double q) const
+{
+    if (count_ == 0)
+        return 0;
+
+    auto rank = static_cast<std::uint64_t>(
+        std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count_)));
+    rank = std::max<std::uint64_t>(rank, 1);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += buckets_[i];
+        if (seen >= rank)
+            return std::min(upperBoundOf(i), max_);
+    }
+    return max_;
+}
+
+nlohmann::json LatencyHistogram::toJson() const
+{
+    auto ms = [](std::uint64_t us) { return static_cast<double>(us) / 1000.0; };
+    return {
+        {"p50_ms", ms(percentile(0.5))},
+        {"p99_ms", ms(percentile(0.99))},
+        {"p999_ms", ms(percentile(0.999))},
+        {"max_ms", ms(max())},
+        {"mean_ms", mean() / 1000.0},
+    };
+}
+
+} // namespace banchoo::bench
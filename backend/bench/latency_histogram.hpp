@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::bench
+{
+
+// 꼬리 지연(p99.9)까지 보기 위한 로그-선형 히스토그램.
+// 2의 거듭제곱 구간마다 32개 하위 버킷을 두어 상대 오차가 약 3% 이내다.
+class LatencyHistogram
+{
+ public:
+    LatencyHistogram();
+
+    void record(std::uint64_t value);
+    void merge(const LatencyHistogram &other);
+
+    std::uint64_t count() const
+    {
+        return count_;
+    }
+    std::uint64_t max() const
+    {
+        return max_;
+    }
+    double mean() const;
+
+    // q 는 [0, 1]. 해당 버킷의 상한을 돌려준다 (max 를 넘지 않음).
+    std::uint64_t percentile(double q) const;
+
+    // 값이 마이크로초라고 보고 p50/p99/p99.9/max/mean 을 ms 로 내보낸다.
+    nlohmann::json toJson() const;
+
+ private:
+    std::vector<std::uint64_t> buckets_;
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+    double sum_ = 0;
+};
+
+} // namespace banchoo::bench
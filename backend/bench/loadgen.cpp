@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "http_client.hpp"
+#include "latency_histogram.hpp"
+
+namespace
+{
+using banchoo::bench::HttpClient;
+using banchoo::bench::HttpResponse;
+using banchoo::bench::LatencyHistogram;
+using Clock = std::chrono::steady_clock;
+
+enum Op
+{
+    GET_NOTE,
+    UPDATE_NOTE,
+    DELETE_NOTE,
+    CREATE_MEMO,
+    CREATE_TASK,
+    CREATE_EVENT,
+    LIST_MEMOS,
+    LIST_TASKS,
+    LIST_EVENTS,
+    SET_STATUS,
+    OP_COUNT
+};
+
+struct OpInfo
+{
+    const char *name;  // --mix 에서 쓰는 이름
+    const char *route; // 보고서에 찍히는 라우트
+};
+
+constexpr std::array<OpInfo, OP_COUNT> OPS = {{
+    {"get", "GET /notes/<id>"},
+    {"update", "PUT /notes/<id>"},
+    {"delete", "DELETE /notes/<id>"},
+    {"create_memo", "POST /memos"},
+    {"create_task", "POST /tasks"},
+    {"create_event", "POST /events"},
+    {"list_memos", "GET /memos"},
+    {"list_tasks", "GET /tasks"},
+    {"list_events", "GET /events"},
+    {"set_status", "PATCH /notes/<id>"},
+}};
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 18080;
+    int connections = 4;
+    std::chrono::seconds duration{10};
+    std::chrono::seconds warmup{1};
+    bool open_loop = false;
+    double rate = 0; // 전체 요청/초 (open loop)
+    std::array<double, OP_COUNT> mix{
+        70, 10, 5, 5, 5, 5, 0, 0, 0, 0}; // 조회 위주 기본 구성
+    int preload = 1000;
+    std::uint64_t seed = 1;
+    std::chrono::milliseconds wait{5000};
+    std::string out_path;
+};
+
+struct RouteStats
+{
+    // open loop 에서는 예정 시각부터 잰 지연 (coordinated omission 보정)
+    LatencyHistogram latency;
+    // 실제 전송 시각부터 잰 서버 응답 시간
+    LatencyHistogram service;
+    std::uint64_t non_2xx = 0;
+    std::uint64_t errors = 0;
+
+    void merge(const RouteStats &other)
+    {
+        latency.merge(other.latency);
+        service.merge(other.service);
+        non_2xx += other.non_2xx;
+        errors += other.errors;
+    }
+};
+
+using Stats = std::array<RouteStats, OP_COUNT>;
+
+std::optional<int> parseId(const std::string &body)
+{
+    auto pos = body.find("\"id\":");
+    if (pos == std::string::npos)
+        return std::nullopt;
+    return std::atoi(body.c_str() + pos + 5);
+}
+
+std::string createBody(Op op, std::uint64_t n)
+{
+    auto content = "\"content\":\"loadgen " + std::to_string(n) + "\"";
+    switch (op)
+    {
+    case CREATE_TASK:
+        return "{" + content +
+            ",\"status\":\"TODO\",\"due_date\":\"2025-04-05T12:00:00\"}";
+    case CREATE_EVENT:
+        return "{" + content +
+            ",\"start_date\":\"2025-04-06T09:00:00\""
+            ",\"end_date\":\"2025-04-06T18:00:00\"}";
+    default:
+        return "{" + content + "}";
+    }
+}
+
+const char *createPath(Op op)
+{
+    switch (op)
+    {
+    case CREATE_TASK:
+        return "/tasks";
+    case CREATE_EVENT:
+        return "/events";
+    default:
+        return "/memos";
+    }
+}
+
+class Worker
+{
+ public:
+    Worker(const Options &options,
+           const std::vector<int> &preloaded,
+           int index)
+        : options_(options),
+          preloaded_(preloaded),
+          client_(options.host, options.port),
+          rng_(options.seed + static_cast<std::uint64_t>(index)),
+          pick_(options.mix.begin(), options.mix.end()),
+          index_(index)
+    {
+    }
+
+    void run(Clock::time_point start,
+             Clock::time_point measure_from,
+             Clock::time_point end)
+    {
+        // 연결마다 같은 간격으로 요청을 예약하되 시작 위상을 엇갈린다.
+        std::chrono::nanoseconds interval{0};
+        if (options_.open_loop)
+            interval = std::chrono::nanoseconds(static_cast<std::int64_t>(
+                1e9 * options_.connections / options_.rate));
+        auto next = start + interval * index_ / options_.connections;
+
+        while (true)
+        {
+            auto intended = Clock::now();
+            if (options_.open_loop)
+            {
+                if (next >= end)
+                    break;
+                std::this_thread::sleep_until(next);
+                // 밀려 있으면 쉬지 않고 바로 보낸다. 지연은 예정 시각부터 잰다.
+                intended = next;
+                next += interval;
+            }
+            else if (intended >= end)
+            {
+                break;
+            }
+
+            auto sent = Clock::now();
+            auto [op, response] = execute(static_cast<Op>(pick_(rng_)));
+            auto done = Clock::now();
+
+            if (sent < measure_from)
+                continue;
+            auto &s = stats_[op];
+            if (!response)
+            {
+                ++s.errors;
+                continue;
+            }
+            if (response->status < 200 || response->status >= 300)
+                ++s.non_2xx;
+            s.latency.record(micros(done - intended));
+            s.service.record(micros(done - sent));
+        }
+    }
+
+    const Stats &stats() const
+    {
+        return stats_;
+    }
+
+ private:
+    static std::uint64_t micros(Clock::duration d)
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    }
+
+    std::optional<int> pickExisting()
+    {
+        if (!preloaded_.empty())
+            return preloaded_[rng_() % preloaded_.size()];
+        if (!created_.empty())
+            return created_[rng_() % created_.size()];
+        return std::nullopt;
+    }
+
+    std::pair<Op, std::optional<HttpResponse>> create(Op op)
+    {
+        auto response =
+            client_.request("POST", createPath(op), createBody(op, ++serial_));
+        if (response && response->status == 200)
+        {
+            if (auto id = parseId(response->body))
+                created_.push_back(*id);
+        }
+        return {op, std::move(response)};
+    }
+
+    std::pair<Op, std::optional<HttpResponse>> execute(Op op)
+    {
+        switch (op)
+        {
+        case GET_NOTE:
+        case UPDATE_NOTE:
+        case SET_STATUS:
+        {
+            auto id = pickExisting();
+            if (!id)
+                return create(CREATE_MEMO);
+            auto path = "/notes/" + std::to_string(*id);
+            if (op == GET_NOTE)
+                return {op, client_.request("GET", path)};
+            if (op == SET_STATUS)
+            {
+                const char *body = ++serial_ % 2 ? R"({"status":"DONE"})"
+                                                 : R"({"status":"TODO"})";
+                return {op, client_.request("PATCH", path, body)};
+            }
+            return {op,
+                    client_.request("PUT", path, createBody(op, ++serial_))};
+        }
+        case DELETE_NOTE:
+        {
+            // 미리 넣은 노트는 조회 대상이므로 이 연결이 만든 것만 지운다.
+            if (created_.empty())
+                return create(CREATE_MEMO);
+            auto id = created_.back();
+            created_.pop_back();
+            auto path = "/notes/" + std::to_string(id);
+            return {op, client_.request("DELETE", path)};
+        }
+        case LIST_MEMOS:
+            return {op, client_.request("GET", "/memos")};
+        case LIST_TASKS:
+            return {op, client_.request("GET", "/tasks")};
+        case LIST_EVENTS:
+            return {op, client_.request("GET", "/events")};
+        default:
+            return create(op);
+        }
+    }
+
+    const Options &options_;
+    const std::vector<int> &preloaded_;
+    HttpClient client_;
+    std::mt19937_64 rng_;
+    std::discrete_distribution<int> pick_;
+    int index_;
+    std::vector<int> created_;
+    std::uint64_t serial_ = 0;
+    Stats stats_;
+};
+
+bool waitForServer(const Options &options)
+{
+    auto deadline = Clock::now() + options.wait;
+    HttpClient client(options.host, options.port);
+    while (Clock::now() < deadline)
+    {
+        if (client.request("GET", "/memos"))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return false;
+}
+
+std::vector<int> preload(const Options &options)
+{
+    HttpClient client(options.host, options.port);
+    std::vector<int> ids;
+    ids.reserve(options.preload);
+
+    const Op kinds[] = {CREATE_MEMO, CREATE_TASK, CREATE_EVENT};
+    for (int i = 0; i < options.preload; ++i)
+    {
+        auto op = kinds[i % 3];
+        auto response = client.request(
+            "POST", createPath(op), createBody(op, static_cast<unsigned>(i)));
+        if (response && response->status == 200)
+        {
+            if (auto id = parseId(response->body))
+                ids.push_back(*id);
+        }
+    }
+    return ids;
+}
+
+double toMillis(std::uint64_t us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+nlohmann::json report(const Options &options, const Stats &stats)
+{
+    auto seconds =
+        std::chrono::duration<double>(options.duration - options.warmup)
+            .count();
+
+    auto routes = nlohmann::json::array();
+    RouteStats total;
+    std::fprintf(stderr,
+                 "%-20s %9s %10s %9s %9s %9s %9s %7s %6s\n",
+                 "route",
+                 "count",
+                 "req/s",
+                 "p50 ms",
+                 "p99 ms",
+                 "p99.9 ms",
+                 "max ms",
+                 "non2xx",
+                 "err");
+
+    auto print = [&](const char *name, const RouteStats &s)
+    {
+        const auto &h = s.latency;
+        std::fprintf(stderr,
+                     "%-20s %9llu %10.1f %9.3f %9.3f %9.3f %9.3f %7llu %6llu\n",
+                     name,
+                     static_cast<unsigned long long>(h.count()),
+                     h.count() / seconds,
+                     toMillis(h.percentile(0.5)),
+                     toMillis(h.percentile(0.99)),
+                     toMillis(h.percentile(0.999)),
+                     toMillis(h.max()),
+                     static_cast<unsigned long long>(s.non_2xx),
+                     static_cast<unsigned long long>(s.errors));
+    };
+
+    for (int op = 0; op < OP_COUNT; ++op)
+    {
+        const auto &s = stats[op];
+        if (s.latency.count() == 0 && s.errors == 0)
+            continue;
+        total.merge(s);
+        print(OPS[op].route, s);
+        routes.push_back({{"route", OPS[op].route},
+                          {"count", s.latency.count()},
+                          {"rps", s.latency.count() / seconds},
+                          {"non_2xx", s.non_2xx},
+                          {"errors", s.errors},
+                          {"latency", s.latency.toJson()},
+                          {"service", s.service.toJson()}});
+    }
+    print("total", total);
+
+    return {
+        {"mode", options.open_loop ? "open" : "closed"},
+        {"target_rps", options.rate},
+        {"connections", options.connections},
+        {"duration_s", seconds},
+        {"throughput_rps", total.latency.count() / seconds},
+        {"non_2xx", total.non_2xx},
+        {"errors", total.errors},
+        {"latency", total.latency.toJson()},
+        {"service", total.service.toJson()},
+        {"routes", std::move(routes)},
+    };
+}
+
+bool parseMix(std::string_view value, std::array<double, OP_COUNT> &mix)
+{
+    mix.fill(0);
+    std::stringstream ss{std::string(value)};
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        auto colon = item.find(':');
+        if (colon == std::string::npos)
+            return false;
+        auto name = item.substr(0, colon);
+        int op = 0;
+        while (op < OP_COUNT && name != OPS[op].name)
+            ++op;
+        if (op == OP_COUNT)
+            return false;
+        mix[op] = std::stod(item.substr(colon + 1));
+    }
+    for (auto w : mix)
+    {
+        if (w > 0)
+            return true;
+    }
+    return false;
+}
+
+void usage()
+{
+    std::cerr
+        << "usage: banchoo_loadgen [--host=127.0.0.1] [--port=18080]\n"
+           "                       [--connections=4] [--duration-s=10]\n"
+           "                       [--warmup-s=1] [--rate=REQ_PER_SEC]\n"
+           "                       [--mix=get:70,update:10,...]\n"
+           "                       [--preload=1000] [--seed=1]\n"
+           "                       [--wait-ms=5000] [--out=report.json]\n"
+           "\n"
+           "  --rate 를 주면 open loop (예정 시각 기준 지연), 없으면 closed "
+           "loop.\n"
+           "  mix 연산: get update delete create_memo create_task "
+           "create_event\n"
+           "            list_memos list_tasks list_events set_status\n";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        auto value = [&](std::string_view key)
+        {
+            return std::string(arg.substr(key.size()));
+        };
+
+        if (arg.starts_with("--host="))
+            options.host = value("--host=");
+        else if (arg.starts_with("--port="))
+            options.port =
+                static_cast<std::uint16_t>(std::stoi(value("--port=")));
+        else if (arg.starts_with("--connections="))
+            options.connections =
+                std::max(1, std::stoi(value("--connections=")));
+        else if (arg.starts_with("--duration-s="))
+            options.duration =
+                std::chrono::seconds(std::stoi(value("--duration-s=")));
+        else if (arg.starts_with("--warmup-s="))
+            options.warmup =
+                std::chrono::seconds(std::stoi(value("--warmup-s=")));
+        else if (arg.starts_with("--rate="))
+        {
+            options.rate = std::stod(value("--rate="));
+            options.open_loop = options.rate > 0;
+        }
+        else if (arg.starts_with("--mix="))
+        {
+            if (!parseMix(value("--mix="), options.mix))
+            {
+                std::cerr << "invalid --mix: " << arg << '\n';
+                return 1;
+            }
+        }
+        else if (arg.starts_with("--preload="))
+            options.preload = std::stoi(value("--preload="));
+        else if (arg.starts_with("--seed="))
+            options.seed = std::stoull(value("--seed="));
+        else if (arg.starts_with("--wait-ms="))
+            options.wait =
+                std::chrono::milliseconds(std::stoi(value("--wait-ms=")));
+        else if (arg.starts_with("--out="))
+            options.out_path = value("--out=");
+        else
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (options.warmup >= options.duration)
+        options.warmup = std::chrono::seconds(0);
+
+    if (!waitForServer(options))
+    {
+        std::cerr << "server " << options.host << ':' << options.port
+                  << " is not responding\n";
+        return 1;
+    }
+
+    auto preloaded = preload(options);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.connections; ++i)
+        workers.push_back(std::make_unique<Worker>(options, preloaded, i));
+
+    auto start = Clock::now();
+    auto measure_from = start + options.warmup;
+    auto end = start + options.duration;
+
+    std::vector<std::thread> threads;
+    for (auto &w : workers)
+        threads.emplace_back([&] { w->run(start, measure_from, end); });
+    for (auto &t : threads)
+        t.join();
+
+    Stats merged;
+    for (const auto &w : workers)
+    {
+        for (int op = 0; op < OP_COUNT; ++op)
+            merged[op].merge(w->stats()[op]);
+    }
+
+    auto json = report(options, merged);
+    if (!options.out_path.empty())
+        std::ofstream(options.out_path) << json.dump(2) << '\n';
+
+    // 전송 오류가 있으면 실패로 본다. 4xx/5xx 는 보고만 한다.
+    return json["errors"].get<std::uint64_t>() == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "harness.hpp"
+
+namespace
+{
+template <typename T>
+std::vector<T> parseList(std::string_view value)
+{
+    std::vector<T> out;
+    std::stringstream ss{std::string(value)};
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        std::stringstream is(item);
+        T v{};
+        is >> v;
+        out.push_back(v);
+    }
+    return out;
+}
+
+void usage()
+{
+    std::cerr << "usage: banchoo_bench [--filter=SUBSTR] [--sizes=1000,10000]\n"
+                 "                     [--threads=1,4] "
+                 "[--backends=inmemory,inmemory-compact,sqlite]\n"
+                 "                     [--sqlite-path=PATH] [--min-time-ms=N]\n"
+                 "                     [--out=results.json]\n";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    banchoo::Logger::init("warn");
+
+    banchoo::bench::Options options;
+    std::string out_path;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        auto value = [&](std::string_view key) -> std::string_view
+        {
+            return arg.substr(key.size());
+        };
+
+        if (arg.starts_with("--filter="))
+            options.filter = value("--filter=");
+        else if (arg.starts_with("--sizes="))
+            options.sizes = parseList<std::size_t>(value("--sizes="));
+        else if (arg.starts_with("--threads="))
+            options.threads = parseList<int>(value("--threads="));
+        else if (arg.starts_with("--backends="))
+            options.backends = parseList<std::string>(value("--backends="));
+        else if (arg.starts_with("--sqlite-path="))
+            options.sqlite_path = value("--sqlite-path=");
+        else if (arg.starts_with("--min-time-ms="))
+            options.min_time = std::chrono::milliseconds(
+                std::stoi(std::string(value("--min-time-ms="))));
+        else if (arg.starts_with("--out="))
+            out_path = value("--out=");
+        else
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    banchoo::bench::Harness harness(options);
+    for (const auto &[name, suite] : banchoo::bench::suites())
+    {
+        std::cerr << "== " << name << '\n';
+        suite(harness);
+    }
+
+    auto json = harness.toJson().dump(2);
+    if (out_path.empty())
+    {
+        std::cout << json << '\n';
+    }
+    else
+    {
+        std::ofstream(out_path) << json << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "capture/capture_file.hpp"
+#include "http_client.hpp"
+#include "latency_histogram.hpp"
+
+namespace
+{
+using banchoo::bench::HttpClient;
+using banchoo::bench::LatencyHistogram;
+using banchoo::capture::CaptureReader;
+using banchoo::capture::CaptureRecord;
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+struct Options
+{
+    std::string host = "127.0.0.1";
+    std::uint16_t port = 18080;
+    int connections = 16;
+    double speed = 1.0; // 0 이면 간격 없이 최대한 빠르게
+    std::chrono::milliseconds wait{5000};
+    std::string out_path;
+    double max_regression = -1; // compare: 허용하는 p99 증가 비율
+};
+
+struct RouteStats
+{
+    // 원래 도착 시각(배속 적용)부터 잰 지연
+    LatencyHistogram latency;
+    LatencyHistogram service;
+    std::map<int, std::uint64_t> status;
+    std::uint64_t status_mismatch = 0; // 캡처 당시 응답 코드와 다른 횟수
+    std::uint64_t errors = 0;
+
+    void merge(const RouteStats &other)
+    {
+        latency.merge(other.latency);
+        service.merge(other.service);
+        for (const auto &[code, n] : other.status)
+            status[code] += n;
+        status_mismatch += other.status_mismatch;
+        errors += other.errors;
+    }
+};
+
+using Stats = std::map<std::string, RouteStats>;
+
+// "GET /notes/12?x=1" -> "GET /notes/<int>"
+std::string routeOf(const CaptureRecord &record)
+{
+    std::string_view url = record.url;
+    url = url.substr(0, url.find('?'));
+
+    std::string route = record.method + " ";
+    std::size_t pos = 0;
+    while (pos < url.size())
+    {
+        auto end = url.find('/', pos + 1);
+        auto segment = url.substr(pos, end - pos); // 앞의 '/' 포함
+        bool numeric = segment.size() > 1 &&
+            std::all_of(segment.begin() + 1,
+                        segment.end(),
+                        [](char c) { return c >= '0' && c <= '9'; });
+        route += numeric ? std::string("/<int>") : std::string(segment);
+        if (end == std::string_view::npos)
+            break;
+        pos = end;
+    }
+    return route;
+}
+
+std::vector<CaptureRecord> loadTrace(const std::string &path)
+{
+    std::vector<CaptureRecord> records;
+    CaptureReader reader;
+    if (!reader.open(path))
+        return records;
+    while (auto record = reader.next())
+        records.push_back(std::move(*record));
+
+    // 파일에는 응답이 끝난 순서로 쌓이므로 도착 순서로 되돌린다.
+    std::stable_sort(records.begin(),
+                     records.end(),
+                     [](const auto &a, const auto &b)
+                     { return a.offset_ns < b.offset_ns; });
+    return records;
+}
+
+bool waitForServer(const Options &options)
+{
+    auto deadline = Clock::now() + options.wait;
+    HttpClient client(options.host, options.port);
+    while (Clock::now() < deadline)
+    {
+        if (client.request("GET", "/metrics"))
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return false;
+}
+
+std::uint64_t micros(Clock::duration d)
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+Stats replay(const Options &options,
+             const std::vector<CaptureRecord> &records,
+             double &seconds)
+{
+    std::atomic<std::size_t> next{0};
+    std::vector<Stats> partial(options.connections);
+    const auto first = records.front().offset_ns;
+    const auto start = Clock::now();
+
+    auto worker = [&](int index)
+    {
+        HttpClient client(options.host, options.port);
+        auto &stats = partial[index];
+        while (true)
+        {
+            auto i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= records.size())
+                break;
+            const auto &record = records[i];
+
+            auto scheduled = Clock::now();
+            if (options.speed > 0)
+            {
+                scheduled = start +
+                    std::chrono::nanoseconds(static_cast<std::int64_t>(
+                        (record.offset_ns - first) / options.speed));
+                std::this_thread::sleep_until(scheduled);
+            }
+
+            auto sent = Clock::now();
+            auto response =
+                client.request(record.method, record.url, record.body);
+            auto done = Clock::now();
+
+            auto &s = stats[routeOf(record)];
+            if (!response)
+            {
+                ++s.errors;
+                continue;
+            }
+            ++s.status[response->status];
+            if (response->status != record.status)
+                ++s.status_mismatch;
+            s.latency.record(micros(done - scheduled));
+            s.service.record(micros(done - sent));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.connections; ++i)
+        threads.emplace_back(worker, i);
+    for (auto &t : threads)
+        t.join();
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Stats merged;
+    for (const auto &stats : partial)
+    {
+        for (const auto &[route, s] : stats)
+            merged[route].merge(s);
+    }
+    return merged;
+}
+
+json report(const Options &options,
+            const Stats &stats,
+            std::size_t requests,
+            double seconds)
+{
+    std::fprintf(stderr,
+                 "%-24s %8s %9s %9s %9s %9s %8s %6s\n",
+                 "route",
+                 "count",
+                 "p50 ms",
+                 "p99 ms",
+                 "p99.9 ms",
+                 "max ms",
+                 "mismatch",
+                 "err");
+
+    auto routes = json::object();
+    std::uint64_t mismatches = 0;
+    std::uint64_t errors = 0;
+    for (const auto &[route, s] : stats)
+    {
+        auto ms = [](std::uint64_t us) { return us / 1000.0; };
+        std::fprintf(stderr,
+                     "%-24s %8llu %9.3f %9.3f %9.3f %9.3f %8llu %6llu\n",
+                     route.c_str(),
+                     static_cast<unsigned long long>(s.latency.count()),
+                     ms(s.latency.percentile(0.5)),
+                     ms(s.latency.percentile(0.99)),
+                     ms(s.latency.percentile(0.999)),
+                     ms(s.latency.max()),
+                     static_cast<unsigned long long>(s.status_mismatch),
+                     static_cast<unsigned long long>(s.errors));
+
+        auto status = json::object();
+        for (const auto &[code, n] : s.status)
+            status[std::to_string(code)] = n;
+        routes[route] = {{"count", s.latency.count()},
+                         {"status", std::move(status)},
+                         {"status_mismatch", s.status_mismatch},
+                         {"errors", s.errors},
+                         {"latency", s.latency.toJson()},
+                         {"service", s.service.toJson()}};
+        mismatches += s.status_mismatch;
+        errors += s.errors;
+    }
+
+    return {{"speed", options.speed},
+            {"connections", options.connections},
+            {"requests", requests},
+            {"duration_s", seconds},
+            {"status_mismatch", mismatches},
+            {"errors", errors},
+            {"routes", std::move(routes)}};
+}
+
+int runReplay(const Options &options, const std::string &trace_path)
+{
+    auto records = loadTrace(trace_path);
+    if (records.empty())
+    {
+        std::cerr << "no records in " << trace_path << '\n';
+        return 1;
+    }
+    if (!waitForServer(options))
+    {
+        std::cerr << "server " << options.host << ':' << options.port
+                  << " is not responding\n";
+        return 1;
+    }
+
+    double seconds = 0;
+    auto stats = replay(options, records, seconds);
+    auto result = report(options, stats, records.size(), seconds);
+    std::fprintf(stderr,
+                 "%zu requests in %.2fs, %llu status mismatches\n",
+                 records.size(),
+                 seconds,
+                 static_cast<unsigned long long>(
+                     result["status_mismatch"].get<std::uint64_t>()));
+
+    if (!options.out_path.empty())
+        std::ofstream(options.out_path) << result.dump(2) << '\n';
+    return result["errors"].get<std::uint64_t>() == 0 ? 0 : 1;
+}
+
+int runCompare(const Options &options,
+               const std::string &base_path,
+               const std::string &candidate_path)
+{
+    json base = json::parse(std::ifstream(base_path), nullptr, false);
+    json candidate = json::parse(std::ifstream(candidate_path), nullptr, false);
+    if (base.is_discarded() || candidate.is_discarded())
+    {
+        std::cerr << "failed to read replay results\n";
+        return 1;
+    }
+
+    std::set<std::string> routes;
+    for (const auto &[route, _] : base["routes"].items())
+        routes.insert(route);
+    for (const auto &[route, _] : candidate["routes"].items())
+        routes.insert(route);
+
+    std::fprintf(stderr,
+                 "%-24s %19s %19s %19s %8s\n",
+                 "route",
+                 "p50 ms",
+                 "p99 ms",
+                 "p99.9 ms",
+                 "status");
+
+    bool failed = false;
+    auto empty = json::object();
+    for (const auto &route : routes)
+    {
+        const auto &b = base["routes"].contains(route)
+            ? base["routes"][route]
+            : empty;
+        const auto &c = candidate["routes"].contains(route)
+            ? candidate["routes"][route]
+            : empty;
+
+        auto value = [](const json &r, const char *key)
+        {
+            return r.contains("latency") ? r["latency"].value(key, 0.0) : 0.0;
+        };
+        auto cell = [&](const char *key)
+        {
+            char buf[32];
+            std::snprintf(buf,
+                          sizeof(buf),
+                          "%8.3f -> %8.3f",
+                          value(b, key),
+                          value(c, key));
+            return std::string(buf);
+        };
+
+        bool same_status = b.value("status", json::object()) ==
+            c.value("status", json::object());
+        std::fprintf(stderr,
+                     "%-24s %19s %19s %19s %8s\n",
+                     route.c_str(),
+                     cell("p50_ms").c_str(),
+                     cell("p99_ms").c_str(),
+                     cell("p999_ms").c_str(),
+                     same_status ? "same" : "DIFF");
+
+        if (!same_status)
+            failed = true;
+
+        auto base_p99 = value(b, "p99_ms");
+        if (options.max_regression >= 0 && base_p99 > 0 &&
+            value(c, "p99_ms") > base_p99 * (1 + options.max_regression))
+        {
+            std::fprintf(stderr,
+                         "  p99 regression on %s exceeds %.0f%%\n",
+                         route.c_str(),
+                         options.max_regression * 100);
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+void usage()
+{
+    std::cerr
+        << "usage: banchoo_replay run TRACE [--host=127.0.0.1]\n"
+           "                      [--port=18080] [--speed=1.0]\n"
+           "                      [--connections=16]\n"
+           "                      [--wait-ms=5000] [--out=result.json]\n"
+           "       banchoo_replay compare BASE.json CANDIDATE.json\n"
+           "                      [--max-regression=0.10]\n"
+           "\n"
+           "  run     캡처 파일을 원래 간격(--speed 배속)대로 다시 보낸다.\n"
+           "          --speed=0 이면 간격 없이 최대한 빠르게 보낸다.\n"
+           "  compare 두 결과의 라우트별 지연과 응답 코드 분포를 비교한다.\n"
+           "          응답 코드가 다르거나 p99 증가가 한도를 넘으면 1 을 "
+           "돌려준다.\n";
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg = argv[i];
+        auto value = [&](std::string_view key)
+        {
+            return std::string(arg.substr(key.size()));
+        };
+
+        if (arg.starts_with("--host="))
+            options.host = value("--host=");
+        else if (arg.starts_with("--port="))
+            options.port =
+                static_cast<std::uint16_t>(std::stoi(value("--port=")));
+        else if (arg.starts_with("--connections="))
+            options.connections =
+                std::max(1, std::stoi(value("--connections=")));
+        else if (arg.starts_with("--speed="))
+            options.speed = std::max(0.0, std::stod(value("--speed=")));
+        else if (arg.starts_with("--wait-ms="))
+            options.wait =
+                std::chrono::milliseconds(std::stoi(value("--wait-ms=")));
+        else if (arg.starts_with("--out="))
+            options.out_path = value("--out=");
+        else if (arg.starts_with("--max-regression="))
+            options.max_regression = std::stod(value("--max-regression="));
+        else if (arg.starts_with("--"))
+        {
+            usage();
+            return arg == "--help" ? 0 : 1;
+        }
+        else
+            positional.emplace_back(arg);
+    }
+
+    if (positional.size() == 2 && positional[0] == "run")
+        return runReplay(options, positional[1]);
+    if (positional.size() == 3 && positional[0] == "compare")
+        return runCompare(options, positional[1], positional[2]);
+
+    usage();
+    return 1;
+}
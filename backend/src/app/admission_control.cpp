@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/admission_control.hpp"
+
+#include <crow_all.h>
+
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "app/concurrency_limiter.hpp"
+#include "common/logger.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+constexpr const char *ROUTE_CLASS_NAMES[] = {"read", "write", "heavy_read"};
+
+RouteClass parseRouteClass(const std::string &name)
+{
+    for (std::size_t i = 0; i < std::size(ROUTE_CLASS_NAMES); ++i)
+    {
+        if (name == ROUTE_CLASS_NAMES[i])
+            return static_cast<RouteClass>(i);
+    }
+    throw std::invalid_argument("Invalid admission route class: " + name);
+}
+
+ConcurrencyLimiter::Options parseOptions(const nlohmann::json &config,
+                                         const nlohmann::json &defaults)
+{
+    auto get = [&](const char *key, std::size_t fallback)
+    {
+        if (config.contains(key))
+            return config[key].get<std::size_t>();
+        return defaults.value(key, fallback);
+    };
+
+    ConcurrencyLimiter::Options options;
+    options.limit = get("limit", options.limit);
+    options.min_limit = get("min_limit", options.min_limit);
+    options.max_limit = get("max_limit", options.max_limit);
+    options.target_latency = std::chrono::microseconds(
+        get("target_latency_ms", 0) * 1000);
+    return options;
+}
+} // namespace
+
+void AdmissionControl::configure(const nlohmann::json &config)
+{
+    if (!config.contains("admission"))
+        return;
+
+    const auto &admission = config["admission"];
+    if (!admission.value("enabled", true))
+        return;
+
+    retry_after_ = std::chrono::seconds(admission.value("retry_after_s", 1));
+
+    auto classes = admission.value("classes", nlohmann::json::object());
+    for (std::size_t i = 0; i < ROUTE_CLASS_COUNT; ++i)
+    {
+        auto options = parseOptions(
+            classes.value(ROUTE_CLASS_NAMES[i], nlohmann::json::object()),
+            admission);
+        limiters_[i] = std::make_unique<ConcurrencyLimiter>(options);
+
+        BANCHOO_INFO("Admission [{}]: limit {}, target latency {}us",
+                     ROUTE_CLASS_NAMES[i],
+                     options.limit,
+                     options.target_latency.count());
+    }
+
+    auto routes = admission.value("routes", nlohmann::json::object());
+    for (const auto &[route, name] : routes.items())
+        routes_[route] = parseRouteClass(name.get<std::string>());
+}
+
+RouteClass AdmissionControl::classify(const crow::request &req) const
+{
+    auto it = routes_.find(req.url);
+    if (it != routes_.end())
+        return it->second;
+    if (req.method == "GET"_method || req.method == "HEAD"_method)
+        return RouteClass::READ;
+    return RouteClass::WRITE;
+}
+
+void AdmissionControl::before_handle(crow::request &req,
+                                     crow::response &res,
+                                     context &ctx)
+{
+    auto *limiter = limiters_[static_cast<std::size_t>(classify(req))].get();
+    if (!limiter)
+        return;
+
+    if (!limiter->tryAcquire())
+    {
+        BANCHOO_DEBUG("Shedding {} (limit {})", req.url, limiter->limit());
+        res.code = 503;
+        res.set_header("Retry-After", std::to_string(retry_after_.count()));
+        res.end();
+        return;
+    }
+
+    ctx.limiter = limiter;
+    ctx.start = std::chrono::steady_clock::now();
+}
+
+void AdmissionControl::after_handle(crow::request &,
+                                    crow::response &,
+                                    context &ctx)
+{
+    if (!ctx.limiter)
+        return;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - ctx.start);
+    ctx.limiter->release(elapsed);
+    ctx.limiter = nullptr;
+}
+
+} // namespace banchoo::app
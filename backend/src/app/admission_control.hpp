@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include "app/concurrency_limiter.hpp"
+
+namespace banchoo::app
+{
+
+enum class RouteClass
+{
+    READ,
+    WRITE,
+    HEAVY_READ
+};
+
+// 라우트 종류별 동시 실행 한도를 적용하는 Crow 미들웨어.
+// 한도가 찬 요청은 io 스레드에서 기다리게 하지 않고 핸들러에 닿기 전에
+// 503 과 Retry-After 로 돌려보낸다.
+struct AdmissionControl
+{
+    struct context
+    {
+        ConcurrencyLimiter *limiter = nullptr;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // "admission" 설정 블록이 없으면 아무 것도 제한하지 않는다.
+    // "routes": { "/stats": "heavy_read" } 처럼 경로별로 종류를 정하고,
+    // 표에 없는 경로는 GET/HEAD 면 read, 나머지는 write 다.
+    void configure(const nlohmann::json &config);
+
+    void before_handle(crow::request &req, crow::response &res, context &ctx);
+    void after_handle(crow::request &req, crow::response &res, context &ctx);
+
+    RouteClass classify(const crow::request &req) const;
+
+ private:
+    static constexpr std::size_t ROUTE_CLASS_COUNT = 3;
+
+    std::array<std::unique_ptr<ConcurrencyLimiter>, ROUTE_CLASS_COUNT>
+        limiters_;
+    std::unordered_map<std::string, RouteClass> routes_;
+    std::chrono::seconds retry_after_{1};
+};
+
+} // namespace banchoo::app
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/capture_middleware.hpp"
+
+#include <crow_all.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "capture/capture_file.hpp"
+#include "common/logger.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+bool isOperational(std::string_view url)
+{
+    return url.starts_with("/admin") || url.starts_with("/metrics");
+}
+} // namespace
+
+void CaptureMiddleware::configure(const nlohmann::json &config)
+{
+    auto capture = config.value("capture", nlohmann::json::object());
+    if (!capture.value("enabled", false))
+        return;
+
+    auto path = capture.value("path", std::string("capture.bin"));
+    auto writer = std::make_unique<capture::CaptureWriter>();
+    if (!writer->open(path))
+        throw std::runtime_error("Failed to open capture file: " + path);
+
+    writer_ = std::move(writer);
+    origin_ = std::chrono::steady_clock::now();
+    BANCHOO_INFO("Capturing requests to {}", path);
+}
+
+void CaptureMiddleware::before_handle(crow::request &,
+                                      crow::response &,
+                                      context &ctx)
+{
+    if (!writer_)
+        return;
+    ctx.arrival_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin_)
+            .count());
+}
+
+void CaptureMiddleware::after_handle(crow::request &req,
+                                     crow::response &res,
+                                     context &ctx)
+{
+    if (!writer_ || isOperational(req.url))
+        return;
+
+    // 응답 코드까지 알아야 하므로 도착 시각만 앞에서 재고 기록은 여기서 한다.
+    writer_->append({ctx.arrival_ns,
+                     static_cast<std::uint16_t>(res.code),
+                     crow::method_name(req.method),
+                     req.raw_url,
+                     req.body});
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <nlohmann/json.hpp>
+
+#include "capture/capture_file.hpp"
+
+namespace banchoo::app
+{
+
+// 들어온 요청을 캡처 파일에 남겨 banchoo_replay 로 다시 재생할 수 있게 한다.
+// /admin, /metrics 같은 운영용 요청은 남기지 않는다.
+struct CaptureMiddleware
+{
+    struct context
+    {
+        std::uint64_t arrival_ns = 0;
+    };
+
+    // "capture": { "enabled": false, "path": "capture.bin" }
+    void configure(const nlohmann::json &config);
+
+    void before_handle(crow::request &req, crow::response &res, context &ctx);
+    void after_handle(crow::request &req, crow::response &res, context &ctx);
+
+ private:
+    std::unique_ptr<capture::CaptureWriter> writer_;
+    std::chrono::steady_clock::time_point origin_;
+};
+
+} // namespace banchoo::app
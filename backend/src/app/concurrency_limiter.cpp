@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/concurrency_limiter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace banchoo::app
+{
+
+ConcurrencyLimiter::ConcurrencyLimiter(const Options &options)
+    : options_(options),
+      limit_(std::clamp(options.limit, options.min_limit, options.max_limit))
+{
+}
+
+bool ConcurrencyLimiter::tryAcquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_flight_ < limit_)
+    {
+        ++in_flight_;
+        return true;
+    }
+    ++window_rejected_;
+    return false;
+}
+
+void ConcurrencyLimiter::release(std::chrono::microseconds latency)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_flight_;
+    adapt(latency);
+}
+
+std::size_t ConcurrencyLimiter::limit() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+std::size_t ConcurrencyLimiter::inFlight() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+}
+
+void ConcurrencyLimiter::adapt(std::chrono::microseconds latency)
+{
+    if (options_.target_latency.count() == 0)
+        return;
+
+    window_total_ += latency;
+    if (++window_count_ < ADAPT_WINDOW)
+        return;
+
+    auto average = window_total_ / window_count_;
+    auto rejected = window_rejected_;
+    window_count_ = 0;
+    window_rejected_ = 0;
+    window_total_ = std::chrono::microseconds{0};
+
+    if (average > options_.target_latency)
+    {
+        // 지연이 목표를 넘으면 한도를 10% 줄인다.
+        auto decrease = std::max<std::size_t>(1, limit_ / 10);
+        limit_ = std::max(options_.min_limit,
+                          limit_ > decrease ? limit_ - decrease : 0);
+    }
+    else if (rejected > 0 || in_flight_ + 1 >= limit_)
+    {
+        // 여유가 있고 한도가 실제로 찼을 때(거절이 있었을 때)만 하나씩
+        // 늘린다.
+        limit_ = std::min(options_.max_limit, limit_ + 1);
+    }
+}
+
+} // namespace banchoo::app
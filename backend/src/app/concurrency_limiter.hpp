@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+namespace banchoo::app
+{
+
+// 동시 실행 한도를 가진 세마포어. 한도가 차 있으면 기다리지 않고 바로
+// 거절한다. Crow io 스레드 하나가 여러 연결을 돌리고 응답 완료도 그
+// 스레드로 돌아오므로, 거기서 잠들면 자리를 비워 줄 요청까지 멈춘다.
+// target_latency 가 주어지면 관측된 지연 시간에 따라 한도를 AIMD 로 조정한다.
+class ConcurrencyLimiter
+{
+ public:
+    struct Options
+    {
+        std::size_t limit = 64;
+        std::size_t min_limit = 1;
+        std::size_t max_limit = 1024;
+        std::chrono::microseconds target_latency{0}; // 0 이면 고정 한도
+    };
+
+    explicit ConcurrencyLimiter(const Options &options);
+
+    // 실행 슬롯을 얻는다. 한도가 차 있으면 false.
+    bool tryAcquire();
+    void release(std::chrono::microseconds latency);
+
+    std::size_t limit() const;
+    std::size_t inFlight() const;
+
+ private:
+    static constexpr std::size_t ADAPT_WINDOW = 32;
+
+    void adapt(std::chrono::microseconds latency);
+
+    const Options options_;
+
+    mutable std::mutex mutex_;
+    std::size_t limit_;
+    std::size_t in_flight_ = 0;
+
+    std::size_t window_count_ = 0;
+    std::size_t window_rejected_ = 0;
+    std::chrono::microseconds window_total_{0};
+};
+
+} // namespace banchoo::app
@@ -8,179 +8,852 @@
 
 #include <crow_all.h>
 
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <nlohmann/json.hpp>
 
+#include "app/admission_control.hpp"
 #include "app/base_app.hpp"
+#include "app/capture_middleware.hpp"
 #include "app/crow_cors.hpp"
+#include "app/metrics_middleware.hpp"
+#include "app/note_decoder.hpp"
+#include "app/note_serializer.hpp"
+#include "app/note_stream.hpp"
+#include "app/reminder_stream.hpp"
+#include "app/replica_guard.hpp"
+#include "app/request_arena.hpp"
+#include "app/trace_middleware.hpp"
+#include "common/logger.hpp"
+#include "index/content_matcher.hpp"
+#include "index/suggest_index.hpp"
+#include "index/tag_query.hpp"
+#include "metrics/registry.hpp"
 #include "note/note.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "replication/change_log.hpp"
+#include "replication/follower.hpp"
+#include "repository/async_repository.hpp"
+#include "repository/base_repository.hpp"
 #include "repository/repository_factory.hpp"
+#include "repository/tenant_pool.hpp"
+#include "trace/tracer.hpp"
 
 using json = nlohmann::json;
 
 namespace banchoo::app
 {
 
+namespace
+{
+// GET /grep 이 한 번에 돌려주는 노트 수의 기본값과 상한
+constexpr std::size_t DEFAULT_GREP_LIMIT = 100;
+constexpr std::size_t MAX_GREP_LIMIT = 1000;
+// GET /suggest 가 ?limit= 없이 돌려주는 노트 수
+constexpr std::size_t DEFAULT_SUGGEST_LIMIT = 10;
+// 요청 본문은 메모리에 모두 올라오므로 max_body_bytes 가 없으면 이만큼으로
+// 제한한다. POST /import 도 이 한도 안에서만 받는다.
+constexpr std::size_t DEFAULT_MAX_BODY_BYTES = 64 * 1024 * 1024;
+
+crow::response jsonResponse(std::string body)
+{
+    crow::response res(std::move(body));
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+crow::response errorResponse(const DecodeError &error)
+{
+    std::string body;
+    body.reserve(error.error.size() + error.field.size() +
+                 error.message.size() + 40);
+    body.append("{\"error\":\"");
+    NoteSerializer::appendEscaped(body, error.error);
+    body.append("\",\"field\":\"");
+    NoteSerializer::appendEscaped(body, error.field);
+    body.append("\",\"message\":\"");
+    NoteSerializer::appendEscaped(body, error.message);
+    body.append("\"}");
+
+    crow::response res(400, std::move(body));
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
+// source 가 만드는 조각을 chunked 로 보낸다. 첫 조각 뒤의 조각은 핸들러가
+// 돌아간 뒤, 앞 조각을 다 보낼 때마다 만든다. 저장소 스레드 풀(io)이
+// 있으면 조각을 그 풀에서 만들어 저장소 읽기가 Crow io 스레드를 막지
+// 않게 하고, 없으면 io 스레드에서 만든다. 어느 쪽이든 after_handle 이
+// 끝난 뒤이므로 admission 한도에는 잡히지 않는다. 풀이 있으면 동시에
+// 만드는 조각 수가 풀의 스레드 수로 묶인다.
+void setBodySource(crow::response &res,
+                   repository::AsyncRepository *io,
+                   std::function<bool(std::string &)> source)
+{
+    res.set_body_source(std::move(source));
+    if (io)
+        res.body_source_runner = [io](std::function<void()> job)
+        { io->post(std::move(job)); };
+}
+
+// ?fields=, ?preview= 로 고른 필드만 목록으로 응답한다.
+// ?tags= 가 있으면 태그 검색식에 맞는 type 노트만 id 순으로 돌려준다.
+// 그 밖에는 저장소를 id 순으로 배치씩 훑는다. 첫 조각에 다 드는 작은 목록만
+// 한 번에 보내고, 나머지는 본문 전체를 만들지 않고 조각마다 chunked 로
+// 보낸다(setBodySource). Crow 는 stream_threshold(1MB) 이상인 본문을 io
+// 스레드를 막은 채 나눠 쓰므로 그보다 큰 본문은 만들지 않는다.
+crow::response listResponse(const crow::request &req,
+                            repository::AsyncRepository *io,
+                            std::shared_ptr<repository::BaseRepository> repo,
+                            std::optional<note::NoteType> type)
+{
+    note::Projection view = NoteSerializer::DEFAULT_VIEW;
+    auto decoded = NoteDecoder::decodeProjection(
+        req.url_params.get("fields"), req.url_params.get("preview"), view);
+    if (!decoded.ok())
+        return errorResponse(*decoded.error);
+
+    std::optional<index::TagQuery> query;
+    decoded = NoteDecoder::decodeTagQuery(req.url_params.get("tags"), query);
+    if (!decoded.ok())
+        return errorResponse(*decoded.error);
+
+    // 검색 결과는 응답을 다 보낼 때까지 들고 있어야 하므로 요청 아레나에
+    // 두지 않는다.
+    auto stream =
+        query ? std::make_shared<NoteListStream>(
+                    repo->findNotes(*query, type, view), view)
+              : std::make_shared<NoteListStream>(std::move(repo), type, view);
+    std::string first;
+    if (!stream->next(first) && first.size() < NoteListStream::MAX_CHUNK_BYTES)
+        return jsonResponse(std::move(first));
+
+    crow::response res;
+    res.set_header("Content-Type", "application/json");
+    setBodySource(
+        res,
+        io,
+        [stream, first = std::move(first)](std::string &chunk) mutable
+        {
+            if (first.empty())
+                return stream->next(chunk);
+            chunk = std::move(first);
+            first.clear();
+            return true;
+        });
+    return res;
+}
+
+// ?limit= 이 있으면 1..max 인지 보고 limit 에 쓴다.
+std::optional<DecodeError>
+decodeLimit(const crow::request &req, std::size_t max, std::size_t &limit)
+{
+    const char *text = req.url_params.get("limit");
+    if (!text)
+        return std::nullopt;
+
+    std::string_view value(text);
+    std::size_t parsed = 0;
+    auto [end, ec] =
+        std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (ec != std::errc{} || end != value.data() + value.size() ||
+        parsed == 0 || parsed > max)
+    {
+        return DecodeError{"invalid_value",
+                           "limit",
+                           "limit must be 1.." + std::to_string(max)};
+    }
+    limit = parsed;
+    return std::nullopt;
+}
+
+// ?pattern= 이 본문에 들어 있는 노트를 id 순으로 앞에서부터 ?limit= 개
+// 돌려준다. ?regex=true 면 pattern 을 줄 단위 정규식으로 본다.
+crow::response grepResponse(const crow::request &req,
+                            const repository::BaseRepository &repo)
+{
+    const char *pattern = req.url_params.get("pattern");
+    if (!pattern)
+        return errorResponse(DecodeError{
+            "missing_field", "pattern", "pattern is required"});
+
+    std::string_view regex = req.url_params.get("regex")
+                                 ? req.url_params.get("regex")
+                                 : "false";
+    if (regex != "true" && regex != "false" && regex != "1" && regex != "0")
+        return errorResponse(DecodeError{
+            "invalid_value", "regex", "regex must be true or false"});
+
+    std::size_t limit = DEFAULT_GREP_LIMIT;
+    if (auto error = decodeLimit(req, MAX_GREP_LIMIT, limit))
+        return errorResponse(*error);
+
+    note::Projection view = NoteSerializer::DEFAULT_VIEW;
+    auto decoded = NoteDecoder::decodeProjection(
+        req.url_params.get("fields"), req.url_params.get("preview"), view);
+    if (!decoded.ok())
+        return errorResponse(*decoded.error);
+
+    std::string error;
+    auto matcher = index::ContentMatcher::parse(
+        pattern, regex == "true" || regex == "1", error);
+    if (!matcher)
+        return errorResponse(DecodeError{"invalid_value", "pattern", error});
+
+    auto ids = repo.grepNotes(*matcher, limit);
+    RequestArena::Scope arena;
+    auto notes = repo.getNotes(ids, view, arena.resource());
+    return jsonResponse(NoteSerializer::writeNotes(notes, view));
+}
+
+// ?prefix= 로 시작하는 단어나 태그가 있는 노트를 최근에 고친 순서로
+// ?limit= 개 돌려준다. 한글은 입력 중인 음절과 초성만으로도 찾는다.
+crow::response suggestResponse(const crow::request &req,
+                               const repository::BaseRepository &repo)
+{
+    const char *prefix = req.url_params.get("prefix");
+    if (!prefix)
+        return errorResponse(
+            DecodeError{"missing_field", "prefix", "prefix is required"});
+    std::string normalized;
+    if (!index::normalizePrefix(prefix, normalized))
+        return errorResponse(DecodeError{
+            "invalid_value", "prefix", "prefix must be a single word"});
+
+    std::size_t limit = DEFAULT_SUGGEST_LIMIT;
+    if (auto error = decodeLimit(req, index::SuggestIndex::MAX_LIMIT, limit))
+        return errorResponse(*error);
+
+    note::Projection view = NoteSerializer::DEFAULT_VIEW;
+    auto decoded = NoteDecoder::decodeProjection(
+        req.url_params.get("fields"), req.url_params.get("preview"), view);
+    if (!decoded.ok())
+        return errorResponse(*decoded.error);
+
+    auto ids = repo.suggestNotes(normalized, limit);
+    RequestArena::Scope arena;
+    auto notes = repo.getNotes(ids, view, arena.resource());
+    return jsonResponse(NoteSerializer::writeNotes(notes, view));
+}
+
+crow::response noteResponse(const note::Note &n)
+{
+    std::string body;
+    body.reserve(n.content.size() + 32);
+    NoteSerializer::writeNote(body, n);
+    return jsonResponse(std::move(body));
+}
+
+using Work = std::function<crow::response(repository::BaseRepository &)>;
+
+// 저장소 작업으로 응답을 만든다. 저장소 스레드 풀이 있으면 작업을 거기로
+// 넘기고 Crow 작업 스레드는 바로 다음 요청을 받는다. 결과는 연결의
+// io_service 로 돌아와서 그 스레드에서 응답을 끝낸다.
+void respond(repository::AsyncRepository *io,
+             std::shared_ptr<repository::BaseRepository> repo,
+             const crow::request &req,
+             crow::response &res,
+             Work work)
+{
+    if (!io)
+    {
+        res = work(*repo);
+        res.end();
+        return;
+    }
+
+    auto *service = req.io_service;
+    io->then(std::move(repo),
+             std::move(work),
+             [service, &res](std::future<crow::response> result)
+             {
+                 auto shared = std::make_shared<std::future<crow::response>>(
+                     std::move(result));
+                 service->post(
+                     [shared, &res]
+                     {
+                         try
+                         {
+                             res = shared->get();
+                         }
+                         catch (const std::exception &e)
+                         {
+                             BANCHOO_ERROR("storage request failed: {}",
+                                           e.what());
+                             res = crow::response(500);
+                         }
+                         res.end();
+                     });
+             });
+}
+
+DecodeError tenantError(const std::string &header)
+{
+    return {"invalid_tenant",
+            header,
+            "tenant id must be 1-64 characters of A-Z, a-z, 0-9, '-', '_'"};
+}
+
+void reject(crow::response &res, const DecodeError &error)
+{
+    res = errorResponse(error);
+    res.end();
+}
+} // namespace
+
 void CrowApp::configure(const nlohmann::json &config)
 {
-    repo_ = repository::RepositoryFactory::create(config["repository"]);
+    // "reminders": { "enabled": true, "tick_ms": 1000 }
+    auto reminders = config.value("reminders", nlohmann::json::object());
+    if (reminders.value("enabled", true))
+    {
+        reminders_ = std::make_shared<reminder::ReminderScheduler>(
+            std::chrono::milliseconds(reminders.value("tick_ms", 1000)));
+        reminder_stream_ = std::make_shared<ReminderStream>();
+        reminders_->subscribe(reminder_stream_);
+    }
+
+    // "replication": { "role": "none", "dir": "data/replication",
+    //                  "poll_ms": 50, "leader_url": "" }
+    // 리더는 쓰기를 dir/changes.log 에 남기고, 팔로워는 그 로그를 따라 읽어
+    // 자기 저장소에 적용한다. 팔로워는 노트를 바꾸는 요청을 받지 않는다.
+    auto replication = config.value("replication", nlohmann::json::object());
+    auto role = replication.value("role", std::string("none"));
+    std::filesystem::path replication_dir =
+        replication.value("dir", std::string("data/replication"));
+    auto log_path = (replication_dir / "changes.log").string();
+    if (role == "leader")
+    {
+        std::filesystem::create_directories(replication_dir);
+        changes_ = std::make_shared<replication::ChangeLogWriter>();
+        if (!changes_->open(log_path))
+            throw std::runtime_error("Failed to open change log: " +
+                                     log_path);
+    }
+    else if (role == "follower")
+    {
+        // 리더의 id 를 그대로 받아야 하는데 SQLite 는 id 를 새로 붙인다.
+        // 팔로워는 시작할 때마다 스냅숏부터 받으므로 메모리 저장소로 족하다.
+        if (config["repository"].value("type", std::string()) != "inmemory")
+            throw std::invalid_argument(
+                "Replication follower needs an inmemory repository");
+    }
+    else if (role != "none")
+    {
+        throw std::invalid_argument("Invalid replication role: " + role);
+    }
+
+    repo_ = repository::RepositoryFactory::create(
+        config["repository"], reminders_, changes_);
+    if (role == "follower")
+    {
+        follower_ = std::make_unique<replication::Follower>(
+            repo_,
+            log_path,
+            std::chrono::milliseconds(replication.value("poll_ms", 50)));
+    }
+
+    // "tenants": { "enabled": false, "header": "X-Tenant-Id",
+    //              "dir": "data/tenants", "max_open": 64 }
+    // 헤더가 있는 요청은 그 테넌트의 저장소로, 없는 요청은 기본 저장소로 간다.
+    auto tenants = config.value("tenants", nlohmann::json::object());
+    if (tenants.value("enabled", false))
+    {
+        tenants_ = std::make_unique<repository::TenantPool>(tenants);
+        tenant_header_ = tenants.value("header", std::string("X-Tenant-Id"));
+    }
 
     this->setPort(config["port"].get<uint32_t>());
     this->setBindAddr(config["bindaddr"].get<std::string>());
 
+    threads_ = config.value("threads", uint16_t{0});
+    auto io_threads = config.value("io_threads", std::size_t{0});
+    if (io_threads > 0)
+        io_ = std::make_unique<repository::AsyncRepository>(repo_, io_threads);
+    cpu_affinity_ = config.value("cpu_affinity", std::vector<int>{});
+    for (int cpu : cpu_affinity_)
+    {
+        // CPU_SET 은 범위를 보지 않으므로 cpu_set_t 밖의 번호는 여기서 막는다.
+#ifdef __linux__
+        bool valid = cpu >= 0 && cpu < CPU_SETSIZE;
+#else
+        bool valid = cpu >= 0;
+#endif
+        if (!valid)
+            throw std::invalid_argument("Invalid cpu_affinity entry: " +
+                                        std::to_string(cpu));
+    }
+    max_body_bytes_ = config.value("max_body_bytes", DEFAULT_MAX_BODY_BYTES);
+    app_.get_middleware<AdmissionControl>().configure(config);
+    app_.get_middleware<CaptureMiddleware>().configure(config);
+    app_.get_middleware<MetricsMiddleware>().configure(config);
+    app_.get_middleware<ReplicaGuard>().configure(config);
+    trace::Tracer::instance().configure(
+        config.value("trace", nlohmann::json::object()));
+
     // 🔸 단일 Note 조회
     CROW_ROUTE(app_, "/notes/<int>")
         .methods("GET"_method)(
-            [this](int id)
+            [this](const crow::request &req, int id)
             {
-                auto result = repo_->getNote(id);
+                BANCHOO_SPAN("GET /notes/<int>");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                auto result = repo->getNote(id);
                 if (!result)
                     return crow::response(404);
-                return crow::response(
-                    json({{"id", result->id}, {"content", result->content}})
-                        .dump());
+                return noteResponse(*result);
             });
 
     // 🔸 전체 Note 조회
     CROW_ROUTE(app_, "/notes")
         .methods("GET"_method)(
-            [this]()
+            [this](const crow::request &req)
             {
-                auto notes = repo_->getAllNotes();
-                json res = json::array();
-                for (const auto &n : notes)
-                    res.push_back({{"id", n.id}, {"content", n.content}});
-                return crow::response(res.dump());
+                BANCHOO_SPAN("GET /notes");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return listResponse(
+                    req, io_.get(), std::move(repo), std::nullopt);
             });
 
     // 🔸 Memo
     CROW_ROUTE(app_, "/memos")
         .methods("POST"_method)(
-            [this](const crow::request &req)
+            [this](const crow::request &req, crow::response &res)
             {
-                auto body = json::parse(req.body);
+                BANCHOO_SPAN("POST /memos");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
                 note::Note n;
-                n.content = body["content"];
+                auto decoded =
+                    NoteDecoder::decode(req.body, NoteDecoder::MEMO_SCHEMA, n);
+                if (!decoded.ok())
+                    return reject(res, *decoded.error);
 
-                auto id = repo_->createMemo(n);
-                return crow::response(
-                    json({{"id", id}, {"content", n.content}}).dump());
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [n = std::move(n)](auto &repo) mutable
+                        {
+                            auto created = repo.createMemo(std::move(n));
+                            return noteResponse(*created);
+                        });
             });
 
     CROW_ROUTE(app_, "/memos")
         .methods("GET"_method)(
-            [this]()
+            [this](const crow::request &req)
             {
-                auto memos = repo_->getAllMemos();
-                json res = json::array();
-                for (const auto &m : memos)
-                    res.push_back({{"id", m.id}, {"content", m.content}});
-                return crow::response(res.dump());
+                BANCHOO_SPAN("GET /memos");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return listResponse(
+                    req, io_.get(), std::move(repo), note::NoteType::MEMO);
             });
 
     // 🔸 Task
     CROW_ROUTE(app_, "/tasks")
         .methods("POST"_method)(
-            [this](const crow::request &req)
+            [this](const crow::request &req, crow::response &res)
             {
-                auto body = json::parse(req.body);
+                BANCHOO_SPAN("POST /tasks");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
                 note::Note n;
-                n.content = body["content"];
-                if (body.contains("status"))
-                {
-                    auto status = body["status"].get<std::string>();
-                    if (status == "TODO")
-                        n.status = note::NoteStatus::TODO;
-                    else if (status == "DOING")
-                        n.status = note::NoteStatus::DOING;
-                    else if (status == "DONE")
-                        n.status = note::NoteStatus::DONE;
-                }
-                if (body.contains("due_date"))
-                {
-                    auto due_date = body["due_date"].get<std::string>();
-                    n.due_date = note::parse_time(due_date);
-                }
-                auto id = repo_->createTask(n);
-                return crow::response(
-                    json({{"id", id}, {"content", n.content}}).dump());
+                auto decoded =
+                    NoteDecoder::decode(req.body, NoteDecoder::TASK_SCHEMA, n);
+                if (!decoded.ok())
+                    return reject(res, *decoded.error);
+
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [n = std::move(n)](auto &repo) mutable
+                        {
+                            auto created = repo.createTask(std::move(n));
+                            return noteResponse(*created);
+                        });
             });
 
     CROW_ROUTE(app_, "/tasks")
         .methods("GET"_method)(
-            [this]()
+            [this](const crow::request &req)
             {
-                auto tasks = repo_->getAllTasks();
-                json res = json::array();
-                for (const auto &t : tasks)
-                    res.push_back({{"id", t.id}, {"content", t.content}});
-                return crow::response(res.dump());
+                BANCHOO_SPAN("GET /tasks");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return listResponse(
+                    req, io_.get(), std::move(repo), note::NoteType::TASK);
             });
 
     // 🔸 Event
     CROW_ROUTE(app_, "/events")
         .methods("POST"_method)(
-            [this](const crow::request &req)
+            [this](const crow::request &req, crow::response &res)
             {
-                auto body = json::parse(req.body);
+                BANCHOO_SPAN("POST /events");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
                 note::Note n;
-                n.content = body["content"];
-                if (body.contains("start_date"))
-                {
-                    auto start_date = body["start_date"].get<std::string>();
-                    n.start_date = note::parse_time(start_date);
-                }
-                if (body.contains("end_date"))
-                {
-                    auto end_date = body["end_date"].get<std::string>();
-                    n.end_date = note::parse_time(end_date);
-                }
-                auto id = repo_->createEvent(n);
-                return crow::response(
-                    json({{"id", id}, {"content", n.content}}).dump());
+                auto decoded =
+                    NoteDecoder::decode(req.body, NoteDecoder::EVENT_SCHEMA, n);
+                if (!decoded.ok())
+                    return reject(res, *decoded.error);
+
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [n = std::move(n)](auto &repo) mutable
+                        {
+                            auto created = repo.createEvent(std::move(n));
+                            return noteResponse(*created);
+                        });
             });
 
     CROW_ROUTE(app_, "/events")
         .methods("GET"_method)(
-            [this]()
+            [this](const crow::request &req)
             {
-                auto events = repo_->getAllEvents();
-                json res = json::array();
-                for (const auto &e : events)
-                    res.push_back({{"id", e.id}, {"content", e.content}});
-                return crow::response(res.dump());
+                BANCHOO_SPAN("GET /events");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return listResponse(
+                    req, io_.get(), std::move(repo), note::NoteType::EVENT);
             });
 
     // 🔸 Note 수정
     CROW_ROUTE(app_, "/notes/<int>")
         .methods("PUT"_method)(
-            [this](const crow::request &req, int id)
+            [this](const crow::request &req, crow::response &res, int id)
             {
-                auto body = json::parse(req.body);
+                BANCHOO_SPAN("PUT /notes/<int>");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
                 note::Note n;
-                n.id = id;
-                n.content = body["content"];
-                bool ok = repo_->updateNote(n);
-                return crow::response(ok ? 200 : 404);
+                auto decoded = NoteDecoder::decode(
+                    req.body, NoteDecoder::UPDATE_SCHEMA, n);
+                if (!decoded.ok())
+                    return reject(res, *decoded.error);
+
+                // 본문만 바꾸고 종류, 생성 시각, 상태, 날짜는 그대로 둔다.
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [id, n = std::move(n)](auto &repo) mutable
+                        {
+                            bool ok = repo.patchNote(
+                                id, std::move(n), note::field::CONTENT);
+                            return crow::response(ok ? 200 : 404);
+                        });
+            });
+
+    // 🔸 Note 부분 수정 (본문에 있는 필드만, 선택 필드는 null 로 지움)
+    CROW_ROUTE(app_, "/notes/<int>")
+        .methods("PATCH"_method)(
+            [this](const crow::request &req, crow::response &res, int id)
+            {
+                BANCHOO_SPAN("PATCH /notes/<int>");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
+                note::Note n;
+                auto decoded = NoteDecoder::decode(
+                    req.body, NoteDecoder::PATCH_SCHEMA, n);
+                if (!decoded.ok())
+                    return reject(res, *decoded.error);
+                if (decoded.present == 0)
+                    return reject(res,
+                                  {"missing_field",
+                                   "",
+                                   "no updatable field in body"});
+
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [id, n = std::move(n), fields = decoded.present](
+                            auto &repo) mutable
+                        {
+                            bool ok = repo.patchNote(id, std::move(n), fields);
+                            return crow::response(ok ? 200 : 404);
+                        });
             });
 
     // 🔸 Note 삭제
     CROW_ROUTE(app_, "/notes/<int>")
         .methods("DELETE"_method)(
-            [this](int id)
+            [this](const crow::request &req, crow::response &res, int id)
             {
-                bool ok = repo_->deleteNote(id);
-                return crow::response(ok ? 200 : 404);
+                BANCHOO_SPAN("DELETE /notes/<int>");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [id](auto &repo)
+                        {
+                            bool ok = repo.deleteNote(id);
+                            return crow::response(ok ? 200 : 404);
+                        });
             });
+
+    // 🔸 종류별, 할 일 상태별, 날짜별 노트 수와 마감 지난 할 일 수
+    CROW_ROUTE(app_, "/stats")
+        .methods("GET"_method)(
+            [this](const crow::request &req)
+            {
+                BANCHOO_SPAN("GET /stats");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                auto stats =
+                    repo->noteStats(std::chrono::system_clock::now());
+                return jsonResponse(stats.toJson());
+            });
+
+    // 🔸 본문 검색 (?pattern=, ?regex=true 면 줄 단위 정규식, ?limit=)
+    CROW_ROUTE(app_, "/grep")
+        .methods("GET"_method)(
+            [this](const crow::request &req)
+            {
+                BANCHOO_SPAN("GET /grep");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return grepResponse(req, *repo);
+            });
+
+    // 🔸 자동 완성 (?prefix= 로 시작하는 단어가 있는 노트, 최근 수정 순)
+    CROW_ROUTE(app_, "/suggest")
+        .methods("GET"_method)(
+            [this](const crow::request &req)
+            {
+                BANCHOO_SPAN("GET /suggest");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                return suggestResponse(req, *repo);
+            });
+
+    // 🔸 NDJSON 일괄 가져오기 (줄마다 노트 하나, 배치 트랜잭션으로 저장)
+    CROW_ROUTE(app_, "/import")
+        .methods("POST"_method)(
+            [this](const crow::request &req, crow::response &res)
+            {
+                BANCHOO_SPAN("POST /import");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return reject(res, tenantError(tenant_header_));
+                // 요청 본문은 응답을 끝낼 때까지 연결에 남아 있다. 본문은
+                // 통째로 메모리에 올라오며, max_body_bytes 를 넘으면 Crow 가
+                // 핸들러에 넘기기 전에 413 으로 돌려보낸다.
+                respond(io_.get(),
+                        std::move(repo),
+                        req,
+                        res,
+                        [&body = req.body](auto &repo)
+                        {
+                            NoteImporter importer(repo);
+                            importer.feed(body);
+                            return jsonResponse(importer.finish().toJson());
+                        });
+            });
+
+    // 🔸 전체 Note 를 NDJSON 으로 내보내기 (chunked 로 배치마다 전송)
+    CROW_ROUTE(app_, "/export")
+        .methods("GET"_method)(
+            [this](const crow::request &req)
+            {
+                BANCHOO_SPAN("GET /export");
+                auto repo = tenantRepository(req);
+                if (!repo)
+                    return errorResponse(tenantError(tenant_header_));
+                auto exporter = std::make_shared<NoteExporter>(repo);
+                crow::response res;
+                res.set_header("Content-Type", "application/x-ndjson");
+                setBodySource(res,
+                              io_.get(),
+                              [exporter](std::string &chunk)
+                              { return exporter->next(chunk); });
+                return res;
+            });
+
+    // 🔸 마감된 할 일과 시작된 일정 알림 (웹소켓, 알림마다 JSON 프레임 하나)
+    if (reminders_)
+    {
+        CROW_ROUTE(app_, "/reminders/stream")
+            .websocket()
+            .onopen([this](crow::websocket::connection &conn)
+                    { reminder_stream_->open(conn); })
+            .onclose([this](crow::websocket::connection &conn,
+                            const std::string &)
+                     { reminder_stream_->close(conn); });
+    }
+
+    // 🔸 테넌트 저장소 현황
+    CROW_ROUTE(app_, "/admin/tenants")
+        .methods("GET"_method)(
+            [this]()
+            {
+                if (!tenants_)
+                    return crow::response(404);
+                return jsonResponse(
+                    json({{"open", tenants_->openCount()},
+                          {"cached", tenants_->cachedCount()},
+                          {"max_open", tenants_->maxOpen()}})
+                        .dump());
+            });
+
+    // 🔸 복제 상태 (리더는 로그 위치, 팔로워는 적용 위치와 지연)
+    CROW_ROUTE(app_, "/admin/replication")
+        .methods("GET"_method)(
+            [this]()
+            {
+                if (changes_)
+                    return jsonResponse(json({{"role", "leader"},
+                                              {"epoch", changes_->epoch()},
+                                              {"seq", changes_->seq()}})
+                                            .dump());
+                if (!follower_)
+                    return crow::response(404);
+                auto status = follower_->status().toJson();
+                status["role"] = "follower";
+                return jsonResponse(status.dump());
+            });
+
+    // 🔸 Prometheus 지표
+    CROW_ROUTE(app_, "/metrics")
+        .methods("GET"_method)(
+            []()
+            {
+                crow::response res(
+                    metrics::Registry::instance().renderPrometheus());
+                res.set_header("Content-Type",
+                               "text/plain; version=0.0.4; charset=utf-8");
+                return res;
+            });
+
+    // 🔸 트레이스 덤프 (Chrome Trace Event JSON)
+    CROW_ROUTE(app_, "/admin/trace")
+        .methods("GET"_method)(
+            []()
+            {
+                return jsonResponse(
+                    trace::Tracer::instance().dumpChromeTrace());
+            });
+
+    // 🔸 트레이스 설정 변경 {"enabled": bool, "sample_rate": 0.0 ~ 1.0}
+    CROW_ROUTE(app_, "/admin/trace")
+        .methods("PUT"_method)(
+            [](const crow::request &req)
+            {
+                auto body = json::parse(req.body, nullptr, false);
+                if (body.is_discarded() || !body.is_object() ||
+                    (body.contains("enabled") &&
+                     !body["enabled"].is_boolean()) ||
+                    (body.contains("sample_rate") &&
+                     !body["sample_rate"].is_number()))
+                    return crow::response(400);
+
+                auto &tracer = trace::Tracer::instance();
+                tracer.setEnabled(body.value("enabled", tracer.enabled()));
+                tracer.setSampleRate(
+                    body.value("sample_rate", tracer.sampleRate()));
+                return jsonResponse(json({{"enabled", tracer.enabled()},
+                                          {"sample_rate", tracer.sampleRate()}})
+                                        .dump());
+            });
+
+    CROW_ROUTE(app_, "/admin/trace")
+        .methods("DELETE"_method)(
+            []()
+            {
+                trace::Tracer::instance().clear();
+                return crow::response(200);
+            });
+}
+
+std::shared_ptr<repository::BaseRepository>
+CrowApp::tenantRepository(const crow::request &req) const
+{
+    if (!tenants_)
+        return repo_;
+    const auto &tenant = req.get_header_value(tenant_header_);
+    if (tenant.empty())
+        return repo_;
+    if (!repository::TenantPool::validTenant(tenant))
+        return nullptr;
+    return tenants_->acquire(tenant);
 }
 
 void CrowApp::run()
 {
+#ifdef __linux__
+    // 워커 스레드는 run() 안에서 만들어지므로 현재 스레드의 affinity 를
+    // 그대로 물려받는다.
+    if (!cpu_affinity_.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpu_affinity_)
+            CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            BANCHOO_WARN("Failed to set CPU affinity");
+    }
+#else
+    if (!cpu_affinity_.empty())
+        BANCHOO_WARN("CPU affinity is only supported on Linux");
+#endif
+
     app_.port(this->getPort())
         .bindaddr(this->getBindAddr())
-        .multithreaded()
-        .run();
+        .body_limit(max_body_bytes_);
+    if (threads_ > 0)
+        app_.concurrency(threads_);
+    else
+        app_.multithreaded();
+
+    if (reminders_)
+        reminders_->start();
+    if (follower_)
+        follower_->start();
+    app_.run();
 }
 
 } // namespace banchoo::app
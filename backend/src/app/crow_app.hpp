@@ -7,13 +7,27 @@
 
 #include <crow_all.h>
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "app/admission_control.hpp"
 #include "app/base_app.hpp"
+#include "app/capture_middleware.hpp"
 #include "app/crow_cors.hpp"
+#include "app/metrics_middleware.hpp"
+#include "app/reminder_stream.hpp"
+#include "app/replica_guard.hpp"
+#include "app/trace_middleware.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "replication/change_log.hpp"
+#include "replication/follower.hpp"
+#include "repository/async_repository.hpp"
 #include "repository/base_repository.hpp"
+#include "repository/tenant_pool.hpp"
 
 namespace banchoo::app
 {
@@ -25,8 +39,33 @@ class CrowApp : public BaseApp
     void run() override;
 
  private:
-    crow::App<Cors> app_;
+    // 요청 헤더의 테넌트 저장소. 헤더가 없으면 기본 저장소, 잘못된 id 면 null
+    std::shared_ptr<repository::BaseRepository>
+    tenantRepository(const crow::request &req) const;
+
+    crow::App<Cors,
+              MetricsMiddleware,
+              TraceMiddleware,
+              CaptureMiddleware,
+              ReplicaGuard,
+              AdmissionControl>
+        app_;
     std::shared_ptr<repository::BaseRepository> repo_;
+    std::unique_ptr<repository::TenantPool> tenants_;
+    std::string tenant_header_;
+    // 쓰기 요청을 돌리는 저장소 스레드 풀. io_threads 가 0 이면 없고 Crow
+    // 작업 스레드가 직접 쓴다. app_ 보다 먼저 없어지면서 남은 쓰기를 끝낸다.
+    std::unique_ptr<repository::AsyncRepository> io_;
+    // 리더면 쓰기를 남기는 변경 로그, 팔로워면 그 로그를 적용하는 스레드
+    std::shared_ptr<replication::ChangeLogWriter> changes_;
+    std::unique_ptr<replication::Follower> follower_;
+    // 알림을 보내는 스레드가 연결을 건드리므로 app_ 보다 먼저 멈춘다.
+    std::shared_ptr<reminder::ReminderScheduler> reminders_;
+    std::shared_ptr<ReminderStream> reminder_stream_;
+
+    uint16_t threads_{0};          // 0 이면 하드웨어 스레드 수
+    std::vector<int> cpu_affinity_; // 비어 있으면 고정하지 않음
+    std::size_t max_body_bytes_;    // 요청 본문 한도, 0 이면 제한 없음
 };
 
 } // namespace banchoo::app
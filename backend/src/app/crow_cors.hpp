@@ -26,7 +26,7 @@ struct Cors
     {
         res.add_header("Access-Control-Allow-Origin", "*");
         res.add_header("Access-Control-Allow-Methods",
-                       "GET, POST, PUT, DELETE, OPTIONS");
+                       "GET, POST, PUT, PATCH, DELETE, OPTIONS");
         res.add_header("Access-Control-Allow-Headers", "Content-Type");
     }
 };
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/metrics_middleware.hpp"
+
+#include <crow_all.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "metrics/registry.hpp"
+#include "repository/tenant_pool.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+// 라우트 라벨은 등록된 규칙 수로 묶여 있지만, 테넌트는 헤더 값이라 끝없이
+// 늘어날 수 있으므로 수를 제한한다. 넘치면 "other" 로 묶는다.
+constexpr std::size_t MAX_TENANTS = 32;
+// 어떤 라우트에도 매칭되지 않은 요청(404 탐색 등)의 라우트 라벨
+const std::string OTHER_ROUTE = "other";
+
+struct RouteMetrics
+{
+    std::string labels;
+    metrics::Counter requests;
+    metrics::Histogram latency;
+    metrics::Histogram request_bytes;
+    metrics::Histogram response_bytes;
+    std::vector<std::pair<int, metrics::Counter>> statuses;
+
+    metrics::Counter &status(int code)
+    {
+        for (auto &[c, counter] : statuses)
+        {
+            if (c == code)
+                return counter;
+        }
+        auto labels_with_code =
+            labels + "," + metrics::label("code", std::to_string(code));
+        statuses.emplace_back(code,
+                              metrics::Registry::instance().counter(
+                                  "banchoo_http_responses_total",
+                                  "HTTP responses by status code",
+                                  labels_with_code));
+        return statuses.back().second;
+    }
+};
+
+RouteMetrics makeRouteMetrics(const std::string &method,
+                              const std::string &route)
+{
+    auto &registry = metrics::Registry::instance();
+    RouteMetrics m;
+    m.labels =
+        metrics::label("method", method) + "," + metrics::label("route", route);
+    m.requests = registry.counter(
+        "banchoo_http_requests_total", "HTTP requests received", m.labels);
+    m.latency = registry.histogram("banchoo_http_request_duration_us",
+                                   "HTTP request latency in microseconds",
+                                   m.labels);
+    m.request_bytes = registry.histogram("banchoo_http_request_size_bytes",
+                                         "HTTP request body size in bytes",
+                                         m.labels);
+    m.response_bytes =
+        registry.histogram("banchoo_http_response_size_bytes",
+                           "HTTP response body size in bytes",
+                           m.labels);
+    return m;
+}
+
+RouteMetrics &lookup(const crow::request &req)
+{
+    // 스레드마다 캐시를 두어 기록 경로에서 잠금과 할당을 피한다.
+    // 키는 메서드와 규칙 문자열의 주소다. 규칙은 앱이 끝날 때까지 남는다.
+    thread_local std::map<std::pair<crow::HTTPMethod, const std::string *>,
+                          RouteMetrics>
+        cache;
+
+    const auto *route = req.rule ? req.rule : &OTHER_ROUTE;
+    auto key = std::make_pair(req.method, route);
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
+    auto method = std::string(crow::method_name(req.method));
+    return cache.emplace(key, makeRouteMetrics(method, *route)).first->second;
+}
+struct TenantMetrics
+{
+    metrics::Counter requests;
+    metrics::Counter errors;
+    metrics::Histogram latency;
+};
+
+TenantMetrics makeTenantMetrics(const std::string &tenant)
+{
+    auto &registry = metrics::Registry::instance();
+    auto labels = metrics::label("tenant", tenant);
+    return {registry.counter("banchoo_tenant_requests_total",
+                             "HTTP requests by tenant",
+                             labels),
+            registry.counter("banchoo_tenant_errors_total",
+                             "HTTP 5xx responses by tenant",
+                             labels),
+            registry.histogram("banchoo_tenant_request_duration_us",
+                               "HTTP request latency by tenant in "
+                               "microseconds",
+                               labels)};
+}
+
+TenantMetrics &tenantLookup(const std::string &tenant)
+{
+    static std::mutex mutex;
+    static std::unordered_set<std::string> seen;
+    thread_local std::unordered_map<std::string, TenantMetrics> cache;
+
+    auto it = cache.find(tenant);
+    if (it != cache.end())
+        return it->second;
+
+    bool admitted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        admitted = seen.count(tenant) || seen.size() < MAX_TENANTS;
+        if (admitted)
+            seen.insert(tenant);
+    }
+    if (!admitted)
+    {
+        thread_local TenantMetrics other = makeTenantMetrics("other");
+        return other;
+    }
+    return cache.emplace(tenant, makeTenantMetrics(tenant)).first->second;
+}
+} // namespace
+
+void MetricsMiddleware::configure(const nlohmann::json &config)
+{
+    auto tenants = config.value("tenants", nlohmann::json::object());
+    if (tenants.value("enabled", false))
+        tenant_header_ = tenants.value("header", std::string("X-Tenant-Id"));
+}
+
+void MetricsMiddleware::before_handle(crow::request &,
+                                      crow::response &,
+                                      context &ctx)
+{
+    ctx.start = std::chrono::steady_clock::now();
+}
+
+void MetricsMiddleware::after_handle(crow::request &req,
+                                     crow::response &res,
+                                     context &ctx)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - ctx.start);
+
+    auto &m = lookup(req);
+    m.requests.inc();
+    m.status(res.code).inc();
+    m.latency.observe(static_cast<std::uint64_t>(elapsed.count()));
+    m.request_bytes.observe(req.body.size());
+    if (res.body_source)
+    {
+        // chunked 본문은 아직 만들어지지 않았으므로 조각을 세어 두었다가
+        // 마지막 조각을 만들 때 기록한다. 중간에 끊기면 기록하지 않는다.
+        res.body_source = [source = std::move(res.body_source),
+                           histogram = m.response_bytes,
+                           sent = std::uint64_t{0}](std::string &chunk) mutable
+        {
+            bool more = source(chunk);
+            sent += chunk.size();
+            if (!more)
+                histogram.observe(sent);
+            return more;
+        };
+    }
+    else
+    {
+        m.response_bytes.observe(res.body.size());
+    }
+
+    if (tenant_header_.empty())
+        return;
+    const auto &tenant = req.get_header_value(tenant_header_);
+    if (!repository::TenantPool::validTenant(tenant))
+        return;
+    auto &t = tenantLookup(tenant);
+    t.requests.inc();
+    if (res.code >= 500)
+        t.errors.inc();
+    t.latency.observe(static_cast<std::uint64_t>(elapsed.count()));
+}
+
+} // namespace banchoo::app
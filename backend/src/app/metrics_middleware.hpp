@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <chrono>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::app
+{
+
+// 라우트별 요청 수, 상태 코드, 지연 시간, 본문 크기를 metrics::Registry 에
+// 기록하는 Crow 미들웨어. 라우트 라벨은 매칭된 규칙("/notes/<int>")이고,
+// 어떤 규칙에도 매칭되지 않은 요청은 "other" 로 묶는다.
+struct MetricsMiddleware
+{
+    struct context
+    {
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // "tenants": { "enabled": true, "header": "X-Tenant-Id" } 이면 테넌트별
+    // 요청 수, 5xx 수, 지연 시간도 남긴다.
+    void configure(const nlohmann::json &config);
+
+    void before_handle(crow::request &req, crow::response &res, context &ctx);
+    void after_handle(crow::request &req, crow::response &res, context &ctx);
+
+ private:
+    std::string tenant_header_;
+};
+
+} // namespace banchoo::app
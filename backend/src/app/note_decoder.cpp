@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/note_decoder.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "note/time_codec.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+
+note::FieldMask fieldFromKey(std::string_view key)
+{
+    if (key == "id")
+        return note::field::ID;
+    if (key == "type")
+        return note::field::TYPE;
+    if (key == "created_at")
+        return note::field::CREATED_AT;
+    if (key == "updated_at")
+        return note::field::UPDATED_AT;
+    if (key == "content")
+        return note::field::CONTENT;
+    if (key == "status")
+        return note::field::STATUS;
+    if (key == "due_date")
+        return note::field::DUE_DATE;
+    if (key == "start_date")
+        return note::field::START_DATE;
+    if (key == "end_date")
+        return note::field::END_DATE;
+    if (key == "tags")
+        return note::field::TAGS;
+    return 0;
+}
+
+const char *fieldName(note::FieldMask field)
+{
+    switch (field)
+    {
+    case note::field::ID:
+        return "id";
+    case note::field::TYPE:
+        return "type";
+    case note::field::CREATED_AT:
+        return "created_at";
+    case note::field::UPDATED_AT:
+        return "updated_at";
+    case note::field::CONTENT:
+        return "content";
+    case note::field::STATUS:
+        return "status";
+    case note::field::DUE_DATE:
+        return "due_date";
+    case note::field::START_DATE:
+        return "start_date";
+    case note::field::END_DATE:
+        return "end_date";
+    case note::field::TAGS:
+        return "tags";
+    default:
+        return "";
+    }
+}
+
+class NoteSax
+{
+ public:
+    using json = nlohmann::json;
+
+    NoteSax(const NoteSchema &schema, note::Note &out, DecodeResult &result)
+        : schema_(schema), out_(out), result_(result)
+    {
+    }
+
+    bool null()
+    {
+        if (!checkRoot())
+            return false;
+        if (depth_ == 1 && (current_ & schema_.nullable))
+        {
+            result_.present |= current_;
+            if (current_ == note::field::STATUS)
+                out_.status.reset();
+            else if (current_ == note::field::DUE_DATE)
+                out_.due_date.reset();
+            else if (current_ == note::field::START_DATE)
+                out_.start_date.reset();
+            else if (current_ == note::field::END_DATE)
+                out_.end_date.reset();
+            return true;
+        }
+        return scalar();
+    }
+    bool boolean(bool)
+    {
+        return scalar();
+    }
+    bool number_integer(json::number_integer_t)
+    {
+        return scalar();
+    }
+    bool number_unsigned(json::number_unsigned_t)
+    {
+        return scalar();
+    }
+    bool number_float(json::number_float_t, const json::string_t &)
+    {
+        return scalar();
+    }
+    bool binary(json::binary_t &)
+    {
+        return scalar();
+    }
+
+    bool string(json::string_t &val)
+    {
+        if (!checkRoot())
+            return false;
+        if (in_tags_)
+            return tag(val);
+        if (depth_ != 1 || current_ == 0)
+            return true;
+
+        result_.present |= current_;
+        switch (current_)
+        {
+        case note::field::TAGS:
+            return typeError();
+        case note::field::CONTENT:
+            out_.content = std::move(val);
+            return true;
+        case note::field::TYPE:
+        {
+            auto type = note::parse_type(val);
+            if (!type)
+                return fail("invalid_value",
+                            "type must be one of MEMO, TASK, EVENT");
+            out_.type = *type;
+            return true;
+        }
+        case note::field::STATUS:
+        {
+            auto status = note::parse_status(val);
+            if (!status)
+                return fail("invalid_value",
+                            "status must be one of TODO, DOING, DONE");
+            out_.status = status;
+            return true;
+        }
+        default:
+        {
+            auto tp = note::parse_timestamp(val);
+            if (!tp)
+                return fail("invalid_value",
+                            "expected RFC 3339 time (YYYY-MM-DDTHH:MM:SSZ)");
+            if (current_ == note::field::CREATED_AT)
+                out_.created_at = *tp;
+            else if (current_ == note::field::UPDATED_AT)
+                out_.updated_at = *tp;
+            else if (current_ == note::field::DUE_DATE)
+                out_.due_date = tp;
+            else if (current_ == note::field::START_DATE)
+                out_.start_date = tp;
+            else
+                out_.end_date = tp;
+            return true;
+        }
+        }
+    }
+
+    bool start_object(std::size_t)
+    {
+        if (depth_ == 0)
+        {
+            is_object_ = true;
+            ++depth_;
+            return true;
+        }
+        return nested();
+    }
+
+    bool end_object()
+    {
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t)
+    {
+        if (!checkRoot())
+            return false;
+        if (depth_ == 1 && current_ == note::field::TAGS)
+        {
+            result_.present |= current_;
+            out_.tags.clear();
+            in_tags_ = true;
+            ++depth_;
+            return true;
+        }
+        return nested();
+    }
+
+    bool end_array()
+    {
+        --depth_;
+        if (in_tags_ && depth_ == 1)
+        {
+            in_tags_ = false;
+            note::normalize_tags(out_.tags);
+        }
+        return true;
+    }
+
+    bool key(json::string_t &val)
+    {
+        if (depth_ == 1)
+        {
+            // 스키마에 없는 필드는 무시한다.
+            current_ = fieldFromKey(val) & schema_.allowed;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t,
+                     const std::string &,
+                     const nlohmann::detail::exception &ex)
+    {
+        if (!result_.error)
+            result_.error = DecodeError{"malformed_json", "", ex.what()};
+        return false;
+    }
+
+ private:
+    bool checkRoot()
+    {
+        if (depth_ == 0 && !is_object_)
+        {
+            current_ = 0;
+            return fail("invalid_type", "request body must be a JSON object");
+        }
+        return true;
+    }
+
+    bool scalar()
+    {
+        if (!checkRoot())
+            return false;
+        if ((depth_ == 1 && current_ != 0) || in_tags_)
+            return typeError();
+        return true;
+    }
+
+    bool nested()
+    {
+        if ((depth_ == 1 && current_ != 0) || in_tags_)
+            return typeError();
+        ++depth_;
+        return true;
+    }
+
+    // tags 배열의 원소 하나
+    bool tag(json::string_t &val)
+    {
+        if (out_.tags.size() >= note::MAX_TAGS)
+            return fail("invalid_value", "too many tags (at most 32)");
+        if (!note::valid_tag(val))
+            return fail("invalid_value",
+                        "tags may use letters, digits and -_.:/ only");
+        out_.tags.push_back(std::move(val));
+        return true;
+    }
+
+    bool typeError()
+    {
+        return fail("invalid_type",
+                    current_ == note::field::TAGS
+                        ? "expected an array of strings"
+                        : "expected a string");
+    }
+
+    bool fail(const char *error, const char *message)
+    {
+        result_.error = DecodeError{error, fieldName(current_), message};
+        return false;
+    }
+
+    const NoteSchema &schema_;
+    note::Note &out_;
+    DecodeResult &result_;
+    int depth_ = 0;
+    bool is_object_ = false;
+    bool in_tags_ = false; // tags 배열 안
+    note::FieldMask current_ = 0;
+};
+
+} // namespace
+
+DecodeResult NoteDecoder::decode(std::string_view body,
+                                 const NoteSchema &schema,
+                                 note::Note &out)
+{
+    BANCHOO_SPAN("decode");
+
+    DecodeResult result;
+    NoteSax sax(schema, out, result);
+
+    bool parsed = nlohmann::json::sax_parse(body.begin(), body.end(), &sax);
+    if (!parsed || result.error)
+    {
+        if (!result.error)
+            result.error = DecodeError{"malformed_json", "", "invalid JSON"};
+        return result;
+    }
+
+    note::FieldMask missing = schema.required & ~result.present;
+    for (note::FieldMask f = 1; missing != 0; f <<= 1)
+    {
+        if (missing & f)
+        {
+            result.error = DecodeError{
+                "missing_field", fieldName(f), "required field is missing"};
+            break;
+        }
+    }
+
+    return result;
+}
+
+DecodeResult NoteDecoder::decodeProjection(const char *fields,
+                                           const char *preview,
+                                           note::Projection &out)
+{
+    DecodeResult result;
+    std::size_t preview_length = 0;
+
+    if (fields)
+    {
+        note::FieldMask mask = 0;
+        std::string_view rest(fields);
+        while (!rest.empty())
+        {
+            auto comma = rest.find(',');
+            auto key = rest.substr(0, comma);
+            rest = comma == std::string_view::npos ? std::string_view{}
+                                                   : rest.substr(comma + 1);
+            if (key.empty())
+                continue;
+            if (key == "preview")
+            {
+                preview_length = DEFAULT_PREVIEW;
+                continue;
+            }
+            auto field = fieldFromKey(key);
+            if (field == 0)
+            {
+                result.error = DecodeError{
+                    "invalid_value", "fields", "unknown field in fields"};
+                return result;
+            }
+            mask |= field;
+        }
+        if (mask == 0 && preview_length == 0)
+        {
+            result.error =
+                DecodeError{"invalid_value", "fields", "fields is empty"};
+            return result;
+        }
+        out.fields = mask;
+        out.preview = 0;
+    }
+
+    if (preview)
+    {
+        std::string_view text(preview);
+        std::size_t length = 0;
+        auto [end, ec] =
+            std::from_chars(text.data(), text.data() + text.size(), length);
+        if (ec != std::errc{} || end != text.data() + text.size() ||
+            length == 0 || length > MAX_PREVIEW)
+        {
+            result.error = DecodeError{
+                "invalid_value", "preview", "preview must be 1..1000"};
+            return result;
+        }
+        preview_length = length;
+    }
+
+    if (preview_length != 0)
+        out.preview = preview_length;
+    result.present = out.fields;
+    return result;
+}
+
+DecodeResult NoteDecoder::decodeTagQuery(const char *tags,
+                                         std::optional<index::TagQuery> &out)
+{
+    DecodeResult result;
+    if (!tags)
+        return result;
+
+    std::string message;
+    out = index::TagQuery::parse(tags, message);
+    if (!out)
+        result.error = DecodeError{"invalid_value", "tags", message};
+    else
+        result.present = note::field::TAGS;
+    return result;
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+
+namespace banchoo::app
+{
+
+// 요청 본문 검증 실패 정보 (400 응답으로 변환된다)
+struct DecodeError
+{
+    std::string error;   // malformed_json, missing_field, invalid_type, ...
+    std::string field;   // 문제가 된 필드 (본문 전체 오류면 비어 있음)
+    std::string message; // 사람이 읽을 수 있는 설명
+};
+
+struct DecodeResult
+{
+    note::FieldMask present = 0; // 본문에 실제로 있었던 필드
+    std::optional<DecodeError> error;
+
+    bool ok() const
+    {
+        return !error.has_value();
+    }
+};
+
+// 라우트별로 받을 수 있는 필드와 반드시 있어야 하는 필드
+struct NoteSchema
+{
+    note::FieldMask allowed;
+    note::FieldMask required;
+    note::FieldMask nullable = 0; // null 로 값을 지울 수 있는 필드
+};
+
+// JSON DOM 을 만들지 않고 SAX 이벤트로 바로 note::Note 를 채운다.
+// 잘못된 입력은 예외 대신 DecodeResult::error 로 보고된다.
+class NoteDecoder
+{
+ public:
+    static constexpr NoteSchema MEMO_SCHEMA{
+        note::field::CONTENT | note::field::TAGS, note::field::CONTENT};
+    static constexpr NoteSchema TASK_SCHEMA{
+        note::field::CONTENT | note::field::STATUS | note::field::DUE_DATE |
+            note::field::TAGS,
+        note::field::CONTENT};
+    static constexpr NoteSchema EVENT_SCHEMA{
+        note::field::CONTENT | note::field::START_DATE |
+            note::field::END_DATE | note::field::TAGS,
+        note::field::CONTENT};
+    static constexpr NoteSchema UPDATE_SCHEMA{note::field::CONTENT,
+                                              note::field::CONTENT};
+    // 본문에 있는 필드만 바꾼다. 선택 필드는 null 로 지운다.
+    static constexpr NoteSchema PATCH_SCHEMA{
+        note::field::CONTENT | note::field::STATUS | note::field::DUE_DATE |
+            note::field::START_DATE | note::field::END_DATE |
+            note::field::TAGS,
+        0,
+        note::field::STATUS | note::field::DUE_DATE | note::field::START_DATE |
+            note::field::END_DATE};
+
+    // 가져오기 한 줄. 내보내기 결과를 그대로 받을 수 있도록 id 는 무시하고
+    // 선택 필드의 null 을 허용한다.
+    static constexpr NoteSchema IMPORT_SCHEMA{
+        note::field::ALL & ~note::field::ID,
+        note::field::CONTENT,
+        note::field::STATUS | note::field::DUE_DATE | note::field::START_DATE |
+            note::field::END_DATE};
+
+    // 미리보기 길이를 따로 주지 않았을 때의 글자 수와 상한
+    static constexpr std::size_t DEFAULT_PREVIEW = 80;
+    static constexpr std::size_t MAX_PREVIEW = 1000;
+
+    static DecodeResult
+    decode(std::string_view body, const NoteSchema &schema, note::Note &out);
+
+    // 목록 조회의 ?fields=id,type,status,preview&preview=120 을 읽는다.
+    // 없는(nullptr) 매개변수는 out 을 그대로 둔다. fields 에 preview 가
+    // 있거나 preview 매개변수가 있으면 본문 미리보기를 붙인다.
+    static DecodeResult decodeProjection(const char *fields,
+                                         const char *preview,
+                                         note::Projection &out);
+
+    // 목록 조회의 ?tags=work AND (urgent OR today) NOT done 을 읽는다.
+    // 없는(nullptr) 매개변수는 out 을 그대로 둔다.
+    static DecodeResult decodeTagQuery(const char *tags,
+                                       std::optional<index::TagQuery> &out);
+};
+
+} // namespace banchoo::app
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/note_serializer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "note/note.hpp"
+#include "note/time_codec.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+constexpr note::FieldMask TIME_FIELDS =
+    note::field::CREATED_AT | note::field::UPDATED_AT |
+    note::field::DUE_DATE | note::field::START_DATE | note::field::END_DATE;
+
+// 노트 하나에서 본문을 뺀 고정 부분 길이 상한.
+// 기본 형태 {"id":-2147483648,"content":""}, 는 32바이트다.
+std::size_t fixedBytes(const note::Projection &view)
+{
+    std::size_t bytes = 3; // {, }, ","
+    if (view.fields & note::field::ID)
+        bytes += 17; // "id":-2147483648,
+    if (view.fields & note::field::TYPE)
+        bytes += 16; // "type":"EVENT",
+    if (view.fields & note::field::CONTENT)
+        bytes += 13; // "content":"",
+    if (view.preview != 0)
+        bytes += 13; // "preview":"",
+    if (view.fields & note::field::STATUS)
+        bytes += 17; // "status":"DOING",
+    // "start_date":"2025-04-05T12:00:00Z",
+    bytes += 36 * static_cast<std::size_t>(
+                      std::popcount(view.fields & TIME_FIELDS));
+    if (view.fields & note::field::TAGS)
+        bytes += 10; // "tags":[], (태그 이름은 따로 센다)
+    return bytes;
+}
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+bool needsEscape(unsigned char c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+} // namespace
+
+void NoteSerializer::appendEscaped(std::string &out, std::string_view s)
+{
+    // 이스케이프가 필요 없는 구간은 통째로 복사한다.
+    std::size_t run_begin = 0;
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+        auto c = static_cast<unsigned char>(s[i]);
+        if (!needsEscape(c))
+            continue;
+
+        out.append(s.data() + run_begin, i - run_begin);
+        run_begin = i + 1;
+
+        switch (c)
+        {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\b':
+            out.append("\\b");
+            break;
+        case '\f':
+            out.append("\\f");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+        {
+            char buf[6] = {
+                '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+            out.append(buf, sizeof(buf));
+            break;
+        }
+        }
+    }
+    out.append(s.data() + run_begin, s.size() - run_begin);
+}
+
+void NoteSerializer::writeNote(std::string &out, const note::Note &note)
+{
+    writeNote(out, note, DEFAULT_VIEW);
+}
+
+void NoteSerializer::writeNote(std::string &out,
+                               const note::Note &note,
+                               const note::Projection &view)
+{
+    auto fields = view.fields;
+    char sep = '{';
+    auto key = [&](std::string_view name)
+    {
+        out.push_back(sep);
+        out.push_back('"');
+        out.append(name);
+        out.append("\":");
+        sep = ',';
+    };
+    auto text = [&](std::string_view value)
+    {
+        out.push_back('"');
+        appendEscaped(out, value);
+        out.push_back('"');
+    };
+    auto time = [&](const std::optional<note::TimePoint> &tp)
+    {
+        if (!tp)
+        {
+            out.append("null");
+            return;
+        }
+        out.push_back('"');
+        note::append_timestamp(out, *tp);
+        out.push_back('"');
+    };
+
+    if (fields & note::field::ID)
+    {
+        char id_buf[16];
+        auto [end, ec] =
+            std::to_chars(id_buf, id_buf + sizeof(id_buf), note.id);
+        key("id");
+        out.append(id_buf, end);
+    }
+    if (fields & note::field::TYPE)
+    {
+        key("type");
+        text(note::to_string(note.type));
+    }
+    if (fields & note::field::CONTENT)
+    {
+        key("content");
+        text(note.content);
+    }
+    if (view.preview != 0)
+    {
+        key("preview");
+        text(note::utf8_prefix(note.content, view.preview));
+    }
+    if (fields & note::field::CREATED_AT)
+    {
+        key("created_at");
+        time(note.created_at);
+    }
+    if (fields & note::field::UPDATED_AT)
+    {
+        key("updated_at");
+        time(note.updated_at);
+    }
+    if (fields & note::field::STATUS)
+    {
+        key("status");
+        if (note.status)
+            text(note::to_string(*note.status));
+        else
+            out.append("null");
+    }
+    if (fields & note::field::DUE_DATE)
+    {
+        key("due_date");
+        time(note.due_date);
+    }
+    if (fields & note::field::START_DATE)
+    {
+        key("start_date");
+        time(note.start_date);
+    }
+    if (fields & note::field::END_DATE)
+    {
+        key("end_date");
+        time(note.end_date);
+    }
+    if (fields & note::field::TAGS)
+    {
+        key("tags");
+        out.push_back('[');
+        for (std::size_t i = 0; i < note.tags.size(); ++i)
+        {
+            if (i != 0)
+                out.push_back(',');
+            text(note.tags[i]);
+        }
+        out.push_back(']');
+    }
+
+    if (sep == '{')
+        out.push_back('{');
+    out.push_back('}');
+}
+
+std::string NoteSerializer::writeNotes(std::span<const note::NotePtr> notes,
+                                       const note::Projection &view)
+{
+    BANCHOO_SPAN("serialize");
+
+    std::size_t overhead = fixedBytes(view);
+    bool content = view.fields & note::field::CONTENT;
+    bool tags = view.fields & note::field::TAGS;
+    // UTF-8 한 글자는 최대 4바이트
+    std::size_t preview_bytes = view.preview * 4;
+
+    std::size_t estimated = 2;
+    for (const auto &n : notes)
+    {
+        estimated += overhead;
+        if (content)
+            estimated += n->content.size();
+        if (view.preview != 0)
+            estimated += std::min(n->content.size(), preview_bytes);
+        if (tags)
+        {
+            for (const auto &tag : n->tags)
+                estimated += tag.size() + 3; // "",
+        }
+    }
+
+    std::string out;
+    out.reserve(estimated);
+
+    out.push_back('[');
+    for (std::size_t i = 0; i < notes.size(); ++i)
+    {
+        if (i != 0)
+            out.push_back(',');
+        writeNote(out, *notes[i], view);
+    }
+    out.push_back(']');
+
+    return out;
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "note/note.hpp"
+
+namespace banchoo::app
+{
+
+// nlohmann::json DOM 을 거치지 않고 응답 버퍼에 바로 JSON 을 기록한다.
+class NoteSerializer
+{
+ public:
+    // 기본 응답 형태: {"id":..,"content":".."}
+    static constexpr note::Projection DEFAULT_VIEW{note::field::ID |
+                                                   note::field::CONTENT};
+
+    static void writeNote(std::string &out, const note::Note &note);
+    // view.fields 에 든 필드만 id, type, content, preview, created_at,
+    // updated_at, status, due_date, start_date, end_date, tags 순으로 쓴다.
+    // 값이 없는 선택 필드는 null 이다. view.preview 가 0 이 아니면 본문
+    // 앞 view.preview 글자를 "preview" 로 쓴다.
+    static void writeNote(std::string &out,
+                          const note::Note &note,
+                          const note::Projection &view);
+
+    // 노트 배열 전체를 한 번의 할당으로 직렬화한다.
+    static std::string writeNotes(std::span<const note::NotePtr> notes,
+                                  const note::Projection &view = DEFAULT_VIEW);
+
+    // JSON 문자열 규칙에 맞게 이스케이프하여 out 뒤에 덧붙인다.
+    static void appendEscaped(std::string &out, std::string_view s);
+};
+
+} // namespace banchoo::app
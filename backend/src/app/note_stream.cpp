@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/note_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "app/note_decoder.hpp"
+#include "app/note_serializer.hpp"
+#include "app/request_arena.hpp"
+#include "common/logger.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::app
+{
+
+namespace
+{
+// 이만큼 처리할 때마다 진행 상황을 로그로 남긴다.
+constexpr std::size_t PROGRESS_INTERVAL = 100000;
+
+double perSecond(std::size_t count, std::chrono::nanoseconds elapsed)
+{
+    auto seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(count) / seconds : 0.0;
+}
+
+// 노트가 크면 다음 배치를 줄여 조각 하나가 max_bytes 안팎이 되게 한다.
+// 작은 노트가 이어지면 다시 batch_size 까지 늘린다.
+std::size_t nextLimit(std::size_t bytes,
+                      std::size_t notes,
+                      std::size_t max_bytes,
+                      std::size_t batch_size)
+{
+    auto per_note = std::max<std::size_t>(bytes / notes, 1);
+    return std::clamp<std::size_t>(max_bytes / per_note, 1, batch_size);
+}
+} // namespace
+
+double NoteImporter::Summary::notesPerSecond() const
+{
+    return perSecond(imported, elapsed);
+}
+
+std::string NoteImporter::Summary::toJson() const
+{
+    auto lines = nlohmann::json::array();
+    for (const auto &e : errors)
+    {
+        lines.push_back({{"line", e.line},
+                         {"error", e.error.error},
+                         {"field", e.error.field},
+                         {"message", e.error.message}});
+    }
+    return nlohmann::json{
+        {"imported", imported},
+        {"failed", failed},
+        {"errors", std::move(lines)},
+        {"elapsed_ms",
+         std::chrono::duration<double, std::milli>(elapsed).count()},
+        {"notes_per_sec", notesPerSecond()}}
+        .dump();
+}
+
+NoteImporter::NoteImporter(repository::BaseRepository &repo,
+                           std::size_t batch_size)
+    : repo_(repo), batch_size_(batch_size == 0 ? 1 : batch_size),
+      start_(std::chrono::steady_clock::now())
+{
+    batch_.reserve(batch_size_);
+}
+
+void NoteImporter::feed(std::string_view data)
+{
+    BANCHOO_SPAN("import.feed");
+
+    while (!data.empty())
+    {
+        auto newline = data.find('\n');
+        if (newline == std::string_view::npos)
+        {
+            partial_.append(data);
+            return;
+        }
+
+        if (partial_.empty())
+        {
+            decodeLine(data.substr(0, newline));
+        }
+        else
+        {
+            partial_.append(data.substr(0, newline));
+            decodeLine(partial_);
+            partial_.clear();
+        }
+        data.remove_prefix(newline + 1);
+    }
+}
+
+NoteImporter::Summary NoteImporter::finish()
+{
+    if (!partial_.empty())
+    {
+        decodeLine(partial_);
+        partial_.clear();
+    }
+    flush();
+
+    summary_.elapsed = std::chrono::steady_clock::now() - start_;
+    BANCHOO_INFO("import: {} notes, {} failed in {:.0f} ms ({:.0f} notes/s)",
+                 summary_.imported,
+                 summary_.failed,
+                 std::chrono::duration<double, std::milli>(summary_.elapsed)
+                     .count(),
+                 summary_.notesPerSecond());
+    return std::move(summary_);
+}
+
+void NoteImporter::decodeLine(std::string_view text)
+{
+    ++line_;
+    if (!text.empty() && text.back() == '\r')
+        text.remove_suffix(1);
+    if (text.find_first_not_of(" \t") == std::string_view::npos)
+        return;
+
+    note::Note n{};
+    auto decoded = NoteDecoder::decode(text, NoteDecoder::IMPORT_SCHEMA, n);
+    if (!decoded.ok())
+    {
+        ++summary_.failed;
+        if (summary_.errors.size() < MAX_ERRORS)
+            summary_.errors.push_back({line_, std::move(*decoded.error)});
+        return;
+    }
+
+    // 종류가 없으면 메모, 상태가 없는 할 일은 createTask 처럼 TODO 다.
+    if (!(decoded.present & note::field::TYPE))
+        n.type = note::NoteType::MEMO;
+    if (n.type == note::NoteType::TASK &&
+        !(decoded.present & note::field::STATUS))
+        n.status = note::NoteStatus::TODO;
+
+    batch_.push_back(std::move(n));
+    if (batch_.size() >= batch_size_)
+        flush();
+}
+
+void NoteImporter::flush()
+{
+    if (batch_.empty())
+        return;
+
+    repo_.importNotes(batch_);
+    auto before = summary_.imported;
+    summary_.imported += batch_.size();
+    batch_.clear();
+
+    if (before / PROGRESS_INTERVAL != summary_.imported / PROGRESS_INTERVAL)
+    {
+        BANCHOO_INFO("import: {} notes ({:.0f} notes/s)",
+                     summary_.imported,
+                     perSecond(summary_.imported,
+                               std::chrono::steady_clock::now() - start_));
+    }
+}
+
+NoteExporter::NoteExporter(std::shared_ptr<repository::BaseRepository> repo,
+                           std::size_t batch_size)
+    : repo_(std::move(repo)), batch_size_(batch_size == 0 ? 1 : batch_size),
+      limit_(batch_size_), start_(std::chrono::steady_clock::now())
+{
+}
+
+bool NoteExporter::next(std::string &chunk)
+{
+    if (done_)
+        return false;
+
+    BANCHOO_SPAN("export.next");
+
+    // 배치는 요청 아레나에 받아 매번 같은 버퍼를 다시 쓴다.
+    RequestArena::Scope arena;
+    auto limit = limit_;
+    auto notes = repo_->scanNotes(
+        last_id_, limit, std::nullopt, {}, arena.resource());
+
+    std::size_t estimated = 0;
+    for (const auto &n : notes)
+        estimated += n->content.size() + 256;
+    chunk.reserve(chunk.size() + estimated);
+
+    const note::Projection all{};
+    auto bytes = chunk.size();
+    for (const auto &n : notes)
+    {
+        NoteSerializer::writeNote(chunk, *n, all);
+        chunk.push_back('\n');
+    }
+
+    auto before = exported_;
+    exported_ += notes.size();
+    if (!notes.empty())
+    {
+        last_id_ = notes.back()->id;
+        limit_ = nextLimit(
+            chunk.size() - bytes, notes.size(), MAX_CHUNK_BYTES, batch_size_);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    done_ = notes.size() < limit;
+    if (done_)
+    {
+        BANCHOO_INFO("export: {} notes in {:.0f} ms ({:.0f} notes/s)",
+                     exported_,
+                     std::chrono::duration<double, std::milli>(elapsed).count(),
+                     perSecond(exported_, elapsed));
+    }
+    else if (before / PROGRESS_INTERVAL != exported_ / PROGRESS_INTERVAL)
+    {
+        BANCHOO_INFO("export: {} notes ({:.0f} notes/s)",
+                     exported_,
+                     perSecond(exported_, elapsed));
+    }
+    return !done_;
+}
+
+NoteListStream::NoteListStream(
+    std::shared_ptr<repository::BaseRepository> repo,
+    std::optional<note::NoteType> type,
+    const note::Projection &view,
+    std::size_t batch_size)
+    : repo_(std::move(repo)), type_(type), view_(view),
+      batch_size_(batch_size == 0 ? 1 : batch_size), limit_(batch_size_)
+{
+}
+
+NoteListStream::NoteListStream(repository::NoteList notes,
+                               const note::Projection &view)
+    : view_(view), notes_(std::move(notes))
+{
+}
+
+bool NoteListStream::next(std::string &chunk)
+{
+    if (done_)
+        return false;
+
+    BANCHOO_SPAN("list.next");
+
+    if (!started_)
+    {
+        chunk.push_back('[');
+        started_ = true;
+    }
+    done_ = !(repo_ ? nextScanned(chunk) : nextListed(chunk));
+    if (done_)
+        chunk.push_back(']');
+    return !done_;
+}
+
+void NoteListStream::write(std::string &chunk, const note::Note &n)
+{
+    if (written_++ != 0)
+        chunk.push_back(',');
+    NoteSerializer::writeNote(chunk, n, view_);
+}
+
+bool NoteListStream::nextScanned(std::string &chunk)
+{
+    RequestArena::Scope arena;
+    auto limit = limit_;
+    auto notes =
+        repo_->scanNotes(last_id_, limit, type_, view_, arena.resource());
+
+    auto before = chunk.size();
+    for (const auto &n : notes)
+        write(chunk, *n);
+    if (notes.empty())
+        return false;
+    last_id_ = notes.back()->id;
+    limit_ = nextLimit(
+        chunk.size() - before, notes.size(), MAX_CHUNK_BYTES, batch_size_);
+    return notes.size() == limit;
+}
+
+bool NoteListStream::nextListed(std::string &chunk)
+{
+    auto before = chunk.size();
+    while (next_note_ < notes_.size() &&
+           chunk.size() - before < MAX_CHUNK_BYTES)
+        write(chunk, *notes_[next_note_++]);
+    return next_note_ < notes_.size();
+}
+
+} // namespace banchoo::app
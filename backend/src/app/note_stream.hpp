@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "app/note_decoder.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::app
+{
+
+// NDJSON(줄마다 노트 하나) 본문을 읽어 batch_size 개씩 저장소에 넣는다.
+// 본문은 몇 조각으로 나눠 넣어도 되고, 조각 경계에 걸린 줄만 들고 있는다.
+// 잘못된 줄은 건너뛰고 결과에 줄 번호를 남긴다.
+class NoteImporter
+{
+ public:
+    static constexpr std::size_t DEFAULT_BATCH = 1000;
+    // 결과에 남기는 실패 줄 수의 상한
+    static constexpr std::size_t MAX_ERRORS = 10;
+
+    struct LineError
+    {
+        std::size_t line; // 1부터 센다
+        DecodeError error;
+    };
+
+    struct Summary
+    {
+        std::size_t imported = 0;
+        std::size_t failed = 0;
+        std::vector<LineError> errors;
+        std::chrono::nanoseconds elapsed{};
+
+        double notesPerSecond() const;
+        // {"imported":..,"failed":..,"errors":[..],"elapsed_ms":..,
+        //  "notes_per_sec":..}
+        std::string toJson() const;
+    };
+
+    explicit NoteImporter(repository::BaseRepository &repo,
+                          std::size_t batch_size = DEFAULT_BATCH);
+
+    void feed(std::string_view data);
+    // 남은 줄과 배치를 저장하고 결과를 돌려준다.
+    Summary finish();
+
+ private:
+    void decodeLine(std::string_view text);
+    void flush();
+
+    repository::BaseRepository &repo_;
+    std::size_t batch_size_;
+    std::vector<note::Note> batch_;
+    std::string partial_; // 아직 줄바꿈을 못 만난 앞 조각
+    std::size_t line_ = 0;
+    Summary summary_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 저장소를 id 순으로 batch_size 개씩 훑어 NDJSON 조각을 만든다.
+// 한 번에 한 배치만 메모리에 올리므로 전체 노트 수와 상관없이 일정하다.
+// 조각이 MAX_CHUNK_BYTES 를 넘으면 다음 배치를 노트 크기에 맞춰 줄인다.
+class NoteExporter
+{
+ public:
+    static constexpr std::size_t DEFAULT_BATCH = 1000;
+    // 조각 하나의 대략적인 상한. 노트 하나가 이보다 크면 그 노트만 담는다.
+    static constexpr std::size_t MAX_CHUNK_BYTES = 1024 * 1024;
+
+    explicit NoteExporter(std::shared_ptr<repository::BaseRepository> repo,
+                          std::size_t batch_size = DEFAULT_BATCH);
+
+    // chunk 뒤에 다음 배치를 덧붙인다. 보낼 것이 더 있으면 true.
+    bool next(std::string &chunk);
+
+    std::size_t exported() const
+    {
+        return exported_;
+    }
+
+ private:
+    std::shared_ptr<repository::BaseRepository> repo_;
+    std::size_t batch_size_;
+    std::size_t limit_; // 다음 배치에서 읽을 노트 수
+    note::Id last_id_ = 0;
+    std::size_t exported_ = 0;
+    bool done_ = false;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// 목록 응답을 JSON 배열 조각으로 나눠 만든다. 큰 목록 응답을 chunked 로
+// 보낼 때 쓰며, 이어 붙이면 NoteSerializer::writeNotes 와 같은 본문이 된다.
+// view 에 고른 필드만 쓴다.
+class NoteListStream
+{
+ public:
+    static constexpr std::size_t DEFAULT_BATCH = 1000;
+    // 조각 하나의 대략적인 상한. 노트 하나가 이보다 크면 그 노트만 담는다.
+    static constexpr std::size_t MAX_CHUNK_BYTES = 1024 * 1024;
+
+    // 저장소를 id 순으로 훑는다. type 이 있으면 그 종류만. 한 번에 읽는
+    // 노트 수는 batch_size 에서 시작해, 조각이 MAX_CHUNK_BYTES 를 넘으면
+    // 직전 배치의 노트 크기에 맞춰 줄인다.
+    NoteListStream(std::shared_ptr<repository::BaseRepository> repo,
+                   std::optional<note::NoteType> type,
+                   const note::Projection &view,
+                   std::size_t batch_size = DEFAULT_BATCH);
+
+    // 이미 읽은 목록(태그 검색 결과 등)을 MAX_CHUNK_BYTES 씩 나눠 쓴다.
+    NoteListStream(repository::NoteList notes, const note::Projection &view);
+
+    // chunk 뒤에 다음 조각을 덧붙인다. 보낼 것이 더 있으면 true.
+    bool next(std::string &chunk);
+
+ private:
+    void write(std::string &chunk, const note::Note &n);
+    bool nextScanned(std::string &chunk);
+    bool nextListed(std::string &chunk);
+
+    std::shared_ptr<repository::BaseRepository> repo_;
+    std::optional<note::NoteType> type_;
+    note::Projection view_;
+    std::size_t batch_size_ = DEFAULT_BATCH;
+    std::size_t limit_ = DEFAULT_BATCH; // 다음 배치에서 읽을 노트 수
+    note::Id last_id_ = 0;
+    repository::NoteList notes_; // repo_ 가 없을 때 쓸 목록
+    std::size_t next_note_ = 0;
+    std::size_t written_ = 0;
+    bool started_ = false;
+    bool done_ = false;
+};
+
+} // namespace banchoo::app
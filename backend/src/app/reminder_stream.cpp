@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/reminder_stream.hpp"
+
+#include <crow_all.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+#include "common/logger.hpp"
+#include "reminder/timing_wheel.hpp"
+
+namespace banchoo::app
+{
+
+void ReminderStream::open(crow::websocket::connection &conn)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.insert(static_cast<Connection *>(&conn));
+    BANCHOO_DEBUG("reminder stream opened ({} open)", connections_.size());
+}
+
+void ReminderStream::close(crow::websocket::connection &conn)
+{
+    // Crow 는 닫는 핸들러를 한 연결에 두 번 부를 수 있다.
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(static_cast<Connection *>(&conn));
+}
+
+void ReminderStream::onReminder(const reminder::Reminder &reminder)
+{
+    auto message = reminder.toJson();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto *conn : connections_)
+    {
+        // 연결은 닫힌 뒤 그 스레드에서 지워진다. 넘긴 작업이 돌 때 아직
+        // 목록에 있으면 살아 있는 연결이다.
+        conn->post(
+            [self = shared_from_this(), conn, message]
+            {
+                std::lock_guard<std::mutex> lock(self->mutex_);
+                if (self->connections_.count(conn))
+                    conn->send_text(message);
+            });
+    }
+}
+
+std::size_t ReminderStream::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connections_.size();
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#include "reminder/reminder_scheduler.hpp"
+#include "reminder/timing_wheel.hpp"
+
+namespace banchoo::app
+{
+
+// 울린 알림을 웹소켓 연결마다 JSON 텍스트 프레임 하나로 보낸다. 연결은 자기
+// io_service 스레드에서만 건드리므로, 보낼 때도 그 스레드로 넘긴 뒤 아직
+// 열려 있는지 보고 보낸다.
+class ReminderStream : public reminder::ReminderSubscriber,
+                       public std::enable_shared_from_this<ReminderStream>
+{
+ public:
+    void open(crow::websocket::connection &conn);
+    void close(crow::websocket::connection &conn);
+
+    void onReminder(const reminder::Reminder &reminder) override;
+
+    std::size_t size() const;
+
+ private:
+    // SSL 을 쓰지 않으므로 연결은 모두 평문 소켓이다. post 는 구체 타입에만
+    // 있다.
+    using Connection = crow::websocket::Connection<crow::SocketAdaptor>;
+
+    mutable std::mutex mutex_;
+    std::unordered_set<Connection *> connections_;
+};
+
+} // namespace banchoo::app
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/replica_guard.hpp"
+
+#include <crow_all.h>
+
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::app
+{
+
+void ReplicaGuard::configure(const nlohmann::json &config)
+{
+    auto replication = config.value("replication", nlohmann::json::object());
+    read_only_ = replication.value("role", std::string()) == "follower";
+    leader_url_ = replication.value("leader_url", std::string());
+    // 요청 경로를 그대로 붙이므로 끝의 '/' 는 뗀다.
+    while (!leader_url_.empty() && leader_url_.back() == '/')
+        leader_url_.pop_back();
+}
+
+void ReplicaGuard::before_handle(crow::request &req,
+                                 crow::response &res,
+                                 context &)
+{
+    if (!read_only_ || req.method == "GET"_method ||
+        req.method == "HEAD"_method || req.method == "OPTIONS"_method ||
+        std::string_view(req.url).starts_with("/admin/"))
+        return;
+
+    if (!leader_url_.empty())
+    {
+        // 307 은 메서드와 본문을 바꾸지 않고 다시 보내게 한다.
+        res.code = 307;
+        res.set_header("Location", leader_url_ + req.raw_url);
+    }
+    else
+    {
+        res.code = 403;
+        res.set_header("Content-Type", "application/json");
+        res.body = "{\"error\":\"read_only\",\"field\":\"\","
+                   "\"message\":\"this server is a read-only follower\"}";
+    }
+    res.end();
+}
+
+void ReplicaGuard::after_handle(crow::request &, crow::response &, context &)
+{
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::app
+{
+
+// 읽기 전용 팔로워에서 노트를 바꾸는 요청을 핸들러에 닿기 전에 막는다.
+// leader_url 이 있으면 307 로 리더에 보내고, 없으면 403 으로 거절한다.
+// /admin 요청은 서버 자신의 설정이라 막지 않는다.
+struct ReplicaGuard
+{
+    struct context
+    {
+    };
+
+    // "replication": { "role": "follower", "leader_url": "" }
+    void configure(const nlohmann::json &config);
+
+    void before_handle(crow::request &req, crow::response &res, context &ctx);
+    void after_handle(crow::request &req, crow::response &res, context &ctx);
+
+ private:
+    bool read_only_ = false;
+    std::string leader_url_;
+};
+
+} // namespace banchoo::app
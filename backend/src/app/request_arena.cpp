@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/request_arena.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace banchoo::app
+{
+
+namespace
+{
+
+// 아레나 버퍼가 모자라 힙에서 받은 바이트를 센다.
+class SpillResource : public std::pmr::memory_resource
+{
+ public:
+    std::size_t spilled = 0;
+
+ private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        spilled += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p,
+                       std::size_t bytes,
+                       std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+class ThreadArena
+{
+ public:
+    void open()
+    {
+        if (depth_++ > 0)
+            return;
+        if (!arena_)
+            reset(RequestArena::INITIAL_SIZE);
+    }
+
+    void close()
+    {
+        if (--depth_ > 0)
+            return;
+
+        auto needed = size_ + spill_.spilled;
+        arena_->release();
+        spill_.spilled = 0;
+
+        // 모자랐던 만큼 버퍼를 키워 다음 요청부터는 힙을 타지 않게 한다.
+        if (needed > size_ && size_ < RequestArena::MAX_RETAINED)
+            reset(std::min(std::bit_ceil(needed), RequestArena::MAX_RETAINED));
+    }
+
+    std::pmr::memory_resource *resource()
+    {
+        return &*arena_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+ private:
+    void reset(std::size_t size)
+    {
+        arena_.reset();
+        buffer_ = std::make_unique_for_overwrite<std::byte[]>(size);
+        size_ = size;
+        arena_.emplace(buffer_.get(), size_, &spill_);
+    }
+
+    SpillResource spill_;
+    std::unique_ptr<std::byte[]> buffer_;
+    std::size_t size_ = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+    int depth_ = 0;
+};
+
+ThreadArena &threadArena()
+{
+    thread_local ThreadArena arena;
+    return arena;
+}
+
+} // namespace
+
+RequestArena::Scope::Scope()
+{
+    threadArena().open();
+}
+
+RequestArena::Scope::~Scope()
+{
+    threadArena().close();
+}
+
+std::pmr::memory_resource *RequestArena::Scope::resource() const
+{
+    return threadArena().resource();
+}
+
+std::size_t RequestArena::retainedBytes()
+{
+    return threadArena().size();
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace banchoo::app
+{
+
+// 요청 하나 동안만 쓰는 단조 증가 아레나.
+// 스레드마다 버퍼를 하나 두고, 범위가 끝나면 처음으로 되감아 다음 요청이
+// 다시 쓴다. 버퍼가 모자랐던 스레드는 다음 범위부터 그만큼 큰 버퍼를 쓴다.
+class RequestArena
+{
+ public:
+    static constexpr std::size_t INITIAL_SIZE = 64 * 1024;
+    // 스레드가 계속 들고 있는 버퍼의 상한. 넘는 부분은 매번 힙에서 받는다.
+    static constexpr std::size_t MAX_RETAINED = 16 * 1024 * 1024;
+
+    // 범위 안에서 resource() 로 받은 메모리는 범위가 끝날 때 한꺼번에
+    // 돌려준다. 범위는 중첩될 수 있고 가장 바깥 범위가 끝날 때 비운다.
+    class Scope
+    {
+     public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        std::pmr::memory_resource *resource() const;
+    };
+
+    // 현재 스레드가 들고 있는 버퍼 크기
+    static std::size_t retainedBytes();
+};
+
+} // namespace banchoo::app
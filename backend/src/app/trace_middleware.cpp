@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "app/trace_middleware.hpp"
+
+#include <crow_all.h>
+
+#include "trace/tracer.hpp"
+
+namespace banchoo::app
+{
+
+void TraceMiddleware::before_handle(crow::request &,
+                                    crow::response &,
+                                    context &ctx)
+{
+    auto &tracer = trace::Tracer::instance();
+    tracer.beginRequest();
+    ctx.sampled = trace::Tracer::active();
+    if (ctx.sampled)
+        ctx.start_ns = trace::Tracer::now();
+}
+
+void TraceMiddleware::after_handle(crow::request &req,
+                                   crow::response &,
+                                   context &ctx)
+{
+    auto &tracer = trace::Tracer::instance();
+    if (ctx.sampled)
+        tracer.record(
+            "http_request", ctx.start_ns, trace::Tracer::now(), req.url);
+    tracer.endRequest();
+}
+
+} // namespace banchoo::app
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <crow_all.h>
+
+#include <cstdint>
+
+namespace banchoo::app
+{
+
+// 요청마다 샘플링 여부를 정하고, 샘플링된 요청 전체를 루트 스팬으로 남긴다.
+struct TraceMiddleware
+{
+    struct context
+    {
+        bool sampled = false;
+        std::uint64_t start_ns = 0;
+    };
+
+    void before_handle(crow::request &req, crow::response &res, context &ctx);
+    void after_handle(crow::request &req, crow::response &res, context &ctx);
+};
+
+} // namespace banchoo::app
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "capture/capture_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace banchoo::capture
+{
+
+namespace
+{
+constexpr char MAGIC[] = {'B', 'N', 'C', 'H', 'C', 'A', 'P'};
+constexpr char VERSION = 1;
+constexpr unsigned char UNKNOWN_METHOD = 0xFF;
+// 손상된 길이 값으로 거대한 할당을 하지 않도록 막는다.
+constexpr std::uint64_t MAX_FIELD_BYTES = 256 * 1024 * 1024;
+
+constexpr std::string_view METHODS[] = {
+    "GET", "POST", "PUT", "DELETE", "PATCH", "HEAD", "OPTIONS"};
+
+void putVarint(std::string &out, std::uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putString(std::string &out, std::string_view s)
+{
+    putVarint(out, s.size());
+    out.append(s);
+}
+
+bool getVarint(std::istream &in, std::uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        auto c = in.get();
+        if (c == std::char_traits<char>::eof())
+            return false;
+        v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool getString(std::istream &in, std::string &s)
+{
+    std::uint64_t size;
+    if (!getVarint(in, size) || size > MAX_FIELD_BYTES)
+        return false;
+    s.resize(size);
+    return size == 0 ||
+        in.read(s.data(), static_cast<std::streamsize>(size)).good();
+}
+
+void encode(std::string &out, const CaptureRecord &record)
+{
+    putVarint(out, record.offset_ns);
+    putVarint(out, record.status);
+
+    unsigned char code = UNKNOWN_METHOD;
+    for (std::size_t i = 0; i < std::size(METHODS); ++i)
+    {
+        if (METHODS[i] == record.method)
+            code = static_cast<unsigned char>(i);
+    }
+    out.push_back(static_cast<char>(code));
+    if (code == UNKNOWN_METHOD)
+        putString(out, record.method);
+
+    putString(out, record.url);
+    putString(out, record.body);
+}
+} // namespace
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_)
+        return false;
+    out_.write(MAGIC, sizeof(MAGIC));
+    out_.put(VERSION);
+    records_ = 0;
+    return static_cast<bool>(out_);
+}
+
+void CaptureWriter::close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open())
+        return;
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    out_.close();
+}
+
+bool CaptureWriter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return out_.is_open();
+}
+
+void CaptureWriter::append(const CaptureRecord &record)
+{
+    // 인코딩은 잠금 밖에서 한다.
+    thread_local std::string encoded;
+    encoded.clear();
+    encode(encoded, record);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open())
+        return;
+    buffer_.append(encoded);
+    ++records_;
+    if (buffer_.size() >= FLUSH_BYTES)
+    {
+        out_.write(buffer_.data(),
+                   static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+void CaptureWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open())
+        return;
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    out_.flush();
+}
+
+std::uint64_t CaptureWriter::recordCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+bool CaptureReader::open(const std::string &path)
+{
+    in_.open(path, std::ios::binary);
+    char header[sizeof(MAGIC) + 1] = {};
+    if (!in_.read(header, sizeof(header)))
+        return false;
+    return std::string_view(header, sizeof(MAGIC)) ==
+        std::string_view(MAGIC, sizeof(MAGIC)) &&
+        header[sizeof(MAGIC)] == VERSION;
+}
+
+std::optional<CaptureRecord> CaptureReader::next()
+{
+    CaptureRecord record;
+    std::uint64_t status;
+    if (!getVarint(in_, record.offset_ns) || !getVarint(in_, status))
+        return std::nullopt;
+    record.status = static_cast<std::uint16_t>(status);
+
+    auto code = in_.get();
+    if (code == std::char_traits<char>::eof())
+        return std::nullopt;
+    if (static_cast<std::size_t>(code) < std::size(METHODS))
+        record.method = METHODS[code];
+    else if (!getString(in_, record.method))
+        return std::nullopt;
+
+    if (!getString(in_, record.url) || !getString(in_, record.body))
+        return std::nullopt;
+    return record;
+}
+
+} // namespace banchoo::capture
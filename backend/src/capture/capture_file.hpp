@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace banchoo::capture
+{
+
+// 캡처 파일 한 건. offset_ns 는 캡처 시작부터 요청 도착까지의 시간이다.
+struct CaptureRecord
+{
+    std::uint64_t offset_ns = 0;
+    std::uint16_t status = 0; // 캡처 당시 응답 코드
+    std::string method;
+    std::string url; // 쿼리 문자열 포함
+    std::string body;
+};
+
+// 파일 형식: "BNCHCAP" + 버전 1바이트, 이어서 레코드가 반복된다.
+// 레코드: varint offset_ns, varint status, 메서드 코드 1바이트
+//         (알 수 없는 메서드면 0xFF 뒤에 varint 길이 + 문자열),
+//         varint url 길이 + url, varint body 길이 + body
+class CaptureWriter
+{
+ public:
+    ~CaptureWriter();
+
+    // 기존 파일은 덮어쓴다.
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const;
+
+    // 여러 워커 스레드에서 동시에 불러도 된다.
+    void append(const CaptureRecord &record);
+    void flush();
+
+    std::uint64_t recordCount() const;
+
+ private:
+    static constexpr std::size_t FLUSH_BYTES = 64 * 1024;
+
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    std::string buffer_;
+    std::uint64_t records_ = 0;
+};
+
+class CaptureReader
+{
+ public:
+    bool open(const std::string &path);
+
+    // 파일 끝이거나 레코드가 잘려 있으면 std::nullopt
+    std::optional<CaptureRecord> next();
+
+ private:
+    std::ifstream in_;
+};
+
+} // namespace banchoo::capture
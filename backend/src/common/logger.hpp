@@ -5,15 +5,35 @@
  */
 #pragma once
 
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 
+#include <nlohmann/json.hpp>
+
+// 컴파일 시점 최소 로그 레벨. 이보다 낮은 레벨의 매크로는 코드가 사라진다.
+// CMake 의 BANCHOO_LOG_ACTIVE_LEVEL 캐시 변수로 정한다.
+#define BANCHOO_LOG_LEVEL_TRACE 0
+#define BANCHOO_LOG_LEVEL_DEBUG 1
+#define BANCHOO_LOG_LEVEL_INFO 2
+#define BANCHOO_LOG_LEVEL_WARN 3
+#define BANCHOO_LOG_LEVEL_ERROR 4
+#define BANCHOO_LOG_LEVEL_CRITICAL 5
+#define BANCHOO_LOG_LEVEL_OFF 6
+
+#ifndef BANCHOO_LOG_ACTIVE_LEVEL
+#define BANCHOO_LOG_ACTIVE_LEVEL BANCHOO_LOG_LEVEL_TRACE
+#endif
+
 namespace banchoo
 {
 
@@ -25,31 +45,92 @@ static const std::unordered_map<std::string, spdlog::level::level_enum>
                   {"error", spdlog::level::err},
                   {"critical", spdlog::level::critical}};
 
+static const std::unordered_map<std::string, spdlog::async_overflow_policy>
+    LOG_OVERFLOW_POLICIES = {
+        {"block", spdlog::async_overflow_policy::block},
+        {"drop_oldest", spdlog::async_overflow_policy::overrun_oldest},
+        {"drop_new", spdlog::async_overflow_policy::discard_new}};
+
+struct LogOptions
+{
+    std::string level = "info";
+    std::optional<std::string> file;
+
+    // 비동기 모드: 요청 스레드는 큐에 넣기만 하고 백그라운드 스레드가 쓴다.
+    bool async = false;
+    std::size_t queue_size = 8192;
+    spdlog::async_overflow_policy overflow =
+        spdlog::async_overflow_policy::block;
+    std::chrono::milliseconds flush_interval{1000};
+
+    // 최상위 설정의 "log_level", "log_file",
+    // "log_async": { "enabled", "queue_size", "overflow", "flush_interval_ms" }
+    static LogOptions fromConfig(const nlohmann::json &config)
+    {
+        LogOptions options;
+        options.level = config.value("log_level", options.level);
+        auto file = config.value("log_file", std::string());
+        if (!file.empty())
+            options.file = file;
+
+        auto async = config.value("log_async", nlohmann::json::object());
+        options.async = async.value("enabled", false);
+        options.queue_size = async.value("queue_size", options.queue_size);
+        auto overflow = async.value("overflow", std::string("block"));
+        if (!LOG_OVERFLOW_POLICIES.contains(overflow))
+            throw std::invalid_argument("Invalid log overflow policy");
+        options.overflow = LOG_OVERFLOW_POLICIES.at(overflow);
+        options.flush_interval = std::chrono::milliseconds(
+            async.value("flush_interval_ms", options.flush_interval.count()));
+        return options;
+    }
+};
+
 class Logger
 {
  public:
     static void init(const std::string &level = "info",
                      const std::optional<std::string> &log_file = std::nullopt)
     {
-        if (!logger)
+        LogOptions options;
+        options.level = level;
+        options.file = log_file;
+        init(options);
+    }
+
+    static void init(const LogOptions &options)
+    {
+        if (logger)
+            return;
+
+        spdlog::sink_ptr sink;
+        if (options.file.has_value())
+            sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(
+                options.file.value());
+        else
+            sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+
+        std::shared_ptr<spdlog::logger> l;
+        if (options.async)
+        {
+            spdlog::init_thread_pool(options.queue_size, 1);
+            l = std::make_shared<spdlog::async_logger>(
+                "banchoo", sink, spdlog::thread_pool(), options.overflow);
+            // 큐에 쌓인 로그는 주기적으로, 에러 이상은 즉시 내보낸다.
+            l->flush_on(spdlog::level::err);
+        }
+        else
         {
-            std::shared_ptr<spdlog::logger> l;
-
-            if (log_file.has_value())
-            {
-                l = spdlog::basic_logger_mt("banchoo", log_file.value());
-            }
-            else
-            {
-                l = spdlog::stdout_color_mt("banchoo");
-            }
-
-            l->set_pattern(
-                "(%Y-%m-%d %H:%M:%S) BANCHOO - [%^%-8l%$] (%s:%#) %v");
-            l->set_level(LOG_LEVELS.at(level));
-
-            logger = l;
+            l = std::make_shared<spdlog::logger>("banchoo", sink);
         }
+        spdlog::register_logger(l);
+        if (options.async)
+            spdlog::flush_every(options.flush_interval);
+
+        l->set_pattern("(%Y-%m-%d %H:%M:%S) BANCHOO - [%^%-8l%$] (%s:%#) %v");
+        l->set_level(LOG_LEVELS.at(options.level));
+
+        logger = l;
     }
 
     static std::shared_ptr<spdlog::logger> &get()
@@ -61,40 +142,75 @@ class Logger
         return logger;
     }
 
+    // 비동기 큐가 넘쳐 버려진 메시지 수
+    static std::size_t droppedMessages()
+    {
+        auto pool = spdlog::thread_pool();
+        if (!pool)
+            return 0;
+        return pool->overrun_counter() + pool->discard_counter();
+    }
+
+    // 비동기 큐에 남은 로그를 모두 내보낸다. 로그를 남기는 스레드가 모두
+    // 끝난 뒤에 부른다. 다른 스레드가 BANCHOO_LOG 로 들고 있을 수 있으므로
+    // logger 는 비우지 않는다. 비우면 다음 get() 이 로거를 다시 만든다.
+    static void shutdown()
+    {
+        spdlog::shutdown();
+    }
+
  private:
     static inline std::shared_ptr<spdlog::logger> logger = nullptr;
 };
 
+// 레벨이 꺼져 있으면 인자를 평가하지 않는다.
+#define BANCHOO_LOG(level, ...)                                                \
+    do                                                                         \
+    {                                                                          \
+        auto &banchoo_logger_ = ::banchoo::Logger::get();                      \
+        if (banchoo_logger_->should_log(level))                                \
+            banchoo_logger_->log(                                              \
+                spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},       \
+                level,                                                         \
+                __VA_ARGS__);                                                  \
+    } while (false)
+
 // Logging macro shortcuts
-#define BANCHOO_TRACE(...)                                                     \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::trace,                                                  \
-        __VA_ARGS__)
-#define BANCHOO_DEBUG(...)                                                     \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::debug,                                                  \
-        __VA_ARGS__)
-#define BANCHOO_INFO(...)                                                      \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::info,                                                   \
-        __VA_ARGS__)
-#define BANCHOO_WARN(...)                                                      \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::warn,                                                   \
-        __VA_ARGS__)
-#define BANCHOO_ERROR(...)                                                     \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::err,                                                    \
-        __VA_ARGS__)
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_TRACE
+#define BANCHOO_TRACE(...) BANCHOO_LOG(spdlog::level::trace, __VA_ARGS__)
+#else
+#define BANCHOO_TRACE(...) (void)0
+#endif
+
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_DEBUG
+#define BANCHOO_DEBUG(...) BANCHOO_LOG(spdlog::level::debug, __VA_ARGS__)
+#else
+#define BANCHOO_DEBUG(...) (void)0
+#endif
+
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_INFO
+#define BANCHOO_INFO(...) BANCHOO_LOG(spdlog::level::info, __VA_ARGS__)
+#else
+#define BANCHOO_INFO(...) (void)0
+#endif
+
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_WARN
+#define BANCHOO_WARN(...) BANCHOO_LOG(spdlog::level::warn, __VA_ARGS__)
+#else
+#define BANCHOO_WARN(...) (void)0
+#endif
+
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_ERROR
+#define BANCHOO_ERROR(...) BANCHOO_LOG(spdlog::level::err, __VA_ARGS__)
+#else
+#define BANCHOO_ERROR(...) (void)0
+#endif
+
+#if BANCHOO_LOG_ACTIVE_LEVEL <= BANCHOO_LOG_LEVEL_CRITICAL
 #define BANCHOO_CRITICAL(...)                                                  \
-    ::banchoo::Logger::get()->log(                                             \
-        spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION},               \
-        spdlog::level::critical,                                               \
-        __VA_ARGS__)
+    BANCHOO_LOG(spdlog::level::critical, __VA_ARGS__)
+#else
+#define BANCHOO_CRITICAL(...) (void)0
+#endif
 
 } // namespace banchoo
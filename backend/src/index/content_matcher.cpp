@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/content_matcher.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace banchoo::index
+{
+
+namespace
+{
+constexpr std::string_view REGEX_SPECIAL = "\\^$.|?*+()[]{}";
+
+// run 의 마지막 글자(UTF-8 한 글자)를 뺀다.
+void popChar(std::string &run)
+{
+    while (!run.empty() &&
+           (static_cast<unsigned char>(run.back()) & 0xC0) == 0x80)
+        run.pop_back();
+    if (!run.empty())
+        run.pop_back();
+}
+
+// 정규식에 맞는 문자열에 반드시 들어 있는 가장 긴 문자열. 괄호 밖에서
+// 이어지는 보통 글자만 본다. 뒤에 ?, *, { 가 붙은 글자는 없어도 되므로
+// 뺀다. 괄호 밖에 | 가 있으면 어느 쪽이 맞을지 모르므로 포기한다.
+std::string requiredLiteral(std::string_view pattern)
+{
+    std::string best;
+    std::string run;
+    auto finish = [&]
+    {
+        if (run.size() > best.size())
+            best = run;
+        run.clear();
+    };
+
+    int depth = 0;
+    bool in_class = false;
+    for (std::size_t i = 0; i < pattern.size(); ++i)
+    {
+        char c = pattern[i];
+        if (c == '\\')
+        {
+            finish();
+            ++i;
+            continue;
+        }
+        if (in_class)
+        {
+            in_class = c != ']';
+            continue;
+        }
+        switch (c)
+        {
+        case '[':
+            in_class = true;
+            finish();
+            break;
+        case '(':
+            ++depth;
+            finish();
+            break;
+        case ')':
+            --depth;
+            finish();
+            break;
+        case '{':
+            // {n,m} 의 숫자는 글자가 아니다.
+            while (i + 1 < pattern.size() && pattern[i] != '}')
+                ++i;
+            [[fallthrough]];
+        case '?':
+        case '*':
+            popChar(run);
+            finish();
+            break;
+        case '|':
+            if (depth == 0)
+                return {};
+            finish();
+            break;
+        case '+':
+            finish();
+            break;
+        case '^':
+        case '$':
+        case '.':
+            finish();
+            break;
+        default:
+            if (depth == 0)
+                run.push_back(c);
+            break;
+        }
+    }
+    finish();
+    return best;
+}
+} // namespace
+
+std::size_t findLiteral(std::string_view haystack, std::string_view needle)
+{
+    const auto m = needle.size();
+    if (m == 0)
+        return 0;
+    if (m > haystack.size())
+        return std::string_view::npos;
+    if (m == 1)
+    {
+        const auto *p = static_cast<const char *>(
+            std::memchr(haystack.data(), needle[0], haystack.size()));
+        return p ? static_cast<std::size_t>(p - haystack.data())
+                 : std::string_view::npos;
+    }
+
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const auto *data = haystack.data();
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    for (; i + m - 1 + 16 <= haystack.size(); i += 16)
+    {
+        auto block_first =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        auto block_last = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(data + i + m - 1));
+        auto mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                            _mm_cmpeq_epi8(last, block_last))));
+        while (mask != 0)
+        {
+            auto bit = static_cast<std::size_t>(std::countr_zero(mask));
+            if (std::memcmp(data + i + bit + 1, needle.data() + 1, m - 2) == 0)
+                return i + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    auto rest = haystack.substr(i).find(needle);
+    return rest == std::string_view::npos ? rest : i + rest;
+}
+
+std::optional<ContentMatcher>
+ContentMatcher::parse(std::string_view pattern, bool regex, std::string &error)
+{
+    if (pattern.empty())
+    {
+        error = "pattern is empty";
+        return std::nullopt;
+    }
+    if (pattern.size() > MAX_PATTERN)
+    {
+        error = "pattern is longer than 1024 bytes";
+        return std::nullopt;
+    }
+
+    ContentMatcher matcher;
+    if (!regex || pattern.find_first_of(REGEX_SPECIAL) == std::string::npos)
+    {
+        matcher.literal_ = pattern;
+        return matcher;
+    }
+
+    auto compiled = LineRegex::compile(pattern, error);
+    if (!compiled)
+    {
+        error = "invalid regular expression: " + error;
+        return std::nullopt;
+    }
+    matcher.regex_ = std::make_shared<const LineRegex>(std::move(*compiled));
+    matcher.literal_ = requiredLiteral(pattern);
+    return matcher;
+}
+
+bool ContentMatcher::matches(std::string_view content) const
+{
+    if (!literal_.empty() &&
+        findLiteral(content, literal_) == std::string_view::npos)
+        return false;
+    if (!regex_)
+        return true;
+
+    // grep 처럼 줄마다 맞춰 본다.
+    std::size_t start = 0;
+    for (;;)
+    {
+        auto end = content.find('\n', start);
+        if (end == std::string_view::npos)
+            end = content.size();
+        if (regex_->search(content.substr(start, end - start)))
+            return true;
+        if (end == content.size())
+            return false;
+        start = end + 1;
+    }
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "index/line_regex.hpp"
+
+namespace banchoo::index
+{
+
+// needle 이 처음 나오는 위치, 없으면 npos. SSE2 가 있으면 첫 바이트와 끝
+// 바이트가 모두 맞는 자리만 16바이트씩 한 번에 골라 나머지를 비교한다.
+std::size_t findLiteral(std::string_view haystack, std::string_view needle);
+
+// 노트 본문 검색식. 그대로 찾는 문자열이거나, 줄 단위로 맞춰 보는
+// 정규식(LineRegex)이다. 여러 스레드에서 함께 matches 를 불러도 된다.
+class ContentMatcher
+{
+ public:
+    static constexpr std::size_t MAX_PATTERN = 1024;
+
+    // regex 가 true 여도 특수 문자가 없으면 그대로 찾는다. 잘못된 식이면
+    // error 에 이유를 쓰고 nullopt
+    static std::optional<ContentMatcher>
+    parse(std::string_view pattern, bool regex, std::string &error);
+
+    bool matches(std::string_view content) const;
+
+    bool isRegex() const
+    {
+        return regex_ != nullptr;
+    }
+    // 정규식이면 맞는 본문에 반드시 들어 있는 문자열 (없으면 빈 문자열)
+    const std::string &literal() const
+    {
+        return literal_;
+    }
+
+ private:
+    std::string literal_;
+    std::shared_ptr<const LineRegex> regex_;
+};
+
+} // namespace banchoo::index
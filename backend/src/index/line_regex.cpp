@@ -0,0 +1,799 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/line_regex.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace banchoo::index
+{
+
+namespace
+{
+using Op = LineRegex::Op;
+using CharClass = LineRegex::CharClass;
+
+// 묶음을 이만큼 넘게 겹치면 거절한다 (재귀 깊이 제한).
+constexpr int MAX_DEPTH = 32;
+// {n,m} 의 n, m 상한
+constexpr std::uint32_t MAX_REPEAT = 1000;
+constexpr std::uint32_t UNBOUNDED = UINT32_MAX;
+constexpr char32_t MAX_CODE_POINT = 0x10FFFF;
+
+const CharClass DIGIT = {{'0', '9'}};
+const CharClass WORD = {{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+const CharClass SPACE = {{'\t', '\r'},
+                         {' ', ' '},
+                         {0xA0, 0xA0},
+                         {0x1680, 0x1680},
+                         {0x2000, 0x200A},
+                         {0x2028, 0x2029},
+                         {0x202F, 0x202F},
+                         {0x205F, 0x205F},
+                         {0x3000, 0x3000},
+                         {0xFEFF, 0xFEFF}};
+
+// 다음 코드 포인트를 읽는다. 깨진 바이트는 U+FFFD 로 보고 한 바이트 넘긴다.
+char32_t decode(std::string_view s, std::size_t &i)
+{
+    auto c = static_cast<unsigned char>(s[i++]);
+    if (c < 0x80)
+        return c;
+
+    std::size_t extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+    if (extra == 0 || i + extra > s.size())
+        return 0xFFFD;
+    char32_t cp = c & (0x3F >> extra);
+    for (std::size_t k = 0; k < extra; ++k)
+    {
+        auto next = static_cast<unsigned char>(s[i + k]);
+        if ((next & 0xC0) != 0x80)
+            return 0xFFFD;
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return cp;
+}
+
+bool isWord(char32_t cp)
+{
+    return (cp >= '0' && cp <= '9') || (cp >= 'A' && cp <= 'Z') ||
+           (cp >= 'a' && cp <= 'z') || cp == '_';
+}
+
+bool isLineTerminator(char32_t cp)
+{
+    return cp == '\n' || cp == '\r' || cp == 0x2028 || cp == 0x2029;
+}
+
+bool inClass(const CharClass &set, char32_t cp)
+{
+    auto it = std::upper_bound(set.begin(),
+                               set.end(),
+                               cp,
+                               [](char32_t value, const auto &range)
+                               { return value < range.first; });
+    return it != set.begin() && cp <= std::prev(it)->second;
+}
+
+// 구간을 정렬하고 겹치거나 맞닿은 구간을 합친다.
+void normalize(CharClass &set)
+{
+    std::sort(set.begin(), set.end());
+    CharClass merged;
+    for (const auto &range : set)
+    {
+        if (!merged.empty() && range.first <= merged.back().second + 1)
+            merged.back().second = std::max(merged.back().second, range.second);
+        else
+            merged.push_back(range);
+    }
+    set = std::move(merged);
+}
+
+CharClass complement(const CharClass &set)
+{
+    CharClass out;
+    char32_t next = 0;
+    for (const auto &range : set)
+    {
+        if (range.first > next)
+            out.emplace_back(next, range.first - 1);
+        next = range.second + 1;
+    }
+    if (next <= MAX_CODE_POINT)
+        out.emplace_back(next, MAX_CODE_POINT);
+    return out;
+}
+
+// \d \w \s 와 대문자 여집합
+bool shorthand(char32_t e, CharClass &out)
+{
+    const CharClass *set = nullptr;
+    switch (e)
+    {
+    case 'd':
+    case 'D':
+        set = &DIGIT;
+        break;
+    case 'w':
+    case 'W':
+        set = &WORD;
+        break;
+    case 's':
+    case 'S':
+        set = &SPACE;
+        break;
+    default:
+        return false;
+    }
+    out = e >= 'a' ? *set : complement(*set);
+    return true;
+}
+
+struct Node
+{
+    enum class Kind : std::uint8_t
+    {
+        EMPTY,
+        CHAR,
+        ANY,
+        CLASS,
+        ASSERT,
+        CONCAT,
+        ALTERNATE,
+        REPEAT,
+    };
+
+    Kind kind = Kind::EMPTY;
+    char32_t c = 0;
+    std::uint32_t index = 0; // CLASS 일 때 글자 묶음 번호
+    Op assertion = Op::LINE_START;
+    std::uint32_t min = 0;
+    std::uint32_t max = 0;
+    std::vector<Node> children;
+};
+
+// 재귀 하강 파서. alternate := concat ("|" concat)*,
+// concat := (atom quantifier?)*, atom := "(" alternate ")" | 글자 | ...
+class Parser
+{
+ public:
+    Parser(std::u32string_view pattern, std::vector<CharClass> &classes)
+        : pattern_(pattern), classes_(classes)
+    {
+    }
+
+    bool parse(Node &root, std::string &error)
+    {
+        if (!parseAlternate(root, 0, error))
+            return false;
+        if (pos_ < pattern_.size())
+            return fail(error, "unmatched ')'");
+        return true;
+    }
+
+ private:
+    static bool fail(std::string &error, const char *message)
+    {
+        error = message;
+        return false;
+    }
+
+    bool peek(char32_t c) const
+    {
+        return pos_ < pattern_.size() && pattern_[pos_] == c;
+    }
+
+    bool eat(char32_t c)
+    {
+        if (!peek(c))
+            return false;
+        ++pos_;
+        return true;
+    }
+
+    bool parseAlternate(Node &out, int depth, std::string &error)
+    {
+        if (depth > MAX_DEPTH)
+            return fail(error, "groups are nested too deeply");
+
+        Node branch;
+        if (!parseConcat(branch, depth, error))
+            return false;
+        if (!peek('|'))
+        {
+            out = std::move(branch);
+            return true;
+        }
+
+        out.kind = Node::Kind::ALTERNATE;
+        out.children.push_back(std::move(branch));
+        while (eat('|'))
+        {
+            Node next;
+            if (!parseConcat(next, depth, error))
+                return false;
+            out.children.push_back(std::move(next));
+        }
+        return true;
+    }
+
+    bool parseConcat(Node &out, int depth, std::string &error)
+    {
+        out.kind = Node::Kind::CONCAT;
+        while (pos_ < pattern_.size() && !peek('|') && !peek(')'))
+        {
+            Node atom;
+            if (!parseAtom(atom, depth, error) || !parseQuantifier(atom, error))
+                return false;
+            out.children.push_back(std::move(atom));
+        }
+        return true;
+    }
+
+    bool parseAtom(Node &out, int depth, std::string &error)
+    {
+        char32_t c = pattern_[pos_++];
+        switch (c)
+        {
+        case '(':
+            if (eat('?') && !eat(':'))
+                return fail(error, "lookaround is not supported");
+            if (!parseAlternate(out, depth + 1, error))
+                return false;
+            if (!eat(')'))
+                return fail(error, "missing ')'");
+            return true;
+        case '[':
+            return parseClass(out, error);
+        case '.':
+            out.kind = Node::Kind::ANY;
+            return true;
+        case '^':
+            setAssertion(out, Op::LINE_START);
+            return true;
+        case '$':
+            setAssertion(out, Op::LINE_END);
+            return true;
+        case '\\':
+            return parseEscape(out, error);
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            return fail(error, "nothing to repeat");
+        default:
+            out.kind = Node::Kind::CHAR;
+            out.c = c;
+            return true;
+        }
+    }
+
+    bool parseQuantifier(Node &atom, std::string &error)
+    {
+        std::uint32_t min = 0;
+        std::uint32_t max = UNBOUNDED;
+        if (eat('*'))
+        {
+        }
+        else if (eat('+'))
+        {
+            min = 1;
+        }
+        else if (eat('?'))
+        {
+            max = 1;
+        }
+        else if (peek('{'))
+        {
+            if (!parseBraces(min, max, error))
+                return false;
+        }
+        else
+        {
+            return true;
+        }
+        // 게으른 반복도 맞는지 여부는 같다.
+        eat('?');
+
+        if (atom.kind == Node::Kind::ASSERT || peek('*') || peek('+') ||
+            peek('?') || peek('{'))
+            return fail(error, "nothing to repeat");
+
+        Node repeat;
+        repeat.kind = Node::Kind::REPEAT;
+        repeat.min = min;
+        repeat.max = max;
+        repeat.children.push_back(std::move(atom));
+        atom = std::move(repeat);
+        return true;
+    }
+
+    // {n}, {n,}, {n,m}
+    bool parseBraces(std::uint32_t &min, std::uint32_t &max, std::string &error)
+    {
+        ++pos_;
+        bool has_min = false;
+        if (!parseCount(min, has_min, error))
+            return false;
+        if (!has_min)
+            return fail(error, "invalid repetition");
+        max = min;
+        if (eat(','))
+        {
+            bool has_max = false;
+            if (!parseCount(max, has_max, error))
+                return false;
+            if (!has_max)
+                max = UNBOUNDED;
+        }
+        if (!eat('}') || min > max)
+            return fail(error, "invalid repetition");
+        return true;
+    }
+
+    bool parseCount(std::uint32_t &value, bool &found, std::string &error)
+    {
+        value = 0;
+        while (pos_ < pattern_.size() && pattern_[pos_] >= '0' &&
+               pattern_[pos_] <= '9')
+        {
+            value = value * 10 + (pattern_[pos_++] - '0');
+            if (value > MAX_REPEAT)
+                return fail(error, "repetition count is too large");
+            found = true;
+        }
+        return true;
+    }
+
+    bool parseEscape(Node &out, std::string &error)
+    {
+        if (pos_ >= pattern_.size())
+            return fail(error, "trailing '\\'");
+        char32_t e = pattern_[pos_++];
+        if (e == 'b' || e == 'B')
+        {
+            setAssertion(out, e == 'b' ? Op::WORD_BOUNDARY
+                                       : Op::NOT_WORD_BOUNDARY);
+            return true;
+        }
+
+        CharClass set;
+        if (shorthand(e, set))
+        {
+            setClass(out, std::move(set));
+            return true;
+        }
+        out.kind = Node::Kind::CHAR;
+        return escapeChar(e, out.c, error);
+    }
+
+    // \ 뒤의 e 가 나타내는 글자 하나
+    bool escapeChar(char32_t e, char32_t &c, std::string &error)
+    {
+        switch (e)
+        {
+        case 't':
+            c = '\t';
+            return true;
+        case 'n':
+            c = '\n';
+            return true;
+        case 'r':
+            c = '\r';
+            return true;
+        case 'f':
+            c = '\f';
+            return true;
+        case 'v':
+            c = '\v';
+            return true;
+        case '0':
+            c = 0;
+            return true;
+        case 'x':
+            return parseHex(2, c, error);
+        case 'u':
+            return parseHex(4, c, error);
+        default:
+            break;
+        }
+        if (e >= '1' && e <= '9')
+            return fail(error, "backreferences are not supported");
+        if ((e >= 'a' && e <= 'z') || (e >= 'A' && e <= 'Z'))
+            return fail(error, "invalid escape");
+        c = e;
+        return true;
+    }
+
+    bool parseHex(int digits, char32_t &c, std::string &error)
+    {
+        c = 0;
+        for (int i = 0; i < digits; ++i)
+        {
+            if (pos_ >= pattern_.size())
+                return fail(error, "invalid escape");
+            char32_t h = pattern_[pos_++];
+            if (h >= '0' && h <= '9')
+                c = c * 16 + (h - '0');
+            else if (h >= 'a' && h <= 'f')
+                c = c * 16 + (h - 'a' + 10);
+            else if (h >= 'A' && h <= 'F')
+                c = c * 16 + (h - 'A' + 10);
+            else
+                return fail(error, "invalid escape");
+        }
+        return true;
+    }
+
+    // [ 다음부터 ] 까지. [] 는 아무 글자에도, [^] 는 모든 글자에 맞는다.
+    bool parseClass(Node &out, std::string &error)
+    {
+        bool negated = eat('^');
+        CharClass set;
+        while (!eat(']'))
+        {
+            if (pos_ >= pattern_.size())
+                return fail(error, "missing ']'");
+
+            char32_t first = 0;
+            bool single = false;
+            if (!parseClassAtom(set, first, single, error))
+                return false;
+
+            bool range = peek('-') && pos_ + 1 < pattern_.size() &&
+                         pattern_[pos_ + 1] != ']';
+            if (!range)
+            {
+                if (single)
+                    set.emplace_back(first, first);
+                continue;
+            }
+
+            ++pos_;
+            char32_t last = 0;
+            bool last_single = false;
+            if (!parseClassAtom(set, last, last_single, error))
+                return false;
+            if (!single || !last_single || last < first)
+                return fail(error, "invalid character class range");
+            set.emplace_back(first, last);
+        }
+
+        normalize(set);
+        setClass(out, negated ? complement(set) : std::move(set));
+        return true;
+    }
+
+    // 글자 하나면 c 에 쓰고 single 을 세운다. \d 같은 묶음은 set 에 더한다.
+    bool parseClassAtom(CharClass &set,
+                        char32_t &c,
+                        bool &single,
+                        std::string &error)
+    {
+        c = pattern_[pos_++];
+        single = true;
+        if (c != '\\')
+            return true;
+        if (pos_ >= pattern_.size())
+            return fail(error, "trailing '\\'");
+
+        char32_t e = pattern_[pos_++];
+        if (e == 'b')
+        {
+            c = '\b';
+            return true;
+        }
+        CharClass shorthand_set;
+        if (shorthand(e, shorthand_set))
+        {
+            set.insert(set.end(), shorthand_set.begin(), shorthand_set.end());
+            single = false;
+            return true;
+        }
+        return escapeChar(e, c, error);
+    }
+
+    void setAssertion(Node &out, Op op)
+    {
+        out.kind = Node::Kind::ASSERT;
+        out.assertion = op;
+    }
+
+    void setClass(Node &out, CharClass set)
+    {
+        out.kind = Node::Kind::CLASS;
+        out.index = static_cast<std::uint32_t>(classes_.size());
+        classes_.push_back(std::move(set));
+    }
+
+    std::u32string_view pattern_;
+    std::vector<CharClass> &classes_;
+    std::size_t pos_ = 0;
+};
+
+// 구문 나무를 Pike VM 명령으로 풀어 쓴다.
+class Compiler
+{
+ public:
+    explicit Compiler(std::vector<LineRegex::Inst> &program)
+        : program_(program)
+    {
+    }
+
+    bool emit(const Node &node, std::string &error)
+    {
+        switch (node.kind)
+        {
+        case Node::Kind::EMPTY:
+            return true;
+        case Node::Kind::CHAR:
+            return push({Op::CHAR, node.c}, error);
+        case Node::Kind::ANY:
+            return push({Op::ANY}, error);
+        case Node::Kind::CLASS:
+            return push({Op::CLASS, 0, node.index}, error);
+        case Node::Kind::ASSERT:
+            return push({node.assertion}, error);
+        case Node::Kind::CONCAT:
+            for (const auto &child : node.children)
+            {
+                if (!emit(child, error))
+                    return false;
+            }
+            return true;
+        case Node::Kind::ALTERNATE:
+            return emitAlternate(node, error);
+        case Node::Kind::REPEAT:
+            return emitRepeat(node, error);
+        }
+        return false;
+    }
+
+    bool push(LineRegex::Inst inst, std::string &error)
+    {
+        if (program_.size() >= LineRegex::MAX_PROGRAM)
+        {
+            error = "pattern is too complex";
+            return false;
+        }
+        program_.push_back(inst);
+        return true;
+    }
+
+ private:
+    std::uint32_t here() const
+    {
+        return static_cast<std::uint32_t>(program_.size());
+    }
+
+    // SPLIT a, next; a; JUMP end; next: SPLIT b, next2; b; JUMP end; ... z
+    bool emitAlternate(const Node &node, std::string &error)
+    {
+        std::vector<std::uint32_t> jumps;
+        for (std::size_t i = 0; i < node.children.size(); ++i)
+        {
+            bool last = i + 1 == node.children.size();
+            auto split = here();
+            if (!last && !push({Op::SPLIT, 0, split + 1}, error))
+                return false;
+            if (!emit(node.children[i], error))
+                return false;
+            if (!last)
+            {
+                jumps.push_back(here());
+                if (!push({Op::JUMP}, error))
+                    return false;
+                program_[split].y = here();
+            }
+        }
+        for (auto jump : jumps)
+            program_[jump].x = here();
+        return true;
+    }
+
+    // 앞의 min 번은 그대로 잇고, 나머지는 건너뛸 수 있게 SPLIT 으로 감싼다.
+    // 상한이 없으면 마지막 복사본으로 돌아가는 고리를 만든다.
+    bool emitRepeat(const Node &node, std::string &error)
+    {
+        const auto &child = node.children.front();
+        for (std::uint32_t i = 0; i < node.min; ++i)
+        {
+            if (!emit(child, error))
+                return false;
+        }
+
+        if (node.max == UNBOUNDED)
+        {
+            auto loop = here();
+            if (!push({Op::SPLIT, 0, loop + 1}, error) || !emit(child, error) ||
+                !push({Op::JUMP, 0, loop}, error))
+                return false;
+            program_[loop].y = here();
+            return true;
+        }
+
+        std::vector<std::uint32_t> splits;
+        for (std::uint32_t i = node.min; i < node.max; ++i)
+        {
+            splits.push_back(here());
+            if (!push({Op::SPLIT, 0, here() + 1}, error) || !emit(child, error))
+                return false;
+        }
+        for (auto split : splits)
+            program_[split].y = here();
+        return true;
+    }
+
+    std::vector<LineRegex::Inst> &program_;
+};
+
+// search 가 스레드마다 다시 쓰는 상태 목록
+struct Threads
+{
+    // 명령마다 마지막으로 목록에 넣은 위치의 세대
+    std::vector<std::uint32_t> marks;
+    std::uint32_t generation = 0;
+    std::vector<std::uint32_t> current; // 이 위치에서 글자를 기다리는 명령
+    std::vector<std::uint32_t> next;    // 다음 위치에서 이어 갈 명령
+    std::vector<std::uint32_t> stack;
+};
+
+struct Position
+{
+    bool start;
+    bool end;
+    bool prev_word;
+    bool next_word;
+};
+
+// pc 에서 글자를 읽지 않고 갈 수 있는 명령을 모두 따라가 글자를 기다리는
+// 명령을 current 에 넣는다. MATCH 에 닿으면 true.
+bool follow(const std::vector<LineRegex::Inst> &program,
+            Threads &t,
+            std::uint32_t pc,
+            const Position &at)
+{
+    t.stack.push_back(pc);
+    while (!t.stack.empty())
+    {
+        pc = t.stack.back();
+        t.stack.pop_back();
+        if (t.marks[pc] == t.generation)
+            continue;
+        t.marks[pc] = t.generation;
+
+        const auto &inst = program[pc];
+        switch (inst.op)
+        {
+        case Op::JUMP:
+            t.stack.push_back(inst.x);
+            break;
+        case Op::SPLIT:
+            t.stack.push_back(inst.y);
+            t.stack.push_back(inst.x);
+            break;
+        case Op::LINE_START:
+            if (at.start)
+                t.stack.push_back(pc + 1);
+            break;
+        case Op::LINE_END:
+            if (at.end)
+                t.stack.push_back(pc + 1);
+            break;
+        case Op::WORD_BOUNDARY:
+            if (at.prev_word != at.next_word)
+                t.stack.push_back(pc + 1);
+            break;
+        case Op::NOT_WORD_BOUNDARY:
+            if (at.prev_word == at.next_word)
+                t.stack.push_back(pc + 1);
+            break;
+        case Op::MATCH:
+            t.stack.clear();
+            return true;
+        default:
+            t.current.push_back(pc);
+            break;
+        }
+    }
+    return false;
+}
+} // namespace
+
+std::optional<LineRegex> LineRegex::compile(std::string_view pattern,
+                                            std::string &error)
+{
+    std::u32string code_points;
+    for (std::size_t i = 0; i < pattern.size();)
+        code_points.push_back(decode(pattern, i));
+
+    LineRegex regex;
+    Node root;
+    Parser parser(code_points, regex.classes_);
+    if (!parser.parse(root, error))
+        return std::nullopt;
+
+    Compiler compiler(regex.program_);
+    if (!compiler.emit(root, error) || !compiler.push({Op::MATCH}, error))
+        return std::nullopt;
+    regex.anchored_ = regex.program_.front().op == Op::LINE_START;
+    return regex;
+}
+
+bool LineRegex::search(std::string_view line) const
+{
+    thread_local Threads t;
+    if (t.marks.size() < program_.size())
+        t.marks.resize(program_.size(), 0);
+    t.next.clear();
+
+    bool prev_word = false;
+    std::size_t i = 0;
+    for (;;)
+    {
+        // 세대를 올리면 이전 위치의 표시가 모두 지워진다.
+        if (++t.generation == 0)
+        {
+            std::fill(t.marks.begin(), t.marks.end(), 0);
+            t.generation = 1;
+        }
+
+        bool end = i == line.size();
+        std::size_t after = i;
+        char32_t cp = end ? 0 : decode(line, after);
+        Position at{i == 0, end, prev_word, !end && isWord(cp)};
+
+        // 앞 글자에서 넘어온 갈래와 여기서 새로 시작하는 갈래
+        t.current.clear();
+        for (auto pc : t.next)
+        {
+            if (follow(program_, t, pc, at))
+                return true;
+        }
+        if ((i == 0 || !anchored_) && follow(program_, t, 0, at))
+            return true;
+        if (end || (t.current.empty() && anchored_))
+            return false;
+
+        t.next.clear();
+        for (auto pc : t.current)
+        {
+            const auto &inst = program_[pc];
+            bool ok = false;
+            switch (inst.op)
+            {
+            case Op::CHAR:
+                ok = inst.c == cp;
+                break;
+            case Op::ANY:
+                ok = !isLineTerminator(cp);
+                break;
+            case Op::CLASS:
+                ok = inClass(classes_[inst.x], cp);
+                break;
+            default:
+                break;
+            }
+            if (ok)
+                t.next.push_back(pc + 1);
+        }
+
+        prev_word = isWord(cp);
+        i = after;
+    }
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace banchoo::index
+{
+
+// 줄 하나에 맞춰 보는 정규식. ECMAScript 문법 가운데 글자, ., [...],
+// \d \w \s 와 그 여집합, ^ $ \b \B, (...) (?:...), |, * + ? {n,m} 을 받고
+// 되참조와 전후방 탐색은 받지 않는다. 글자는 UTF-8 코드 포인트 단위다.
+// 되짚지 않고 NFA 의 모든 갈래를 한 글자씩 함께 옮기므로 (Pike VM) 시간은
+// 줄 길이와 식 크기의 곱을 넘지 않고 줄이 길어도 스택을 더 쓰지 않는다.
+// 여러 스레드에서 함께 search 를 불러도 된다.
+class LineRegex
+{
+ public:
+    // 풀어 쓴 명령 수의 상한. {n,m} 은 앞의 식을 m 번 복사한다.
+    static constexpr std::size_t MAX_PROGRAM = 4096;
+
+    enum class Op : std::uint8_t
+    {
+        CHAR,  // 글자 c 하나
+        ANY,   // 줄바꿈이 아닌 글자 하나
+        CLASS, // classes[x] 에 드는 글자 하나
+        SPLIT, // x 와 y 로 함께 간다
+        JUMP,  // x 로 간다
+        LINE_START,
+        LINE_END,
+        WORD_BOUNDARY,
+        NOT_WORD_BOUNDARY,
+        MATCH,
+    };
+
+    struct Inst
+    {
+        Op op;
+        char32_t c = 0;
+        std::uint32_t x = 0;
+        std::uint32_t y = 0;
+    };
+
+    // 정렬돼 있고 겹치지 않는 코드 포인트 구간 [first, second] 들
+    using CharClass = std::vector<std::pair<char32_t, char32_t>>;
+
+    // 잘못되었거나 받지 않는 식이면 error 에 이유를 쓰고 nullopt
+    static std::optional<LineRegex> compile(std::string_view pattern,
+                                            std::string &error);
+
+    // line 어딘가에 맞는 곳이 있으면 true. line 에는 줄바꿈이 없다고 본다.
+    bool search(std::string_view line) const;
+
+    const std::vector<Inst> &program() const
+    {
+        return program_;
+    }
+
+ private:
+    std::vector<Inst> program_;
+    std::vector<CharClass> classes_;
+    bool anchored_ = false; // ^ 로 시작해 줄 머리에서만 맞을 수 있다
+};
+
+} // namespace banchoo::index
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/parallel_scan.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace banchoo::index
+{
+
+namespace
+{
+// 이보다 적게 훑으면 스레드를 만드는 비용이 더 크다.
+constexpr std::size_t PARALLEL_BYTES = 1024 * 1024;
+// 스레드마다 조각을 여러 개 가져가도록 잘게 나눠 본문 길이가 고르지 않아도
+// 일이 한쪽에 몰리지 않게 한다.
+constexpr std::size_t CHUNKS_PER_THREAD = 16;
+constexpr std::size_t MIN_CHUNK = 64;
+constexpr std::size_t MAX_CHUNK = 4096;
+
+// 모든 parallelScan 이 함께 쓰는 작업 스레드. 요청마다 스레드를 만들지
+// 않고, grep 이 동시에 여럿 와도 스레드 수가 늘지 않는다.
+class ScanPool
+{
+ public:
+    static ScanPool &instance()
+    {
+        static ScanPool pool(std::max(1U, std::thread::hardware_concurrency()) -
+                             1);
+        return pool;
+    }
+
+    ~ScanPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto &worker : workers_)
+            worker.join();
+    }
+
+    std::size_t size() const
+    {
+        return workers_.size();
+    }
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+ private:
+    explicit ScanPool(std::size_t threads)
+    {
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+            workers_.emplace_back([this] { run(); });
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty())
+                    return;
+                task = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// 풀에 넘긴 도우미와 부른 스레드가 함께 보는 상태. 도우미가 늦게 시작해
+// 부른 스레드가 이미 돌아갔을 수 있으므로 shared_ptr 로 들고 있는다.
+struct Helpers
+{
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::size_t active = 0; // 지금 훑는 중인 도우미 수
+    bool closed = false;    // 이후에 시작한 도우미는 아무것도 하지 않는다
+};
+} // namespace
+
+std::vector<std::size_t>
+parallelScan(std::size_t count,
+             std::size_t limit,
+             std::size_t bytes,
+             const std::function<bool(std::size_t)> &match,
+             std::size_t threads)
+{
+    std::vector<std::size_t> result;
+    if (count == 0 || limit == 0)
+        return result;
+
+    auto &pool = ScanPool::instance();
+    if (threads == 0 || threads > pool.size() + 1)
+        threads = pool.size() + 1;
+    if (threads == 1 || bytes < PARALLEL_BYTES)
+    {
+        for (std::size_t i = 0; i < count && result.size() < limit; ++i)
+        {
+            if (match(i))
+                result.push_back(i);
+        }
+        return result;
+    }
+
+    const auto chunk = std::clamp(
+        count / (threads * CHUNKS_PER_THREAD), MIN_CHUNK, MAX_CHUNK);
+    const auto chunks = (count + chunk - 1) / chunk;
+    threads = std::min(threads, chunks);
+
+    std::vector<std::vector<std::size_t>> found(chunks);
+    std::vector<char> done(chunks, 0);
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> enough{false};
+
+    // 앞에서부터 이어서 끝난 조각 수와 그 조각들에서 찾은 수
+    std::mutex mutex;
+    std::size_t prefix = 0;
+    std::size_t prefix_found = 0;
+    std::exception_ptr error;
+
+    auto work = [&]
+    {
+        try
+        {
+            while (!enough.load(std::memory_order_relaxed))
+            {
+                auto c = next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= chunks)
+                    break;
+
+                auto &out = found[c];
+                auto end = std::min(count, (c + 1) * chunk);
+                for (auto i = c * chunk; i < end && out.size() < limit; ++i)
+                {
+                    if (match(i))
+                        out.push_back(i);
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                done[c] = 1;
+                while (prefix < chunks && done[prefix])
+                    prefix_found += found[prefix++].size();
+                if (prefix_found >= limit)
+                    enough = true;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error)
+                error = std::current_exception();
+            enough = true;
+        }
+    };
+
+    // 도우미는 풀이 바쁘면 늦게 시작한다. 부른 스레드가 먼저 다 훑으면
+    // 기다리지 않고, 이미 훑는 중인 도우미만 기다린다.
+    auto helpers = std::make_shared<Helpers>();
+    for (std::size_t t = 1; t < threads; ++t)
+    {
+        pool.post(
+            [helpers, &work]
+            {
+                {
+                    std::lock_guard<std::mutex> lock(helpers->mutex);
+                    if (helpers->closed)
+                        return;
+                    ++helpers->active;
+                }
+                work();
+                {
+                    std::lock_guard<std::mutex> lock(helpers->mutex);
+                    --helpers->active;
+                }
+                helpers->idle.notify_all();
+            });
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> lock(helpers->mutex);
+        helpers->closed = true;
+        helpers->idle.wait(lock, [&] { return helpers->active == 0; });
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    for (const auto &part : found)
+    {
+        for (auto i : part)
+        {
+            if (result.size() == limit)
+                return result;
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace banchoo::index
+{
+
+// 0..count-1 을 앞에서부터 작은 조각으로 나눠 여러 스레드가 차례로 가져가며
+// 훑는다. match(i) 가 true 인 i 를 작은 것부터 최대 limit 개 돌려준다.
+// 앞쪽 조각들에서 limit 개가 모이면 남은 조각은 훑지 않는다.
+// bytes 는 훑을 전체 크기로, 작으면 부른 스레드에서만 훑는다. 크면 모든
+// 호출이 함께 쓰는 작업 스레드(하드웨어 스레드 수 - 1 개)에 일을 나눠
+// 주고 부른 스레드도 함께 훑는다. threads 는 부른 스레드를 포함해 한
+// 호출이 쓰는 스레드 수의 상한이고, 0 이면 풀 전체를 쓴다.
+// match 가 던진 예외는 모든 스레드가 멈춘 뒤 다시 던진다.
+std::vector<std::size_t>
+parallelScan(std::size_t count,
+             std::size_t limit,
+             std::size_t bytes,
+             const std::function<bool(std::size_t)> &match,
+             std::size_t threads = 0);
+
+} // namespace banchoo::index
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/roaring_bitmap.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace banchoo::index
+{
+
+namespace
+{
+// 배열 묶음의 최대 크기. 4096 * 2바이트 = 비트맵 8KB 와 같다.
+constexpr std::uint32_t ARRAY_MAX = 4096;
+constexpr std::size_t BITMAP_WORDS = 65536 / 64;
+
+std::uint16_t high(std::uint32_t value)
+{
+    return static_cast<std::uint16_t>(value >> 16);
+}
+
+std::uint16_t low(std::uint32_t value)
+{
+    return static_cast<std::uint16_t>(value & 0xFFFF);
+}
+
+bool testBit(const std::vector<std::uint64_t> &bits, std::uint16_t v)
+{
+    return (bits[v >> 6] >> (v & 63)) & 1U;
+}
+
+void setBit(std::vector<std::uint64_t> &bits, std::uint16_t v)
+{
+    bits[v >> 6] |= std::uint64_t{1} << (v & 63);
+}
+
+void clearBit(std::vector<std::uint64_t> &bits, std::uint16_t v)
+{
+    bits[v >> 6] &= ~(std::uint64_t{1} << (v & 63));
+}
+
+std::uint32_t popcount(const std::vector<std::uint64_t> &bits)
+{
+    std::uint32_t n = 0;
+    for (auto word : bits)
+        n += static_cast<std::uint32_t>(std::popcount(word));
+    return n;
+}
+
+// 두 정렬된 목록을 key 순으로 훑으며 op 를 부른다.
+template <typename Both, typename OnlyA, typename OnlyB, typename C>
+void merge(const std::vector<C> &a,
+           const std::vector<C> &b,
+           Both both,
+           OnlyA only_a,
+           OnlyB only_b)
+{
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < a.size() && j < b.size())
+    {
+        if (a[i].key < b[j].key)
+            only_a(a[i++]);
+        else if (b[j].key < a[i].key)
+            only_b(b[j++]);
+        else
+            both(a[i++], b[j++]);
+    }
+    for (; i < a.size(); ++i)
+        only_a(a[i]);
+    for (; j < b.size(); ++j)
+        only_b(b[j]);
+}
+} // namespace
+
+bool RoaringBitmap::Container::add(std::uint16_t value)
+{
+    if (isBitmap())
+    {
+        if (testBit(bits, value))
+            return false;
+        setBit(bits, value);
+        ++cardinality;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), value);
+    if (it != array.end() && *it == value)
+        return false;
+    array.insert(it, value);
+    ++cardinality;
+    if (cardinality > ARRAY_MAX)
+        toBitmap();
+    return true;
+}
+
+bool RoaringBitmap::Container::remove(std::uint16_t value)
+{
+    if (isBitmap())
+    {
+        if (!testBit(bits, value))
+            return false;
+        clearBit(bits, value);
+        --cardinality;
+        if (cardinality <= ARRAY_MAX)
+            toArray();
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), value);
+    if (it == array.end() || *it != value)
+        return false;
+    array.erase(it);
+    --cardinality;
+    return true;
+}
+
+bool RoaringBitmap::Container::contains(std::uint16_t value) const
+{
+    if (isBitmap())
+        return testBit(bits, value);
+    return std::binary_search(array.begin(), array.end(), value);
+}
+
+void RoaringBitmap::Container::toBitmap()
+{
+    bits.assign(BITMAP_WORDS, 0);
+    for (auto v : array)
+        setBit(bits, v);
+    std::vector<std::uint16_t>().swap(array);
+}
+
+void RoaringBitmap::Container::toArray()
+{
+    std::vector<std::uint16_t> values;
+    values.reserve(cardinality);
+    for (std::uint32_t w = 0; w < bits.size(); ++w)
+    {
+        for (auto word = bits[w]; word != 0; word &= word - 1)
+            values.push_back(
+                static_cast<std::uint16_t>(w * 64 + std::countr_zero(word)));
+    }
+    array.swap(values);
+    std::vector<std::uint64_t>().swap(bits);
+}
+
+void RoaringBitmap::Container::fit()
+{
+    if (isBitmap() && cardinality <= ARRAY_MAX)
+        toArray();
+    else if (!isBitmap() && cardinality > ARRAY_MAX)
+        toBitmap();
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect(const Container &a,
+                                                  const Container &b)
+{
+    Container out;
+    out.key = a.key;
+    if (a.isBitmap() && b.isBitmap())
+    {
+        out.bits.resize(BITMAP_WORDS);
+        for (std::size_t w = 0; w < BITMAP_WORDS; ++w)
+            out.bits[w] = a.bits[w] & b.bits[w];
+        out.cardinality = popcount(out.bits);
+        out.fit();
+        return out;
+    }
+    if (a.isBitmap() || b.isBitmap())
+    {
+        const auto &array = a.isBitmap() ? b.array : a.array;
+        const auto &bitmap = a.isBitmap() ? a.bits : b.bits;
+        out.array.reserve(array.size());
+        for (auto v : array)
+        {
+            if (testBit(bitmap, v))
+                out.array.push_back(v);
+        }
+    }
+    else
+    {
+        out.array.reserve(std::min(a.array.size(), b.array.size()));
+        std::set_intersection(a.array.begin(),
+                              a.array.end(),
+                              b.array.begin(),
+                              b.array.end(),
+                              std::back_inserter(out.array));
+    }
+    out.cardinality = static_cast<std::uint32_t>(out.array.size());
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite(const Container &a,
+                                              const Container &b)
+{
+    Container out;
+    out.key = a.key;
+    if (!a.isBitmap() && !b.isBitmap() &&
+        a.cardinality + b.cardinality <= ARRAY_MAX)
+    {
+        out.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(),
+                       a.array.end(),
+                       b.array.begin(),
+                       b.array.end(),
+                       std::back_inserter(out.array));
+        out.cardinality = static_cast<std::uint32_t>(out.array.size());
+        return out;
+    }
+
+    out.bits.assign(BITMAP_WORDS, 0);
+    for (const auto *c : {&a, &b})
+    {
+        if (c->isBitmap())
+        {
+            for (std::size_t w = 0; w < BITMAP_WORDS; ++w)
+                out.bits[w] |= c->bits[w];
+        }
+        else
+        {
+            for (auto v : c->array)
+                setBit(out.bits, v);
+        }
+    }
+    out.cardinality = popcount(out.bits);
+    out.fit();
+    return out;
+}
+
+RoaringBitmap::Container RoaringBitmap::subtract(const Container &a,
+                                                 const Container &b)
+{
+    Container out;
+    out.key = a.key;
+    if (a.isBitmap())
+    {
+        out.bits = a.bits;
+        if (b.isBitmap())
+        {
+            for (std::size_t w = 0; w < BITMAP_WORDS; ++w)
+                out.bits[w] &= ~b.bits[w];
+        }
+        else
+        {
+            for (auto v : b.array)
+                clearBit(out.bits, v);
+        }
+        out.cardinality = popcount(out.bits);
+        out.fit();
+        return out;
+    }
+
+    out.array.reserve(a.array.size());
+    if (b.isBitmap())
+    {
+        for (auto v : a.array)
+        {
+            if (!testBit(b.bits, v))
+                out.array.push_back(v);
+        }
+    }
+    else
+    {
+        std::set_difference(a.array.begin(),
+                            a.array.end(),
+                            b.array.begin(),
+                            b.array.end(),
+                            std::back_inserter(out.array));
+    }
+    out.cardinality = static_cast<std::uint32_t>(out.array.size());
+    return out;
+}
+
+RoaringBitmap::Container *RoaringBitmap::find(std::uint16_t key)
+{
+    auto it = std::lower_bound(containers_.begin(),
+                               containers_.end(),
+                               key,
+                               [](const Container &c, std::uint16_t k)
+                               { return c.key < k; });
+    return it != containers_.end() && it->key == key ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container *RoaringBitmap::find(std::uint16_t key) const
+{
+    return const_cast<RoaringBitmap *>(this)->find(key);
+}
+
+bool RoaringBitmap::add(std::uint32_t value)
+{
+    auto it = std::lower_bound(containers_.begin(),
+                               containers_.end(),
+                               high(value),
+                               [](const Container &c, std::uint16_t k)
+                               { return c.key < k; });
+    if (it == containers_.end() || it->key != high(value))
+    {
+        it = containers_.insert(it, Container{});
+        it->key = high(value);
+    }
+    return it->add(low(value));
+}
+
+bool RoaringBitmap::remove(std::uint32_t value)
+{
+    Container *c = find(high(value));
+    if (!c || !c->remove(low(value)))
+        return false;
+    if (c->cardinality == 0)
+        containers_.erase(containers_.begin() + (c - containers_.data()));
+    return true;
+}
+
+bool RoaringBitmap::contains(std::uint32_t value) const
+{
+    const Container *c = find(high(value));
+    return c && c->contains(low(value));
+}
+
+std::uint64_t RoaringBitmap::cardinality() const
+{
+    std::uint64_t n = 0;
+    for (const auto &c : containers_)
+        n += c.cardinality;
+    return n;
+}
+
+std::size_t RoaringBitmap::memoryBytes() const
+{
+    std::size_t bytes = containers_.capacity() * sizeof(Container);
+    for (const auto &c : containers_)
+        bytes += c.array.capacity() * sizeof(std::uint16_t) +
+                 c.bits.capacity() * sizeof(std::uint64_t);
+    return bytes;
+}
+
+std::vector<std::uint32_t> RoaringBitmap::toVector() const
+{
+    std::vector<std::uint32_t> values;
+    values.reserve(cardinality());
+    forEach([&](std::uint32_t v) { values.push_back(v); });
+    return values;
+}
+
+RoaringBitmap operator&(const RoaringBitmap &a, const RoaringBitmap &b)
+{
+    RoaringBitmap out;
+    merge(
+        a.containers_,
+        b.containers_,
+        [&](const auto &x, const auto &y)
+        {
+            auto c = RoaringBitmap::intersect(x, y);
+            if (c.cardinality != 0)
+                out.containers_.push_back(std::move(c));
+        },
+        [](const auto &) {},
+        [](const auto &) {});
+    return out;
+}
+
+RoaringBitmap operator|(const RoaringBitmap &a, const RoaringBitmap &b)
+{
+    RoaringBitmap out;
+    out.containers_.reserve(a.containers_.size() + b.containers_.size());
+    merge(
+        a.containers_,
+        b.containers_,
+        [&](const auto &x, const auto &y)
+        { out.containers_.push_back(RoaringBitmap::unite(x, y)); },
+        [&](const auto &x) { out.containers_.push_back(x); },
+        [&](const auto &y) { out.containers_.push_back(y); });
+    return out;
+}
+
+RoaringBitmap operator-(const RoaringBitmap &a, const RoaringBitmap &b)
+{
+    RoaringBitmap out;
+    out.containers_.reserve(a.containers_.size());
+    merge(
+        a.containers_,
+        b.containers_,
+        [&](const auto &x, const auto &y)
+        {
+            auto c = RoaringBitmap::subtract(x, y);
+            if (c.cardinality != 0)
+                out.containers_.push_back(std::move(c));
+        },
+        [&](const auto &x) { out.containers_.push_back(x); },
+        [](const auto &) {});
+    return out;
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace banchoo::index
+{
+
+// 압축 비트맵 (Roaring 방식). 값의 상위 16비트로 묶음을 나누고, 묶음 안의
+// 값이 4096 개 이하면 정렬된 16비트 배열, 넘으면 65536 비트 비트맵으로
+// 둔다. 어느 쪽이든 묶음 하나는 8KB 를 넘지 않는다.
+class RoaringBitmap
+{
+ public:
+    // 새로 들어가거나 빠졌으면 true
+    bool add(std::uint32_t value);
+    bool remove(std::uint32_t value);
+    bool contains(std::uint32_t value) const;
+
+    std::uint64_t cardinality() const;
+    bool empty() const
+    {
+        return containers_.empty();
+    }
+    std::size_t memoryBytes() const;
+
+    friend RoaringBitmap operator&(const RoaringBitmap &a,
+                                   const RoaringBitmap &b);
+    friend RoaringBitmap operator|(const RoaringBitmap &a,
+                                   const RoaringBitmap &b);
+    // a 에서 b 를 뺀다 (and-not).
+    friend RoaringBitmap operator-(const RoaringBitmap &a,
+                                   const RoaringBitmap &b);
+
+    bool operator==(const RoaringBitmap &other) const = default;
+
+    // 오름차순으로 f(value) 를 부른다.
+    template <typename F>
+    void forEach(F &&f) const
+    {
+        for (const auto &c : containers_)
+        {
+            std::uint32_t base = static_cast<std::uint32_t>(c.key) << 16;
+            if (!c.isBitmap())
+            {
+                for (auto v : c.array)
+                    f(base | v);
+                continue;
+            }
+            for (std::uint32_t w = 0; w < c.bits.size(); ++w)
+            {
+                for (auto word = c.bits[w]; word != 0; word &= word - 1)
+                    f(base + w * 64 + std::countr_zero(word));
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> toVector() const;
+
+ private:
+    struct Container
+    {
+        std::uint16_t key = 0;
+        std::uint32_t cardinality = 0;
+        std::vector<std::uint16_t> array; // 배열 묶음의 정렬된 값
+        std::vector<std::uint64_t> bits;  // 비어 있지 않으면 비트맵 묶음
+
+        bool isBitmap() const
+        {
+            return !bits.empty();
+        }
+        bool operator==(const Container &other) const = default;
+
+        bool add(std::uint16_t value);
+        bool remove(std::uint16_t value);
+        bool contains(std::uint16_t value) const;
+        // 크기에 맞는 표현으로 바꾼다.
+        void toBitmap();
+        void toArray();
+        void fit();
+    };
+
+    static Container intersect(const Container &a, const Container &b);
+    static Container unite(const Container &a, const Container &b);
+    static Container subtract(const Container &a, const Container &b);
+
+    Container *find(std::uint16_t key);
+    const Container *find(std::uint16_t key) const;
+
+    std::vector<Container> containers_; // key 순
+};
+
+} // namespace banchoo::index
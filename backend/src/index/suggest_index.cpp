@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/suggest_index.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "index/roaring_bitmap.hpp"
+#include "note/note.hpp"
+
+namespace banchoo::index
+{
+
+namespace
+{
+constexpr std::size_t MAX_WORD = 32;   // 단어에서 보는 글자 수
+constexpr std::size_t MAX_TERMS = 1024; // 노트 하나에서 넣는 단어 수
+// 아래 비트맵 크기 합이 이보다 큰 노드는 최근 노트를 골라 둔다. 골라 두지
+// 않은 노드는 찾을 때 이만큼까지 훑는다.
+constexpr std::uint32_t HEAVY = 2048;
+constexpr std::size_t CACHE_SIZE = 4 * SuggestIndex::MAX_LIMIT;
+
+constexpr char32_t SYLLABLE_FIRST = 0xAC00; // 가
+constexpr char32_t SYLLABLE_LAST = 0xD7A3;  // 힣
+constexpr char32_t VOWEL_FIRST = 0x314F;    // ㅏ (호환 자모)
+
+// 음절의 초성, 종성 순번에 해당하는 호환 자모
+constexpr char32_t CHOSEONG[19] = {
+    0x3131, 0x3132, 0x3134, 0x3137, 0x3138, 0x3139, 0x3141,
+    0x3142, 0x3143, 0x3145, 0x3146, 0x3147, 0x3148, 0x3149,
+    0x314A, 0x314B, 0x314C, 0x314D, 0x314E};
+constexpr char32_t JONGSEONG[28] = {
+    0,      0x3131, 0x3132, 0x3133, 0x3134, 0x3135, 0x3136,
+    0x3137, 0x3139, 0x313A, 0x313B, 0x313C, 0x313D, 0x313E,
+    0x313F, 0x3140, 0x3141, 0x3142, 0x3144, 0x3145, 0x3146,
+    0x3147, 0x3148, 0x314A, 0x314B, 0x314C, 0x314D, 0x314E};
+
+// 자판에서 두 번 눌러 만드는 겹받침과 겹모음. 쌍자음은 한 번에 누르므로
+// 나누지 않는다.
+struct Compound
+{
+    char32_t jamo;
+    char32_t first;
+    char32_t second;
+};
+constexpr Compound COMPOUNDS[] = {
+    {0x3133, 0x3131, 0x3145}, // ㄳ
+    {0x3135, 0x3134, 0x3148}, // ㄵ
+    {0x3136, 0x3134, 0x314E}, // ㄶ
+    {0x313A, 0x3139, 0x3131}, // ㄺ
+    {0x313B, 0x3139, 0x3141}, // ㄻ
+    {0x313C, 0x3139, 0x3142}, // ㄼ
+    {0x313D, 0x3139, 0x3145}, // ㄽ
+    {0x313E, 0x3139, 0x314C}, // ㄾ
+    {0x313F, 0x3139, 0x314D}, // ㄿ
+    {0x3140, 0x3139, 0x314E}, // ㅀ
+    {0x3144, 0x3142, 0x3145}, // ㅄ
+    {0x3158, 0x3157, 0x314F}, // ㅘ
+    {0x3159, 0x3157, 0x3150}, // ㅙ
+    {0x315A, 0x3157, 0x3163}, // ㅚ
+    {0x315D, 0x315C, 0x3153}, // ㅝ
+    {0x315E, 0x315C, 0x3154}, // ㅞ
+    {0x315F, 0x315C, 0x3163}, // ㅟ
+    {0x3162, 0x3161, 0x3163}, // ㅢ
+};
+
+bool isSyllable(char32_t cp)
+{
+    return cp >= SYLLABLE_FIRST && cp <= SYLLABLE_LAST;
+}
+
+// 다음 코드 포인트를 읽는다. 깨진 바이트는 U+FFFD 로 보고 한 바이트 넘긴다.
+char32_t decode(std::string_view s, std::size_t &i)
+{
+    auto c = static_cast<unsigned char>(s[i++]);
+    if (c < 0x80)
+        return c;
+
+    std::size_t extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+    if (extra == 0 || i + extra > s.size())
+        return 0xFFFD;
+    char32_t cp = c & (0x3F >> extra);
+    for (std::size_t k = 0; k < extra; ++k)
+    {
+        auto next = static_cast<unsigned char>(s[i + k]);
+        if ((next & 0xC0) != 0x80)
+            return 0xFFFD;
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    i += extra;
+    return cp;
+}
+
+void appendUtf8(std::string &out, char32_t cp)
+{
+    if (cp < 0x80)
+    {
+        out.push_back(static_cast<char>(cp));
+    }
+    else if (cp < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+void appendJamo(std::string &out, char32_t jamo)
+{
+    for (const auto &c : COMPOUNDS)
+    {
+        if (c.jamo == jamo)
+        {
+            appendUtf8(out, c.first);
+            appendUtf8(out, c.second);
+            return;
+        }
+    }
+    appendUtf8(out, jamo);
+}
+
+// 글자 하나를 단어 형식으로 붙인다.
+void appendNormalized(std::string &out, char32_t cp)
+{
+    if (cp >= 'A' && cp <= 'Z')
+    {
+        out.push_back(static_cast<char>(cp - 'A' + 'a'));
+        return;
+    }
+    if (!isSyllable(cp))
+    {
+        appendJamo(out, cp);
+        return;
+    }
+    auto index = cp - SYLLABLE_FIRST;
+    appendJamo(out, CHOSEONG[index / 588]);
+    appendJamo(out, VOWEL_FIRST + (index % 588) / 28);
+    if (index % 28 != 0)
+        appendJamo(out, JONGSEONG[index % 28]);
+}
+
+// 영숫자와 비 ASCII 글자. 라틴-1 기호, 일반 구두점, CJK 기호는 뺀다.
+bool isWordChar(char32_t cp)
+{
+    if (cp < 0x80)
+    {
+        return (cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') ||
+               (cp >= 'A' && cp <= 'Z');
+    }
+    if (cp < 0xC0)
+        return false;
+    if (cp >= 0x2000 && cp <= 0x206F)
+        return false;
+    if (cp >= 0x3000 && cp <= 0x303F)
+        return false;
+    return cp != 0xFFFD;
+}
+
+// text 를 단어로 나눠 f(word) 를 부른다. 단어는 앞 MAX_WORD 글자만 본다.
+// f 가 false 를 돌려주면 멈춘다.
+template <typename F>
+void forEachWord(std::string_view text, F &&f)
+{
+    std::u32string word;
+    std::size_t i = 0;
+    while (i < text.size())
+    {
+        auto cp = decode(text, i);
+        if (isWordChar(cp))
+        {
+            if (word.size() < MAX_WORD)
+                word.push_back(cp);
+            continue;
+        }
+        if (!word.empty())
+        {
+            if (!f(word))
+                return;
+            word.clear();
+        }
+    }
+    if (!word.empty())
+        f(word);
+}
+
+template <typename E>
+bool newer(const E &a, const E &b)
+{
+    return a.at != b.at ? a.at > b.at : a.id > b.id;
+}
+
+// 최근 순으로 정렬하고 같은 노트를 하나만 남긴다. 노트마다 시각이 하나라
+// 같은 노트는 정렬하면 붙는다.
+template <typename E>
+void sortEntries(std::vector<E> &entries)
+{
+    std::sort(entries.begin(), entries.end(), newer<E>);
+    entries.erase(std::unique(entries.begin(),
+                              entries.end(),
+                              [](const E &a, const E &b)
+                              { return a.id == b.id; }),
+                  entries.end());
+}
+} // namespace
+
+std::vector<std::string> suggestTerms(std::string_view content,
+                                      std::span<const std::string> tags)
+{
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> terms;
+    auto add = [&](std::string term)
+    {
+        if (terms.size() < MAX_TERMS && seen.insert(term).second)
+            terms.push_back(std::move(term));
+    };
+
+    for (const auto &tag : tags)
+    {
+        std::string term;
+        std::size_t i = 0;
+        while (i < tag.size())
+            appendNormalized(term, decode(tag, i));
+        add(std::move(term));
+    }
+
+    forEachWord(content,
+                [&](const std::u32string &word)
+                {
+                    std::string term;
+                    std::size_t syllables = 0;
+                    for (auto cp : word)
+                    {
+                        appendNormalized(term, cp);
+                        syllables += isSyllable(cp) ? 1 : 0;
+                    }
+                    add(std::move(term));
+
+                    if (syllables >= 2)
+                    {
+                        std::string initials;
+                        for (auto cp : word)
+                        {
+                            if (isSyllable(cp))
+                                appendUtf8(initials,
+                                           CHOSEONG[(cp - SYLLABLE_FIRST) /
+                                                    588]);
+                            else
+                                appendNormalized(initials, cp);
+                        }
+                        add(std::move(initials));
+                    }
+                    return terms.size() < MAX_TERMS;
+                });
+
+    std::sort(terms.begin(), terms.end());
+    return terms;
+}
+
+bool normalizePrefix(std::string_view prefix, std::string &out)
+{
+    out.clear();
+    std::size_t words = 0;
+    forEachWord(prefix,
+                [&](const std::u32string &word)
+                {
+                    if (++words == 1)
+                    {
+                        for (auto cp : word)
+                            appendNormalized(out, cp);
+                    }
+                    return words == 1;
+                });
+    return words == 1;
+}
+
+void SuggestIndex::put(note::Id id,
+                       note::TimePoint updated_at,
+                       std::span<const std::string> terms)
+{
+    auto value = static_cast<std::uint32_t>(id);
+    std::vector<std::uint32_t> dirty;
+    auto &note = notes_[value];
+    if (!note.terms.empty())
+        unlink(value, note, dirty);
+
+    note.at = updated_at.time_since_epoch().count();
+    note.terms.clear();
+    for (const auto &term : terms)
+        note.terms.push_back(termId(term));
+    std::sort(note.terms.begin(), note.terms.end());
+    note.terms.erase(std::unique(note.terms.begin(), note.terms.end()),
+                     note.terms.end());
+
+    link(value, note, dirty);
+    settle(dirty);
+}
+
+void SuggestIndex::touch(note::Id id, note::TimePoint updated_at)
+{
+    auto it = notes_.find(static_cast<std::uint32_t>(id));
+    auto at = updated_at.time_since_epoch().count();
+    if (it == notes_.end() || it->second.at == at)
+        return;
+
+    // 비트맵은 그대로이고 골라 둔 목록에서 자리만 옮긴다.
+    auto &note = it->second;
+    Entry before{note.at, it->first};
+    Entry after{at, it->first};
+    auto path = pathNodes(note);
+    for (auto n : path)
+    {
+        if (nodes_[n].cache == NONE)
+            continue;
+        auto &cache = caches_[nodes_[n].cache];
+        auto &entries = cache.entries;
+        auto pos = std::lower_bound(
+            entries.begin(), entries.end(), before, newer<Entry>);
+        if (pos != entries.end() && pos->id == before.id)
+            entries.erase(pos);
+        pos = std::lower_bound(
+            entries.begin(), entries.end(), after, newer<Entry>);
+        if (cache.complete || pos != entries.end())
+            entries.insert(pos, after);
+        if (entries.size() > CACHE_SIZE)
+        {
+            entries.pop_back();
+            cache.complete = false;
+        }
+    }
+    note.at = at;
+    settle(path);
+}
+
+void SuggestIndex::remove(note::Id id)
+{
+    auto it = notes_.find(static_cast<std::uint32_t>(id));
+    if (it == notes_.end())
+        return;
+
+    std::vector<std::uint32_t> dirty;
+    unlink(it->first, it->second, dirty);
+    notes_.erase(it);
+    settle(dirty);
+}
+
+std::vector<note::Id> SuggestIndex::suggest(std::string_view prefix,
+                                            std::size_t limit) const
+{
+    std::vector<note::Id> ids;
+    limit = std::min(limit, MAX_LIMIT);
+    if (limit == 0 || prefix.empty())
+        return ids;
+    auto n = findNode(prefix);
+    if (n == NONE)
+        return ids;
+
+    if (nodes_[n].cache != NONE)
+    {
+        const auto &entries = caches_[nodes_[n].cache].entries;
+        for (std::size_t i = 0; i < entries.size() && i < limit; ++i)
+            ids.push_back(static_cast<note::Id>(entries[i].id));
+        return ids;
+    }
+
+    // 골라 두지 않은 노드는 아래 노트가 HEAVY 개 이하다.
+    std::vector<Entry> entries;
+    collect(n, entries);
+    sortEntries(entries);
+    for (std::size_t i = 0; i < entries.size() && i < limit; ++i)
+        ids.push_back(static_cast<note::Id>(entries[i].id));
+    return ids;
+}
+
+std::size_t SuggestIndex::memoryBytes() const
+{
+    auto bytes = nodes_.capacity() * sizeof(Node) +
+                 term_nodes_.capacity() * sizeof(std::uint32_t) +
+                 caches_.capacity() * sizeof(Cache);
+    for (const auto &p : postings_)
+        bytes += sizeof(p) + p.memoryBytes();
+    for (const auto &c : caches_)
+        bytes += c.entries.capacity() * sizeof(Entry);
+    for (const auto &[id, note] : notes_)
+    {
+        bytes += sizeof(id) + sizeof(note) + 2 * sizeof(void *) +
+                 note.terms.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+std::uint32_t SuggestIndex::findNode(std::string_view key) const
+{
+    std::uint32_t n = 0;
+    for (auto c : key)
+    {
+        auto child = nodes_[n].child;
+        while (child != NONE && nodes_[child].label != c)
+            child = nodes_[child].sibling;
+        if (child == NONE)
+            return NONE;
+        n = child;
+    }
+    return n;
+}
+
+std::uint32_t SuggestIndex::termId(std::string_view term)
+{
+    std::uint32_t n = 0;
+    for (auto c : term)
+    {
+        auto child = nodes_[n].child;
+        while (child != NONE && nodes_[child].label != c)
+            child = nodes_[child].sibling;
+        if (child == NONE)
+        {
+            child = static_cast<std::uint32_t>(nodes_.size());
+            Node node;
+            node.parent = n;
+            node.sibling = nodes_[n].child;
+            node.label = c;
+            nodes_.push_back(node);
+            nodes_[n].child = child;
+        }
+        n = child;
+    }
+    if (nodes_[n].term == NONE)
+    {
+        nodes_[n].term = static_cast<std::uint32_t>(term_nodes_.size());
+        term_nodes_.push_back(n);
+        postings_.emplace_back();
+    }
+    return nodes_[n].term;
+}
+
+std::vector<std::uint32_t>
+SuggestIndex::pathNodes(const NoteTerms &note) const
+{
+    std::vector<std::uint32_t> path;
+    for (auto t : note.terms)
+    {
+        for (auto n = term_nodes_[t]; n != 0; n = nodes_[n].parent)
+            path.push_back(n);
+    }
+    std::sort(path.begin(), path.end());
+    path.erase(std::unique(path.begin(), path.end()), path.end());
+    return path;
+}
+
+void SuggestIndex::link(std::uint32_t id,
+                        const NoteTerms &note,
+                        std::vector<std::uint32_t> &dirty)
+{
+    for (auto t : note.terms)
+    {
+        postings_[t].add(id);
+        for (auto n = term_nodes_[t]; n != 0; n = nodes_[n].parent)
+            ++nodes_[n].postings;
+    }
+
+    // 단어 여러 개가 같은 노드를 지나도 노트는 한 번만 넣는다.
+    Entry entry{note.at, id};
+    for (auto n : pathNodes(note))
+    {
+        dirty.push_back(n);
+        if (nodes_[n].cache == NONE)
+            continue;
+        auto &cache = caches_[nodes_[n].cache];
+        auto &entries = cache.entries;
+        auto pos = std::lower_bound(
+            entries.begin(), entries.end(), entry, newer<Entry>);
+        // 다 담지 않은 목록의 끝보다 오래된 노트는 목록 밖에도 더 있다.
+        if (!cache.complete && pos == entries.end())
+            continue;
+        entries.insert(pos, entry);
+        if (entries.size() > CACHE_SIZE)
+        {
+            entries.pop_back();
+            cache.complete = false;
+        }
+    }
+}
+
+void SuggestIndex::unlink(std::uint32_t id,
+                          const NoteTerms &note,
+                          std::vector<std::uint32_t> &dirty)
+{
+    for (auto t : note.terms)
+    {
+        postings_[t].remove(id);
+        for (auto n = term_nodes_[t]; n != 0; n = nodes_[n].parent)
+            --nodes_[n].postings;
+    }
+
+    Entry entry{note.at, id};
+    for (auto n : pathNodes(note))
+    {
+        dirty.push_back(n);
+        if (nodes_[n].cache == NONE)
+            continue;
+        auto &entries = caches_[nodes_[n].cache].entries;
+        auto pos = std::lower_bound(
+            entries.begin(), entries.end(), entry, newer<Entry>);
+        if (pos != entries.end() && pos->id == id)
+            entries.erase(pos);
+    }
+}
+
+void SuggestIndex::settle(std::vector<std::uint32_t> &dirty)
+{
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    for (auto n : dirty)
+    {
+        const auto &node = nodes_[n];
+        if (node.cache == NONE)
+        {
+            if (node.postings > HEAVY)
+                buildCache(n);
+            continue;
+        }
+        // 지워져서 모자라면 아래 노트를 다시 훑는다. 새 노트는 늘 맨 앞에
+        // 들어가므로 최근 노트가 연달아 지워질 때만 생긴다.
+        const auto &cache = caches_[node.cache];
+        if (!cache.complete && cache.entries.size() < MAX_LIMIT)
+            buildCache(n);
+    }
+}
+
+void SuggestIndex::buildCache(std::uint32_t node)
+{
+    Cache cache;
+    collect(node, cache.entries);
+    sortEntries(cache.entries);
+    cache.complete = cache.entries.size() <= CACHE_SIZE;
+    if (!cache.complete)
+        cache.entries.resize(CACHE_SIZE);
+    cache.entries.shrink_to_fit();
+
+    if (nodes_[node].cache == NONE)
+    {
+        nodes_[node].cache = static_cast<std::uint32_t>(caches_.size());
+        caches_.push_back(std::move(cache));
+        return;
+    }
+    caches_[nodes_[node].cache] = std::move(cache);
+}
+
+void SuggestIndex::collect(std::uint32_t node, std::vector<Entry> &out) const
+{
+    std::vector<std::uint32_t> stack{node};
+    while (!stack.empty())
+    {
+        auto n = stack.back();
+        stack.pop_back();
+        if (nodes_[n].term != NONE)
+        {
+            postings_[nodes_[n].term].forEach(
+                [&](std::uint32_t id)
+                { out.push_back({notes_.find(id)->second.at, id}); });
+        }
+        for (auto c = nodes_[n].child; c != NONE; c = nodes_[c].sibling)
+            stack.push_back(c);
+    }
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "index/roaring_bitmap.hpp"
+#include "note/note.hpp"
+
+namespace banchoo::index
+{
+
+// 자동 완성 색인에 넣을 단어. 본문을 단어로 나누고 태그는 통째로 한
+// 단어로 본다. ASCII 는 소문자로, 한글 음절은 자판에서 누르는 순서대로
+// 자모로 풀어 쓴다 (한 → ㅎㅏㄴ, 닭 → ㄷㅏㄹㄱ). 입력 중인 음절도 앞부분이
+// 맞는다. 두 음절 이상인 한글 단어는 초성만 모은 단어도 넣는다 (ㅎㄱ).
+// 정렬되고 중복 없는 목록을 돌려준다.
+std::vector<std::string> suggestTerms(std::string_view content,
+                                      std::span<const std::string> tags);
+
+// 입력 중인 접두사를 단어와 같은 방식으로 바꾼다. 비었거나 한 단어가
+// 아니면 false
+bool normalizePrefix(std::string_view prefix, std::string &out);
+
+// 단어 접두사로 노트를 찾는 바이트 트라이. 단어마다 노트 id 비트맵을 두고,
+// 아래에 노트가 많은 노드는 updated_at 이 최근인 노트를 미리 골라 둔다.
+// 그래서 짧은 접두사도 비트맵 전체를 훑지 않는다. 동기화는 부르는 쪽이
+// 맡는다.
+class SuggestIndex
+{
+ public:
+    static constexpr std::size_t MAX_LIMIT = 50;
+
+    // terms 는 suggestTerms 의 결과. 이미 있는 노트면 단어를 바꾼다.
+    void put(note::Id id,
+             note::TimePoint updated_at,
+             std::span<const std::string> terms);
+    // 단어는 그대로 두고 updated_at 만 바꾼다.
+    void touch(note::Id id, note::TimePoint updated_at);
+    void remove(note::Id id);
+
+    // prefix (normalizePrefix 의 결과) 로 시작하는 단어가 있는 노트를
+    // updated_at 이 최근인 순서로 limit (MAX_LIMIT 이하) 개
+    std::vector<note::Id> suggest(std::string_view prefix,
+                                  std::size_t limit) const;
+
+    std::size_t noteCount() const
+    {
+        return notes_.size();
+    }
+    std::size_t termCount() const
+    {
+        return term_nodes_.size();
+    }
+    std::size_t memoryBytes() const;
+
+ private:
+    static constexpr std::uint32_t NONE = UINT32_MAX;
+
+    // 형제는 연결 목록으로 잇는다. 자식 수가 적어 찾는 비용보다 노드
+    // 크기를 줄이는 편이 낫다.
+    struct Node
+    {
+        std::uint32_t parent = NONE;
+        std::uint32_t child = NONE;   // 첫 자식
+        std::uint32_t sibling = NONE; // 다음 형제
+        std::uint32_t term = NONE;    // 이 노드에서 끝나는 단어
+        std::uint32_t cache = NONE;   // caches_ 의 자리
+        std::uint32_t postings = 0;   // 아래 단어들의 비트맵 크기 합
+        char label = 0;
+    };
+
+    struct Entry
+    {
+        std::int64_t at; // updated_at 의 rep
+        std::uint32_t id;
+    };
+
+    // 노드 아래 노트 중 최근 것부터 CACHE_SIZE 개. complete 면 아래 노트를
+    // 모두 담고 있다. 아니면 MAX_LIMIT 개보다 적어지기 전에 다시 채운다.
+    struct Cache
+    {
+        std::vector<Entry> entries;
+        bool complete = false;
+    };
+
+    struct NoteTerms
+    {
+        std::int64_t at = 0;
+        std::vector<std::uint32_t> terms; // 단어 id, 오름차순
+    };
+
+    std::uint32_t findNode(std::string_view key) const;
+    std::uint32_t termId(std::string_view term);
+    // 노트의 단어들이 지나는 노드 (루트 제외, 중복 없음)
+    std::vector<std::uint32_t> pathNodes(const NoteTerms &note) const;
+
+    void link(std::uint32_t id,
+              const NoteTerms &note,
+              std::vector<std::uint32_t> &dirty);
+    void unlink(std::uint32_t id,
+                const NoteTerms &note,
+                std::vector<std::uint32_t> &dirty);
+    // 바뀐 노드 중 캐시가 필요해졌거나 모자라진 노드를 채운다.
+    void settle(std::vector<std::uint32_t> &dirty);
+    void buildCache(std::uint32_t node);
+
+    // node 아래 모든 노트 (중복 포함)
+    void collect(std::uint32_t node, std::vector<Entry> &out) const;
+
+    std::vector<Node> nodes_{Node{}}; // 0 은 루트
+    std::vector<std::uint32_t> term_nodes_;
+    std::vector<RoaringBitmap> postings_; // 단어 id 순
+    std::vector<Cache> caches_;
+    std::unordered_map<std::uint32_t, NoteTerms> notes_;
+};
+
+} // namespace banchoo::index
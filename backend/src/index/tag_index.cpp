@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/tag_index.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "index/roaring_bitmap.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+
+namespace banchoo::index
+{
+
+namespace
+{
+std::uint32_t toValue(note::Id id)
+{
+    return static_cast<std::uint32_t>(id);
+}
+
+// 평가 스택의 항목. 태그 비트맵은 복사하지 않고 가리키기만 한다.
+struct Operand
+{
+    const RoaringBitmap *ref = nullptr;
+    RoaringBitmap owned;
+
+    const RoaringBitmap &get() const
+    {
+        return ref ? *ref : owned;
+    }
+};
+} // namespace
+
+void TagIndex::add(note::Id id,
+                   note::NoteType type,
+                   std::span<const std::string> tags)
+{
+    auto value = toValue(id);
+    all_.add(value);
+    types_[static_cast<std::size_t>(type)].add(value);
+    for (const auto &tag : tags)
+        tags_[tag].add(value);
+}
+
+void TagIndex::remove(note::Id id)
+{
+    auto value = toValue(id);
+    if (!all_.remove(value))
+        return;
+    for (auto &bitmap : types_)
+        bitmap.remove(value);
+    removeTags(value);
+}
+
+void TagIndex::setTags(note::Id id, std::span<const std::string> tags)
+{
+    auto value = toValue(id);
+    if (!all_.contains(value))
+        return;
+    removeTags(value);
+    for (const auto &tag : tags)
+        tags_[tag].add(value);
+}
+
+void TagIndex::removeTags(std::uint32_t value)
+{
+    // 노트 -> 태그 역색인을 두지 않는 대신 태그를 모두 훑는다. 태그 수는
+    // 수백 개 수준이라 비트맵마다 묶음 하나를 찾는 비용이다.
+    for (auto it = tags_.begin(); it != tags_.end();)
+    {
+        it->second.remove(value);
+        if (it->second.empty())
+            it = tags_.erase(it);
+        else
+            ++it;
+    }
+}
+
+RoaringBitmap TagIndex::evaluate(const TagQuery &query,
+                                 std::optional<note::NoteType> type) const
+{
+    static const RoaringBitmap EMPTY;
+
+    std::vector<Operand> stack;
+    stack.reserve(query.steps().size());
+    for (const auto &step : query.steps())
+    {
+        switch (step.op)
+        {
+        case TagQuery::Op::TAG:
+        {
+            auto it = tags_.find(step.tag);
+            stack.push_back({it != tags_.end() ? &it->second : &EMPTY, {}});
+            break;
+        }
+        case TagQuery::Op::NOT:
+            stack.back() = {nullptr, all_ - stack.back().get()};
+            break;
+        default:
+        {
+            Operand right = std::move(stack.back());
+            stack.pop_back();
+            const auto &left = stack.back().get();
+            RoaringBitmap result;
+            if (step.op == TagQuery::Op::AND)
+                result = left & right.get();
+            else if (step.op == TagQuery::Op::OR)
+                result = left | right.get();
+            else
+                result = left - right.get();
+            stack.back() = {nullptr, std::move(result)};
+            break;
+        }
+        }
+    }
+
+    if (stack.empty())
+        return {};
+    if (type)
+        return stack.back().get() & types_[static_cast<std::size_t>(*type)];
+    if (stack.back().ref)
+        return *stack.back().ref;
+    return std::move(stack.back().owned);
+}
+
+std::size_t TagIndex::memoryBytes() const
+{
+    std::size_t bytes = all_.memoryBytes();
+    for (const auto &bitmap : types_)
+        bytes += bitmap.memoryBytes();
+    for (const auto &[tag, bitmap] : tags_)
+        bytes += tag.capacity() + bitmap.memoryBytes();
+    return bytes;
+}
+
+} // namespace banchoo::index
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "index/roaring_bitmap.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+
+namespace banchoo::index
+{
+
+// 태그마다, 종류마다 노트 id 비트맵을 둔다. 검색식은 비트맵의 교집합,
+// 합집합, 차집합으로 푼다. 동기화는 부르는 쪽이 맡는다.
+class TagIndex
+{
+ public:
+    void add(note::Id id,
+             note::NoteType type,
+             std::span<const std::string> tags);
+    // 모든 비트맵에서 id 를 뺀다.
+    void remove(note::Id id);
+    // 종류는 그대로 두고 태그만 바꾼다.
+    void setTags(note::Id id, std::span<const std::string> tags);
+
+    // type 이 있으면 그 종류의 노트만. NOT 은 전체 노트에 대한 여집합이다.
+    RoaringBitmap evaluate(const TagQuery &query,
+                           std::optional<note::NoteType> type) const;
+
+    std::size_t tagCount() const
+    {
+        return tags_.size();
+    }
+    std::size_t memoryBytes() const;
+
+ private:
+    void removeTags(std::uint32_t value);
+
+    RoaringBitmap all_;
+    std::array<RoaringBitmap, 3> types_; // NoteType 값 순
+    std::map<std::string, RoaringBitmap, std::less<>> tags_;
+};
+
+} // namespace banchoo::index
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "index/tag_query.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "note/note.hpp"
+
+namespace banchoo::index
+{
+
+namespace
+{
+// 괄호를 이만큼 넘게 겹치면 거절한다 (재귀 깊이 제한).
+constexpr int MAX_DEPTH = 32;
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == ',';
+}
+
+bool isDelimiter(char c)
+{
+    return isSpace(c) || c == '(' || c == ')';
+}
+
+// 재귀 하강 파서. or := and ("OR" and)*, and := unary (["AND"] unary)*,
+// unary := "NOT" unary | "(" or ")" | 태그
+class Parser
+{
+ public:
+    Parser(std::string_view text, std::vector<TagQuery::Step> &out)
+        : text_(text), out_(out)
+    {
+    }
+
+    bool parse(std::string &error)
+    {
+        advance();
+        if (token_.empty())
+            return fail(error, "tags expression is empty");
+        if (!parseOr(error))
+            return false;
+        if (!token_.empty())
+            return fail(error, "unexpected ')'");
+        return true;
+    }
+
+ private:
+    bool parseOr(std::string &error)
+    {
+        if (!parseAnd(error))
+            return false;
+        while (token_ == "OR")
+        {
+            advance();
+            if (!parseAnd(error))
+                return false;
+            out_.push_back({TagQuery::Op::OR, {}});
+        }
+        return true;
+    }
+
+    bool parseAnd(std::string &error)
+    {
+        if (!parseUnary(error))
+            return false;
+        while (!token_.empty() && token_ != "OR" && token_ != ")")
+        {
+            if (token_ == "AND")
+                advance();
+            auto op = TagQuery::Op::AND;
+            if (token_ == "NOT")
+            {
+                advance();
+                op = TagQuery::Op::AND_NOT;
+            }
+            if (!parseUnary(error))
+                return false;
+            out_.push_back({op, {}});
+        }
+        return true;
+    }
+
+    bool parseUnary(std::string &error)
+    {
+        if (token_ == "NOT")
+        {
+            advance();
+            if (!parseUnary(error))
+                return false;
+            out_.push_back({TagQuery::Op::NOT, {}});
+            return true;
+        }
+        if (token_ == "(")
+        {
+            if (++depth_ > MAX_DEPTH)
+                return fail(error, "tags expression is nested too deeply");
+            advance();
+            if (!parseOr(error))
+                return false;
+            if (token_ != ")")
+                return fail(error, "missing ')'");
+            --depth_;
+            advance();
+            return true;
+        }
+        if (token_.empty())
+            return fail(error, "tags expression ends unexpectedly");
+        if (token_ == ")" || token_ == "AND" || token_ == "OR")
+            return fail(error, "expected a tag");
+        if (!note::valid_tag(token_))
+            return fail(error, "invalid tag");
+        out_.push_back({TagQuery::Op::TAG, std::string(token_)});
+        advance();
+        return true;
+    }
+
+    void advance()
+    {
+        while (pos_ < text_.size() && isSpace(text_[pos_]))
+            ++pos_;
+        auto begin = pos_;
+        if (pos_ < text_.size() && (text_[pos_] == '(' || text_[pos_] == ')'))
+            ++pos_;
+        else
+        {
+            while (pos_ < text_.size() && !isDelimiter(text_[pos_]))
+                ++pos_;
+        }
+        token_ = text_.substr(begin, pos_ - begin);
+    }
+
+    bool fail(std::string &error, const char *message)
+    {
+        error = message;
+        return false;
+    }
+
+    std::string_view text_;
+    std::vector<TagQuery::Step> &out_;
+    std::size_t pos_ = 0;
+    std::string_view token_;
+    int depth_ = 0;
+};
+} // namespace
+
+std::optional<TagQuery> TagQuery::parse(std::string_view text,
+                                        std::string &error)
+{
+    TagQuery query;
+    Parser parser(text, query.steps_);
+    if (!parser.parse(error))
+        return std::nullopt;
+    return query;
+}
+
+bool TagQuery::matches(std::span<const std::string> tags) const
+{
+    std::vector<bool> stack;
+    stack.reserve(steps_.size());
+    for (const auto &step : steps_)
+    {
+        if (step.op == Op::TAG)
+        {
+            stack.push_back(
+                std::binary_search(tags.begin(), tags.end(), step.tag));
+            continue;
+        }
+        if (step.op == Op::NOT)
+        {
+            stack.back() = !stack.back();
+            continue;
+        }
+        bool right = stack.back();
+        stack.pop_back();
+        bool left = stack.back();
+        if (step.op == Op::AND)
+            stack.back() = left && right;
+        else if (step.op == Op::OR)
+            stack.back() = left || right;
+        else
+            stack.back() = left && !right;
+    }
+    return !stack.empty() && stack.back();
+}
+
+} // namespace banchoo::index
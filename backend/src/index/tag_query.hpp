@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace banchoo::index
+{
+
+// 태그 불리언 식. 예: "work AND urgent NOT done", "(a OR b),NOT c"
+// 연산자는 대문자 AND, OR, NOT 과 괄호이고, 공백이나 ',' 로 이어 쓴 항은
+// AND 다. 우선순위는 NOT > AND > OR.
+class TagQuery
+{
+ public:
+    enum class Op : std::uint8_t
+    {
+        TAG,
+        AND,
+        OR,
+        NOT,
+        AND_NOT, // a AND NOT b 를 여집합 없이 뺄셈으로 푼다
+    };
+
+    struct Step
+    {
+        Op op;
+        std::string tag; // TAG 일 때만
+    };
+
+    // 잘못된 식이면 error 에 이유를 쓰고 nullopt
+    static std::optional<TagQuery> parse(std::string_view text,
+                                         std::string &error);
+
+    // tags 는 정렬돼 있어야 한다 (note::normalize_tags).
+    bool matches(std::span<const std::string> tags) const;
+
+    // 후위 표기 순서
+    const std::vector<Step> &steps() const
+    {
+        return steps_;
+    }
+
+ private:
+    std::vector<Step> steps_;
+};
+
+} // namespace banchoo::index
@@ -16,15 +16,17 @@ int main() noexcept
     std::ifstream ifs("config.json");
     nlohmann::json config = nlohmann::json::parse(ifs);
 
-    BANCHOO_TRACE("Banchoo logger creating...");
-    banchoo::Logger::init(config["log_level"],
-                          config.value("log_file", "")); // 로거 초기화
+    // 로거를 쓰기 전에 초기화해야 설정이 적용된다.
+    banchoo::Logger::init(banchoo::LogOptions::fromConfig(config));
 
-    BANCHOO_TRACE("Banchoo server creating...");
-    auto app = banchoo::app::AppFactory::create(config["app"]);
+    {
+        BANCHOO_TRACE("Banchoo server creating...");
+        auto app = banchoo::app::AppFactory::create(config["app"]);
 
-    BANCHOO_TRACE("Banchoo server running...");
-    app->run(); // 서버 실행
+        BANCHOO_TRACE("Banchoo server running...");
+        app->run(); // 서버 실행
+    } // 앱의 스레드와 소멸자가 남기는 로그까지 끝난 뒤에 로거를 닫는다.
 
+    banchoo::Logger::shutdown(); // 비동기 큐 비우기
     return 0;
 }
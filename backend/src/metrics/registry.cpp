@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "metrics/registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace banchoo::metrics
+{
+
+namespace
+{
+constexpr std::size_t MAX_COUNTERS = 64 * 64;
+constexpr std::size_t MAX_HISTOGRAMS = 64 * 8;
+
+// 단일 작성자이므로 원자적 덧셈 대신 load/store 로 충분하다.
+inline void addRelaxed(std::atomic<std::uint64_t> &cell, std::uint64_t n)
+{
+    cell.store(cell.load(std::memory_order_relaxed) + n,
+               std::memory_order_relaxed);
+}
+
+void appendSeries(std::string &out,
+                  std::string_view name,
+                  std::string_view suffix,
+                  std::string_view labels,
+                  std::string_view extra_label,
+                  std::uint64_t value)
+{
+    out.append(name).append(suffix);
+    if (!labels.empty() || !extra_label.empty())
+    {
+        out.push_back('{');
+        out.append(labels);
+        if (!labels.empty() && !extra_label.empty())
+            out.push_back(',');
+        out.append(extra_label);
+        out.push_back('}');
+    }
+    out.push_back(' ');
+    out.append(std::to_string(value));
+    out.push_back('\n');
+}
+
+void appendHeader(std::string &out,
+                  std::string_view name,
+                  std::string_view help,
+                  std::string_view type,
+                  std::string &last_family)
+{
+    if (last_family == name)
+        return;
+    last_family = name;
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+} // namespace
+
+std::size_t bucketIndex(std::uint64_t value)
+{
+    if (value < 4)
+        return static_cast<std::size_t>(value);
+
+    auto exponent = static_cast<std::size_t>(63 - std::countl_zero(value));
+    auto index = 4 * (exponent - 1) + ((value >> (exponent - 2)) & 3);
+    return std::min(index, HISTOGRAM_BUCKETS - 1);
+}
+
+std::uint64_t bucketUpperBound(std::size_t index)
+{
+    if (index < 4)
+        return index;
+
+    auto exponent = index / 4 + 1;
+    auto sub = index % 4;
+    return ((std::uint64_t{5} + sub) << (exponent - 2)) - 1;
+}
+
+std::string label(std::string_view name, std::string_view value)
+{
+    std::string out;
+    out.reserve(name.size() + value.size() + 3);
+    out.append(name).append("=\"");
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        default:
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+    return out;
+}
+
+void Counter::inc(std::uint64_t n) const
+{
+    if (slot_ == UINT32_MAX)
+        return;
+    addRelaxed(Registry::counterCell(slot_), n);
+}
+
+void Histogram::observe(std::uint64_t value) const
+{
+    if (slot_ == UINT32_MAX)
+        return;
+    auto &cell = Registry::histogramCell(slot_);
+    addRelaxed(cell.buckets[bucketIndex(value)], 1);
+    addRelaxed(cell.count, 1);
+    addRelaxed(cell.sum, value);
+}
+
+Registry &Registry::instance()
+{
+    // 스레드 종료 시점의 기록과 경합하지 않도록 일부러 해제하지 않는다.
+    static Registry *registry = new Registry();
+    return *registry;
+}
+
+Registry::Shard &Registry::localShard()
+{
+    thread_local Shard *shard = nullptr;
+    if (!shard)
+    {
+        auto &registry = instance();
+        std::lock_guard<std::mutex> lock(registry.mutex_);
+        registry.shards_.push_back(std::make_unique<Shard>());
+        shard = registry.shards_.back().get();
+    }
+    return *shard;
+}
+
+std::atomic<std::uint64_t> &Registry::counterCell(std::uint32_t slot)
+{
+    auto &chunk_ptr = localShard().counters[slot / COUNTER_CHUNK];
+    auto *chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (!chunk)
+    {
+        chunk = new CounterChunk();
+        chunk_ptr.store(chunk, std::memory_order_release);
+    }
+    return chunk->cells[slot % COUNTER_CHUNK];
+}
+
+Registry::HistogramCell &Registry::histogramCell(std::uint32_t slot)
+{
+    auto &chunk_ptr = localShard().histograms[slot / HISTOGRAM_CHUNK];
+    auto *chunk = chunk_ptr.load(std::memory_order_acquire);
+    if (!chunk)
+    {
+        chunk = new HistogramChunk();
+        chunk_ptr.store(chunk, std::memory_order_release);
+    }
+    return chunk->cells[slot % HISTOGRAM_CHUNK];
+}
+
+std::uint32_t Registry::registerMetric(std::vector<MetricInfo> &metrics,
+                                       std::size_t capacity,
+                                       std::string_view name,
+                                       std::string_view help,
+                                       std::string_view labels)
+{
+    std::string key;
+    key.append(&metrics == &counters_ ? "c:" : "h:")
+        .append(name)
+        .append("{")
+        .append(labels);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end())
+        return it->second;
+
+    if (metrics.size() >= capacity)
+        return UINT32_MAX;
+
+    auto slot = static_cast<std::uint32_t>(metrics.size());
+    metrics.push_back(
+        {std::string(name), std::string(help), std::string(labels)});
+    index_.emplace(std::move(key), slot);
+    return slot;
+}
+
+Counter Registry::counter(std::string_view name,
+                          std::string_view help,
+                          std::string_view labels)
+{
+    return Counter(
+        registerMetric(counters_, MAX_COUNTERS, name, help, labels));
+}
+
+Histogram Registry::histogram(std::string_view name,
+                              std::string_view help,
+                              std::string_view labels)
+{
+    return Histogram(
+        registerMetric(histograms_, MAX_HISTOGRAMS, name, help, labels));
+}
+
+std::string Registry::renderPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 같은 이름끼리 모아서 HELP/TYPE 를 한 번만 쓴다.
+    auto ordered = [](const std::vector<MetricInfo> &metrics)
+    {
+        std::vector<std::uint32_t> order(metrics.size());
+        for (std::uint32_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(),
+                         order.end(),
+                         [&](auto a, auto b)
+                         { return metrics[a].name < metrics[b].name; });
+        return order;
+    };
+
+    std::string out;
+    std::string family;
+
+    for (auto slot : ordered(counters_))
+    {
+        std::uint64_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            auto *chunk = shard->counters[slot / COUNTER_CHUNK].load(
+                std::memory_order_acquire);
+            if (chunk)
+                total += chunk->cells[slot % COUNTER_CHUNK].load(
+                    std::memory_order_relaxed);
+        }
+
+        const auto &info = counters_[slot];
+        appendHeader(out, info.name, info.help, "counter", family);
+        appendSeries(out, info.name, "", info.labels, "", total);
+    }
+
+    std::array<std::uint64_t, HISTOGRAM_BUCKETS> buckets{};
+    for (auto slot : ordered(histograms_))
+    {
+        buckets.fill(0);
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        for (const auto &shard : shards_)
+        {
+            auto *chunk = shard->histograms[slot / HISTOGRAM_CHUNK].load(
+                std::memory_order_acquire);
+            if (!chunk)
+                continue;
+            const auto &cell = chunk->cells[slot % HISTOGRAM_CHUNK];
+            for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+                buckets[i] += cell.buckets[i].load(std::memory_order_relaxed);
+            count += cell.count.load(std::memory_order_relaxed);
+            sum += cell.sum.load(std::memory_order_relaxed);
+        }
+
+        const auto &info = histograms_[slot];
+        appendHeader(out, info.name, info.help, "histogram", family);
+
+        // 비어 있는 꼬리 버킷은 생략하고 +Inf 로 마무리한다.
+        std::size_t last = 0;
+        for (std::size_t i = 0; i + 1 < HISTOGRAM_BUCKETS; ++i)
+        {
+            if (buckets[i] != 0)
+                last = i;
+        }
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i <= last; ++i)
+        {
+            cumulative += buckets[i];
+            appendSeries(out,
+                         info.name,
+                         "_bucket",
+                         info.labels,
+                         "le=\"" + std::to_string(bucketUpperBound(i)) + "\"",
+                         cumulative);
+        }
+        appendSeries(
+            out, info.name, "_bucket", info.labels, "le=\"+Inf\"", count);
+        appendSeries(out, info.name, "_sum", info.labels, "", sum);
+        appendSeries(out, info.name, "_count", info.labels, "", count);
+    }
+
+    return out;
+}
+
+} // namespace banchoo::metrics
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace banchoo::metrics
+{
+
+// 로그-선형 히스토그램: 2의 거듭제곱 구간마다 4개의 하위 버킷을 둔다.
+constexpr std::size_t HISTOGRAM_BUCKETS = 160;
+
+std::size_t bucketIndex(std::uint64_t value);
+std::uint64_t bucketUpperBound(std::size_t index);
+
+// name="value" 라벨 하나. 값의 \, ", 줄바꿈은 exposition format 대로
+// 이스케이프한다.
+std::string label(std::string_view name, std::string_view value);
+
+class Counter
+{
+ public:
+    Counter() = default;
+    void inc(std::uint64_t n = 1) const;
+
+ private:
+    friend class Registry;
+    explicit Counter(std::uint32_t slot) : slot_(slot) {}
+    std::uint32_t slot_ = UINT32_MAX;
+};
+
+class Histogram
+{
+ public:
+    Histogram() = default;
+    void observe(std::uint64_t value) const;
+
+ private:
+    friend class Registry;
+    explicit Histogram(std::uint32_t slot) : slot_(slot) {}
+    std::uint32_t slot_ = UINT32_MAX;
+};
+
+// 프로세스 전역 지표 저장소.
+// 기록은 스레드별 샤드에 잠금 없이 쌓이고, 수집(render) 시점에 합쳐진다.
+class Registry
+{
+ public:
+    static Registry &instance();
+
+    // 같은 이름과 라벨이면 같은 지표를 돌려준다.
+    // labels 는 `route="/notes",method="GET"` 형식이다.
+    Counter counter(std::string_view name,
+                    std::string_view help,
+                    std::string_view labels = {});
+    Histogram histogram(std::string_view name,
+                        std::string_view help,
+                        std::string_view labels = {});
+
+    // Prometheus text exposition format (0.0.4)
+    std::string renderPrometheus() const;
+
+ private:
+    friend class Counter;
+    friend class Histogram;
+
+    static constexpr std::size_t COUNTER_CHUNK = 64;
+    static constexpr std::size_t HISTOGRAM_CHUNK = 8;
+    static constexpr std::size_t MAX_CHUNKS = 64;
+
+    struct HistogramCell
+    {
+        std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+    };
+
+    struct CounterChunk
+    {
+        std::array<std::atomic<std::uint64_t>, COUNTER_CHUNK> cells{};
+    };
+
+    struct HistogramChunk
+    {
+        std::array<HistogramCell, HISTOGRAM_CHUNK> cells{};
+    };
+
+    // 한 스레드만 쓰고, 수집 스레드는 읽기만 한다.
+    struct Shard
+    {
+        std::array<std::atomic<CounterChunk *>, MAX_CHUNKS> counters{};
+        std::array<std::atomic<HistogramChunk *>, MAX_CHUNKS> histograms{};
+    };
+
+    struct MetricInfo
+    {
+        std::string name;
+        std::string help;
+        std::string labels;
+    };
+
+    Registry() = default;
+
+    static Shard &localShard();
+    static std::atomic<std::uint64_t> &counterCell(std::uint32_t slot);
+    static HistogramCell &histogramCell(std::uint32_t slot);
+
+    std::uint32_t registerMetric(std::vector<MetricInfo> &metrics,
+                                 std::size_t capacity,
+                                 std::string_view name,
+                                 std::string_view help,
+                                 std::string_view labels);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::uint32_t> index_;
+    std::vector<MetricInfo> counters_;
+    std::vector<MetricInfo> histograms_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace banchoo::metrics
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "note/content_codec.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace banchoo::note
+{
+
+namespace
+{
+constexpr std::size_t MIN_MATCH = 4;
+// 블록 끝 5바이트는 항상 리터럴, 마지막 일치는 끝에서 12바이트 전에 시작한다.
+constexpr std::size_t LAST_LITERALS = 5;
+constexpr std::size_t MF_LIMIT = 12;
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr std::size_t RUN_MASK = 15;
+constexpr int HASH_BITS = 12;
+constexpr std::size_t HEADER_SIZE = 4;
+constexpr std::size_t WILD_COPY = 16;
+
+std::uint32_t read32(const char *p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint64_t read64(const char *p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+std::uint32_t hash4(std::uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// p 와 match 가 몇 바이트 같은지 센다. p 는 limit 을 넘지 않는다.
+std::size_t matchLength(const char *p, const char *match, const char *limit)
+{
+    const char *start = p;
+    while (p + 8 <= limit)
+    {
+        auto diff = read64(p) ^ read64(match);
+        if (diff != 0)
+        {
+            if constexpr (std::endian::native == std::endian::little)
+                return p - start + std::countr_zero(diff) / 8;
+            else
+                return p - start + std::countl_zero(diff) / 8;
+        }
+        p += 8;
+        match += 8;
+    }
+    while (p < limit && *p == *match)
+    {
+        ++p;
+        ++match;
+    }
+    return p - start;
+}
+
+char *writeLength(char *op, std::size_t length)
+{
+    for (; length >= 255; length -= 255)
+        *op++ = static_cast<char>(255);
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+// 리터럴과 일치 하나를 쓴다. match_length 가 0 이면 마지막 시퀀스다.
+char *writeSequence(char *op,
+                    const char *literals,
+                    std::size_t literal_length,
+                    std::size_t offset,
+                    std::size_t match_length)
+{
+    char *token = op++;
+    std::size_t t = std::min(literal_length, RUN_MASK) << 4;
+    if (literal_length >= RUN_MASK)
+        op = writeLength(op, literal_length - RUN_MASK);
+    std::memcpy(op, literals, literal_length);
+    op += literal_length;
+
+    if (match_length != 0)
+    {
+        *op++ = static_cast<char>(offset & 0xFF);
+        *op++ = static_cast<char>(offset >> 8);
+        auto length = match_length - MIN_MATCH;
+        t |= std::min(length, RUN_MASK);
+        if (length >= RUN_MASK)
+            op = writeLength(op, length - RUN_MASK);
+    }
+    *token = static_cast<char>(t);
+    return op;
+}
+
+// 15 이후 이어지는 길이 바이트를 읽는다.
+bool readLength(const unsigned char *&ip,
+                const unsigned char *end,
+                std::size_t &length)
+{
+    unsigned char b;
+    do
+    {
+        if (ip >= end)
+            return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+} // namespace
+
+std::size_t compress_block(std::string_view src, char *dst)
+{
+    const char *base = src.data();
+    const char *end = base + src.size();
+    const char *anchor = base;
+    char *op = dst;
+
+    if (src.size() > MF_LIMIT)
+    {
+        // 4바이트 해시 -> 마지막으로 본 위치. 16KB 라 스택에 둔다.
+        std::uint32_t table[1U << HASH_BITS] = {};
+        const char *match_limit = end - LAST_LITERALS;
+        const char *ip_limit = end - MF_LIMIT;
+        const char *ip = base + 1;
+        std::size_t misses = 0;
+
+        while (ip <= ip_limit)
+        {
+            auto sequence = read32(ip);
+            auto h = hash4(sequence);
+            const char *candidate = base + table[h];
+            table[h] = static_cast<std::uint32_t>(ip - base);
+
+            if (static_cast<std::size_t>(ip - candidate) > MAX_OFFSET ||
+                read32(candidate) != sequence)
+            {
+                // 못 찾을수록 건너뛰는 폭을 넓혀 압축이 안 되는 입력에서
+                // 시간을 덜 쓴다.
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            while (ip > anchor && candidate > base && ip[-1] == candidate[-1])
+            {
+                --ip;
+                --candidate;
+            }
+            auto length =
+                MIN_MATCH +
+                matchLength(ip + MIN_MATCH, candidate + MIN_MATCH, match_limit);
+            op = writeSequence(op,
+                               anchor,
+                               static_cast<std::size_t>(ip - anchor),
+                               static_cast<std::size_t>(ip - candidate),
+                               length);
+            ip += length;
+            anchor = ip;
+
+            if (ip <= ip_limit)
+                table[hash4(read32(ip - 2))] =
+                    static_cast<std::uint32_t>(ip - 2 - base);
+        }
+    }
+
+    op = writeSequence(
+        op, anchor, static_cast<std::size_t>(end - anchor), 0, 0);
+    return static_cast<std::size_t>(op - dst);
+}
+
+bool decompress_block(std::string_view src, char *dst, std::size_t dst_size)
+{
+    auto ip = reinterpret_cast<const unsigned char *>(src.data());
+    const unsigned char *in_end = ip + src.size();
+    char *op = dst;
+    char *out_end = dst + dst_size;
+
+    while (op < out_end)
+    {
+        if (ip >= in_end)
+            return false;
+        unsigned token = *ip++;
+
+        std::size_t literals = token >> 4;
+        if (literals == RUN_MASK && !readLength(ip, in_end, literals))
+            return false;
+        if (literals > static_cast<std::size_t>(in_end - ip))
+            return false;
+        auto n = std::min(literals, static_cast<std::size_t>(out_end - op));
+        // 짧은 리터럴은 고정 길이로 복사한다. 넘친 바이트는 다음에 덮어쓴다.
+        if (literals <= WILD_COPY &&
+            static_cast<std::size_t>(in_end - ip) >= WILD_COPY &&
+            static_cast<std::size_t>(out_end - op) >= WILD_COPY)
+            std::memcpy(op, ip, WILD_COPY);
+        else
+            std::memcpy(op, ip, n);
+        op += n;
+        ip += literals;
+        if (op == out_end)
+            return true;
+
+        if (in_end - ip < 2)
+            return false;
+        std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst))
+            return false;
+
+        std::size_t length = token & RUN_MASK;
+        if (length == RUN_MASK && !readLength(ip, in_end, length))
+            return false;
+        length = std::min(length + MIN_MATCH,
+                          static_cast<std::size_t>(out_end - op));
+
+        const char *match = op - offset;
+        if (offset >= 8 &&
+            static_cast<std::size_t>(out_end - op) >= length + 8)
+        {
+            // 8바이트씩 복사해도 아직 안 쓴 바이트를 읽지 않는다.
+            for (std::size_t i = 0; i < length; i += 8)
+                std::memcpy(op + i, match + i, 8);
+            op += length;
+        }
+        else if (offset >= length)
+        {
+            std::memcpy(op, match, length);
+            op += length;
+        }
+        else
+        {
+            // 겹치는 복사는 반복 패턴이므로 한 바이트씩 앞으로 복사한다.
+            for (std::size_t i = 0; i < length; ++i)
+                *op++ = *match++;
+        }
+    }
+    return true;
+}
+
+std::optional<std::string> pack_content(std::string_view content)
+{
+    if (content.size() > std::numeric_limits<std::uint32_t>::max())
+        return std::nullopt;
+
+    std::string packed(HEADER_SIZE + max_compressed_size(content.size()), '\0');
+    auto size = static_cast<std::uint32_t>(content.size());
+    for (std::size_t i = 0; i < HEADER_SIZE; ++i)
+        packed[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+
+    auto written = compress_block(content, packed.data() + HEADER_SIZE);
+    if (HEADER_SIZE + written >= content.size())
+        return std::nullopt;
+    packed.resize(HEADER_SIZE + written);
+    packed.shrink_to_fit();
+    return packed;
+}
+
+std::size_t packed_content_size(std::string_view packed)
+{
+    if (packed.size() < HEADER_SIZE)
+        throw std::runtime_error("Corrupt packed content");
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < HEADER_SIZE; ++i)
+        size |= static_cast<std::size_t>(
+                    static_cast<unsigned char>(packed[i]))
+                << (8 * i);
+    return size;
+}
+
+std::string unpack_content(std::string_view packed, std::size_t limit)
+{
+    auto size = std::min(packed_content_size(packed), limit);
+    std::string content(size, '\0');
+    if (!decompress_block(packed.substr(HEADER_SIZE), content.data(), size))
+        throw std::runtime_error("Corrupt packed content");
+    return content;
+}
+
+} // namespace banchoo::note
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace banchoo::note
+{
+
+// LZ4 블록 형식과 호환되는 간단한 압축기. 외부 의존성 없이 본문만
+// 압축하므로 스트림 헤더나 체크섬은 없다.
+
+// compress_block 이 쓸 수 있는 최대 바이트 수
+constexpr std::size_t max_compressed_size(std::size_t n)
+{
+    return n + n / 255 + 16;
+}
+
+// dst 는 max_compressed_size(src.size()) 이상이어야 하고, 쓴 길이를 돌려준다.
+std::size_t compress_block(std::string_view src, char *dst);
+
+// 처음 dst_size 바이트를 풀면 멈춘다. 따라서 원본 크기보다 작게 주면 앞부분만
+// 푼다. 블록이 깨졌거나 dst_size 만큼 나오지 않으면 false.
+bool decompress_block(std::string_view src, char *dst, std::size_t dst_size);
+
+// 저장용 본문 형식: [원본 크기 u32 LE][LZ 블록]
+// 압축해서 줄어들지 않으면 nullopt 이다.
+std::optional<std::string> pack_content(std::string_view content);
+
+// 압축을 푼 본문 크기
+std::size_t packed_content_size(std::string_view packed);
+
+// 앞에서부터 limit 바이트까지만 푼다. 형식이 깨졌으면 std::runtime_error.
+std::string
+unpack_content(std::string_view packed,
+               std::size_t limit = std::numeric_limits<std::size_t>::max());
+
+} // namespace banchoo::note
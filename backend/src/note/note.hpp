@@ -5,13 +5,21 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "note/time_codec.hpp"
 
 namespace banchoo::note
 {
-using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
 
 enum class NoteStatus
 {
@@ -28,6 +36,24 @@ enum class NoteType
 
 using Id = int;
 
+// Note 필드 비트마스크 (요청 검증, 부분 갱신 등에서 사용)
+using FieldMask = std::uint32_t;
+
+namespace field
+{
+constexpr FieldMask ID = 1U << 0;
+constexpr FieldMask TYPE = 1U << 1;
+constexpr FieldMask CONTENT = 1U << 2;
+constexpr FieldMask CREATED_AT = 1U << 3;
+constexpr FieldMask UPDATED_AT = 1U << 4;
+constexpr FieldMask STATUS = 1U << 5;
+constexpr FieldMask DUE_DATE = 1U << 6;
+constexpr FieldMask START_DATE = 1U << 7;
+constexpr FieldMask END_DATE = 1U << 8;
+constexpr FieldMask TAGS = 1U << 9;
+constexpr FieldMask ALL = (1U << 10) - 1;
+} // namespace field
+
 struct Note
 {
     Id id;
@@ -43,8 +69,90 @@ struct Note
     // Event info
     std::optional<TimePoint> start_date;
     std::optional<TimePoint> end_date;
+
+    // 정렬되고 중복 없는 태그 (normalize_tags)
+    std::vector<std::string> tags;
+};
+
+// source 의 fields 에 든 필드를 target 으로 옮긴다.
+inline void apply_fields(Note &target, Note &&source, FieldMask fields)
+{
+    if (fields & field::CONTENT)
+        target.content = std::move(source.content);
+    if (fields & field::UPDATED_AT)
+        target.updated_at = source.updated_at;
+    if (fields & field::STATUS)
+        target.status = source.status;
+    if (fields & field::DUE_DATE)
+        target.due_date = source.due_date;
+    if (fields & field::START_DATE)
+        target.start_date = source.start_date;
+    if (fields & field::END_DATE)
+        target.end_date = source.end_date;
+    if (fields & field::TAGS)
+        target.tags = std::move(source.tags);
+}
+
+constexpr std::size_t MAX_TAG_LENGTH = 64;
+constexpr std::size_t MAX_TAGS = 32; // 노트 하나에 붙일 수 있는 태그 수
+
+// 태그는 1~64바이트의 영숫자, 비 ASCII(UTF-8) 문자와 - _ . : / 로 이뤄진다.
+// 검색식 연산자인 AND, OR, NOT 은 태그가 될 수 없다.
+inline bool valid_tag(std::string_view tag)
+{
+    if (tag.empty() || tag.size() > MAX_TAG_LENGTH)
+        return false;
+    if (tag == "AND" || tag == "OR" || tag == "NOT")
+        return false;
+    return std::all_of(tag.begin(),
+                       tag.end(),
+                       [](char ch)
+                       {
+                           auto c = static_cast<unsigned char>(ch);
+                           return c >= 0x80 || (c >= '0' && c <= '9') ||
+                                  (c >= 'a' && c <= 'z') ||
+                                  (c >= 'A' && c <= 'Z') || c == '-' ||
+                                  c == '_' || c == '.' || c == ':' || c == '/';
+                       });
+}
+
+// 태그를 정렬하고 중복을 없앤다. 저장소와 검색은 이 순서를 전제로 한다.
+inline void normalize_tags(std::vector<std::string> &tags)
+{
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+}
+
+// 목록 조회에서 채울 필드. fields 에 없는 필드는 기본값으로 남는다.
+// preview 가 0 이 아니고 fields 에 CONTENT 가 없으면 content 에는 앞
+// preview 글자(코드 포인트)만 담긴다.
+struct Projection
+{
+    FieldMask fields = field::ALL;
+    std::size_t preview = 0;
 };
 
+// s 의 앞 chars 글자. UTF-8 다중 바이트 문자 중간에서 자르지 않는다.
+inline std::string_view utf8_prefix(std::string_view s, std::size_t chars)
+{
+    // 글자는 1바이트 이상이므로 바이트 수가 chars 이하면 자를 것이 없다.
+    if (s.size() <= chars)
+        return s;
+    for (std::size_t i = 0; i < s.size(); ++i)
+    {
+        // 연속 바이트(10xxxxxx)가 아닌 곳이 글자의 시작이다.
+        if ((static_cast<unsigned char>(s[i]) & 0xC0) == 0x80)
+            continue;
+        if (chars-- == 0)
+            return s.substr(0, i);
+    }
+    return s;
+}
+
+// 저장소가 내주는 불변 노트. 읽기는 포인터만 복사하고, 수정은 새 노트로
+// 교체한다.
+using NotePtr = std::shared_ptr<const Note>;
+
 inline std::string to_string(NoteType type)
 {
     switch (type)
@@ -75,21 +183,39 @@ inline std::string to_string(NoteStatus status)
     }
 }
 
-inline std::string to_string(const TimePoint &tp)
+inline std::optional<NoteType> parse_type(std::string_view s)
+{
+    if (s == "TASK")
+        return NoteType::TASK;
+    if (s == "EVENT")
+        return NoteType::EVENT;
+    if (s == "MEMO")
+        return NoteType::MEMO;
+    return std::nullopt;
+}
+
+inline std::optional<NoteStatus> parse_status(std::string_view s)
 {
-    std::time_t time = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm = *std::localtime(&time);
+    if (s == "TODO")
+        return NoteStatus::TODO;
+    if (s == "DOING")
+        return NoteStatus::DOING;
+    if (s == "DONE")
+        return NoteStatus::DONE;
+    return std::nullopt;
+}
 
-    char buffer[32];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
-    return std::string(buffer);
+// RFC 3339 UTC (예: 2025-04-05T12:00:00Z)
+inline std::string to_string(const TimePoint &tp)
+{
+    std::string out;
+    append_timestamp(out, tp);
+    return out;
 }
-// 예시용 포맷: ISO 8601
-inline TimePoint parse_time(const std::string &s)
+
+// 읽을 수 없는 문자열이면 epoch 를 돌려준다.
+inline TimePoint parse_time(std::string_view s)
 {
-    std::istringstream ss(s);
-    std::tm t = {};
-    ss >> std::get_time(&t, "%Y-%m-%dT%H:%M:%S"); // ISO8601
-    return std::chrono::system_clock::from_time_t(std::mktime(&t));
+    return parse_timestamp(s).value_or(TimePoint{});
 }
 } // namespace banchoo::note
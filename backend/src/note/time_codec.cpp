@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "note/time_codec.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace banchoo::note
+{
+
+namespace
+{
+constexpr std::size_t PREFIX_LENGTH = 19; // YYYY-MM-DDTHH:MM:SS
+constexpr std::int64_t SECONDS_PER_DAY = 86400;
+constexpr std::int64_t NANOS_PER_SECOND = 1000000000;
+
+// 1970-01-01 기준 일수 <-> 그레고리력 날짜 (H. Hinnant 의 알고리즘)
+std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+void civilFromDays(std::int64_t z, std::int64_t &y, unsigned &m, unsigned &d)
+{
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe =
+        (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+bool isLeap(std::int64_t y)
+{
+    return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+}
+
+unsigned daysInMonth(std::int64_t y, unsigned m)
+{
+    constexpr unsigned DAYS[] = {
+        31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && isLeap(y) ? 29 : DAYS[m - 1];
+}
+
+void put2(char *out, unsigned v)
+{
+    out[0] = static_cast<char>('0' + v / 10);
+    out[1] = static_cast<char>('0' + v % 10);
+}
+
+std::int64_t floorDiv(std::int64_t a, std::int64_t b)
+{
+    auto q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// 같은 초 안에서는 "YYYY-MM-DDTHH:MM:SS" 를 다시 계산하지 않는다.
+struct PrefixCache
+{
+    std::int64_t second = std::numeric_limits<std::int64_t>::min();
+    char prefix[PREFIX_LENGTH];
+};
+
+const char *secondPrefix(std::int64_t second)
+{
+    thread_local PrefixCache cache;
+    if (cache.second == second)
+        return cache.prefix;
+
+    std::int64_t days = floorDiv(second, SECONDS_PER_DAY);
+    auto in_day = static_cast<unsigned>(second - days * SECONDS_PER_DAY);
+    std::int64_t y;
+    unsigned m, d;
+    civilFromDays(days, y, m, d);
+
+    // 4자리를 넘는 연도는 RFC 3339 범위 밖이므로 잘라낸다.
+    auto year = static_cast<unsigned>(y < 0 ? 0 : (y > 9999 ? 9999 : y));
+    char *p = cache.prefix;
+    put2(p, year / 100);
+    put2(p + 2, year % 100);
+    p[4] = '-';
+    put2(p + 5, m);
+    p[7] = '-';
+    put2(p + 8, d);
+    p[10] = 'T';
+    put2(p + 11, in_day / 3600);
+    p[13] = ':';
+    put2(p + 14, in_day / 60 % 60);
+    p[16] = ':';
+    put2(p + 17, in_day % 60);
+
+    cache.second = second;
+    return cache.prefix;
+}
+
+bool readDigits(std::string_view s, std::size_t pos, std::size_t n, int &out)
+{
+    if (pos + n > s.size())
+        return false;
+    int v = 0;
+    for (std::size_t i = pos; i < pos + n; ++i)
+    {
+        if (s[i] < '0' || s[i] > '9')
+            return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    out = v;
+    return true;
+}
+
+// 오프셋이 없는 시각을 이 호스트의 현지 시각으로 보고 UTC 초를 구한다.
+// 서머타임은 mktime 이 고른다. 이전 저장 형식과 API 입력만 이 길을 탄다.
+std::optional<std::int64_t>
+localSeconds(int year, int month, int day, int hour, int minute, int second)
+{
+    std::tm tm{};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+    tm.tm_isdst = -1;
+    // -1 도 올바른 결과라서 실패는 mktime 이 tm_wday 를 채웠는지로 본다.
+    tm.tm_wday = -1;
+    std::time_t t = std::mktime(&tm);
+    if (tm.tm_wday == -1)
+        return std::nullopt;
+    return static_cast<std::int64_t>(t);
+}
+} // namespace
+
+std::size_t format_timestamp(TimePoint tp, char *out, int fraction_digits)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  tp.time_since_epoch())
+                  .count();
+    auto second = floorDiv(ns, NANOS_PER_SECOND);
+    auto fraction = static_cast<std::uint32_t>(ns - second * NANOS_PER_SECOND);
+
+    std::memcpy(out, secondPrefix(second), PREFIX_LENGTH);
+    std::size_t n = PREFIX_LENGTH;
+
+    if (fraction_digits > 0)
+    {
+        if (fraction_digits > 9)
+            fraction_digits = 9;
+        char digits[9];
+        for (int i = 8; i >= 0; --i)
+        {
+            digits[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        out[n++] = '.';
+        std::memcpy(out + n, digits, static_cast<std::size_t>(fraction_digits));
+        n += static_cast<std::size_t>(fraction_digits);
+    }
+    out[n++] = 'Z';
+    return n;
+}
+
+void append_timestamp(std::string &out, TimePoint tp, int fraction_digits)
+{
+    char buf[TIMESTAMP_MAX_LENGTH];
+    out.append(buf, format_timestamp(tp, buf, fraction_digits));
+}
+
+std::optional<TimePoint> parse_timestamp(std::string_view s)
+{
+    int year, month, day, hour, minute, second;
+    if (!readDigits(s, 0, 4, year) || s.size() < PREFIX_LENGTH ||
+        s[4] != '-' || !readDigits(s, 5, 2, month) || s[7] != '-' ||
+        !readDigits(s, 8, 2, day) ||
+        (s[10] != 'T' && s[10] != 't' && s[10] != ' ') ||
+        !readDigits(s, 11, 2, hour) || s[13] != ':' ||
+        !readDigits(s, 14, 2, minute) || s[16] != ':' ||
+        !readDigits(s, 17, 2, second))
+        return std::nullopt;
+
+    if (month < 1 || month > 12 || day < 1 ||
+        static_cast<unsigned>(day) >
+            daysInMonth(year, static_cast<unsigned>(month)) ||
+        hour > 23 || minute > 59 || second > 60)
+        return std::nullopt;
+
+    std::size_t pos = PREFIX_LENGTH;
+    std::int64_t nanos = 0;
+    if (pos < s.size() && s[pos] == '.')
+    {
+        ++pos;
+        std::int64_t scale = NANOS_PER_SECOND;
+        std::size_t begin = pos;
+        while (pos < s.size() && s[pos] >= '0' && s[pos] <= '9')
+        {
+            // 나노초보다 작은 자리는 버린다.
+            if (scale > 1)
+            {
+                scale /= 10;
+                nanos += (s[pos] - '0') * scale;
+            }
+            ++pos;
+        }
+        if (pos == begin)
+            return std::nullopt;
+    }
+
+    std::optional<std::int64_t> offset;
+    if (pos < s.size())
+    {
+        char zone = s[pos];
+        if (zone == 'Z' || zone == 'z')
+        {
+            offset = 0;
+            ++pos;
+        }
+        else if (zone == '+' || zone == '-')
+        {
+            int oh, om;
+            if (!readDigits(s, pos + 1, 2, oh) || pos + 3 >= s.size() ||
+                s[pos + 3] != ':' || !readDigits(s, pos + 4, 2, om) ||
+                oh > 23 || om > 59)
+                return std::nullopt;
+            offset = (oh * 3600 + om * 60) * (zone == '-' ? -1 : 1);
+            pos += 6;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+    if (pos != s.size())
+        return std::nullopt;
+
+    std::int64_t seconds = 0;
+    if (offset)
+    {
+        seconds = daysFromCivil(year,
+                                static_cast<unsigned>(month),
+                                static_cast<unsigned>(day)) *
+                      SECONDS_PER_DAY +
+                  hour * 3600 + minute * 60 + second - *offset;
+    }
+    else
+    {
+        auto local = localSeconds(year, month, day, hour, minute, second);
+        if (!local)
+            return std::nullopt;
+        seconds = *local;
+    }
+
+    // system_clock 은 나노초 단위라 대략 1678 ~ 2261 년만 표현할 수 있다.
+    constexpr std::int64_t LIMIT =
+        std::numeric_limits<std::int64_t>::max() / NANOS_PER_SECOND - 1;
+    if (seconds > LIMIT || seconds < -LIMIT)
+        return std::nullopt;
+
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::nanoseconds(seconds * NANOS_PER_SECOND + nanos)));
+}
+
+} // namespace banchoo::note
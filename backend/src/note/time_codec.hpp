@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace banchoo::note
+{
+using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+
+// "YYYY-MM-DDTHH:MM:SS" + ".fffffffff" + "Z"
+constexpr std::size_t TIMESTAMP_MAX_LENGTH = 30;
+
+// RFC 3339 UTC 문자열로 쓴다 (예: 2025-04-05T12:00:00.123456Z).
+// fraction_digits 는 0 ~ 9. 로캘/시간대 함수를 쓰지 않으며 할당도 없다.
+// out 은 TIMESTAMP_MAX_LENGTH 이상이어야 하고, 쓴 길이를 돌려준다.
+std::size_t format_timestamp(TimePoint tp, char *out, int fraction_digits = 0);
+
+void append_timestamp(std::string &out, TimePoint tp, int fraction_digits = 0);
+
+// RFC 3339 을 읽는다. 소수 초와 Z/±HH:MM 오프셋을 지원한다.
+// 날짜와 시각 사이의 ' ' 도 받는다. 오프셋이 없으면 예전 저장 형식
+// ("YYYY-MM-DD HH:MM:SS") 과 API 가 그랬듯 호스트의 현지 시각으로 본다.
+std::optional<TimePoint> parse_timestamp(std::string_view s);
+
+} // namespace banchoo::note
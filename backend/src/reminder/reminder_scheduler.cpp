@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "reminder/reminder_scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "note/note.hpp"
+#include "reminder/timing_wheel.hpp"
+
+namespace banchoo::reminder
+{
+
+namespace
+{
+std::chrono::milliseconds sinceEpoch(note::TimePoint tp)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        tp.time_since_epoch());
+}
+} // namespace
+
+ReminderScheduler::ReminderScheduler(std::chrono::milliseconds tick,
+                                     note::TimePoint now)
+    : tick_(std::max(tick, std::chrono::milliseconds(1))),
+      wheel_(tickOf(now))
+{
+}
+
+ReminderScheduler::~ReminderScheduler()
+{
+    stop();
+}
+
+std::optional<Reminder> ReminderScheduler::reminderOf(const note::Note &n)
+{
+    if (n.type == note::NoteType::TASK && n.due_date &&
+        n.status != note::NoteStatus::DONE)
+        return Reminder{n.id, n.type, *n.due_date};
+    if (n.type == note::NoteType::EVENT && n.start_date)
+        return Reminder{n.id, n.type, *n.start_date};
+    return std::nullopt;
+}
+
+TimingWheel::Tick ReminderScheduler::tickOf(note::TimePoint now) const
+{
+    auto ms = std::max<std::int64_t>(sinceEpoch(now).count(), 0);
+    return static_cast<TimingWheel::Tick>(ms / tick_.count());
+}
+
+TimingWheel::Tick ReminderScheduler::deadlineOf(note::TimePoint at) const
+{
+    auto ms = std::max<std::int64_t>(sinceEpoch(at).count(), 0);
+    return static_cast<TimingWheel::Tick>((ms + tick_.count() - 1) /
+                                          tick_.count());
+}
+
+void ReminderScheduler::update(const note::Note &n)
+{
+    auto reminder = reminderOf(n);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (reminder)
+    {
+        auto deadline = deadlineOf(reminder->at);
+        if (deadline > wheel_.now())
+        {
+            wheel_.schedule(*reminder, deadline);
+            return;
+        }
+    }
+    wheel_.cancel(n.id);
+}
+
+void ReminderScheduler::cancel(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    wheel_.cancel(id);
+}
+
+void ReminderScheduler::subscribe(
+    std::shared_ptr<ReminderSubscriber> subscriber)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.push_back(std::move(subscriber));
+}
+
+void ReminderScheduler::unsubscribe(const ReminderSubscriber *subscriber)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::erase_if(subscribers_,
+                  [subscriber](const auto &s)
+                  { return s.get() == subscriber; });
+}
+
+std::size_t ReminderScheduler::advance(note::TimePoint now)
+{
+    std::lock_guard<std::mutex> advance_lock(advance_mutex_);
+
+    std::vector<Reminder> due;
+    std::vector<std::shared_ptr<ReminderSubscriber>> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wheel_.advance(tickOf(now), due);
+        if (due.empty())
+            return 0;
+        subscribers = subscribers_;
+    }
+
+    // 구독자는 잠금 밖에서 부른다. 구독자가 노트를 고쳐도 막히지 않는다.
+    for (const auto &reminder : due)
+    {
+        for (const auto &subscriber : subscribers)
+        {
+            try
+            {
+                subscriber->onReminder(reminder);
+            }
+            catch (const std::exception &e)
+            {
+                BANCHOO_ERROR("reminder subscriber failed: {}", e.what());
+            }
+        }
+    }
+    return due.size();
+}
+
+void ReminderScheduler::start()
+{
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (thread_.joinable())
+        return;
+    stopping_ = false;
+    thread_ = std::thread([this] { run(); });
+}
+
+void ReminderScheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void ReminderScheduler::run()
+{
+    std::unique_lock<std::mutex> lock(thread_mutex_);
+    while (!stopping_)
+    {
+        auto now = std::chrono::system_clock::now();
+        lock.unlock();
+        advance(now);
+        lock.lock();
+
+        // 다음 틱 경계까지 잔다. 틱마다 늦어지는 만큼이 쌓이지 않는다.
+        auto next = note::TimePoint(
+            (sinceEpoch(now) / tick_ + 1) * tick_);
+        cv_.wait_until(lock, next, [this] { return stopping_; });
+    }
+}
+
+std::size_t ReminderScheduler::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wheel_.size();
+}
+
+std::size_t ReminderScheduler::memoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wheel_.memoryBytes();
+}
+
+} // namespace banchoo::reminder
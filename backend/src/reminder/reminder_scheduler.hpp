@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "note/note.hpp"
+#include "reminder/timing_wheel.hpp"
+
+namespace banchoo::reminder
+{
+
+// 알림을 받는 쪽. 스케줄러 스레드에서 불리므로 오래 붙잡지 않는다.
+class ReminderSubscriber
+{
+ public:
+    virtual ~ReminderSubscriber() = default;
+    virtual void onReminder(const Reminder &reminder) = 0;
+};
+
+// 노트의 알림 시각을 타이밍 휠에 걸어 두고, 시각이 되면 구독자에게 알린다.
+// start() 를 부르면 틱마다 깨어나는 스레드가 advance 를 부른다.
+class ReminderScheduler
+{
+ public:
+    explicit ReminderScheduler(
+        std::chrono::milliseconds tick = std::chrono::seconds(1),
+        note::TimePoint now = std::chrono::system_clock::now());
+    ~ReminderScheduler();
+
+    ReminderScheduler(const ReminderScheduler &) = delete;
+    ReminderScheduler &operator=(const ReminderScheduler &) = delete;
+
+    // 알림을 만드는 데 필요한 필드
+    static constexpr note::FieldMask FIELDS =
+        note::field::ID | note::field::TYPE | note::field::STATUS |
+        note::field::DUE_DATE | note::field::START_DATE;
+
+    // 끝나지 않은 할 일의 마감, 일정의 시작. 메모와 날짜 없는 노트는 없다.
+    static std::optional<Reminder> reminderOf(const note::Note &n);
+
+    // 노트의 지금 값으로 알림을 걸거나 바꾸거나 취소한다. 이미 지난 시각의
+    // 알림은 걸지 않는다. 다시 시작할 때 지난 마감이 한꺼번에 울리지 않는다.
+    void update(const note::Note &n);
+    void cancel(note::Id id);
+
+    void subscribe(std::shared_ptr<ReminderSubscriber> subscriber);
+    void unsubscribe(const ReminderSubscriber *subscriber);
+
+    // now 까지 울린 알림을 구독자에게 보낸다. 보낸 수를 돌려준다.
+    std::size_t advance(note::TimePoint now);
+
+    void start();
+    void stop();
+
+    std::size_t pending() const;
+    std::size_t memoryBytes() const;
+
+ private:
+    // 알림 시각을 올림한 틱. 그 틱이 지나야 울린다.
+    TimingWheel::Tick deadlineOf(note::TimePoint at) const;
+    TimingWheel::Tick tickOf(note::TimePoint now) const;
+    void run();
+
+    const std::chrono::milliseconds tick_;
+
+    mutable std::mutex mutex_;
+    TimingWheel wheel_;
+    std::vector<std::shared_ptr<ReminderSubscriber>> subscribers_;
+
+    // 알림은 한 번에 한 스레드만 보내서 순서를 지킨다.
+    std::mutex advance_mutex_;
+
+    std::mutex thread_mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace banchoo::reminder
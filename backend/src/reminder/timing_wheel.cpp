@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "reminder/timing_wheel.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "note/note.hpp"
+
+namespace banchoo::reminder
+{
+
+std::string Reminder::toJson() const
+{
+    std::string out = "{\"id\":";
+    out += std::to_string(id);
+    out += ",\"type\":\"";
+    out += note::to_string(type);
+    out += "\",\"at\":\"";
+    note::append_timestamp(out, at);
+    out += "\"}";
+    return out;
+}
+
+TimingWheel::TimingWheel(Tick now) : now_(now)
+{
+    heads_.fill(NIL);
+}
+
+std::uint32_t TimingWheel::slotOf(Tick deadline) const
+{
+    // now 와 윗자리가 같은 가장 낮은 단계에 둔다.
+    for (int level = 0; level < LEVELS - 1; ++level)
+    {
+        int shift = LEVEL_BITS * (level + 1);
+        if ((deadline >> shift) == (now_ >> shift))
+            return static_cast<std::uint32_t>(
+                level * SLOTS +
+                ((deadline >> (shift - LEVEL_BITS)) & (SLOTS - 1)));
+    }
+    // 맨 위 단계를 한 바퀴 넘는 마감은 마지막 칸에 두고, 그 칸을 나눌 때
+    // 다시 자리를 찾는다.
+    int shift = LEVEL_BITS * (LEVELS - 1);
+    Tick top = std::min(deadline >> shift, (now_ >> shift) + SLOTS - 1);
+    return static_cast<std::uint32_t>((LEVELS - 1) * SLOTS +
+                                      (top & (SLOTS - 1)));
+}
+
+void TimingWheel::link(std::uint32_t node)
+{
+    auto &n = nodes_[node];
+    n.slot = slotOf(n.deadline);
+    n.prev = NIL;
+    n.next = heads_[n.slot];
+    if (n.next != NIL)
+        nodes_[n.next].prev = node;
+    heads_[n.slot] = node;
+}
+
+void TimingWheel::unlink(std::uint32_t node)
+{
+    auto &n = nodes_[node];
+    if (n.prev != NIL)
+        nodes_[n.prev].next = n.next;
+    else
+        heads_[n.slot] = n.next;
+    if (n.next != NIL)
+        nodes_[n.next].prev = n.prev;
+}
+
+std::uint32_t TimingWheel::detach(std::uint32_t slot)
+{
+    auto head = heads_[slot];
+    heads_[slot] = NIL;
+    return head;
+}
+
+void TimingWheel::schedule(const Reminder &reminder, Tick deadline)
+{
+    deadline = std::max(deadline, now_ + 1);
+
+    auto [it, inserted] = index_.try_emplace(reminder.id, NIL);
+    if (!inserted)
+    {
+        unlink(it->second);
+    }
+    else if (free_ != NIL)
+    {
+        it->second = free_;
+        free_ = nodes_[free_].next;
+    }
+    else
+    {
+        it->second = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    auto &n = nodes_[it->second];
+    n.reminder = reminder;
+    n.deadline = deadline;
+    link(it->second);
+}
+
+bool TimingWheel::cancel(note::Id id)
+{
+    auto it = index_.find(id);
+    if (it == index_.end())
+        return false;
+    unlink(it->second);
+    nodes_[it->second].next = free_;
+    free_ = it->second;
+    index_.erase(it);
+    return true;
+}
+
+void TimingWheel::step(std::vector<Reminder> &due)
+{
+    ++now_;
+
+    // 이번 틱에 시작하는 위 단계 칸을 위에서부터 아래 단계로 나눈다. 나눈
+    // 알림 중 이번 틱이 마감인 것은 0 단계의 지금 칸으로 간다.
+    for (int level = LEVELS - 1; level > 0; --level)
+    {
+        int shift = LEVEL_BITS * level;
+        if (now_ & ((Tick{1} << shift) - 1))
+            continue;
+        auto slot = level * SLOTS + ((now_ >> shift) & (SLOTS - 1));
+        for (auto node = detach(static_cast<std::uint32_t>(slot));
+             node != NIL;)
+        {
+            auto next = nodes_[node].next;
+            link(node);
+            node = next;
+        }
+    }
+
+    auto first = due.size();
+    for (auto node = detach(static_cast<std::uint32_t>(now_ & (SLOTS - 1)));
+         node != NIL;)
+    {
+        auto &n = nodes_[node];
+        auto next = n.next;
+        due.push_back(n.reminder);
+        index_.erase(n.reminder.id);
+        n.next = free_;
+        free_ = node;
+        node = next;
+    }
+    // 같은 틱 안에서는 실제 시각 순으로 알린다.
+    std::sort(due.begin() + static_cast<std::ptrdiff_t>(first),
+              due.end(),
+              [](const Reminder &a, const Reminder &b)
+              { return a.at < b.at; });
+}
+
+void TimingWheel::advance(Tick now, std::vector<Reminder> &due)
+{
+    while (now_ < now)
+    {
+        // 걸린 알림이 없으면 빈 칸을 하나씩 지나갈 필요가 없다.
+        if (index_.empty())
+        {
+            now_ = now;
+            return;
+        }
+        step(due);
+    }
+}
+
+std::size_t TimingWheel::memoryBytes() const
+{
+    // unordered_map 은 항목마다 노드 하나(다음 포인터 + 키/값 + 해시)를 둔다.
+    constexpr std::size_t MAP_NODE =
+        sizeof(void *) + sizeof(std::pair<note::Id, std::uint32_t>) +
+        sizeof(std::size_t);
+    return nodes_.capacity() * sizeof(Node) + sizeof(heads_) +
+           index_.bucket_count() * sizeof(void *) + index_.size() * MAP_NODE;
+}
+
+} // namespace banchoo::reminder
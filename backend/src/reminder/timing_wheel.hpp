@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "note/note.hpp"
+
+namespace banchoo::reminder
+{
+
+// 할 일의 마감이나 일정의 시작을 알린다.
+struct Reminder
+{
+    note::Id id = 0;
+    note::NoteType type = note::NoteType::TASK;
+    note::TimePoint at;
+
+    std::string toJson() const;
+};
+
+// 계층 타이밍 휠. 단계마다 64칸이고, 단계 l 의 한 칸은 64^l 틱이다. 먼
+// 마감은 위 단계에 두었다가 그 칸의 시간이 오면 아래 단계로 나눈다. 걸기와
+// 취소는 O(1) 이고, 틱을 한 번 보낼 때 하는 일은 그 틱에 울리거나 나눌
+// 알림 수에 비례한다. 노트 하나에 알림은 하나다. 동기화는 부르는 쪽이 맡는다.
+class TimingWheel
+{
+ public:
+    using Tick = std::uint64_t;
+
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr std::size_t SLOTS = std::size_t{1} << LEVEL_BITS;
+    // 64^6 틱. 1초 틱이면 2천 년이 넘는다.
+    static constexpr int LEVELS = 6;
+
+    explicit TimingWheel(Tick now = 0);
+
+    // reminder 를 deadline 틱에 울리도록 건다. 같은 노트의 알림이 이미
+    // 있으면 바꾼다. 지난 시각이면 다음 틱에 울린다.
+    void schedule(const Reminder &reminder, Tick deadline);
+    // 걸린 알림이 없으면 false
+    bool cancel(note::Id id);
+
+    // now 틱까지 시간을 보내고 그동안 울린 알림을 마감 순으로 due 에 붙인다.
+    void advance(Tick now, std::vector<Reminder> &due);
+
+    Tick now() const
+    {
+        return now_;
+    }
+    std::size_t size() const
+    {
+        return index_.size();
+    }
+    std::size_t memoryBytes() const;
+
+ private:
+    static constexpr std::uint32_t NIL = UINT32_MAX;
+
+    // 칸마다 노드를 양방향 연결 리스트로 잇는다. 취소할 때 머리를 고칠 수
+    // 있도록 노드가 자기 칸을 안다.
+    struct Node
+    {
+        Reminder reminder;
+        Tick deadline = 0;
+        std::uint32_t prev = NIL;
+        std::uint32_t next = NIL;
+        std::uint32_t slot = 0;
+    };
+
+    std::uint32_t slotOf(Tick deadline) const;
+    void link(std::uint32_t node);
+    void unlink(std::uint32_t node);
+    std::uint32_t detach(std::uint32_t slot);
+    void step(std::vector<Reminder> &due);
+
+    Tick now_;
+    std::vector<Node> nodes_;
+    std::uint32_t free_ = NIL; // 빈 노드 목록 (next 로 잇는다)
+    std::array<std::uint32_t, LEVELS * SLOTS> heads_;
+    std::unordered_map<note::Id, std::uint32_t> index_;
+};
+
+} // namespace banchoo::reminder
@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "replication/change_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "note/note.hpp"
+
+namespace banchoo::replication
+{
+
+namespace
+{
+constexpr char MAGIC[] = {'B', 'N', 'C', 'H', 'L', 'O', 'G'};
+constexpr char VERSION = 1;
+constexpr std::size_t HEADER_BYTES = sizeof(MAGIC) + 1 + 8;
+// 손상된 길이 값으로 거대한 할당을 하지 않도록 막는다.
+constexpr std::uint64_t MAX_RECORD_BYTES = 256 * 1024 * 1024;
+
+// 있는 선택 필드 표시
+constexpr std::uint8_t HAS_STATUS = 1U << 0;
+constexpr std::uint8_t HAS_DUE_DATE = 1U << 1;
+constexpr std::uint8_t HAS_START_DATE = 1U << 2;
+constexpr std::uint8_t HAS_END_DATE = 1U << 3;
+
+void putVarint(std::string &out, std::uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+void putString(std::string &out, std::string_view s)
+{
+    putVarint(out, s.size());
+    out.append(s);
+}
+
+void putTime(std::string &out, note::TimePoint tp)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  tp.time_since_epoch())
+                  .count();
+    // zigzag: 1970 년 이전 시각도 짧게 쓴다.
+    putVarint(out,
+              (static_cast<std::uint64_t>(ns) << 1) ^
+                  static_cast<std::uint64_t>(ns >> 63));
+}
+
+void encodeNote(std::string &out, const note::Note &n)
+{
+    putVarint(out, static_cast<std::uint64_t>(n.id));
+    out.push_back(static_cast<char>(n.type));
+
+    std::uint8_t flags = 0;
+    if (n.status)
+        flags |= HAS_STATUS;
+    if (n.due_date)
+        flags |= HAS_DUE_DATE;
+    if (n.start_date)
+        flags |= HAS_START_DATE;
+    if (n.end_date)
+        flags |= HAS_END_DATE;
+    out.push_back(static_cast<char>(flags));
+
+    putString(out, n.content);
+    putTime(out, n.created_at);
+    putTime(out, n.updated_at);
+    if (n.status)
+        out.push_back(static_cast<char>(*n.status));
+    if (n.due_date)
+        putTime(out, *n.due_date);
+    if (n.start_date)
+        putTime(out, *n.start_date);
+    if (n.end_date)
+        putTime(out, *n.end_date);
+
+    putVarint(out, n.tags.size());
+    for (const auto &tag : n.tags)
+        putString(out, tag);
+}
+
+// 레코드 본문을 앞에서부터 읽는다. 모자라거나 값이 어긋나면 예외를 던진다.
+class Cursor
+{
+ public:
+    explicit Cursor(std::string_view data) : data_(data) {}
+
+    std::uint8_t byte()
+    {
+        if (pos_ >= data_.size())
+            fail();
+        return static_cast<std::uint8_t>(data_[pos_++]);
+    }
+
+    std::uint64_t varint()
+    {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            auto c = byte();
+            v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0)
+                return v;
+        }
+        fail();
+    }
+
+    std::string string()
+    {
+        auto size = varint();
+        if (size > data_.size() - pos_)
+            fail();
+        std::string s(data_.substr(pos_, size));
+        pos_ += size;
+        return s;
+    }
+
+    note::TimePoint time()
+    {
+        auto v = varint();
+        auto ns = static_cast<std::int64_t>(v >> 1) ^
+            -static_cast<std::int64_t>(v & 1);
+        return note::TimePoint(
+            std::chrono::duration_cast<note::TimePoint::duration>(
+                std::chrono::nanoseconds(ns)));
+    }
+
+    bool done() const
+    {
+        return pos_ == data_.size();
+    }
+
+    [[noreturn]] static void fail()
+    {
+        throw std::runtime_error("Corrupt change log record");
+    }
+
+ private:
+    std::string_view data_;
+    std::size_t pos_ = 0;
+};
+
+note::Note decodeNote(Cursor &in)
+{
+    note::Note n{};
+    n.id = static_cast<note::Id>(in.varint());
+    auto type = in.byte();
+    if (type > static_cast<std::uint8_t>(note::NoteType::MEMO))
+        Cursor::fail();
+    n.type = static_cast<note::NoteType>(type);
+
+    auto flags = in.byte();
+    n.content = in.string();
+    n.created_at = in.time();
+    n.updated_at = in.time();
+    if (flags & HAS_STATUS)
+    {
+        auto status = in.byte();
+        if (status > static_cast<std::uint8_t>(note::NoteStatus::DONE))
+            Cursor::fail();
+        n.status = static_cast<note::NoteStatus>(status);
+    }
+    if (flags & HAS_DUE_DATE)
+        n.due_date = in.time();
+    if (flags & HAS_START_DATE)
+        n.start_date = in.time();
+    if (flags & HAS_END_DATE)
+        n.end_date = in.time();
+
+    auto count = in.varint();
+    for (std::uint64_t i = 0; i < count; ++i)
+        n.tags.push_back(in.string());
+    return n;
+}
+
+ChangeRecord decodeRecord(std::string_view payload)
+{
+    Cursor in(payload);
+    ChangeRecord record;
+    record.seq = in.varint();
+    record.at = in.time();
+    auto op = in.byte();
+    switch (op)
+    {
+    case static_cast<std::uint8_t>(ChangeOp::PUT):
+        record.note = decodeNote(in);
+        break;
+    case static_cast<std::uint8_t>(ChangeOp::REMOVE):
+        record.note.id = static_cast<note::Id>(in.varint());
+        break;
+    case static_cast<std::uint8_t>(ChangeOp::SNAPSHOT_END):
+        break;
+    default:
+        Cursor::fail();
+    }
+    record.op = static_cast<ChangeOp>(op);
+    if (!in.done())
+        Cursor::fail();
+    return record;
+}
+
+// 파일 끝이면 false. bytes 에 읽은 바이트 수를 더한다.
+bool getVarint(std::istream &in, std::uint64_t &v, std::uint64_t &bytes)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        auto c = in.get();
+        if (c == std::char_traits<char>::eof())
+            return false;
+        ++bytes;
+        v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0)
+            return true;
+    }
+    Cursor::fail();
+}
+
+std::string tempPath(const std::string &path)
+{
+    return path + ".tmp";
+}
+} // namespace
+
+ChangeLogWriter::~ChangeLogWriter()
+{
+    close();
+}
+
+bool ChangeLogWriter::open(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    out_.close();
+    out_.open(tempPath(path), std::ios::binary | std::ios::trunc);
+    if (!out_)
+        return false;
+
+    path_ = path;
+    published_ = false;
+    seq_ = 0;
+    epoch_ = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+
+    char header[HEADER_BYTES];
+    std::copy(std::begin(MAGIC), std::end(MAGIC), header);
+    header[sizeof(MAGIC)] = VERSION;
+    for (std::size_t i = 0; i < 8; ++i)
+        header[sizeof(MAGIC) + 1 + i] = static_cast<char>(epoch_ >> (8 * i));
+    out_.write(header, sizeof(header));
+    return static_cast<bool>(out_);
+}
+
+bool ChangeLogWriter::publish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!out_.is_open() || published_)
+            return false;
+    }
+    append(ChangeOp::SNAPSHOT_END, note::Note{});
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeBuffer();
+    out_.flush();
+    // 같은 파일 시스템 안의 rename 은 원자적이라, 따라오는 쪽은 이전
+    // 로그나 스냅숏을 다 쓴 새 로그 중 하나만 본다.
+    std::error_code ec;
+    std::filesystem::rename(tempPath(path_), path_, ec);
+    if (ec || !out_)
+        return false;
+    published_ = true;
+    return true;
+}
+
+void ChangeLogWriter::close()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open())
+        return;
+    writeBuffer();
+    out_.close();
+}
+
+bool ChangeLogWriter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return out_.is_open();
+}
+
+std::uint64_t ChangeLogWriter::put(const note::Note &n)
+{
+    return append(ChangeOp::PUT, n);
+}
+
+std::uint64_t ChangeLogWriter::remove(note::Id id)
+{
+    note::Note n{};
+    n.id = id;
+    return append(ChangeOp::REMOVE, n);
+}
+
+std::uint64_t ChangeLogWriter::epoch() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return epoch_;
+}
+
+std::uint64_t ChangeLogWriter::seq() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seq_;
+}
+
+std::uint64_t ChangeLogWriter::append(ChangeOp op, const note::Note &n)
+{
+    // 본문 인코딩은 잠금 밖에서 한다. seq 는 잠금 안에서 붙이므로 길이를
+    // 앞에 쓰기 전에 seq 를 맨 앞에 끼워 넣는다.
+    thread_local std::string body;
+    body.clear();
+    putTime(body, std::chrono::system_clock::now());
+    body.push_back(static_cast<char>(op));
+    if (op == ChangeOp::PUT)
+        encodeNote(body, n);
+    else if (op == ChangeOp::REMOVE)
+        putVarint(body, static_cast<std::uint64_t>(n.id));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!out_.is_open())
+        return 0;
+
+    auto seq = ++seq_;
+    std::string prefix;
+    putVarint(prefix, seq);
+    putVarint(buffer_, prefix.size() + body.size());
+    buffer_.append(prefix).append(body);
+
+    // 스냅숏은 모아서 쓰고, 공개한 뒤의 변경은 바로 파일로 내보낸다.
+    if (published_)
+    {
+        writeBuffer();
+        out_.flush();
+    }
+    else if (buffer_.size() >= FLUSH_BYTES)
+    {
+        writeBuffer();
+    }
+    return seq;
+}
+
+void ChangeLogWriter::writeBuffer()
+{
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+bool ChangeLogReader::open(const std::string &path)
+{
+    in_.close();
+    in_.clear();
+    in_.open(path, std::ios::binary);
+    char header[HEADER_BYTES] = {};
+    if (!in_.read(header, sizeof(header)) ||
+        std::string_view(header, sizeof(MAGIC)) !=
+            std::string_view(MAGIC, sizeof(MAGIC)) ||
+        header[sizeof(MAGIC)] != VERSION)
+        return false;
+
+    epoch_ = 0;
+    for (std::size_t i = 0; i < 8; ++i)
+        epoch_ |= static_cast<std::uint64_t>(static_cast<unsigned char>(
+                      header[sizeof(MAGIC) + 1 + i]))
+            << (8 * i);
+    path_ = path;
+    offset_ = HEADER_BYTES;
+    rewind_ = false;
+    return true;
+}
+
+std::optional<ChangeRecord> ChangeLogReader::next()
+{
+    if (!in_.is_open())
+        return std::nullopt;
+    if (rewind_)
+    {
+        in_.clear();
+        in_.seekg(static_cast<std::streamoff>(offset_));
+        rewind_ = false;
+    }
+
+    std::uint64_t size = 0;
+    std::uint64_t bytes = 0;
+    if (!getVarint(in_, size, bytes))
+    {
+        rewind_ = true;
+        return std::nullopt;
+    }
+    if (size > MAX_RECORD_BYTES)
+        Cursor::fail();
+    payload_.resize(size);
+    if (size > 0 &&
+        !in_.read(payload_.data(), static_cast<std::streamsize>(size)))
+    {
+        rewind_ = true;
+        return std::nullopt;
+    }
+
+    auto record = decodeRecord(payload_);
+    offset_ += bytes + size;
+    return record;
+}
+
+bool ChangeLogReader::replaced() const
+{
+    auto epoch = readEpoch(path_);
+    return epoch && *epoch != epoch_;
+}
+
+std::uint64_t ChangeLogReader::pendingBytes()
+{
+    if (!in_.is_open())
+        return 0;
+    auto end = in_.rdbuf()->pubseekoff(0, std::ios::end, std::ios::in);
+    rewind_ = true;
+    if (end == std::streampos(-1))
+        return 0;
+    auto size = static_cast<std::uint64_t>(std::streamoff(end));
+    return size > offset_ ? size - offset_ : 0;
+}
+
+std::optional<std::uint64_t>
+ChangeLogReader::readEpoch(const std::string &path)
+{
+    ChangeLogReader reader;
+    if (!reader.open(path))
+        return std::nullopt;
+    return reader.epoch_;
+}
+
+} // namespace banchoo::replication
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "note/note.hpp"
+
+namespace banchoo::replication
+{
+
+enum class ChangeOp : std::uint8_t
+{
+    PUT,         // 노트 전체 (새로 만들었거나 고친 뒤의 값)
+    REMOVE,      // note.id 만 쓴다
+    SNAPSHOT_END // 여기까지가 로그를 열 때의 전체 노트다
+};
+
+// 변경 한 건. 고친 필드가 아니라 고친 뒤의 노트 전체를 담아서, 같은
+// 레코드를 두 번 적용해도 결과가 같다.
+struct ChangeRecord
+{
+    std::uint64_t seq = 0; // 로그 안에서 1부터 1씩 는다
+    note::TimePoint at;    // 리더가 기록한 시각
+    ChangeOp op = ChangeOp::PUT;
+    note::Note note{};
+};
+
+// 파일 형식: "BNCHLOG" + 버전 1바이트 + epoch u64 LE. 이어서 레코드가
+// 반복된다. 레코드: varint 길이 + 본문. 본문: varint seq, zigzag varint
+// at(ns), op 1바이트, 이어서 op 에 따라 노트 또는 id.
+// epoch 는 로그를 열 때마다 새로 정해서, 따라오는 쪽이 리더가 다시 시작해
+// 로그를 새로 썼는지 알 수 있게 한다.
+class ChangeLogWriter
+{
+ public:
+    ~ChangeLogWriter();
+
+    // path 옆의 임시 파일에 새 로그를 연다. publish() 전까지는 따라오는
+    // 쪽에 보이지 않으므로, 그사이 현재 노트 전체를 put 으로 쓴다.
+    bool open(const std::string &path);
+    // SNAPSHOT_END 를 쓰고 임시 파일을 path 로 바꿔 단다. 그 뒤의 기록은
+    // 바로 파일에 쓴다.
+    bool publish();
+    void close();
+    bool isOpen() const;
+
+    // 쓴 레코드의 seq. 부르는 쪽이 저장소에 쓴 순서대로 불러야 한다.
+    std::uint64_t put(const note::Note &n);
+    std::uint64_t remove(note::Id id);
+
+    std::uint64_t epoch() const;
+    std::uint64_t seq() const;
+
+ private:
+    static constexpr std::size_t FLUSH_BYTES = 64 * 1024;
+
+    std::uint64_t append(ChangeOp op, const note::Note &n);
+    void writeBuffer();
+
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    std::string path_;
+    std::string buffer_;
+    bool published_ = false;
+    std::uint64_t epoch_ = 0;
+    std::uint64_t seq_ = 0;
+};
+
+// 리더가 쓰고 있는 로그를 따라 읽는다. 한 스레드에서만 쓴다.
+class ChangeLogReader
+{
+ public:
+    bool open(const std::string &path);
+
+    // 다음 레코드. 아직 끝까지 쓰이지 않았으면 std::nullopt 이고, 다 쓰인
+    // 뒤에 다시 부르면 그 레코드를 읽는다. 본문이 깨졌으면
+    // std::runtime_error.
+    std::optional<ChangeRecord> next();
+
+    // path 에 다른 epoch 의 로그가 있으면 true. 지금 연 파일을 끝까지 읽은
+    // 뒤 다시 open 해야 한다.
+    bool replaced() const;
+    // 지금 연 파일에서 아직 읽지 않은 바이트 수
+    std::uint64_t pendingBytes();
+
+    std::uint64_t epoch() const
+    {
+        return epoch_;
+    }
+
+    // path 에 있는 로그의 epoch. 없거나 형식이 다르면 std::nullopt
+    static std::optional<std::uint64_t> readEpoch(const std::string &path);
+
+ private:
+    std::ifstream in_;
+    std::string path_;
+    std::string payload_;
+    std::uint64_t epoch_ = 0;
+    std::uint64_t offset_ = 0;
+    // 파일 끝에서 멈췄으면 다음에 offset_ 으로 되돌아가 다시 읽는다.
+    bool rewind_ = false;
+};
+
+} // namespace banchoo::replication
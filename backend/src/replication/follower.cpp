@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "replication/follower.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "common/logger.hpp"
+#include "metrics/registry.hpp"
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::replication
+{
+
+namespace
+{
+// 새 노트를 모아서 넣는 단위. 스냅숏을 받을 때 노트마다 잠그지 않는다.
+constexpr std::size_t CREATE_BATCH = 1024;
+// 큰 스냅숏을 받는 동안에도 이만큼마다 상태를 갱신한다.
+constexpr std::size_t STATUS_BATCH = 4096;
+constexpr std::size_t SCAN_BATCH = 1024;
+
+const metrics::Counter &appliedCounter()
+{
+    static const auto counter = metrics::Registry::instance().counter(
+        "banchoo_replication_applied_total",
+        "Change log records applied by the follower");
+    return counter;
+}
+
+const metrics::Histogram &lagHistogram()
+{
+    static const auto histogram = metrics::Registry::instance().histogram(
+        "banchoo_replication_lag_us",
+        "Time from a change being logged on the leader to being applied");
+    return histogram;
+}
+} // namespace
+
+nlohmann::json FollowerStatus::toJson() const
+{
+    return {{"epoch", epoch},
+            {"seq", seq},
+            {"pending_bytes", pending_bytes},
+            {"lag_us", lag_us},
+            {"applied", applied},
+            {"synced", synced}};
+}
+
+Follower::Follower(std::shared_ptr<repository::BaseRepository> repo,
+                   std::string path,
+                   std::chrono::milliseconds poll)
+    : repo_(std::move(repo)), path_(std::move(path)), poll_(poll)
+{
+}
+
+Follower::~Follower()
+{
+    stop();
+}
+
+std::size_t Follower::poll()
+{
+    std::lock_guard<std::mutex> lock(poll_mutex_);
+    if (!reader_ && !openLog())
+        return 0;
+
+    std::size_t applied = 0;
+    std::size_t unreported = 0;
+    std::uint64_t seq = 0;
+    note::TimePoint at;
+    auto report = [&]
+    {
+        flushCreates();
+        if (unreported == 0)
+            return;
+        auto lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now() - at)
+                       .count();
+        std::lock_guard<std::mutex> status_lock(status_mutex_);
+        status_.seq = seq;
+        status_.lag_us = lag > 0 ? static_cast<std::uint64_t>(lag) : 0;
+        status_.applied += unreported;
+        unreported = 0;
+    };
+
+    for (;;)
+    {
+        auto record = reader_->next();
+        if (!record)
+        {
+            report();
+            // 지금 파일을 끝까지 읽은 뒤에야 새 로그로 넘어간다.
+            if (!reader_->replaced())
+                break;
+            BANCHOO_INFO("change log replaced, resyncing from {}", path_);
+            if (!openLog())
+                break;
+            continue;
+        }
+
+        seq = record->seq;
+        at = record->at;
+        auto lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now() - at)
+                       .count();
+        apply(std::move(*record));
+        appliedCounter().inc();
+        lagHistogram().observe(lag > 0 ? static_cast<std::uint64_t>(lag) : 0);
+        ++applied;
+        if (++unreported >= STATUS_BATCH)
+            report();
+    }
+
+    auto pending = reader_->pendingBytes();
+    std::lock_guard<std::mutex> status_lock(status_mutex_);
+    status_.pending_bytes = pending;
+    return applied;
+}
+
+bool Follower::openLog()
+{
+    ChangeLogReader reader;
+    if (!reader.open(path_))
+        return false;
+
+    flushCreates();
+    stale_.clear();
+    note::Id after = 0;
+    for (;;)
+    {
+        auto batch = repo_->scanNotes(after, SCAN_BATCH);
+        if (batch.empty())
+            break;
+        for (const auto &n : batch)
+            stale_.insert(n->id);
+        after = batch.back()->id;
+    }
+
+    BANCHOO_INFO("following change log {} (epoch {}), {} local notes",
+                 path_,
+                 reader.epoch(),
+                 stale_.size());
+    std::lock_guard<std::mutex> status_lock(status_mutex_);
+    status_.epoch = reader.epoch();
+    status_.seq = 0;
+    status_.synced = false;
+    reader_ = std::move(reader);
+    return true;
+}
+
+void Follower::apply(ChangeRecord &&record)
+{
+    auto id = record.note.id;
+    switch (record.op)
+    {
+    case ChangeOp::PUT:
+        stale_.erase(id);
+        // 같은 노트가 모아 둔 묶음에 있으면 먼저 넣어야 갱신이 된다.
+        if (create_ids_.count(id))
+            flushCreates();
+        if (repo_->getNote(id))
+        {
+            repo_->updateNote(std::move(record.note));
+            break;
+        }
+        create_ids_.insert(id);
+        creates_.push_back(std::move(record.note));
+        if (creates_.size() >= CREATE_BATCH)
+            flushCreates();
+        break;
+    case ChangeOp::REMOVE:
+        if (create_ids_.count(id))
+            flushCreates();
+        repo_->deleteNote(id);
+        break;
+    case ChangeOp::SNAPSHOT_END:
+    {
+        // 스냅숏에 없던 노트는 리더가 다시 시작하기 전에 지워진 것이다.
+        flushCreates();
+        for (auto stale : stale_)
+            repo_->deleteNote(stale);
+        stale_.clear();
+        std::lock_guard<std::mutex> status_lock(status_mutex_);
+        status_.synced = true;
+        break;
+    }
+    }
+}
+
+void Follower::flushCreates()
+{
+    if (creates_.empty())
+        return;
+    repo_->createNotes(creates_);
+    creates_.clear();
+    create_ids_.clear();
+}
+
+void Follower::start()
+{
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (thread_.joinable())
+        return;
+    stopping_ = false;
+    thread_ = std::thread([this] { run(); });
+}
+
+void Follower::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+FollowerStatus Follower::status() const
+{
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    return status_;
+}
+
+void Follower::run()
+{
+    std::unique_lock<std::mutex> lock(thread_mutex_);
+    while (!stopping_)
+    {
+        lock.unlock();
+        try
+        {
+            poll();
+        }
+        catch (const std::exception &e)
+        {
+            BANCHOO_ERROR("replication failed: {}", e.what());
+        }
+        lock.lock();
+        cv_.wait_for(lock, poll_, [this] { return stopping_; });
+    }
+}
+
+} // namespace banchoo::replication
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::replication
+{
+
+struct FollowerStatus
+{
+    std::uint64_t epoch = 0;
+    std::uint64_t seq = 0;           // 마지막으로 적용한 레코드
+    std::uint64_t pending_bytes = 0; // 로그에 남은, 아직 읽지 않은 양
+    // 마지막으로 적용한 변경이 리더에서 쓰인 뒤 적용되기까지 걸린 시간
+    std::uint64_t lag_us = 0;
+    std::uint64_t applied = 0; // 시작한 뒤 적용한 레코드 수
+    bool synced = false;       // 스냅숏을 다 받았다
+
+    nlohmann::json toJson() const;
+};
+
+// 리더가 쓰는 변경 로그를 따라 읽어 저장소에 적용한다. 저장소는 리더의 id
+// 를 그대로 받아야 하므로 id 를 새로 붙이지 않는 메모리 저장소여야 한다.
+// 로그는 늘 스냅숏으로 시작하므로 따라오는 쪽은 상태를 따로 남기지 않고,
+// 시작하거나 리더가 로그를 새로 쓸 때마다 스냅숏부터 다시 맞춘다.
+class Follower
+{
+ public:
+    Follower(std::shared_ptr<repository::BaseRepository> repo,
+             std::string path,
+             std::chrono::milliseconds poll = std::chrono::milliseconds(50));
+    ~Follower();
+
+    Follower(const Follower &) = delete;
+    Follower &operator=(const Follower &) = delete;
+
+    // 로그에 새로 쓰인 변경을 모두 적용한다. 적용한 레코드 수를 돌려준다.
+    // 로그가 아직 없으면 0 이다.
+    std::size_t poll();
+
+    // poll 간격마다 깨어나 poll 을 부르는 스레드
+    void start();
+    void stop();
+
+    FollowerStatus status() const;
+
+ private:
+    // 새 epoch 의 로그를 연다. 스냅숏에 없는 노트를 지우려고 지금 가진
+    // id 를 모두 기억해 둔다.
+    bool openLog();
+    void apply(ChangeRecord &&record);
+    // 모아 둔 새 노트를 한 번에 넣는다.
+    void flushCreates();
+    void run();
+
+    std::shared_ptr<repository::BaseRepository> repo_;
+    const std::string path_;
+    const std::chrono::milliseconds poll_;
+
+    // poll 은 한 번에 한 스레드만
+    std::mutex poll_mutex_;
+    std::optional<ChangeLogReader> reader_;
+    std::unordered_set<note::Id> stale_;
+    std::vector<note::Note> creates_;
+    std::unordered_set<note::Id> create_ids_;
+
+    mutable std::mutex status_mutex_;
+    FollowerStatus status_;
+
+    std::mutex thread_mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+} // namespace banchoo::replication
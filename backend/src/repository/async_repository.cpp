@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/async_repository.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "common/logger.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+AsyncRepository::AsyncRepository(std::shared_ptr<BaseRepository> repo,
+                                 std::size_t threads)
+    : repo_(std::move(repo))
+{
+    if (threads == 0)
+        throw std::invalid_argument("AsyncRepository needs at least 1 thread");
+
+    threads_.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i)
+        threads_.emplace_back([this] { work(); });
+    BANCHOO_INFO("storage executor: {} threads", threads);
+}
+
+AsyncRepository::~AsyncRepository()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+std::size_t AsyncRepository::pending() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void AsyncRepository::enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void AsyncRepository::work()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty())
+                return; // 멈추는 중이고 남은 작업도 없다
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace banchoo::repository
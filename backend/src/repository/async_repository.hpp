@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 저장소 호출을 전용 스레드 풀에서 돌린다. 부르는 쪽(Crow 작업 스레드)은
+// fsync 를 기다리지 않고 바로 돌아가고, 결과는 future 나 완료 콜백으로 받는다.
+// 작업은 넣은 순서대로 꺼내지만, 스레드가 여럿이면 끝나는 순서는 다를 수 있다.
+class AsyncRepository
+{
+ public:
+    AsyncRepository(std::shared_ptr<BaseRepository> repo, std::size_t threads);
+    // 이미 넣은 작업을 모두 끝낸 뒤 스레드를 멈춘다.
+    ~AsyncRepository();
+
+    AsyncRepository(const AsyncRepository &) = delete;
+    AsyncRepository &operator=(const AsyncRepository &) = delete;
+
+    // fn(repo) 를 저장소 스레드에서 돌리고 그 결과를 future 로 돌려준다.
+    // fn 이 던진 예외는 future::get 에서 다시 던져진다.
+    template <typename F>
+    auto submit(F &&fn)
+        -> std::future<std::invoke_result_t<std::decay_t<F> &,
+                                            BaseRepository &>>
+    {
+        auto task = makeTask(repo_, std::forward<F>(fn));
+        auto future = task->get_future();
+        enqueue([task] { (*task)(); });
+        return future;
+    }
+
+    // fn(repo) 를 저장소 스레드에서 돌리고, 끝나면 같은 스레드에서 결과가
+    // 준비된 future 로 done 을 부른다. done 은 결과를 원래 스레드로 돌려보내는
+    // 일만 하고 바로 돌아와야 한다.
+    template <typename F, typename Done>
+    void then(F &&fn, Done &&done)
+    {
+        then(repo_, std::forward<F>(fn), std::forward<Done>(done));
+    }
+
+    // 같은 스레드 풀에서 다른 저장소(테넌트 저장소 등)에 대해 돌린다.
+    template <typename F, typename Done>
+    void then(std::shared_ptr<BaseRepository> repo, F &&fn, Done &&done)
+    {
+        auto task = makeTask(std::move(repo), std::forward<F>(fn));
+        enqueue(
+            [task, done = std::forward<Done>(done)]() mutable
+            {
+                (*task)();
+                done(task->get_future());
+            });
+    }
+
+    // 저장소를 받지 않는 작업(chunked 응답의 다음 조각 만들기 등)을 같은
+    // 스레드 풀에서 돌린다.
+    void post(std::function<void()> job)
+    {
+        enqueue(std::move(job));
+    }
+
+    // 아직 시작하지 않은 작업 수
+    std::size_t pending() const;
+
+    BaseRepository &repository() const
+    {
+        return *repo_;
+    }
+
+ private:
+    template <typename F>
+    auto makeTask(std::shared_ptr<BaseRepository> repo, F &&fn)
+    {
+        using Result =
+            std::invoke_result_t<std::decay_t<F> &, BaseRepository &>;
+        // std::function 에 담을 수 있도록 shared_ptr 로 감싼다.
+        return std::make_shared<std::packaged_task<Result()>>(
+            [repo = std::move(repo), fn = std::forward<F>(fn)]() mutable
+            { return fn(*repo); });
+    }
+
+    void enqueue(std::function<void()> job);
+    void work();
+
+    std::shared_ptr<BaseRepository> repo_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+} // namespace banchoo::repository
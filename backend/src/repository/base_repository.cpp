@@ -6,36 +6,93 @@
 
 #include "repository/base_repository.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
 #include "common/logger.hpp"
+#include "index/content_matcher.hpp"
+#include "index/suggest_index.hpp"
+#include "index/tag_query.hpp"
 #include "note/note.hpp"
+#include "stats/note_stats.hpp"
+#include "trace/tracer.hpp"
 
 namespace banchoo::repository
 {
-note::Id BaseRepository::createMemo(const note::Note &note)
+
+namespace
+{
+constexpr note::FieldMask PATCHABLE_FIELDS =
+    note::field::CONTENT | note::field::STATUS | note::field::DUE_DATE |
+    note::field::START_DATE | note::field::END_DATE | note::field::TAGS;
+
+// grepNotes 기본 구현이 한 번에 읽는 노트 수
+constexpr std::size_t GREP_BATCH = 1024;
+} // namespace
+
+void BaseRepository::createNotes(std::span<note::Note> notes)
 {
-    note::Note new_note = note;
+    for (auto &n : notes)
+        this->createNote(std::move(n));
+}
+
+void BaseRepository::importNotes(std::span<note::Note> notes)
+{
+    BANCHOO_SPAN("BaseRepository::importNotes");
+
+    auto now = std::chrono::system_clock::now();
+    for (auto &n : notes)
+    {
+        n.id = this->newId();
+        if (n.created_at == note::TimePoint{})
+            n.created_at = now;
+        if (n.updated_at == note::TimePoint{})
+            n.updated_at = n.created_at;
+    }
+    this->createNotes(notes);
+}
+
+note::NotePtr BaseRepository::createMemo(note::Note &&note)
+{
+    BANCHOO_SPAN("BaseRepository::createMemo");
+
+    note::Note new_note = std::move(note);
     new_note.id = this->newId();
     new_note.type = note::NoteType::MEMO;
     new_note.created_at = std::chrono::system_clock::now();
-    new_note.updated_at = note.created_at;
+    new_note.updated_at = new_note.created_at;
 
     BANCHOO_TRACE("Create memo: id: {}, type: {}, created_at: {}",
                   new_note.id,
                   banchoo::note::to_string(new_note.type),
                   banchoo::note::to_string(new_note.created_at));
 
-    return this->createNote(new_note);
+    return this->createNote(std::move(new_note));
 }
 
-note::Id BaseRepository::createTask(const note::Note &note)
+note::NotePtr BaseRepository::createTask(note::Note &&note)
 {
+    BANCHOO_SPAN("BaseRepository::createTask");
+
     BANCHOO_DEBUG("Create task: {}", note.content);
 
-    note::Note new_note = note;
+    note::Note new_note = std::move(note);
     new_note.id = this->newId();
     new_note.type = note::NoteType::TASK;
     new_note.created_at = std::chrono::system_clock::now();
-    new_note.updated_at = note.created_at;
+    new_note.updated_at = new_note.created_at;
 
     new_note.status = note::NoteStatus::TODO;
 
@@ -45,25 +102,176 @@ note::Id BaseRepository::createTask(const note::Note &note)
                   banchoo::note::to_string(new_note.created_at),
                   banchoo::note::to_string(new_note.status.value()));
 
-    return this->createNote(new_note);
+    return this->createNote(std::move(new_note));
 }
 
-note::Id BaseRepository::createEvent(const note::Note &note)
+note::NotePtr BaseRepository::createEvent(note::Note &&note)
 {
+    BANCHOO_SPAN("BaseRepository::createEvent");
+
     BANCHOO_DEBUG("Create event: {}", note.content);
 
-    note::Note new_note = note;
+    note::Note new_note = std::move(note);
     new_note.id = this->newId();
     new_note.type = note::NoteType::EVENT;
     new_note.created_at = std::chrono::system_clock::now();
-    new_note.updated_at = note.created_at;
+    new_note.updated_at = new_note.created_at;
 
     BANCHOO_TRACE("Create event: id: {}, type: {}, created_at: {}",
                   new_note.id,
                   banchoo::note::to_string(new_note.type),
                   banchoo::note::to_string(new_note.created_at));
 
-    return this->createNote(new_note);
+    return this->createNote(std::move(new_note));
+}
+
+bool BaseRepository::patchNote(note::Id id,
+                               note::Note &&values,
+                               note::FieldMask fields)
+{
+    BANCHOO_SPAN("BaseRepository::patchNote");
+
+    values.updated_at = std::chrono::system_clock::now();
+    fields = (fields & PATCHABLE_FIELDS) | note::field::UPDATED_AT;
+    return this->applyPatch(id, std::move(values), fields);
+}
+
+NoteList BaseRepository::getNotes(std::span<const note::Id> ids,
+                                  const note::Projection &,
+                                  std::pmr::memory_resource *mr) const
+{
+    NoteList notes(mr);
+    notes.reserve(ids.size());
+    for (auto id : ids)
+    {
+        if (auto n = this->getNote(id))
+            notes.push_back(std::move(n));
+    }
+    return notes;
+}
+
+NoteList BaseRepository::findNotes(const index::TagQuery &query,
+                                   std::optional<note::NoteType> type,
+                                   const note::Projection &projection,
+                                   std::pmr::memory_resource *mr) const
+{
+    BANCHOO_SPAN("BaseRepository::findNotes");
+
+    auto with_tags = projection;
+    with_tags.fields |= note::field::TAGS;
+    auto notes = listNotes(type, with_tags, mr);
+    std::erase_if(notes,
+                  [&](const note::NotePtr &n)
+                  { return !query.matches(n->tags); });
+    std::sort(notes.begin(),
+              notes.end(),
+              [](const note::NotePtr &a, const note::NotePtr &b)
+              { return a->id < b->id; });
+    return notes;
+}
+
+std::vector<note::Id>
+BaseRepository::grepNotes(const index::ContentMatcher &matcher,
+                          std::size_t limit) const
+{
+    BANCHOO_SPAN("BaseRepository::grepNotes");
+
+    std::vector<note::Id> ids;
+    note::Id after = 0;
+    while (ids.size() < limit)
+    {
+        auto batch = scanNotes(
+            after, GREP_BATCH, std::nullopt, {.fields = note::field::CONTENT});
+        if (batch.empty())
+            break;
+        for (const auto &n : batch)
+        {
+            if (ids.size() < limit && matcher.matches(n->content))
+                ids.push_back(n->id);
+        }
+        after = batch.back()->id;
+    }
+    return ids;
+}
+
+std::vector<note::Id> BaseRepository::suggestNotes(std::string_view prefix,
+                                                   std::size_t limit) const
+{
+    BANCHOO_SPAN("BaseRepository::suggestNotes");
+
+    constexpr auto fields =
+        note::field::ID | note::field::CONTENT | note::field::UPDATED_AT |
+        note::field::TAGS;
+    std::vector<std::pair<note::TimePoint, note::Id>> found;
+    for (const auto &n : getAllNotes({fields, 0}))
+    {
+        auto terms = index::suggestTerms(n->content, n->tags);
+        if (std::any_of(terms.begin(),
+                        terms.end(),
+                        [&](const std::string &term)
+                        { return term.starts_with(prefix); }))
+            found.emplace_back(n->updated_at, n->id);
+    }
+
+    limit = std::min(limit, found.size());
+    std::partial_sort(found.begin(),
+                      found.begin() + static_cast<std::ptrdiff_t>(limit),
+                      found.end(),
+                      std::greater<>());
+    std::vector<note::Id> ids;
+    ids.reserve(limit);
+    for (std::size_t i = 0; i < limit; ++i)
+        ids.push_back(found[i].second);
+    return ids;
+}
+
+stats::NoteStats BaseRepository::noteStats(note::TimePoint now) const
+{
+    BANCHOO_SPAN("BaseRepository::noteStats");
+
+    stats::StatsAggregator aggregator;
+    auto notes = getAllNotes({stats::StatsAggregator::FIELDS, 0});
+    for (const auto &n : notes)
+        aggregator.add(*n);
+    return aggregator.snapshot(now);
+}
+
+NoteList BaseRepository::getAllNotes(const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
+{
+    return listNotes(std::nullopt, projection, mr);
+}
+
+NoteList BaseRepository::getAllMemos(const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
+{
+    return listNotes(note::NoteType::MEMO, projection, mr);
+}
+
+NoteList BaseRepository::getAllTasks(const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
+{
+    return listNotes(note::NoteType::TASK, projection, mr);
+}
+
+NoteList BaseRepository::getAllEvents(const note::Projection &projection,
+                                      std::pmr::memory_resource *mr) const
+{
+    return listNotes(note::NoteType::EVENT, projection, mr);
+}
+
+std::size_t BaseRepository::compressThreshold(const nlohmann::json &config)
+{
+    if (!config.is_object())
+        return 0;
+    return config.value("compress_threshold", std::size_t{0});
+}
+
+note::NotePtr BaseRepository::makeNote(note::Note &&note,
+                                       std::pmr::memory_resource *mr)
+{
+    return std::allocate_shared<const note::Note>(
+        std::pmr::polymorphic_allocator<note::Note>(mr), std::move(note));
 }
 
 note::Id BaseRepository::newId()
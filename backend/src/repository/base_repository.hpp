@@ -5,36 +5,137 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
 #include "note/note.hpp"
+#include "stats/note_stats.hpp"
 
 namespace banchoo::repository
 {
+// 목록 조회 결과. 요청 단위 아레나에 담을 수 있도록 pmr 벡터를 쓴다.
+using NoteList = std::pmr::vector<note::NotePtr>;
+
 class BaseRepository
 {
  public:
     virtual ~BaseRepository() = default;
 
-    virtual note::Id createNote(const note::Note &note) = 0;
+    // 저장된 노트를 돌려준다. 입력 노트는 복사 없이 저장소로 옮겨진다.
+    virtual note::NotePtr createNote(note::Note &&note) = 0;
+
+    // id 가 붙은 노트 여러 개를 한 번에 저장한다. 기본 구현은 createNote 를
+    // 차례로 부르고, 저장소는 한 트랜잭션이나 한 번의 잠금으로 묶을 수 있다.
+    virtual void createNotes(std::span<note::Note> notes);
+
+    note::NotePtr createMemo(note::Note &&note);
+    note::NotePtr createTask(note::Note &&note);
+    note::NotePtr createEvent(note::Note &&note);
+
+    // 가져오기용. 각 노트에 새 id 를 붙이고 비어 있는 생성/수정 시각을 지금으로
+    // 채운 뒤 createNotes 로 저장한다. 종류와 나머지 필드는 그대로 둔다.
+    void importNotes(std::span<note::Note> notes);
+
+    // 없는 id 면 nullptr
+    virtual note::NotePtr getNote(note::Id id) const = 0;
+
+    // id 가 after 보다 큰 노트를 id 순으로 최대 limit 개. type 이 있으면 그
+    // 종류만. 전체를 잠그지 않고 조금씩 훑는 커서로, 마지막 id 를 다음 after
+    // 로 넘긴다. limit 보다 적게 오면 끝이다. projection 은 getAllNotes 와
+    // 같은 힌트다.
+    virtual NoteList scanNotes(note::Id after,
+                               std::size_t limit,
+                               std::optional<note::NoteType> type =
+                                   std::nullopt,
+                               const note::Projection &projection = {},
+                               std::pmr::memory_resource *mr =
+                                   std::pmr::get_default_resource()) const = 0;
+
+    // ids 의 노트를 그 순서대로 읽는다. 없는 id 는 건너뛴다. 기본 구현은
+    // getNote 를 차례로 부른다.
+    virtual NoteList getNotes(std::span<const note::Id> ids,
+                              const note::Projection &projection = {},
+                              std::pmr::memory_resource *mr =
+                                  std::pmr::get_default_resource()) const;
 
-    note::Id createMemo(const note::Note &note);
-    note::Id createTask(const note::Note &note);
-    note::Id createEvent(const note::Note &note);
+    // 태그 식에 맞는 노트를 id 순으로. type 이 있으면 그 종류만. 기본 구현은
+    // 목록 전체를 읽어 거른다. 색인은 IndexedRepository 가 맡는다.
+    virtual NoteList findNotes(const index::TagQuery &query,
+                               std::optional<note::NoteType> type,
+                               const note::Projection &projection = {},
+                               std::pmr::memory_resource *mr =
+                                   std::pmr::get_default_resource()) const;
 
-    virtual std::optional<note::Note> getNote(note::Id id) const = 0;
-    virtual std::vector<note::Note> getAllNotes() const = 0;
-    virtual std::vector<note::Note> getAllMemos() const = 0;
-    virtual std::vector<note::Note> getAllTasks() const = 0;
-    virtual std::vector<note::Note> getAllEvents() const = 0;
-    virtual bool updateNote(const note::Note &note) = 0;
+    // 본문이 matcher 에 맞는 노트의 id 를 id 순으로 최대 limit 개. 기본
+    // 구현은 scanNotes 로 조금씩 읽어 거른다. 메모리 저장소는 본문을 여러
+    // 스레드로 나눠 훑는다.
+    virtual std::vector<note::Id>
+    grepNotes(const index::ContentMatcher &matcher, std::size_t limit) const;
+
+    // prefix (index::normalizePrefix 를 거친 값) 로 시작하는 단어가 있는
+    // 노트의 id 를 updated_at 이 최근인 순서로 최대 limit 개. 기본 구현은
+    // 목록 전체를 읽어 단어로 나눈다. 색인은 SuggestRepository 가 맡는다.
+    virtual std::vector<note::Id> suggestNotes(std::string_view prefix,
+                                               std::size_t limit) const;
+
+    // now 기준의 종류별, 상태별, 날짜별 집계. 기본 구현은 목록 전체를 읽어
+    // 센다. 미리 집계해 두는 것은 StatsRepository 가 맡는다.
+    virtual stats::NoteStats noteStats(note::TimePoint now) const;
+
+    // 목록과, 저장소가 새로 만드는 노트는 mr 에서 할당된다. 아레나를 넘기면
+    // 결과는 그 아레나가 비워지기 전까지만 유효하다.
+    // projection 은 저장소가 읽지 않아도 되는 필드를 알려 주는 힌트다.
+    // 저장소는 그 밖의 필드를 채워서 돌려줄 수도 있다.
+    NoteList getAllNotes(const note::Projection &projection = {},
+                         std::pmr::memory_resource *mr =
+                             std::pmr::get_default_resource()) const;
+    NoteList getAllMemos(const note::Projection &projection = {},
+                         std::pmr::memory_resource *mr =
+                             std::pmr::get_default_resource()) const;
+    NoteList getAllTasks(const note::Projection &projection = {},
+                         std::pmr::memory_resource *mr =
+                             std::pmr::get_default_resource()) const;
+    NoteList getAllEvents(const note::Projection &projection = {},
+                          std::pmr::memory_resource *mr =
+                              std::pmr::get_default_resource()) const;
+
+    virtual bool updateNote(note::Note &&note) = 0;
+    // fields 에 든 필드만 바꾸고 updated_at 을 갱신한다. 없는 id 면 false.
+    // id, type, created_at 은 바꿀 수 없어 무시된다.
+    bool patchNote(note::Id id, note::Note &&values, note::FieldMask fields);
     virtual bool deleteNote(note::Id id) = 0;
 
  protected:
+    // type 이 없으면 전체 노트. id 와 type 은 projection 과 상관없이 채운다.
+    virtual NoteList listNotes(std::optional<note::NoteType> type,
+                               const note::Projection &projection,
+                               std::pmr::memory_resource *mr) const = 0;
+    // fields 에는 항상 UPDATED_AT 이 들어 있다.
+    virtual bool applyPatch(note::Id id,
+                            note::Note &&values,
+                            note::FieldMask fields) = 0;
+
     note::Id newId();
 
+    // 저장소 설정의 "compress_threshold" (바이트). 이보다 긴 본문은 압축해
+    // 저장한다. 없거나 0 이면 압축하지 않는다.
+    static std::size_t compressThreshold(const nlohmann::json &config);
+
+    // 조회 결과로 내줄 노트를 mr 에 만든다.
+    static note::NotePtr makeNote(note::Note &&note,
+                                  std::pmr::memory_resource *mr);
+
  private:
-    note::Id next_id_ = 1;
+    std::atomic<note::Id> next_id_ = 1;
 };
 } // namespace banchoo::repository
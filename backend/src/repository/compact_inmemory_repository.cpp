@@ -0,0 +1,566 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/compact_inmemory_repository.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "index/parallel_scan.hpp"
+#include "note/content_codec.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+constexpr std::uint8_t PRESENT_STATUS = 1U << 0;
+constexpr std::uint8_t PRESENT_DUE_DATE = 1U << 1;
+constexpr std::uint8_t PRESENT_START_DATE = 1U << 2;
+constexpr std::uint8_t PRESENT_END_DATE = 1U << 3;
+// 아레나의 본문이 content_codec 으로 압축돼 있다.
+constexpr std::uint8_t PRESENT_PACKED = 1U << 4;
+
+// 이보다 작은 아레나는 정리하지 않는다.
+constexpr std::size_t MIN_COMPACT_BYTES = 64 * 1024;
+
+static_assert(sizeof(note::TimePoint::rep) == sizeof(std::int64_t));
+
+// 2배씩 늘리면 백만 단위에서 절반 가까이가 빈 공간으로 남으므로 25% 씩
+// 늘린다.
+template <typename Container>
+void reserveFor(Container &c, std::size_t extra)
+{
+    if (c.size() + extra > c.capacity())
+        c.reserve(c.size() + std::max(extra, c.size() / 4));
+}
+
+std::int64_t toRep(const note::TimePoint &tp)
+{
+    return tp.time_since_epoch().count();
+}
+
+note::TimePoint fromRep(std::int64_t rep)
+{
+    return note::TimePoint(note::TimePoint::duration(rep));
+}
+
+std::uint8_t storeOptional(const std::optional<note::TimePoint> &tp,
+                           std::int64_t &rep,
+                           std::uint8_t bit)
+{
+    rep = tp ? toRep(*tp) : 0;
+    return tp ? bit : 0;
+}
+
+std::optional<note::TimePoint>
+loadOptional(std::int64_t rep, std::uint8_t present, std::uint8_t bit)
+{
+    if (present & bit)
+        return fromRep(rep);
+    return std::nullopt;
+}
+} // namespace
+
+CompactInMemoryRepository::CompactInMemoryRepository(
+    const nlohmann::json &config)
+    : compress_threshold_(compressThreshold(config))
+{
+}
+
+note::NotePtr CompactInMemoryRepository::createNote(note::Note &&note)
+{
+    if (note.id <= 0)
+        throw std::invalid_argument("Note id must be positive");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        insert(note);
+    }
+
+    return std::make_shared<const note::Note>(std::move(note));
+}
+
+void CompactInMemoryRepository::createNotes(std::span<note::Note> notes)
+{
+    std::size_t bytes = 0;
+    for (const auto &n : notes)
+    {
+        if (n.id <= 0)
+            throw std::invalid_argument("Note id must be positive");
+        bytes += n.content.size();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    reserveFor(slots_, notes.size());
+    writableArena(bytes);
+    for (const auto &n : notes)
+        insert(n);
+}
+
+void CompactInMemoryRepository::insert(const note::Note &note)
+{
+    Slot *slot = find(note.id);
+    if (!slot)
+    {
+        std::uint32_t pos;
+        if (!free_slots_.empty())
+        {
+            pos = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        else
+        {
+            if (slots_.size() >= std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("Too many notes");
+            pos = static_cast<std::uint32_t>(slots_.size());
+            reserveFor(slots_, 1);
+            slots_.emplace_back();
+        }
+
+        auto id = static_cast<std::size_t>(note.id);
+        if (index_.size() <= id)
+        {
+            reserveFor(index_, id + 1 - index_.size());
+            index_.resize(id + 1, NO_SLOT);
+        }
+        index_[id] = pos + 1;
+        slot = &slots_[pos];
+    }
+    store(*slot, note);
+}
+
+note::NotePtr CompactInMemoryRepository::getNote(note::Id id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Slot *slot = find(id);
+    return slot ? load(*slot) : nullptr;
+}
+
+NoteList
+CompactInMemoryRepository::getNotes(std::span<const note::Id> ids,
+                                    const note::Projection &projection,
+                                    std::pmr::memory_resource *mr) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    NoteList notes(mr);
+    notes.reserve(ids.size());
+    for (auto id : ids)
+    {
+        if (const Slot *slot = find(id))
+            notes.push_back(load(*slot, projection, mr));
+    }
+    return notes;
+}
+
+NoteList
+CompactInMemoryRepository::scanNotes(note::Id after,
+                                     std::size_t limit,
+                                     std::optional<note::NoteType> type,
+                                     const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    NoteList notes(mr);
+    for (auto i = static_cast<std::size_t>(std::max<note::Id>(after, 0)) + 1;
+         i < index_.size() && notes.size() < limit;
+         ++i)
+    {
+        if (index_[i] == NO_SLOT)
+            continue;
+        const auto &slot = slots_[index_[i] - 1];
+        if (!type || slot.type == static_cast<std::uint8_t>(*type))
+            notes.push_back(load(slot, projection, mr));
+    }
+    return notes;
+}
+
+std::vector<note::Id>
+CompactInMemoryRepository::grepNotes(const index::ContentMatcher &matcher,
+                                     std::size_t limit) const
+{
+    // 잠금 안에서는 아레나 세대와 본문 자리만 복사하고 잠금 밖에서 훑는다.
+    // 훑는 동안의 쓰기는 writableArena 가 새 세대에 하므로 이 세대는 그대로다.
+    struct Span
+    {
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0;
+        bool live = false;
+        bool packed = false;
+    };
+    std::shared_ptr<const std::vector<char>> arena;
+    std::vector<Span> spans;
+    std::size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arena = arena_;
+        bytes = arena_->size() - garbage_;
+        spans.resize(index_.size());
+        for (std::size_t i = 0; i < index_.size(); ++i)
+        {
+            if (index_[i] == NO_SLOT)
+                continue;
+            const auto &slot = slots_[index_[i] - 1];
+            spans[i] = {slot.content_offset,
+                        slot.content_size,
+                        true,
+                        (slot.present & PRESENT_PACKED) != 0};
+        }
+    }
+
+    auto scan = [&]
+    {
+        return index::parallelScan(
+            spans.size(),
+            limit,
+            bytes,
+            [&](std::size_t i)
+            {
+                const auto &span = spans[i];
+                if (!span.live)
+                    return false;
+                std::string_view content(arena->data() + span.offset,
+                                         span.size);
+                if (span.packed)
+                    return matcher.matches(note::unpack_content(content));
+                return matcher.matches(content);
+            });
+    };
+    // 세대를 놓는 것도 잠금 안에서 해야 쓰는 쪽이 use_count 로 본 값이 맞다.
+    std::vector<std::size_t> hits;
+    try
+    {
+        hits = scan();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arena.reset();
+        throw;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arena.reset();
+    }
+
+    // index_ 는 id 를 그대로 자리로 쓴다.
+    std::vector<note::Id> ids;
+    ids.reserve(hits.size());
+    for (auto i : hits)
+        ids.push_back(static_cast<note::Id>(i));
+    return ids;
+}
+
+bool CompactInMemoryRepository::updateNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = find(note.id);
+    if (!slot)
+        return false;
+
+    store(*slot, note);
+    compactArena();
+    return true;
+}
+
+bool CompactInMemoryRepository::applyPatch(note::Id id,
+                                           note::Note &&values,
+                                           note::FieldMask fields)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = find(id);
+    if (!slot)
+        return false;
+
+    // 슬롯에서 바뀐 필드만 고친다.
+    if (fields & note::field::CONTENT)
+        storeContent(*slot, values.content);
+    if (fields & note::field::TAGS)
+        storeTags(id, values.tags);
+    if (fields & note::field::UPDATED_AT)
+        slot->updated_at = toRep(values.updated_at);
+    if (fields & note::field::STATUS)
+    {
+        slot->present &= static_cast<std::uint8_t>(~PRESENT_STATUS);
+        if (values.status)
+        {
+            slot->present |= PRESENT_STATUS;
+            slot->status = static_cast<std::uint8_t>(*values.status);
+        }
+    }
+    auto patchTime = [&](note::FieldMask field,
+                         const std::optional<note::TimePoint> &tp,
+                         std::int64_t &rep,
+                         std::uint8_t bit)
+    {
+        if (fields & field)
+        {
+            slot->present &= static_cast<std::uint8_t>(~bit);
+            slot->present |= storeOptional(tp, rep, bit);
+        }
+    };
+    patchTime(note::field::DUE_DATE,
+              values.due_date,
+              slot->due_date,
+              PRESENT_DUE_DATE);
+    patchTime(note::field::START_DATE,
+              values.start_date,
+              slot->start_date,
+              PRESENT_START_DATE);
+    patchTime(note::field::END_DATE,
+              values.end_date,
+              slot->end_date,
+              PRESENT_END_DATE);
+
+    if (fields & note::field::CONTENT)
+        compactArena();
+    return true;
+}
+
+bool CompactInMemoryRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Slot *slot = find(id);
+    if (!slot)
+        return false;
+
+    garbage_ += slot->content_size;
+    note_tags_.erase(id);
+    slot->live = 0;
+    free_slots_.push_back(index_[static_cast<std::size_t>(id)] - 1);
+    index_[static_cast<std::size_t>(id)] = NO_SLOT;
+    compactArena();
+    return true;
+}
+
+CompactInMemoryRepository::Slot *CompactInMemoryRepository::find(note::Id id)
+{
+    auto i = static_cast<std::size_t>(id);
+    if (id <= 0 || i >= index_.size() || index_[i] == NO_SLOT)
+        return nullptr;
+    return &slots_[index_[i] - 1];
+}
+
+const CompactInMemoryRepository::Slot *
+CompactInMemoryRepository::find(note::Id id) const
+{
+    return const_cast<CompactInMemoryRepository *>(this)->find(id);
+}
+
+void CompactInMemoryRepository::store(Slot &slot, const note::Note &note)
+{
+    // storeContent 는 기존 본문 자리를 보므로 live 를 켜기 전에 부른다.
+    // PRESENT_PACKED 도 여기서 정해진다.
+    storeContent(slot, note.content);
+    storeTags(note.id, note.tags);
+    slot.id = note.id;
+    slot.type = static_cast<std::uint8_t>(note.type);
+    slot.created_at = toRep(note.created_at);
+    slot.updated_at = toRep(note.updated_at);
+    slot.status = note.status ? static_cast<std::uint8_t>(*note.status) : 0;
+    slot.present &= PRESENT_PACKED;
+    slot.present |= note.status ? PRESENT_STATUS : 0;
+    slot.present |=
+        storeOptional(note.due_date, slot.due_date, PRESENT_DUE_DATE);
+    slot.present |=
+        storeOptional(note.start_date, slot.start_date, PRESENT_START_DATE);
+    slot.present |=
+        storeOptional(note.end_date, slot.end_date, PRESENT_END_DATE);
+    slot.live = 1;
+}
+
+void CompactInMemoryRepository::storeContent(Slot &slot,
+                                             const std::string &content)
+{
+    if (content.size() > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error("Note content too large");
+
+    std::optional<std::string> packed;
+    if (compress_threshold_ != 0 && content.size() >= compress_threshold_)
+        packed = note::pack_content(content);
+    std::string_view bytes = packed ? std::string_view(*packed) : content;
+
+    auto size = static_cast<std::uint32_t>(bytes.size());
+    // 새 본문이 기존 자리에 들어가면 덮어쓴다.
+    if (slot.live && slot.content_size >= size)
+    {
+        auto &arena = writableArena();
+        std::copy(bytes.begin(),
+                  bytes.end(),
+                  arena.begin() +
+                      static_cast<std::ptrdiff_t>(slot.content_offset));
+        garbage_ += slot.content_size - size;
+    }
+    else
+    {
+        if (slot.live)
+            garbage_ += slot.content_size;
+        auto &arena = writableArena(bytes.size());
+        slot.content_offset = arena.size();
+        arena.insert(arena.end(), bytes.begin(), bytes.end());
+    }
+    slot.content_size = size;
+    slot.present &= static_cast<std::uint8_t>(~PRESENT_PACKED);
+    if (packed)
+        slot.present |= PRESENT_PACKED;
+}
+
+void CompactInMemoryRepository::storeTags(note::Id id,
+                                          const std::vector<std::string> &tags)
+{
+    if (tags.empty())
+    {
+        note_tags_.erase(id);
+        return;
+    }
+
+    std::vector<std::uint32_t> ids;
+    ids.reserve(tags.size());
+    for (const auto &tag : tags)
+    {
+        auto [it, inserted] = tag_ids_.try_emplace(
+            tag, static_cast<std::uint32_t>(tag_names_.size()));
+        if (inserted)
+            tag_names_.push_back(tag);
+        ids.push_back(it->second);
+    }
+    note_tags_[id] = std::move(ids);
+}
+
+void CompactInMemoryRepository::compactArena()
+{
+    // 버려진 바이트가 절반을 넘을 때만 살아 있는 본문을 새 아레나로 옮긴다.
+    if (arena_->size() < MIN_COMPACT_BYTES ||
+        garbage_ * 2 < arena_->size())
+        return;
+
+    // 옛 세대는 고치지 않고 새 세대로 바꾸므로 읽던 grep 은 그대로 읽는다.
+    auto compacted = std::make_shared<std::vector<char>>();
+    compacted->reserve(arena_->size() - garbage_);
+    for (auto &slot : slots_)
+    {
+        if (!slot.live)
+            continue;
+        auto offset = compacted->size();
+        const char *begin = arena_->data() + slot.content_offset;
+        compacted->insert(compacted->end(), begin, begin + slot.content_size);
+        slot.content_offset = offset;
+    }
+    arena_ = std::move(compacted);
+    garbage_ = 0;
+}
+
+std::vector<char> &CompactInMemoryRepository::writableArena(std::size_t extra)
+{
+    if (arena_.use_count() > 1)
+    {
+        auto &old = *arena_;
+        auto copy = std::make_shared<std::vector<char>>();
+        copy->reserve(old.size() + std::max(extra, old.size() / 4));
+        copy->assign(old.begin(), old.end());
+        arena_ = std::move(copy);
+    }
+    else
+    {
+        reserveFor(*arena_, extra);
+    }
+    return *arena_;
+}
+
+note::NotePtr
+CompactInMemoryRepository::load(const Slot &slot,
+                                const note::Projection &projection,
+                                std::pmr::memory_resource *mr) const
+{
+    auto fields = projection.fields;
+    note::Note n;
+    n.id = slot.id;
+    n.type = static_cast<note::NoteType>(slot.type);
+
+    std::string_view content(arena_->data() + slot.content_offset,
+                             slot.content_size);
+    if (slot.present & PRESENT_PACKED)
+    {
+        // 압축된 본문은 필요한 만큼만 푼다. 한 글자는 4바이트를 넘지 않는다.
+        if (fields & note::field::CONTENT)
+            n.content = note::unpack_content(content);
+        else if (projection.preview != 0)
+        {
+            n.content = note::unpack_content(content, projection.preview * 4);
+            n.content.resize(
+                note::utf8_prefix(n.content, projection.preview).size());
+        }
+    }
+    else if (fields & note::field::CONTENT)
+        n.content.assign(content);
+    else if (projection.preview != 0)
+        n.content.assign(note::utf8_prefix(content, projection.preview));
+
+    if (fields & note::field::CREATED_AT)
+        n.created_at = fromRep(slot.created_at);
+    if (fields & note::field::UPDATED_AT)
+        n.updated_at = fromRep(slot.updated_at);
+    if ((fields & note::field::STATUS) && (slot.present & PRESENT_STATUS))
+        n.status = static_cast<note::NoteStatus>(slot.status);
+    if (fields & note::field::DUE_DATE)
+        n.due_date =
+            loadOptional(slot.due_date, slot.present, PRESENT_DUE_DATE);
+    if (fields & note::field::START_DATE)
+        n.start_date =
+            loadOptional(slot.start_date, slot.present, PRESENT_START_DATE);
+    if (fields & note::field::END_DATE)
+        n.end_date =
+            loadOptional(slot.end_date, slot.present, PRESENT_END_DATE);
+    if (fields & note::field::TAGS)
+    {
+        auto it = note_tags_.find(slot.id);
+        if (it != note_tags_.end())
+        {
+            n.tags.reserve(it->second.size());
+            for (auto tag : it->second)
+                n.tags.push_back(tag_names_[tag]);
+        }
+    }
+    return makeNote(std::move(n), mr);
+}
+
+NoteList
+CompactInMemoryRepository::listNotes(std::optional<note::NoteType> type,
+                                     const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    NoteList notes(mr);
+    if (!type)
+        notes.reserve(slots_.size() - free_slots_.size());
+
+    for (const auto &slot : slots_)
+    {
+        if (!slot.live)
+            continue;
+        if (!type || slot.type == static_cast<std::uint8_t>(*type))
+            notes.push_back(load(slot, projection, mr));
+    }
+    return notes;
+}
+
+} // namespace banchoo::repository
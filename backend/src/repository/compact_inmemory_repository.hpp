@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "index/content_matcher.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 노트 수가 많은 경우를 위한 조밀한 메모리 배치.
+// 노트 하나는 64바이트 슬롯 하나와 본문 아레나의 바이트만 차지한다. 대신
+// 읽을 때마다 note::Note 를 새로 만들어 내준다. compress_threshold 를
+// 주면 그보다 긴 본문은 압축해 두고 본문을 읽을 때만 푼다.
+class CompactInMemoryRepository : public BaseRepository
+{
+ public:
+    explicit CompactInMemoryRepository(const nlohmann::json &config);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    note::NotePtr getNote(note::Id id) const override;
+    NoteList getNotes(std::span<const note::Id> ids,
+                      const note::Projection &projection = {},
+                      std::pmr::memory_resource *mr =
+                          std::pmr::get_default_resource()) const override;
+    NoteList scanNotes(note::Id after,
+                       std::size_t limit,
+                       std::optional<note::NoteType> type = std::nullopt,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    std::vector<note::Id> grepNotes(const index::ContentMatcher &matcher,
+                                    std::size_t limit) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    NoteList listNotes(std::optional<note::NoteType> type,
+                       const note::Projection &projection,
+                       std::pmr::memory_resource *mr) const override;
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    struct Slot
+    {
+        // TimePoint::rep 그대로 저장한다.
+        std::int64_t created_at;
+        std::int64_t updated_at;
+        std::int64_t due_date;
+        std::int64_t start_date;
+        std::int64_t end_date;
+        std::uint64_t content_offset;
+        std::uint32_t content_size;
+        note::Id id;
+        std::uint8_t type;
+        std::uint8_t status;
+        std::uint8_t present; // PRESENT_* 비트
+        std::uint8_t live;
+    };
+    static_assert(sizeof(Slot) == 64, "Slot should fill one cache line");
+
+    static constexpr std::uint32_t NO_SLOT = 0;
+
+    // 잠금을 잡은 채로 부른다. 같은 id 가 있으면 덮어쓴다.
+    void insert(const note::Note &note);
+
+    // id 에 해당하는 슬롯, 없으면 nullptr
+    Slot *find(note::Id id);
+    const Slot *find(note::Id id) const;
+
+    void store(Slot &slot, const note::Note &note);
+    void storeContent(Slot &slot, const std::string &content);
+    void storeTags(note::Id id, const std::vector<std::string> &tags);
+    void compactArena();
+    // 고칠 아레나. grep 이 지금 세대를 읽고 있으면 복사해 새 세대로 바꾼다.
+    // extra 는 곧 덧붙일 바이트 수다.
+    std::vector<char> &writableArena(std::size_t extra = 0);
+
+    // projection 에 없는 필드는 읽지 않는다. 본문은 필요한 만큼만 복사한다.
+    note::NotePtr load(const Slot &slot,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const;
+
+    mutable std::mutex mutex_;
+    std::vector<Slot> slots_;
+    // id 는 1부터 순서대로 발급되므로 id -> 슬롯 번호 + 1 을 벡터로 둔다.
+    std::vector<std::uint32_t> index_;
+    std::vector<std::uint32_t> free_slots_;
+    // 본문을 이어 붙인 아레나. grep 은 잠금 안에서 이 포인터를 복사해 두고
+    // 잠금 밖에서 읽으며, 다 읽으면 잠금 안에서 놓는다.
+    std::shared_ptr<std::vector<char>> arena_ =
+        std::make_shared<std::vector<char>>();
+    std::size_t garbage_ = 0; // 아레나에서 더 이상 쓰지 않는 바이트
+    // 이 바이트 이상인 본문은 압축해 아레나에 둔다. 0 이면 압축하지 않는다.
+    std::size_t compress_threshold_;
+    // 태그 이름은 한 번만 두고 노트에는 번호를 붙인다. 태그가 없는 노트는
+    // note_tags_ 에 없다.
+    std::vector<std::string> tag_names_;
+    std::unordered_map<std::string, std::uint32_t> tag_ids_;
+    std::unordered_map<note::Id, std::vector<std::uint32_t>> note_tags_;
+};
+
+} // namespace banchoo::repository
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/forwarding_repository.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "stats/note_stats.hpp"
+
+namespace banchoo::repository
+{
+
+ForwardingRepository::ForwardingRepository(
+    std::shared_ptr<BaseRepository> inner)
+    : inner_(std::move(inner))
+{
+}
+
+note::NotePtr ForwardingRepository::createNote(note::Note &&note)
+{
+    return inner_->createNote(std::move(note));
+}
+
+void ForwardingRepository::createNotes(std::span<note::Note> notes)
+{
+    inner_->createNotes(notes);
+}
+
+note::NotePtr ForwardingRepository::getNote(note::Id id) const
+{
+    return inner_->getNote(id);
+}
+
+NoteList ForwardingRepository::getNotes(std::span<const note::Id> ids,
+                                        const note::Projection &projection,
+                                        std::pmr::memory_resource *mr) const
+{
+    return inner_->getNotes(ids, projection, mr);
+}
+
+NoteList ForwardingRepository::findNotes(const index::TagQuery &query,
+                                         std::optional<note::NoteType> type,
+                                         const note::Projection &projection,
+                                         std::pmr::memory_resource *mr) const
+{
+    return inner_->findNotes(query, type, projection, mr);
+}
+
+NoteList ForwardingRepository::scanNotes(note::Id after,
+                                         std::size_t limit,
+                                         std::optional<note::NoteType> type,
+                                         const note::Projection &projection,
+                                         std::pmr::memory_resource *mr) const
+{
+    return inner_->scanNotes(after, limit, type, projection, mr);
+}
+
+std::vector<note::Id>
+ForwardingRepository::grepNotes(const index::ContentMatcher &matcher,
+                                std::size_t limit) const
+{
+    return inner_->grepNotes(matcher, limit);
+}
+
+std::vector<note::Id>
+ForwardingRepository::suggestNotes(std::string_view prefix,
+                                   std::size_t limit) const
+{
+    return inner_->suggestNotes(prefix, limit);
+}
+
+stats::NoteStats ForwardingRepository::noteStats(note::TimePoint now) const
+{
+    return inner_->noteStats(now);
+}
+
+NoteList ForwardingRepository::listNotes(std::optional<note::NoteType> type,
+                                         const note::Projection &projection,
+                                         std::pmr::memory_resource *mr) const
+{
+    if (!type)
+        return inner_->getAllNotes(projection, mr);
+    switch (*type)
+    {
+    case note::NoteType::MEMO:
+        return inner_->getAllMemos(projection, mr);
+    case note::NoteType::TASK:
+        return inner_->getAllTasks(projection, mr);
+    default:
+        return inner_->getAllEvents(projection, mr);
+    }
+}
+
+bool ForwardingRepository::updateNote(note::Note &&note)
+{
+    return inner_->updateNote(std::move(note));
+}
+
+bool ForwardingRepository::applyPatch(note::Id id,
+                                      note::Note &&values,
+                                      note::FieldMask fields)
+{
+    return inner_->patchNote(id, std::move(values), fields);
+}
+
+bool ForwardingRepository::deleteNote(note::Id id)
+{
+    return inner_->deleteNote(id);
+}
+
+} // namespace banchoo::repository
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "stats/note_stats.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸는 데코레이터의 바탕. 모든 호출을 inner_ 로 그대로
+// 넘기므로, 색인이나 집계를 붙이는 쪽은 바꿀 쓰기 경로와 조회만 다시
+// 정의한다. BaseRepository 에 가상 함수가 늘어도 여기 하나만 고치면 된다.
+class ForwardingRepository : public BaseRepository
+{
+ public:
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    note::NotePtr getNote(note::Id id) const override;
+    NoteList getNotes(std::span<const note::Id> ids,
+                      const note::Projection &projection = {},
+                      std::pmr::memory_resource *mr =
+                          std::pmr::get_default_resource()) const override;
+    NoteList findNotes(const index::TagQuery &query,
+                       std::optional<note::NoteType> type,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    NoteList scanNotes(note::Id after,
+                       std::size_t limit,
+                       std::optional<note::NoteType> type = std::nullopt,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    std::vector<note::Id> grepNotes(const index::ContentMatcher &matcher,
+                                    std::size_t limit) const override;
+    std::vector<note::Id> suggestNotes(std::string_view prefix,
+                                       std::size_t limit) const override;
+    stats::NoteStats noteStats(note::TimePoint now) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    explicit ForwardingRepository(std::shared_ptr<BaseRepository> inner);
+
+    NoteList listNotes(std::optional<note::NoteType> type,
+                       const note::Projection &projection,
+                       std::pmr::memory_resource *mr) const override;
+    // inner_->patchNote 로 넘긴다. updated_at 은 fields 에 이미 들어 있다.
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+    std::shared_ptr<BaseRepository> inner_;
+};
+
+} // namespace banchoo::repository
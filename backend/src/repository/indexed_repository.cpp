@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/indexed_repository.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "index/tag_index.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::repository
+{
+
+IndexedRepository::IndexedRepository(std::shared_ptr<BaseRepository> inner)
+    : ForwardingRepository(std::move(inner))
+{
+    auto notes = inner_->getAllNotes({note::field::TAGS, 0});
+    for (const auto &n : notes)
+        index_.add(n->id, n->type, n->tags);
+    BANCHOO_INFO("tag index: {} notes, {} tags, {} KB",
+                 notes.size(),
+                 index_.tagCount(),
+                 index_.memoryBytes() / 1024);
+}
+
+note::NotePtr IndexedRepository::createNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto created = inner_->createNote(std::move(note));
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.add(created->id, created->type, created->tags);
+    return created;
+}
+
+void IndexedRepository::createNotes(std::span<note::Note> notes)
+{
+    // 저장소가 노트를 옮겨 가므로 종류와 태그를 먼저 떼어 둔다. id 는
+    // 저장소가 새로 붙일 수 있어 저장한 뒤에 읽는다.
+    std::vector<std::pair<note::NoteType, std::vector<std::string>>> keys;
+    keys.reserve(notes.size());
+    for (const auto &n : notes)
+        keys.emplace_back(n.type, n.tags);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    inner_->createNotes(notes);
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    for (std::size_t i = 0; i < notes.size(); ++i)
+        index_.add(notes[i].id, keys[i].first, keys[i].second);
+}
+
+NoteList IndexedRepository::findNotes(const index::TagQuery &query,
+                                      std::optional<note::NoteType> type,
+                                      const note::Projection &projection,
+                                      std::pmr::memory_resource *mr) const
+{
+    BANCHOO_SPAN("IndexedRepository::findNotes");
+
+    std::vector<note::Id> ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        auto matched = index_.evaluate(query, type);
+        ids.reserve(matched.cardinality());
+        matched.forEach([&](std::uint32_t v)
+                        { ids.push_back(static_cast<note::Id>(v)); });
+    }
+    return inner_->getNotes(ids, projection, mr);
+}
+
+bool IndexedRepository::updateNote(note::Note &&note)
+{
+    auto id = note.id;
+    auto type = note.type;
+    auto tags = note.tags;
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->updateNote(std::move(note)))
+        return false;
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.remove(id);
+    index_.add(id, type, tags);
+    return true;
+}
+
+bool IndexedRepository::applyPatch(note::Id id,
+                                   note::Note &&values,
+                                   note::FieldMask fields)
+{
+    // 태그를 바꾸지 않는 수정은 색인과 상관없다.
+    if (!(fields & note::field::TAGS))
+        return inner_->patchNote(id, std::move(values), fields);
+
+    auto tags = values.tags;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->patchNote(id, std::move(values), fields))
+        return false;
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.setTags(id, tags);
+    return true;
+}
+
+bool IndexedRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->deleteNote(id))
+        return false;
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.remove(id);
+    return true;
+}
+
+} // namespace banchoo::repository
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+
+#include "index/tag_index.hpp"
+#include "index/tag_query.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 태그 비트맵 색인을 유지하고, findNotes 를 색인으로
+// 푼 뒤 맞는 id 만 getNotes 로 읽는다. 만들 때 감싼 저장소의 노트를 한 번
+// 훑어 색인을 채운다.
+class IndexedRepository : public ForwardingRepository
+{
+ public:
+    explicit IndexedRepository(std::shared_ptr<BaseRepository> inner);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    NoteList findNotes(const index::TagQuery &query,
+                       std::optional<note::NoteType> type,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    // 저장소에 쓰는 순서와 색인에 반영하는 순서를 맞춘다.
+    std::mutex write_mutex_;
+    mutable std::shared_mutex index_mutex_;
+    index::TagIndex index_;
+};
+
+} // namespace banchoo::repository
@@ -6,97 +6,310 @@
 
 #include "repository/inmemory_repository.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
-#include <ranges>
+#include <optional>
+#include <span>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/logger.hpp"
+#include "index/content_matcher.hpp"
+#include "index/parallel_scan.hpp"
 #include "inmemory_repository.hpp"
+#include "note/content_codec.hpp"
 #include "note/note.hpp"
 #include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
 
 namespace banchoo::repository
 {
 
-InMemoryRepository::InMemoryRepository(const nlohmann::json &config) {}
+namespace
+{
+// 본문만 뺀 사본. 압축한 노트는 이것을 맵에 둔다.
+note::NotePtr withoutContent(const note::Note &n)
+{
+    return std::make_shared<const note::Note>(
+        note::Note{.id = n.id,
+                   .type = n.type,
+                   .created_at = n.created_at,
+                   .updated_at = n.updated_at,
+                   .status = n.status,
+                   .due_date = n.due_date,
+                   .start_date = n.start_date,
+                   .end_date = n.end_date,
+                   .tags = n.tags});
+}
+} // namespace
+
+InMemoryRepository::InMemoryRepository(const nlohmann::json &config)
+    : compress_threshold_(compressThreshold(config))
+{
+}
 
-note::Id InMemoryRepository::createNote(const note::Note &note)
+note::NotePtr InMemoryRepository::createNote(note::Note &&note)
 {
+    auto packed = pack(note.content);
+    auto created = std::make_shared<const note::Note>(std::move(note));
+    auto stored = packed ? withoutContent(*created) : created;
+
     std::lock_guard<std::mutex> lock(mutex_);
-    notes_[note.id] = note;
+    notes_[stored->id] = stored;
+    setPacked(stored->id, std::move(packed));
 
-    return note.id;
+    return created;
+}
+
+void InMemoryRepository::createNotes(std::span<note::Note> notes)
+{
+    std::vector<note::NotePtr> stored;
+    std::vector<std::optional<std::string>> packed;
+    stored.reserve(notes.size());
+    packed.reserve(notes.size());
+    for (auto &n : notes)
+    {
+        packed.push_back(pack(n.content));
+        if (packed.back())
+            n.content.clear();
+        stored.push_back(std::make_shared<const note::Note>(std::move(n)));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < stored.size(); ++i)
+    {
+        auto id = stored[i]->id;
+        notes_[id] = std::move(stored[i]);
+        setPacked(id, std::move(packed[i]));
+    }
 }
 
-std::optional<note::Note> InMemoryRepository::getNote(note::Id id) const
+note::NotePtr InMemoryRepository::getNote(note::Id id) const
 {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = notes_.find(id);
     if (it != notes_.end())
     {
-        return it->second;
+        return expand(it->second, 0, std::pmr::get_default_resource());
     }
-    return std::nullopt;
+    return nullptr;
 }
 
-std::vector<note::Note> InMemoryRepository::getAllNotes() const
+NoteList InMemoryRepository::getNotes(std::span<const note::Id> ids,
+                                      const note::Projection &projection,
+                                      std::pmr::memory_resource *mr) const
 {
+    bool content = projection.fields & note::field::CONTENT;
+    bool unpack = content || projection.preview != 0;
+    auto preview = content ? 0 : projection.preview;
+
     std::lock_guard<std::mutex> lock(mutex_);
-    std::vector<note::Note> all;
-    all.reserve(notes_.size());
-    for (const auto &[_, n] : notes_)
+    NoteList notes(mr);
+    notes.reserve(ids.size());
+    for (auto id : ids)
     {
-        all.push_back(n);
+        auto it = notes_.find(id);
+        if (it != notes_.end())
+            notes.push_back(unpack ? expand(it->second, preview, mr)
+                                   : it->second);
     }
-    return all;
+    return notes;
 }
 
-std::vector<note::Note> InMemoryRepository::getAllMemos() const
+NoteList InMemoryRepository::listNotes(std::optional<note::NoteType> type,
+                                       const note::Projection &projection,
+                                       std::pmr::memory_resource *mr) const
 {
-    auto all = getAllNotes();
-    auto filtered = all |
-        std::views::filter([](const note::Note &note)
-                           { return note.type == note::NoteType::MEMO; });
-    std::vector<note::Note> filtered_notes(filtered.begin(), filtered.end());
-    return filtered_notes;
+    // 저장된 노트를 그대로 공유하므로 필드를 덜어내면 오히려 복사가 생긴다.
+    // 압축한 본문만 projection 이 본문을 원할 때 푼다.
+    bool content = projection.fields & note::field::CONTENT;
+    auto preview = content ? 0 : projection.preview;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool unpack = !packed_.empty() && (content || projection.preview != 0);
+    NoteList notes(mr);
+    if (!type)
+        notes.reserve(notes_.size());
+    for (const auto &[_, n] : notes_)
+    {
+        if (type && n->type != *type)
+            continue;
+        notes.push_back(unpack ? expand(n, preview, mr) : n);
+    }
+    return notes;
 }
 
-std::vector<note::Note> InMemoryRepository::getAllTasks() const
+NoteList InMemoryRepository::scanNotes(note::Id after,
+                                       std::size_t limit,
+                                       std::optional<note::NoteType> type,
+                                       const note::Projection &projection,
+                                       std::pmr::memory_resource *mr) const
 {
-    auto all = getAllNotes();
-    auto filtered = all |
-        std::views::filter([](const note::Note &note)
-                           { return note.type == note::NoteType::TASK; });
-    std::vector<note::Note> filtered_notes(filtered.begin(), filtered.end());
-    return all;
+    // listNotes 처럼 압축한 본문은 projection 이 본문을 원할 때만 푼다.
+    bool content = projection.fields & note::field::CONTENT;
+    bool unpack = content || projection.preview != 0;
+    auto preview = content ? 0 : projection.preview;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    unpack = unpack && !packed_.empty();
+    NoteList notes(mr);
+    notes.reserve(std::min(limit, notes_.size()));
+    for (auto it = notes_.upper_bound(after);
+         it != notes_.end() && notes.size() < limit;
+         ++it)
+    {
+        if (!type || it->second->type == *type)
+            notes.push_back(unpack ? expand(it->second, preview, mr)
+                                   : it->second);
+    }
+    return notes;
 }
-std::vector<note::Note> InMemoryRepository::getAllEvents() const
-{
-    auto all = getAllNotes();
-    auto filtered = all |
-        std::views::filter([](const note::Note &note)
-                           { return note.type == note::NoteType::EVENT; });
-    std::vector<note::Note> filtered_notes(filtered.begin(), filtered.end());
-    return all;
+
+std::vector<note::Id>
+InMemoryRepository::grepNotes(const index::ContentMatcher &matcher,
+                              std::size_t limit) const
+{
+    BANCHOO_SPAN("InMemoryRepository::grepNotes");
+
+    // 잠금은 노트를 id 순으로 늘어놓는 동안만 잡는다. 노트와 압축본은
+    // 고칠 때 새로 만들어 바꾸므로 포인터만 들고 잠금 밖에서 읽는다.
+    struct Candidate
+    {
+        note::NotePtr note;
+        std::shared_ptr<const std::string> packed;
+    };
+    std::vector<Candidate> candidates;
+    std::size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        candidates.reserve(notes_.size());
+        for (const auto &[id, n] : notes_)
+        {
+            auto &candidate = candidates.emplace_back();
+            candidate.note = n;
+            auto it = packed_.empty() ? packed_.end() : packed_.find(id);
+            if (it != packed_.end())
+                candidate.packed = it->second;
+            bytes += n->content.size() +
+                     (candidate.packed ? candidate.packed->size() : 0);
+        }
+    }
+
+    auto hits = index::parallelScan(
+        candidates.size(),
+        limit,
+        bytes,
+        [&](std::size_t i)
+        {
+            const auto &candidate = candidates[i];
+            if (!candidate.packed)
+                return matcher.matches(candidate.note->content);
+            return matcher.matches(note::unpack_content(*candidate.packed));
+        });
+
+    std::vector<note::Id> ids;
+    ids.reserve(hits.size());
+    for (auto i : hits)
+        ids.push_back(candidates[i].note->id);
+    return ids;
 }
 
-bool InMemoryRepository::updateNote(const note::Note &note)
+bool InMemoryRepository::updateNote(note::Note &&note)
 {
+    // 이미 내준 노트는 그대로 두고 새 노트로 교체한다.
+    auto packed = pack(note.content);
+    if (packed)
+        note.content.clear();
+    auto updated = std::make_shared<const note::Note>(std::move(note));
+
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = notes_.find(note.id);
+    auto it = notes_.find(updated->id);
     if (it != notes_.end())
     {
-        notes_[note.id] = note;
+        setPacked(updated->id, std::move(packed));
+        it->second = std::move(updated);
         return true;
     }
     return false;
 }
 
+bool InMemoryRepository::applyPatch(note::Id id,
+                                    note::Note &&values,
+                                    note::FieldMask fields)
+{
+    std::optional<std::string> packed;
+    if (fields & note::field::CONTENT)
+    {
+        packed = pack(values.content);
+        if (packed)
+            values.content.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = notes_.find(id);
+    if (it == notes_.end())
+        return false;
+
+    // 내준 노트는 불변이므로 고친 사본으로 교체한다. 본문을 고치지 않으면
+    // 압축본은 그대로 둔다.
+    auto patched = std::make_shared<note::Note>(*it->second);
+    note::apply_fields(*patched, std::move(values), fields);
+    it->second = std::move(patched);
+    if (fields & note::field::CONTENT)
+        setPacked(id, std::move(packed));
+    return true;
+}
+
 bool InMemoryRepository::deleteNote(note::Id id)
 {
     std::lock_guard<std::mutex> lock(mutex_);
+    packed_.erase(id);
     return notes_.erase(id) > 0;
 }
 
+std::optional<std::string>
+InMemoryRepository::pack(const std::string &content) const
+{
+    if (compress_threshold_ == 0 || content.size() < compress_threshold_)
+        return std::nullopt;
+    return note::pack_content(content);
+}
+
+void InMemoryRepository::setPacked(note::Id id,
+                                   std::optional<std::string> &&packed)
+{
+    if (packed)
+        packed_[id] = std::make_shared<const std::string>(std::move(*packed));
+    else
+        packed_.erase(id);
+}
+
+note::NotePtr InMemoryRepository::expand(const note::NotePtr &n,
+                                         std::size_t preview,
+                                         std::pmr::memory_resource *mr) const
+{
+    auto it = packed_.find(n->id);
+    if (it == packed_.end())
+        return n;
+
+    note::Note copy = *n;
+    if (preview == 0)
+    {
+        copy.content = note::unpack_content(*it->second);
+    }
+    else
+    {
+        // 한 글자는 UTF-8 로 4바이트를 넘지 않는다.
+        copy.content = note::unpack_content(*it->second, preview * 4);
+        copy.content.resize(note::utf8_prefix(copy.content, preview).size());
+    }
+    return makeNote(std::move(copy), mr);
+}
+
 } // namespace banchoo::repository
@@ -5,35 +5,78 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <optional>
+#include <span>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "index/content_matcher.hpp"
 #include "repository/base_repository.hpp"
 
 namespace banchoo::repository
 {
 
+// 노트를 shared_ptr 로 들고 있다가 그대로 내준다. compress_threshold 를 주면
+// 그보다 긴 본문은 압축해 packed_ 에 따로 두고, 본문을 읽을 때 푼 사본을
+// 내준다.
 class InMemoryRepository : public BaseRepository
 {
  public:
     explicit InMemoryRepository(const nlohmann::json &config);
 
-    note::Id createNote(const note::Note &note) override;
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
 
-    std::optional<note::Note> getNote(note::Id id) const override;
-    std::vector<note::Note> getAllNotes() const override;
-    std::vector<note::Note> getAllMemos() const override;
-    std::vector<note::Note> getAllTasks() const override;
-    std::vector<note::Note> getAllEvents() const override;
-    bool updateNote(const note::Note &note) override;
+    note::NotePtr getNote(note::Id id) const override;
+    NoteList getNotes(std::span<const note::Id> ids,
+                      const note::Projection &projection = {},
+                      std::pmr::memory_resource *mr =
+                          std::pmr::get_default_resource()) const override;
+    NoteList scanNotes(note::Id after,
+                       std::size_t limit,
+                       std::optional<note::NoteType> type = std::nullopt,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    std::vector<note::Id> grepNotes(const index::ContentMatcher &matcher,
+                                    std::size_t limit) const override;
+    bool updateNote(note::Note &&note) override;
     bool deleteNote(note::Id id) override;
 
+ protected:
+    NoteList listNotes(std::optional<note::NoteType> type,
+                       const note::Projection &projection,
+                       std::pmr::memory_resource *mr) const override;
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
  private:
+    // threshold 를 넘고 압축해서 줄어드는 본문의 압축본
+    std::optional<std::string> pack(const std::string &content) const;
+    // 잠금을 잡은 채로 부른다.
+    void setPacked(note::Id id, std::optional<std::string> &&packed);
+    // 압축해 둔 노트면 본문을 푼 사본을 만든다. preview 가 0 이 아니면 앞의
+    // preview 글자만 푼다. 잠금을 잡은 채로 부른다.
+    note::NotePtr expand(const note::NotePtr &n,
+                         std::size_t preview,
+                         std::pmr::memory_resource *mr) const;
+
     mutable std::mutex mutex_;
-    std::unordered_map<note::Id, note::Note> notes_;
+    // scanNotes 가 after 다음 id 부터 바로 찾아가도록 id 순으로 둔다.
+    std::map<note::Id, note::NotePtr> notes_;
+    // 압축한 노트의 본문. notes_ 쪽 노트는 본문이 비어 있다. 노트처럼
+    // 고칠 때 새로 만들어 바꾸므로 grep 은 포인터만 들고 잠금 밖에서 읽는다.
+    std::unordered_map<note::Id, std::shared_ptr<const std::string>> packed_;
+    std::size_t compress_threshold_;
 };
 
 } // namespace banchoo::repository
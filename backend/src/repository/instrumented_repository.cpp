@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/instrumented_repository.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
+#include "metrics/registry.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+metrics::Histogram methodHistogram(const char *method)
+{
+    return metrics::Registry::instance().histogram(
+        "banchoo_repository_duration_ns",
+        "Repository call latency in nanoseconds",
+        std::string("method=\"") + method + "\"");
+}
+
+template <typename F>
+auto timed(const char *span, const metrics::Histogram &histogram, F &&f)
+{
+    BANCHOO_SPAN(span);
+    auto start = std::chrono::steady_clock::now();
+    auto result = f();
+    histogram.observe(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count()));
+    return result;
+}
+} // namespace
+
+InstrumentedRepository::InstrumentedRepository(
+    std::shared_ptr<BaseRepository> inner)
+    : ForwardingRepository(std::move(inner)),
+      timings_{methodHistogram("createNote"),
+               methodHistogram("createNotes"),
+               methodHistogram("getNote"),
+               methodHistogram("getNotes"),
+               methodHistogram("findNotes"),
+               methodHistogram("scanNotes"),
+               methodHistogram("noteStats"),
+               methodHistogram("grepNotes"),
+               methodHistogram("suggestNotes"),
+               methodHistogram("getAllNotes"),
+               methodHistogram("getAllMemos"),
+               methodHistogram("getAllTasks"),
+               methodHistogram("getAllEvents"),
+               methodHistogram("updateNote"),
+               methodHistogram("patchNote"),
+               methodHistogram("deleteNote")}
+{
+}
+
+note::NotePtr InstrumentedRepository::createNote(note::Note &&note)
+{
+    return timed("repository::createNote",
+                 timings_.create_note,
+                 [&] { return inner_->createNote(std::move(note)); });
+}
+
+void InstrumentedRepository::createNotes(std::span<note::Note> notes)
+{
+    timed("repository::createNotes",
+          timings_.create_notes,
+          [&]
+          {
+              inner_->createNotes(notes);
+              return notes.size();
+          });
+}
+
+note::NotePtr InstrumentedRepository::getNote(note::Id id) const
+{
+    return timed("repository::getNote",
+                 timings_.get_note,
+                 [&] { return inner_->getNote(id); });
+}
+
+NoteList InstrumentedRepository::getNotes(std::span<const note::Id> ids,
+                                         const note::Projection &projection,
+                                         std::pmr::memory_resource *mr) const
+{
+    return timed("repository::getNotes",
+                 timings_.get_notes,
+                 [&] { return inner_->getNotes(ids, projection, mr); });
+}
+
+NoteList
+InstrumentedRepository::findNotes(const index::TagQuery &query,
+                                  std::optional<note::NoteType> type,
+                                  const note::Projection &projection,
+                                  std::pmr::memory_resource *mr) const
+{
+    return timed("repository::findNotes",
+                 timings_.find_notes,
+                 [&]
+                 { return inner_->findNotes(query, type, projection, mr); });
+}
+
+NoteList
+InstrumentedRepository::scanNotes(note::Id after,
+                                  std::size_t limit,
+                                  std::optional<note::NoteType> type,
+                                  const note::Projection &projection,
+                                  std::pmr::memory_resource *mr) const
+{
+    return timed(
+        "repository::scanNotes",
+        timings_.scan_notes,
+        [&] { return inner_->scanNotes(after, limit, type, projection, mr); });
+}
+
+std::vector<note::Id>
+InstrumentedRepository::grepNotes(const index::ContentMatcher &matcher,
+                                  std::size_t limit) const
+{
+    return timed("repository::grepNotes",
+                 timings_.grep_notes,
+                 [&] { return inner_->grepNotes(matcher, limit); });
+}
+
+std::vector<note::Id>
+InstrumentedRepository::suggestNotes(std::string_view prefix,
+                                     std::size_t limit) const
+{
+    return timed("repository::suggestNotes",
+                 timings_.suggest_notes,
+                 [&] { return inner_->suggestNotes(prefix, limit); });
+}
+
+stats::NoteStats InstrumentedRepository::noteStats(note::TimePoint now) const
+{
+    return timed("repository::noteStats",
+                 timings_.note_stats,
+                 [&] { return inner_->noteStats(now); });
+}
+
+NoteList
+InstrumentedRepository::listNotes(std::optional<note::NoteType> type,
+                                  const note::Projection &projection,
+                                  std::pmr::memory_resource *mr) const
+{
+    if (!type)
+        return timed("repository::getAllNotes",
+                     timings_.get_all_notes,
+                     [&] { return inner_->getAllNotes(projection, mr); });
+
+    switch (*type)
+    {
+    case note::NoteType::MEMO:
+        return timed("repository::getAllMemos",
+                     timings_.get_all_memos,
+                     [&] { return inner_->getAllMemos(projection, mr); });
+    case note::NoteType::TASK:
+        return timed("repository::getAllTasks",
+                     timings_.get_all_tasks,
+                     [&] { return inner_->getAllTasks(projection, mr); });
+    default:
+        return timed("repository::getAllEvents",
+                     timings_.get_all_events,
+                     [&] { return inner_->getAllEvents(projection, mr); });
+    }
+}
+
+bool InstrumentedRepository::updateNote(note::Note &&note)
+{
+    return timed("repository::updateNote",
+                 timings_.update_note,
+                 [&] { return inner_->updateNote(std::move(note)); });
+}
+
+bool InstrumentedRepository::applyPatch(note::Id id,
+                                        note::Note &&values,
+                                        note::FieldMask fields)
+{
+    return timed("repository::patchNote",
+                 timings_.patch_note,
+                 [&]
+                 { return inner_->patchNote(id, std::move(values), fields); });
+}
+
+bool InstrumentedRepository::deleteNote(note::Id id)
+{
+    return timed("repository::deleteNote",
+                 timings_.delete_note,
+                 [&] { return inner_->deleteNote(id); });
+}
+
+} // namespace banchoo::repository
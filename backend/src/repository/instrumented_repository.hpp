@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "metrics/registry.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 메서드별 소요 시간을 metrics::Registry 에 기록한다.
+// 재지 않는 메서드는 ForwardingRepository 가 그대로 넘긴다.
+class InstrumentedRepository : public ForwardingRepository
+{
+ public:
+    explicit InstrumentedRepository(std::shared_ptr<BaseRepository> inner);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    note::NotePtr getNote(note::Id id) const override;
+    NoteList getNotes(std::span<const note::Id> ids,
+                      const note::Projection &projection = {},
+                      std::pmr::memory_resource *mr =
+                          std::pmr::get_default_resource()) const override;
+    NoteList findNotes(const index::TagQuery &query,
+                       std::optional<note::NoteType> type,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    NoteList scanNotes(note::Id after,
+                       std::size_t limit,
+                       std::optional<note::NoteType> type = std::nullopt,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    std::vector<note::Id> grepNotes(const index::ContentMatcher &matcher,
+                                    std::size_t limit) const override;
+    std::vector<note::Id> suggestNotes(std::string_view prefix,
+                                       std::size_t limit) const override;
+    stats::NoteStats noteStats(note::TimePoint now) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    NoteList listNotes(std::optional<note::NoteType> type,
+                       const note::Projection &projection,
+                       std::pmr::memory_resource *mr) const override;
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    struct Timings
+    {
+        metrics::Histogram create_note;
+        metrics::Histogram create_notes;
+        metrics::Histogram get_note;
+        metrics::Histogram get_notes;
+        metrics::Histogram find_notes;
+        metrics::Histogram scan_notes;
+        metrics::Histogram note_stats;
+        metrics::Histogram grep_notes;
+        metrics::Histogram suggest_notes;
+        metrics::Histogram get_all_notes;
+        metrics::Histogram get_all_memos;
+        metrics::Histogram get_all_tasks;
+        metrics::Histogram get_all_events;
+        metrics::Histogram update_note;
+        metrics::Histogram patch_note;
+        metrics::Histogram delete_note;
+    };
+
+    Timings timings_;
+};
+
+} // namespace banchoo::repository
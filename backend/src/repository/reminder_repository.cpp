@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/reminder_repository.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "note/note.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+using reminder::ReminderScheduler;
+
+// 알림 시각을 바꿀 수 있는 필드
+constexpr note::FieldMask REMINDER_FIELDS =
+    note::field::STATUS | note::field::DUE_DATE | note::field::START_DATE;
+
+// 저장소로 옮겨 가기 전에 알림 필드만 떼어 둔다.
+note::Note keyOf(const note::Note &n)
+{
+    return note::Note{.id = n.id,
+                      .type = n.type,
+                      .status = n.status,
+                      .due_date = n.due_date,
+                      .start_date = n.start_date};
+}
+} // namespace
+
+ReminderRepository::ReminderRepository(
+    std::shared_ptr<BaseRepository> inner,
+    std::shared_ptr<reminder::ReminderScheduler> scheduler)
+    : ForwardingRepository(std::move(inner)), scheduler_(std::move(scheduler))
+{
+    auto notes = inner_->getAllNotes({ReminderScheduler::FIELDS, 0});
+    for (const auto &n : notes)
+        scheduler_->update(*n);
+    BANCHOO_INFO("reminders: {} pending, {} KB",
+                 scheduler_->pending(),
+                 scheduler_->memoryBytes() / 1024);
+}
+
+note::NotePtr ReminderRepository::createNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto created = inner_->createNote(std::move(note));
+    scheduler_->update(*created);
+    return created;
+}
+
+void ReminderRepository::createNotes(std::span<note::Note> notes)
+{
+    std::vector<note::Note> keys;
+    keys.reserve(notes.size());
+    for (const auto &n : notes)
+        keys.push_back(keyOf(n));
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    inner_->createNotes(notes);
+    for (std::size_t i = 0; i < notes.size(); ++i)
+    {
+        keys[i].id = notes[i].id;
+        scheduler_->update(keys[i]);
+    }
+}
+
+bool ReminderRepository::updateNote(note::Note &&note)
+{
+    auto key = keyOf(note);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->updateNote(std::move(note)))
+        return false;
+    scheduler_->update(key);
+    return true;
+}
+
+bool ReminderRepository::applyPatch(note::Id id,
+                                    note::Note &&values,
+                                    note::FieldMask fields)
+{
+    // 본문이나 태그만 바꾸는 수정은 알림과 상관없다.
+    if (!(fields & REMINDER_FIELDS))
+        return inner_->patchNote(id, std::move(values), fields);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->patchNote(id, std::move(values), fields))
+        return false;
+
+    // 종류와 고치지 않은 날짜가 필요하므로 고친 뒤의 값을 다시 읽는다.
+    auto notes = inner_->getNotes({&id, 1}, {ReminderScheduler::FIELDS, 0});
+    if (notes.empty())
+        scheduler_->cancel(id);
+    else
+        scheduler_->update(*notes.front());
+    return true;
+}
+
+bool ReminderRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->deleteNote(id))
+        return false;
+    scheduler_->cancel(id);
+    return true;
+}
+
+} // namespace banchoo::repository
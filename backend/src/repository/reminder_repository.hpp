@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "note/note.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 쓰기마다 알림 스케줄러를 맞춰 둔다. 만들 때 감싼
+// 저장소의 노트를 한 번 훑어 다가오는 알림을 모두 건다.
+class ReminderRepository : public ForwardingRepository
+{
+ public:
+    ReminderRepository(std::shared_ptr<BaseRepository> inner,
+                       std::shared_ptr<reminder::ReminderScheduler> scheduler);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    std::shared_ptr<reminder::ReminderScheduler> scheduler_;
+    // 저장소에 쓰는 순서와 알림에 반영하는 순서를 맞춘다.
+    std::mutex write_mutex_;
+};
+
+} // namespace banchoo::repository
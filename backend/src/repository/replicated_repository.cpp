@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/replicated_repository.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+// 스냅숏을 쓸 때 한 번에 읽는 노트 수
+constexpr std::size_t SNAPSHOT_BATCH = 1024;
+} // namespace
+
+ReplicatedRepository::ReplicatedRepository(
+    std::shared_ptr<BaseRepository> inner,
+    std::shared_ptr<replication::ChangeLogWriter> log)
+    : ForwardingRepository(std::move(inner)), log_(std::move(log))
+{
+    std::size_t count = 0;
+    note::Id after = 0;
+    for (;;)
+    {
+        auto batch = inner_->scanNotes(after, SNAPSHOT_BATCH);
+        if (batch.empty())
+            break;
+        for (const auto &n : batch)
+            log_->put(*n);
+        count += batch.size();
+        after = batch.back()->id;
+    }
+    if (!log_->publish())
+        throw std::runtime_error("Failed to publish change log");
+    BANCHOO_INFO("change log: epoch {}, snapshot of {} notes",
+                 log_->epoch(),
+                 count);
+}
+
+note::NotePtr ReplicatedRepository::createNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto created = inner_->createNote(std::move(note));
+    log_->put(*created);
+    return created;
+}
+
+void ReplicatedRepository::createNotes(std::span<note::Note> notes)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    inner_->createNotes(notes);
+
+    // 저장소가 노트를 옮겨 갔으므로 붙은 id 로 다시 읽어 남긴다.
+    std::vector<note::Id> ids;
+    ids.reserve(notes.size());
+    for (const auto &n : notes)
+        ids.push_back(n.id);
+    for (const auto &n : inner_->getNotes(ids))
+        log_->put(*n);
+}
+
+bool ReplicatedRepository::updateNote(note::Note &&note)
+{
+    auto copy = note;
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->updateNote(std::move(note)))
+        return false;
+    log_->put(copy);
+    return true;
+}
+
+bool ReplicatedRepository::applyPatch(note::Id id,
+                                      note::Note &&values,
+                                      note::FieldMask fields)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->patchNote(id, std::move(values), fields))
+        return false;
+
+    // 고치지 않은 필드까지 담아야 하므로 고친 뒤의 값을 다시 읽는다.
+    auto patched = inner_->getNote(id);
+    if (patched)
+        log_->put(*patched);
+    return true;
+}
+
+bool ReplicatedRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->deleteNote(id))
+        return false;
+    log_->remove(id);
+    return true;
+}
+
+} // namespace banchoo::repository
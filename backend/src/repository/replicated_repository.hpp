@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 쓰기마다 고친 뒤의 노트를 변경 로그에 남긴다.
+// 열어 둔 (아직 공개하지 않은) 로그를 받아, 만들 때 감싼 저장소의 노트를
+// 모두 스냅숏으로 쓰고 공개한다.
+class ReplicatedRepository : public ForwardingRepository
+{
+ public:
+    ReplicatedRepository(std::shared_ptr<BaseRepository> inner,
+                         std::shared_ptr<replication::ChangeLogWriter> log);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    std::shared_ptr<replication::ChangeLogWriter> log_;
+    // 저장소에 쓰는 순서와 로그에 남기는 순서를 맞춘다.
+    std::mutex write_mutex_;
+};
+
+} // namespace banchoo::repository
@@ -7,26 +7,80 @@
 #include "repository/repository_factory.hpp"
 
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
 #include <nlohmann/json.hpp>
 
+#include "reminder/reminder_scheduler.hpp"
+#include "replication/change_log.hpp"
 #include "repository/base_repository.hpp"
+#include "repository/compact_inmemory_repository.hpp"
+#include "repository/indexed_repository.hpp"
 #include "repository/inmemory_repository.hpp"
+#include "repository/instrumented_repository.hpp"
+#include "repository/reminder_repository.hpp"
+#include "repository/replicated_repository.hpp"
 #include "repository/sqlite_repository.hpp"
+#include "repository/stats_repository.hpp"
+#include "repository/suggest_repository.hpp"
 
 namespace banchoo::repository
 {
 
 std::shared_ptr<BaseRepository>
-RepositoryFactory::create(const nlohmann::json &config)
+RepositoryFactory::create(
+    const nlohmann::json &config,
+    std::shared_ptr<reminder::ReminderScheduler> reminders,
+    std::shared_ptr<replication::ChangeLogWriter> changes)
+{
+    auto repo = createStorage(config);
+    if (config.value("tag_index", true))
+    {
+        repo = std::make_shared<IndexedRepository>(std::move(repo));
+    }
+    // 접두사 색인은 노트 백만 개에 수백 MB 를 쓰고 만드는 데 수십 초가
+    // 걸리므로 켤 때만 만든다. 꺼져 있으면 suggestNotes 는 목록을 훑는다.
+    if (config.value("suggest_index", false))
+    {
+        repo = std::make_shared<SuggestRepository>(std::move(repo));
+    }
+    if (config.value("stats", true))
+    {
+        repo = std::make_shared<StatsRepository>(std::move(repo));
+    }
+    if (reminders)
+    {
+        repo = std::make_shared<ReminderRepository>(std::move(repo),
+                                                    std::move(reminders));
+    }
+    if (changes)
+    {
+        repo = std::make_shared<ReplicatedRepository>(std::move(repo),
+                                                      std::move(changes));
+    }
+    if (config.value("instrumented", true))
+    {
+        return std::make_shared<InstrumentedRepository>(std::move(repo));
+    }
+    return repo;
+}
+
+std::shared_ptr<BaseRepository>
+RepositoryFactory::createStorage(const nlohmann::json &config)
 {
     auto type = config["type"].get<std::string>();
 
     if (type == "inmemory")
     {
-        return std::make_shared<InMemoryRepository>(config);
+        // "node": 노트마다 힙 노드, "compact": 슬롯 배열 + 본문 아레나
+        auto layout = config.value("layout", std::string("node"));
+        if (layout == "node")
+            return std::make_shared<InMemoryRepository>(config);
+        if (layout == "compact")
+            return std::make_shared<CompactInMemoryRepository>(config);
+        throw std::invalid_argument("Invalid inmemory layout: " + layout);
     }
     if (type == "sqlite")
     {
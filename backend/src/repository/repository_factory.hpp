@@ -10,6 +10,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include "reminder/reminder_scheduler.hpp"
+#include "replication/change_log.hpp"
 #include "repository/base_repository.hpp"
 
 namespace banchoo::repository
@@ -17,6 +19,16 @@ namespace banchoo::repository
 class RepositoryFactory
 {
  public:
-    static std::shared_ptr<BaseRepository> create(const nlohmann::json &config);
+    // reminders 가 있으면 쓰기마다 그 스케줄러의 알림을 맞춘다.
+    // changes 가 있으면 (열어 두고 아직 공개하지 않은 로그) 현재 노트를
+    // 스냅숏으로 쓰고, 이후의 쓰기를 모두 그 로그에 남긴다.
+    static std::shared_ptr<BaseRepository>
+    create(const nlohmann::json &config,
+           std::shared_ptr<reminder::ReminderScheduler> reminders = nullptr,
+           std::shared_ptr<replication::ChangeLogWriter> changes = nullptr);
+
+ private:
+    static std::shared_ptr<BaseRepository>
+    createStorage(const nlohmann::json &config);
 };
 } // namespace banchoo::repository
@@ -6,23 +6,299 @@
 
 #include "repository/sqlite_repository.hpp"
 
+#include <cstddef>
 #include <filesystem>
-#include <iomanip>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
-#include <sstream>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 #include <sqlite/sqlite3.h>
 
+#include "note/content_codec.hpp"
+#include "note/time_codec.hpp"
 #include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
 
 namespace banchoo::repository
 {
 
-SqliteRepository::SqliteRepository(const nlohmann::json &config) : db_(nullptr)
+namespace
+{
+// 저장 형식: RFC 3339 UTC, 마이크로초 (예: 2025-04-05T12:00:00.000000Z)
+// 자릿수가 고정이라 문자열 비교가 시간 순서와 같다.
+constexpr int STORED_FRACTION_DIGITS = 6;
+
+void bindTime(sqlite3_stmt *stmt,
+              int index,
+              const std::optional<note::TimePoint> &tp)
+{
+    if (!tp)
+    {
+        sqlite3_bind_null(stmt, index);
+        return;
+    }
+    char buf[note::TIMESTAMP_MAX_LENGTH];
+    auto n = note::format_timestamp(*tp, buf, STORED_FRACTION_DIGITS);
+    sqlite3_bind_text(stmt, index, buf, static_cast<int>(n), SQLITE_TRANSIENT);
+}
+
+struct PatchColumn
+{
+    note::FieldMask field;
+    const char *name;
+};
+
+constexpr PatchColumn PATCH_COLUMNS[] = {
+    {note::field::CONTENT, "content"},
+    {note::field::UPDATED_AT, "updated_at"},
+    {note::field::STATUS, "status"},
+    {note::field::DUE_DATE, "due_date"},
+    {note::field::START_DATE, "start_date"},
+    {note::field::END_DATE, "end_date"},
+};
+
+constexpr const char *INSERT_SQL = R"(
+        INSERT INTO notes (type, content, created_at, updated_at, status, due_date, start_date, end_date)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?);
+    )";
+
+// threshold 이상이고 압축해서 줄어드는 본문은 압축해 BLOB 으로 넣는다.
+// packed 는 문장을 실행할 때까지 살아 있어야 한다.
+void bindContent(sqlite3_stmt *stmt,
+                 int index,
+                 const std::string &content,
+                 std::size_t threshold,
+                 std::optional<std::string> &packed)
+{
+    packed.reset();
+    if (threshold != 0 && content.size() >= threshold)
+        packed = note::pack_content(content);
+
+    if (packed)
+        sqlite3_bind_blob(stmt,
+                          index,
+                          packed->data(),
+                          static_cast<int>(packed->size()),
+                          SQLITE_STATIC);
+    else
+        sqlite3_bind_text(stmt,
+                          index,
+                          content.data(),
+                          static_cast<int>(content.size()),
+                          SQLITE_STATIC);
+}
+
+void bindInsert(sqlite3_stmt *stmt,
+                const note::Note &note,
+                std::size_t threshold,
+                std::optional<std::string> &packed)
+{
+    sqlite3_bind_text(
+        stmt, 1, to_string(note.type).c_str(), -1, SQLITE_TRANSIENT);
+    bindContent(stmt, 2, note.content, threshold, packed);
+    bindTime(stmt, 3, note.created_at);
+    bindTime(stmt, 4, note.updated_at);
+
+    sqlite3_bind_text(stmt,
+                      5,
+                      note.status ? to_string(*note.status).c_str() : nullptr,
+                      -1,
+                      SQLITE_TRANSIENT);
+    bindTime(stmt, 6, note.due_date);
+    bindTime(stmt, 7, note.start_date);
+    bindTime(stmt, 8, note.end_date);
+}
+
+// id, type 뒤에 오는 조회 열. 순서가 extractNote 가 읽는 순서다.
+constexpr PatchColumn SELECT_COLUMNS[] = {
+    {note::field::CONTENT, "content"},
+    {note::field::CREATED_AT, "created_at"},
+    {note::field::UPDATED_AT, "updated_at"},
+    {note::field::STATUS, "status"},
+    {note::field::DUE_DATE, "due_date"},
+    {note::field::START_DATE, "start_date"},
+    {note::field::END_DATE, "end_date"},
+    {note::field::TAGS,
+     "(SELECT group_concat(t.name, char(31)) FROM note_tags nt"
+     " JOIN tags t ON t.id = nt.tag_id WHERE nt.note_id = notes.id)"},
+};
+
+// group_concat 으로 묶은 태그 목록의 구분자 (태그에 쓸 수 없는 문자)
+constexpr char TAG_SEPARATOR = '\x1f';
+
+// projection 에 든 열만 고르는 SELECT 문. 미리보기만 필요하면 본문 대신
+// substr 로 앞부분만 읽으므로 첫 번째 매개변수가 미리보기 글자 수가 된다.
+// 압축된 본문(BLOB)은 그대로 읽고 extractNote 에서 앞부분만 푼다.
+std::string selectSql(const note::Projection &projection, const char *where)
+{
+    std::string sql;
+    sql.reserve(160);
+    sql = "SELECT id, type";
+    for (const auto &column : SELECT_COLUMNS)
+    {
+        if (column.field == note::field::CONTENT &&
+            !(projection.fields & note::field::CONTENT) &&
+            projection.preview != 0)
+        {
+            sql += ", CASE WHEN typeof(content) = 'blob' THEN content"
+                   " ELSE substr(content, 1, ?) END";
+            continue;
+        }
+        if (!(projection.fields & column.field))
+            continue;
+        sql += ", ";
+        sql += column.name;
+    }
+    sql += " FROM notes";
+    sql += where;
+    return sql;
+}
+
+// 미리보기 매개변수를 묶고 다음 매개변수 번호를 돌려준다.
+int bindPreview(sqlite3_stmt *stmt, const note::Projection &projection)
+{
+    if ((projection.fields & note::field::CONTENT) || projection.preview == 0)
+        return 1;
+    sqlite3_bind_int64(
+        stmt, 1, static_cast<sqlite3_int64>(projection.preview));
+    return 2;
+}
+
+std::string_view columnText(sqlite3_stmt *stmt, int column)
+{
+    const auto *text =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, column));
+    if (!text)
+        return {};
+    return {text, static_cast<std::size_t>(sqlite3_column_bytes(stmt, column))};
+}
+
+// 압축된 본문이면 풀어서 읽는다. limit 은 풀 바이트 수의 상한이다.
+std::string columnContent(sqlite3_stmt *stmt, int column, std::size_t limit)
+{
+    if (sqlite3_column_type(stmt, column) != SQLITE_BLOB)
+        return std::string(columnText(stmt, column));
+    std::string_view packed(
+        static_cast<const char *>(sqlite3_column_blob(stmt, column)),
+        static_cast<std::size_t>(sqlite3_column_bytes(stmt, column)));
+    return note::unpack_content(packed, limit);
+}
+
+std::vector<std::string> columnTags(sqlite3_stmt *stmt, int column)
+{
+    std::vector<std::string> tags;
+    auto text = columnText(stmt, column);
+    while (!text.empty())
+    {
+        auto end = text.find(TAG_SEPARATOR);
+        tags.emplace_back(text.substr(0, end));
+        text = end == std::string_view::npos ? std::string_view{}
+                                             : text.substr(end + 1);
+    }
+    note::normalize_tags(tags);
+    return tags;
+}
+
+// 노트의 태그를 tags(이름) 와 note_tags(노트-태그 연결) 에 쓴다. 문장은
+// 처음 쓸 때 한 번 준비해 되감아 쓴다. 실패하면 std::runtime_error.
+class TagWriter
+{
+ public:
+    explicit TagWriter(sqlite3 *db) : db_(db) {}
+    ~TagWriter()
+    {
+        sqlite3_finalize(clear_);
+        sqlite3_finalize(name_);
+        sqlite3_finalize(link_);
+    }
+    TagWriter(const TagWriter &) = delete;
+    TagWriter &operator=(const TagWriter &) = delete;
+
+    // replace 면 노트의 기존 태그를 먼저 지운다.
+    void write(note::Id id, const std::vector<std::string> &tags, bool replace)
+    {
+        if (replace)
+        {
+            auto *stmt =
+                prepare(clear_, "DELETE FROM note_tags WHERE note_id = ?");
+            sqlite3_bind_int(stmt, 1, id);
+            step(stmt);
+        }
+        for (const auto &tag : tags)
+        {
+            auto *name =
+                prepare(name_, "INSERT OR IGNORE INTO tags (name) VALUES (?)");
+            bindTag(name, 1, tag);
+            step(name);
+
+            auto *link = prepare(link_,
+                                 "INSERT OR IGNORE INTO note_tags"
+                                 " (note_id, tag_id)"
+                                 " SELECT ?, id FROM tags WHERE name = ?");
+            sqlite3_bind_int(link, 1, id);
+            bindTag(link, 2, tag);
+            step(link);
+        }
+    }
+
+ private:
+    sqlite3_stmt *prepare(sqlite3_stmt *&stmt, const char *sql)
+    {
+        if (!stmt &&
+            sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+            throw std::runtime_error("Failed to prepare tag statement");
+        return stmt;
+    }
+
+    static void bindTag(sqlite3_stmt *stmt, int index, const std::string &tag)
+    {
+        sqlite3_bind_text(stmt,
+                          index,
+                          tag.data(),
+                          static_cast<int>(tag.size()),
+                          SQLITE_STATIC);
+    }
+
+    static void step(sqlite3_stmt *stmt)
+    {
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE)
+            throw std::runtime_error("Tag write failed");
+    }
+
+    sqlite3 *db_;
+    sqlite3_stmt *clear_ = nullptr;
+    sqlite3_stmt *name_ = nullptr;
+    sqlite3_stmt *link_ = nullptr;
+};
+
+// 예전 형식("YYYY-MM-DD HH:MM:SS")으로 저장된 행도 읽는다.
+std::optional<note::TimePoint> columnTime(sqlite3_stmt *stmt, int column)
+{
+    if (sqlite3_column_type(stmt, column) == SQLITE_NULL)
+        return std::nullopt;
+    std::string_view text(
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, column)),
+        static_cast<std::size_t>(sqlite3_column_bytes(stmt, column)));
+    return note::parse_timestamp(text);
+}
+} // namespace
+
+SqliteRepository::SqliteRepository(const nlohmann::json &config)
+    : db_(nullptr),
+      compress_threshold_(compressThreshold(config))
 {
     std::string db_path = config["db_path"].get<std::string>();
     if (db_path.empty())
@@ -50,6 +326,17 @@ SqliteRepository::~SqliteRepository()
     sqlite3_close(db_);
 }
 
+void SqliteRepository::exec(const char *sql) const
+{
+    char *errMsg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK)
+    {
+        std::string error = errMsg ? errMsg : "unknown error";
+        sqlite3_free(errMsg);
+        throw std::runtime_error(std::string(sql) + " failed: " + error);
+    }
+}
+
 void SqliteRepository::initializeDatabase() const
 {
     const char *sql = R"(
@@ -64,6 +351,18 @@ void SqliteRepository::initializeDatabase() const
             start_date TEXT,
             end_date TEXT
         );
+        CREATE TABLE IF NOT EXISTS tags (
+            id INTEGER PRIMARY KEY,
+            name TEXT NOT NULL UNIQUE
+        );
+        CREATE TABLE IF NOT EXISTS note_tags (
+            note_id INTEGER NOT NULL REFERENCES notes(id) ON DELETE CASCADE,
+            tag_id INTEGER NOT NULL REFERENCES tags(id),
+            PRIMARY KEY (note_id, tag_id)
+        ) WITHOUT ROWID;
+        CREATE INDEX IF NOT EXISTS note_tags_tag ON note_tags(tag_id);
+        CREATE INDEX IF NOT EXISTS notes_type ON notes(type);
+        PRAGMA foreign_keys = ON;
     )";
 
     char *errMsg = nullptr;
@@ -75,54 +374,25 @@ void SqliteRepository::initializeDatabase() const
     }
 }
 
-note::Id SqliteRepository::createNote(const note::Note &note)
+note::NotePtr SqliteRepository::createNote(note::Note &&note)
 {
-    const char *sql = R"(
-        INSERT INTO notes (type, content, created_at, updated_at, status, due_date, start_date, end_date)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?);
-    )";
+    BANCHOO_SPAN("sqlite.insert");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    // 태그가 있으면 노트와 태그를 한 트랜잭션으로 넣는다.
+    if (!note.tags.empty())
+    {
+        insertNotes({&note, 1});
+        return std::make_shared<const note::Note>(std::move(note));
+    }
 
     sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+    if (sqlite3_prepare_v2(db_, INSERT_SQL, -1, &stmt, nullptr) != SQLITE_OK)
         throw std::runtime_error("Failed to prepare insert");
 
-    sqlite3_bind_text(
-        stmt, 1, to_string(note.type).c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, note.content.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      3,
-                      note::to_string(note.created_at).c_str(),
-                      -1,
-                      SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      4,
-                      note::to_string(note.updated_at).c_str(),
-                      -1,
-                      SQLITE_TRANSIENT);
-
-    sqlite3_bind_text(stmt,
-                      5,
-                      note.status ? to_string(*note.status).c_str() : nullptr,
-                      -1,
-                      SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      6,
-                      note.due_date ? note::to_string(*note.due_date).c_str()
-                                    : nullptr,
-                      -1,
-                      SQLITE_TRANSIENT);
-    sqlite3_bind_text(
-        stmt,
-        7,
-        note.start_date ? note::to_string(*note.start_date).c_str() : nullptr,
-        -1,
-        SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      8,
-                      note.end_date ? note::to_string(*note.end_date).c_str()
-                                    : nullptr,
-                      -1,
-                      SQLITE_TRANSIENT);
+    std::optional<std::string> packed;
+    bindInsert(stmt, note, compress_threshold_, packed);
 
     if (sqlite3_step(stmt) != SQLITE_DONE)
     {
@@ -130,140 +400,341 @@ note::Id SqliteRepository::createNote(const note::Note &note)
         throw std::runtime_error("Insert failed");
     }
 
-    note::Id new_id = static_cast<note::Id>(sqlite3_last_insert_rowid(db_));
+    note.id = static_cast<note::Id>(sqlite3_last_insert_rowid(db_));
     sqlite3_finalize(stmt);
-    return new_id;
+    return std::make_shared<const note::Note>(std::move(note));
 }
 
-std::optional<note::Note> SqliteRepository::getNote(note::Id id) const
+void SqliteRepository::createNotes(std::span<note::Note> notes)
 {
-    const char *sql = "SELECT * FROM notes WHERE id = ?";
-    sqlite3_stmt *stmt;
+    BANCHOO_SPAN("sqlite.insert_batch");
 
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return std::nullopt;
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    insertNotes(notes);
+}
 
-    sqlite3_bind_int(stmt, 1, id);
+void SqliteRepository::insertNotes(std::span<note::Note> notes)
+{
+    // 행마다 커밋하면 fsync 가 행 수만큼 일어나므로 한 트랜잭션으로 묶고,
+    // 문장도 한 번만 준비해 되감아 쓴다.
+    transaction(
+        [&]
+        {
+            sqlite3_stmt *stmt;
+            if (sqlite3_prepare_v2(db_, INSERT_SQL, -1, &stmt, nullptr) !=
+                SQLITE_OK)
+                throw std::runtime_error("Failed to prepare insert");
+
+            TagWriter tags(db_);
+            std::optional<std::string> packed;
+            try
+            {
+                for (auto &n : notes)
+                {
+                    bindInsert(stmt, n, compress_threshold_, packed);
+                    if (sqlite3_step(stmt) != SQLITE_DONE)
+                        throw std::runtime_error("Insert failed");
+                    n.id =
+                        static_cast<note::Id>(sqlite3_last_insert_rowid(db_));
+                    sqlite3_reset(stmt);
+                    tags.write(n.id, n.tags, false);
+                }
+            }
+            catch (...)
+            {
+                sqlite3_finalize(stmt);
+                throw;
+            }
+            sqlite3_finalize(stmt);
+        });
+}
 
-    note::Note note;
-    if (sqlite3_step(stmt) == SQLITE_ROW)
+void SqliteRepository::transaction(const std::function<void()> &body)
+{
+    exec("BEGIN IMMEDIATE");
+    try
     {
-        note = this->extractNote(stmt);
-        sqlite3_finalize(stmt);
-        return note;
+        body();
     }
-
-    sqlite3_finalize(stmt);
-    return std::nullopt;
+    catch (...)
+    {
+        exec("ROLLBACK");
+        throw;
+    }
+    exec("COMMIT");
 }
 
-std::vector<note::Note> SqliteRepository::getAllNotes() const
+NoteList SqliteRepository::scanNotes(note::Id after,
+                                     std::size_t limit,
+                                     std::optional<note::NoteType> type,
+                                     const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
 {
-    return queryNotesByType(note::NoteType::MEMO /* dummy, will not filter */);
-}
+    BANCHOO_SPAN("sqlite.scan");
 
-std::vector<note::Note> SqliteRepository::getAllMemos() const
-{
-    return queryNotesByType(note::NoteType::MEMO);
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    NoteList notes(mr);
+
+    // 기본 키(종류가 있으면 notes_type 색인) 범위 조회라 페이지마다
+    // 앞에서부터 다시 세지 않는다.
+    auto sql = selectSql(projection,
+                         type ? " WHERE type = ? AND id > ? ORDER BY id LIMIT ?"
+                              : " WHERE id > ? ORDER BY id LIMIT ?");
+
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return notes;
+
+    int index = bindPreview(stmt, projection);
+    if (type)
+        sqlite3_bind_text(
+            stmt, index++, to_string(*type).c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, index++, after);
+    sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(limit));
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        notes.push_back(makeNote(extractNote(stmt, projection), mr));
+
+    sqlite3_finalize(stmt);
+    return notes;
 }
 
-std::vector<note::Note> SqliteRepository::getAllTasks() const
+note::NotePtr SqliteRepository::getNote(note::Id id) const
 {
-    return queryNotesByType(note::NoteType::TASK);
+    BANCHOO_SPAN("sqlite.select_one");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    auto sql = selectSql({}, " WHERE id = ?");
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return nullptr;
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    note::NotePtr note;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        note = std::make_shared<const note::Note>(this->extractNote(stmt));
+
+    sqlite3_finalize(stmt);
+    return note;
 }
 
-std::vector<note::Note> SqliteRepository::getAllEvents() const
+NoteList SqliteRepository::getNotes(std::span<const note::Id> ids,
+                                    const note::Projection &projection,
+                                    std::pmr::memory_resource *mr) const
 {
-    return queryNotesByType(note::NoteType::EVENT);
+    BANCHOO_SPAN("sqlite.select_ids");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    NoteList notes(mr);
+    notes.reserve(ids.size());
+
+    // 기본 키 조회 한 문장을 id 마다 되감아 쓴다.
+    auto sql = selectSql(projection, " WHERE id = ?");
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return notes;
+
+    int index = bindPreview(stmt, projection);
+    for (auto id : ids)
+    {
+        sqlite3_bind_int(stmt, index, id);
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+            notes.push_back(makeNote(extractNote(stmt, projection), mr));
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+    return notes;
 }
 
-std::vector<note::Note>
-SqliteRepository::queryNotesByType(note::NoteType type) const
+NoteList SqliteRepository::listNotes(std::optional<note::NoteType> type,
+                                     const note::Projection &projection,
+                                     std::pmr::memory_resource *mr) const
 {
-    std::vector<note::Note> notes;
+    BANCHOO_SPAN("sqlite.select");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
 
-    std::string sql =
-        (type == note::NoteType::MEMO || type == note::NoteType::TASK ||
-         type == note::NoteType::EVENT)
-        ? "SELECT * FROM notes WHERE type = ?"
-        : "SELECT * FROM notes";
+    NoteList notes(mr);
+
+    auto sql = selectSql(projection, type ? " WHERE type = ?" : "");
 
     sqlite3_stmt *stmt;
     if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
         return notes;
 
-    if (type == note::NoteType::MEMO || type == note::NoteType::TASK ||
-        type == note::NoteType::EVENT)
+    int index = bindPreview(stmt, projection);
+    if (type)
         sqlite3_bind_text(
-            stmt, 1, to_string(type).c_str(), -1, SQLITE_TRANSIENT);
+            stmt, index, to_string(*type).c_str(), -1, SQLITE_TRANSIENT);
 
     while (sqlite3_step(stmt) == SQLITE_ROW)
     {
-        notes.push_back(extractNote(stmt));
+        notes.push_back(makeNote(extractNote(stmt, projection), mr));
     }
 
     sqlite3_finalize(stmt);
     return notes;
 }
 
-bool SqliteRepository::updateNote(const note::Note &note)
+bool SqliteRepository::updateNote(note::Note &&note)
 {
+    BANCHOO_SPAN("sqlite.update");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
     const char *sql = R"(
         UPDATE notes
         SET type = ?, content = ?, created_at = ?, updated_at = ?, status = ?, due_date = ?, start_date = ?, end_date = ?
         WHERE id = ?;
     )";
 
-    sqlite3_stmt *stmt;
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
-        return false;
+    // 태그는 통째로 바꾸므로 노트와 같은 트랜잭션에서 다시 쓴다.
+    bool success = false;
+    transaction(
+        [&]
+        {
+            sqlite3_stmt *stmt;
+            if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK)
+                return;
+            // 압축본은 sqlite3_step 까지 살아 있어야 하므로 여기서 들고 있는다.
+            std::optional<std::string> packed;
+            bindUpdate(stmt, note, packed);
+            success = sqlite3_step(stmt) == SQLITE_DONE &&
+                      sqlite3_changes(db_) > 0;
+            sqlite3_finalize(stmt);
+            if (success)
+                TagWriter(db_).write(note.id, note.tags, true);
+        });
+    return success;
+}
 
+void SqliteRepository::bindUpdate(sqlite3_stmt *stmt,
+                                  const note::Note &note,
+                                  std::optional<std::string> &packed)
+{
     sqlite3_bind_text(
         stmt, 1, note::to_string(note.type).c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, note.content.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      3,
-                      note::to_string(note.created_at).c_str(),
-                      -1,
-                      SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      4,
-                      note::to_string(note.updated_at).c_str(),
-                      -1,
-                      SQLITE_TRANSIENT);
+    bindContent(stmt, 2, note.content, compress_threshold_, packed);
+    bindTime(stmt, 3, note.created_at);
+    bindTime(stmt, 4, note.updated_at);
     sqlite3_bind_text(stmt,
                       5,
                       note.status ? note::to_string(*note.status).c_str()
                                   : nullptr,
                       -1,
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      6,
-                      note.due_date ? note::to_string(*note.due_date).c_str()
-                                    : nullptr,
-                      -1,
-                      SQLITE_TRANSIENT);
-    sqlite3_bind_text(
-        stmt,
-        7,
-        note.start_date ? note::to_string(*note.start_date).c_str() : nullptr,
-        -1,
-        SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt,
-                      8,
-                      note.end_date ? note::to_string(*note.end_date).c_str()
-                                    : nullptr,
-                      -1,
-                      SQLITE_TRANSIENT);
+    bindTime(stmt, 6, note.due_date);
+    bindTime(stmt, 7, note.start_date);
+    bindTime(stmt, 8, note.end_date);
     sqlite3_bind_int(stmt, 9, note.id);
+}
 
-    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+bool SqliteRepository::applyPatch(note::Id id,
+                                  note::Note &&values,
+                                  note::FieldMask fields)
+{
+    BANCHOO_SPAN("sqlite.patch");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
+    // 바뀐 열만 SET 에 넣는다. 상태 변경이면 status, updated_at 두 열이다.
+    std::string sql;
+    sql.reserve(160);
+    sql = "UPDATE notes SET ";
+    bool first = true;
+    for (const auto &column : PATCH_COLUMNS)
+    {
+        if (!(fields & column.field))
+            continue;
+        if (!first)
+            sql += ", ";
+        sql += column.name;
+        sql += " = ?";
+        first = false;
+    }
+    sql += " WHERE id = ? RETURNING id";
+
+    // 태그는 note_tags 에 있으므로 행 수정과 같은 트랜잭션에서 다시 쓴다.
+    if (fields & note::field::TAGS)
+    {
+        bool found = false;
+        transaction(
+            [&]
+            {
+                found = updateColumns(sql, id, values, fields);
+                if (found)
+                    TagWriter(db_).write(id, values.tags, true);
+            });
+        return found;
+    }
+    return updateColumns(sql, id, values, fields);
+}
+
+bool SqliteRepository::updateColumns(const std::string &sql,
+                                     note::Id id,
+                                     const note::Note &values,
+                                     note::FieldMask fields)
+{
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+
+    std::optional<std::string> packed;
+    int index = 0;
+    for (const auto &column : PATCH_COLUMNS)
+    {
+        if (!(fields & column.field))
+            continue;
+        ++index;
+        switch (column.field)
+        {
+        case note::field::CONTENT:
+            bindContent(
+                stmt, index, values.content, compress_threshold_, packed);
+            break;
+        case note::field::UPDATED_AT:
+            bindTime(stmt, index, values.updated_at);
+            break;
+        case note::field::STATUS:
+            if (values.status)
+                sqlite3_bind_text(stmt,
+                                  index,
+                                  note::to_string(*values.status).c_str(),
+                                  -1,
+                                  SQLITE_TRANSIENT);
+            else
+                sqlite3_bind_null(stmt, index);
+            break;
+        case note::field::DUE_DATE:
+            bindTime(stmt, index, values.due_date);
+            break;
+        case note::field::START_DATE:
+            bindTime(stmt, index, values.start_date);
+            break;
+        default:
+            bindTime(stmt, index, values.end_date);
+            break;
+        }
+    }
+    sqlite3_bind_int(stmt, index + 1, id);
+
+    // RETURNING 으로 행이 나오면 그 id 가 있었던 것이다.
+    bool found = (sqlite3_step(stmt) == SQLITE_ROW);
     sqlite3_finalize(stmt);
-    return success;
+    return found;
 }
 
 bool SqliteRepository::deleteNote(note::Id id)
 {
+    BANCHOO_SPAN("sqlite.delete");
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+
     const char *sql = "DELETE FROM notes WHERE id = ?";
     sqlite3_stmt *stmt;
 
@@ -276,45 +747,46 @@ bool SqliteRepository::deleteNote(note::Id id)
     return success;
 }
 
-note::Note SqliteRepository::extractNote(sqlite3_stmt *stmt) const
+note::Note
+SqliteRepository::extractNote(sqlite3_stmt *stmt,
+                              const note::Projection &projection) const
 {
-    note::Note note;
+    auto fields = projection.fields;
+    note::Note note{};
     note.id = sqlite3_column_int(stmt, 0);
-    note.type = static_cast<note::NoteType>(
-        std::string(reinterpret_cast<const char *>(
-            sqlite3_column_text(stmt, 1))) == "TASK"
-            ? note::NoteType::TASK
-            : (std::string(reinterpret_cast<const char *>(
-                   sqlite3_column_text(stmt, 1))) == "EVENT"
-                   ? note::NoteType::EVENT
-                   : note::NoteType::MEMO));
-    note.content = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2));
-    note.created_at = note::parse_time(
-        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3)));
-    note.updated_at = note::parse_time(
-        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 4)));
-
-    if (sqlite3_column_type(stmt, 5) != SQLITE_NULL)
-        note.status = static_cast<note::NoteStatus>(
-            std::string(reinterpret_cast<const char *>(
-                sqlite3_column_text(stmt, 5))) == "DOING"
-                ? note::NoteStatus::DOING
-                : (std::string(reinterpret_cast<const char *>(
-                       sqlite3_column_text(stmt, 5))) == "DONE"
-                       ? note::NoteStatus::DONE
-                       : note::NoteStatus::TODO));
-
-    if (sqlite3_column_type(stmt, 6) != SQLITE_NULL)
-        note.due_date = note::parse_time(
-            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 6)));
-
-    if (sqlite3_column_type(stmt, 7) != SQLITE_NULL)
-        note.start_date = note::parse_time(
-            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 7)));
-
-    if (sqlite3_column_type(stmt, 8) != SQLITE_NULL)
-        note.end_date = note::parse_time(
-            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 8)));
+    note.type =
+        note::parse_type(columnText(stmt, 1)).value_or(note::NoteType::MEMO);
+
+    int column = 2;
+    if (fields & note::field::CONTENT)
+    {
+        note.content = columnContent(
+            stmt, column++, std::numeric_limits<std::size_t>::max());
+    }
+    else if (projection.preview != 0)
+    {
+        // 한 글자는 UTF-8 로 4바이트를 넘지 않는다.
+        note.content =
+            columnContent(stmt, column++, projection.preview * 4);
+        note.content.resize(
+            note::utf8_prefix(note.content, projection.preview).size());
+    }
+    if (fields & note::field::CREATED_AT)
+        note.created_at =
+            columnTime(stmt, column++).value_or(note::TimePoint{});
+    if (fields & note::field::UPDATED_AT)
+        note.updated_at =
+            columnTime(stmt, column++).value_or(note::TimePoint{});
+    if (fields & note::field::STATUS)
+        note.status = note::parse_status(columnText(stmt, column++));
+    if (fields & note::field::DUE_DATE)
+        note.due_date = columnTime(stmt, column++);
+    if (fields & note::field::START_DATE)
+        note.start_date = columnTime(stmt, column++);
+    if (fields & note::field::END_DATE)
+        note.end_date = columnTime(stmt, column++);
+    if (fields & note::field::TAGS)
+        note.tags = columnTags(stmt, column++);
 
     return note;
 }
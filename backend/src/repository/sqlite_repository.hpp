@@ -5,6 +5,12 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -23,21 +29,58 @@ class SqliteRepository : public BaseRepository
  public:
     explicit SqliteRepository(const nlohmann::json &config);
     ~SqliteRepository() override;
-    note::Id createNote(const note::Note &note) override;
-
-    std::optional<note::Note> getNote(note::Id id) const override;
-    std::vector<note::Note> getAllNotes() const override;
-    std::vector<note::Note> getAllMemos() const override;
-    std::vector<note::Note> getAllTasks() const override;
-    std::vector<note::Note> getAllEvents() const override;
-    bool updateNote(const note::Note &note) override;
+    note::NotePtr createNote(note::Note &&note) override;
+    // 한 트랜잭션으로 넣는다. 하나라도 실패하면 전부 되돌리고 던진다.
+    void createNotes(std::span<note::Note> notes) override;
+
+    note::NotePtr getNote(note::Id id) const override;
+    NoteList getNotes(std::span<const note::Id> ids,
+                      const note::Projection &projection = {},
+                      std::pmr::memory_resource *mr =
+                          std::pmr::get_default_resource()) const override;
+    NoteList scanNotes(note::Id after,
+                       std::size_t limit,
+                       std::optional<note::NoteType> type = std::nullopt,
+                       const note::Projection &projection = {},
+                       std::pmr::memory_resource *mr =
+                           std::pmr::get_default_resource()) const override;
+    bool updateNote(note::Note &&note) override;
     bool deleteNote(note::Id id) override;
 
+ protected:
+    NoteList listNotes(std::optional<note::NoteType> type,
+                       const note::Projection &projection,
+                       std::pmr::memory_resource *mr) const override;
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
  private:
     sqlite3 *db_;
+    // 이 바이트 이상인 본문은 압축해 저장한다. 0 이면 압축하지 않는다.
+    std::size_t compress_threshold_;
+    // 모든 문장이 연결 하나를 나눠 쓰므로 문장과 트랜잭션을 하나씩 돌린다.
+    // 그러지 않으면 다른 스레드의 문장이 남의 트랜잭션 안에서 실행된다.
+    mutable std::mutex db_mutex_;
     void initializeDatabase() const;
-    std::vector<note::Note> queryNotesByType(note::NoteType type) const;
-    note::Note extractNote(sqlite3_stmt *stmt) const;
+    void exec(const char *sql) const;
+    // body 를 한 트랜잭션으로 돌린다. body 가 던지면 되돌리고 다시 던진다.
+    // db_mutex_ 를 잡은 채로 부른다.
+    void transaction(const std::function<void()> &body);
+    // createNotes 의 본체. db_mutex_ 를 잡은 채로 부른다.
+    void insertNotes(std::span<note::Note> notes);
+    // packed 는 bindContent 처럼 문장을 실행할 때까지 살아 있어야 한다.
+    void bindUpdate(sqlite3_stmt *stmt,
+                    const note::Note &note,
+                    std::optional<std::string> &packed);
+    // applyPatch 가 만든 UPDATE 문을 돌린다. 행이 있었으면 true.
+    bool updateColumns(const std::string &sql,
+                       note::Id id,
+                       const note::Note &values,
+                       note::FieldMask fields);
+    // selectSql 로 만든 문장의 현재 행을 읽는다.
+    note::Note extractNote(sqlite3_stmt *stmt,
+                           const note::Projection &projection = {}) const;
 };
 
 } // namespace banchoo::repository
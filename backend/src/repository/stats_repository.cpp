@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/stats_repository.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "stats/note_stats.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+// 저장소로 옮겨 가기 전에 집계 필드만 떼어 둔다.
+note::Note keyOf(const note::Note &n)
+{
+    return note::Note{.id = n.id,
+                      .type = n.type,
+                      .created_at = n.created_at,
+                      .status = n.status,
+                      .due_date = n.due_date};
+}
+} // namespace
+
+StatsRepository::StatsRepository(std::shared_ptr<BaseRepository> inner)
+    : ForwardingRepository(std::move(inner))
+{
+    auto notes = inner_->getAllNotes({stats::StatsAggregator::FIELDS, 0});
+    for (const auto &n : notes)
+        aggregator_.add(*n);
+    BANCHOO_INFO("stats: {} notes aggregated", notes.size());
+}
+
+std::optional<note::Note> StatsRepository::loadKey(note::Id id) const
+{
+    auto notes =
+        inner_->getNotes({&id, 1}, {stats::StatsAggregator::FIELDS, 0});
+    if (notes.empty())
+        return std::nullopt;
+    return keyOf(*notes.front());
+}
+
+note::NotePtr StatsRepository::createNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto created = inner_->createNote(std::move(note));
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    aggregator_.add(*created);
+    return created;
+}
+
+void StatsRepository::createNotes(std::span<note::Note> notes)
+{
+    std::vector<note::Note> keys;
+    keys.reserve(notes.size());
+    for (const auto &n : notes)
+        keys.push_back(keyOf(n));
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    inner_->createNotes(notes);
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    for (const auto &key : keys)
+        aggregator_.add(key);
+}
+
+stats::NoteStats StatsRepository::noteStats(note::TimePoint now) const
+{
+    BANCHOO_SPAN("StatsRepository::noteStats");
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return aggregator_.snapshot(now);
+}
+
+bool StatsRepository::updateNote(note::Note &&note)
+{
+    auto key = keyOf(note);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto before = loadKey(key.id);
+    if (!before || !inner_->updateNote(std::move(note)))
+        return false;
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    aggregator_.remove(*before);
+    aggregator_.add(key);
+    return true;
+}
+
+bool StatsRepository::applyPatch(note::Id id,
+                                 note::Note &&values,
+                                 note::FieldMask fields)
+{
+    // 본문이나 태그만 바꾸는 수정은 집계와 상관없다.
+    auto changed = fields & stats::StatsAggregator::FIELDS;
+    if (!changed)
+        return inner_->patchNote(id, std::move(values), fields);
+
+    auto patch = keyOf(values);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto before = loadKey(id);
+    if (!before || !inner_->patchNote(id, std::move(values), fields))
+        return false;
+
+    auto after = *before;
+    note::apply_fields(after, std::move(patch), changed);
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    aggregator_.remove(*before);
+    aggregator_.add(after);
+    return true;
+}
+
+bool StatsRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto before = loadKey(id);
+    if (!before || !inner_->deleteNote(id))
+        return false;
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    aggregator_.remove(*before);
+    return true;
+}
+
+} // namespace banchoo::repository
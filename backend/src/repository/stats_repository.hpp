@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+#include "stats/note_stats.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 noteStats 의 집계를 쓰기마다 갱신해 둔다. 수정과
+// 삭제는 바뀌기 전 노트의 집계 필드를 먼저 읽어 빼고 새 값을 더한다.
+// 만들 때 감싼 저장소의 노트를 한 번 훑어 집계를 채운다.
+class StatsRepository : public ForwardingRepository
+{
+ public:
+    explicit StatsRepository(std::shared_ptr<BaseRepository> inner);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    stats::NoteStats noteStats(note::TimePoint now) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    // 집계 필드만 읽는다. 없으면 nullopt
+    std::optional<note::Note> loadKey(note::Id id) const;
+
+    // 이전 값을 읽고 쓰는 사이에 다른 쓰기가 끼지 않게 한다.
+    std::mutex write_mutex_;
+    mutable std::mutex stats_mutex_;
+    mutable stats::StatsAggregator aggregator_;
+};
+
+} // namespace banchoo::repository
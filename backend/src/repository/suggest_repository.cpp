@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/suggest_repository.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/logger.hpp"
+#include "index/suggest_index.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+// 처음 색인을 채울 때 한 번에 읽는 노트 수
+constexpr std::size_t LOAD_BATCH = 1024;
+} // namespace
+
+SuggestRepository::SuggestRepository(std::shared_ptr<BaseRepository> inner)
+    : ForwardingRepository(std::move(inner))
+{
+    note::Id after = 0;
+    for (;;)
+    {
+        auto batch = inner_->scanNotes(
+            after,
+            LOAD_BATCH,
+            std::nullopt,
+            {.fields = note::field::CONTENT | note::field::UPDATED_AT |
+                       note::field::TAGS});
+        if (batch.empty())
+            break;
+        for (const auto &n : batch)
+        {
+            index_.put(
+                n->id, n->updated_at, index::suggestTerms(n->content, n->tags));
+        }
+        after = batch.back()->id;
+    }
+    BANCHOO_INFO("suggest index: {} notes, {} terms, {} KB",
+                 index_.noteCount(),
+                 index_.termCount(),
+                 index_.memoryBytes() / 1024);
+}
+
+note::NotePtr SuggestRepository::createNote(note::Note &&note)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto created = inner_->createNote(std::move(note));
+    auto terms = index::suggestTerms(created->content, created->tags);
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.put(created->id, created->updated_at, terms);
+    return created;
+}
+
+void SuggestRepository::createNotes(std::span<note::Note> notes)
+{
+    // 저장소가 노트를 옮겨 가므로 단어를 먼저 뽑아 둔다. id 는 저장소가
+    // 새로 붙일 수 있어 저장한 뒤에 읽는다.
+    std::vector<std::pair<note::TimePoint, std::vector<std::string>>> keys;
+    keys.reserve(notes.size());
+    for (const auto &n : notes)
+        keys.emplace_back(n.updated_at, index::suggestTerms(n.content, n.tags));
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    inner_->createNotes(notes);
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    for (std::size_t i = 0; i < notes.size(); ++i)
+        index_.put(notes[i].id, keys[i].first, keys[i].second);
+}
+
+std::vector<note::Id>
+SuggestRepository::suggestNotes(std::string_view prefix,
+                                std::size_t limit) const
+{
+    BANCHOO_SPAN("SuggestRepository::suggestNotes");
+
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    return index_.suggest(prefix, limit);
+}
+
+bool SuggestRepository::updateNote(note::Note &&note)
+{
+    auto id = note.id;
+    auto updated_at = note.updated_at;
+    auto terms = index::suggestTerms(note.content, note.tags);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->updateNote(std::move(note)))
+        return false;
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.put(id, updated_at, terms);
+    return true;
+}
+
+bool SuggestRepository::applyPatch(note::Id id,
+                                   note::Note &&values,
+                                   note::FieldMask fields)
+{
+    auto updated_at = values.updated_at;
+    auto words = fields & (note::field::CONTENT | note::field::TAGS);
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->patchNote(id, std::move(values), fields))
+        return false;
+
+    // 본문과 태그를 그대로 두는 수정은 최근 순서만 바뀐다.
+    if (!words)
+    {
+        std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+        index_.touch(id, updated_at);
+        return true;
+    }
+
+    // 한쪽만 바꿔도 단어는 둘 다에서 나오므로 고친 뒤의 노트를 읽는다.
+    auto patched = inner_->getNotes(
+        {&id, 1},
+        {note::field::CONTENT | note::field::TAGS | note::field::UPDATED_AT,
+         0});
+    if (patched.empty())
+        return true;
+    auto terms =
+        index::suggestTerms(patched.front()->content, patched.front()->tags);
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.put(id, updated_at, terms);
+    return true;
+}
+
+bool SuggestRepository::deleteNote(note::Id id)
+{
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!inner_->deleteNote(id))
+        return false;
+
+    std::unique_lock<std::shared_mutex> index_lock(index_mutex_);
+    index_.remove(id);
+    return true;
+}
+
+} // namespace banchoo::repository
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "index/suggest_index.hpp"
+#include "note/note.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 다른 저장소를 감싸서 본문 단어와 태그의 접두사 색인을 유지하고,
+// suggestNotes 를 색인으로 푼다. 쓰기마다 바뀐 노트의 단어만 다시 넣는다.
+// 만들 때 감싼 저장소의 노트를 한 번 훑어 색인을 채운다.
+class SuggestRepository : public ForwardingRepository
+{
+ public:
+    explicit SuggestRepository(std::shared_ptr<BaseRepository> inner);
+
+    note::NotePtr createNote(note::Note &&note) override;
+    void createNotes(std::span<note::Note> notes) override;
+
+    std::vector<note::Id> suggestNotes(std::string_view prefix,
+                                       std::size_t limit) const override;
+    bool updateNote(note::Note &&note) override;
+    bool deleteNote(note::Id id) override;
+
+ protected:
+    bool applyPatch(note::Id id,
+                    note::Note &&values,
+                    note::FieldMask fields) override;
+
+ private:
+    // 저장소에 쓰는 순서와 색인에 반영하는 순서를 맞춘다.
+    std::mutex write_mutex_;
+    mutable std::shared_mutex index_mutex_;
+    index::SuggestIndex index_;
+};
+
+} // namespace banchoo::repository
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "repository/tenant_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "common/logger.hpp"
+#include "metrics/registry.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/repository_factory.hpp"
+#include "trace/tracer.hpp"
+
+namespace banchoo::repository
+{
+
+namespace
+{
+constexpr std::size_t MAX_TENANT_LENGTH = 64;
+
+const metrics::Counter &opens()
+{
+    static const auto counter = metrics::Registry::instance().counter(
+        "banchoo_tenant_opens_total", "Tenant repositories opened");
+    return counter;
+}
+
+const metrics::Counter &closes()
+{
+    static const auto counter = metrics::Registry::instance().counter(
+        "banchoo_tenant_closes_total", "Tenant repositories closed");
+    return counter;
+}
+
+const metrics::Counter &evictions()
+{
+    static const auto counter = metrics::Registry::instance().counter(
+        "banchoo_tenant_evictions_total",
+        "Tenant repositories dropped from the open-handle LRU");
+    return counter;
+}
+} // namespace
+
+TenantPool::Slot::~Slot()
+{
+    if (repo)
+        closes().inc();
+}
+
+TenantPool::TenantPool(const nlohmann::json &config)
+    : repository_config_(config.value(
+          "repository", nlohmann::json{{"type", "sqlite"}})),
+      dir_(config.value("dir", std::string("data/tenants"))),
+      max_open_(std::max<std::size_t>(config.value("max_open", 64), 1))
+{
+    // 테넌트 저장소는 LRU 에서 밀려났다 다시 열릴 때마다 통째로 만들어지므로,
+    // 열 때 전체를 훑어 채우는 메모리 색인과 집계는 따로 켜지 않는 한 끈다.
+    for (const char *key : {"tag_index", "suggest_index", "stats"})
+    {
+        if (!repository_config_.contains(key))
+            repository_config_[key] = false;
+    }
+
+    std::filesystem::create_directories(dir_);
+    BANCHOO_INFO("tenants: {} (max {} open)", dir_.string(), max_open_);
+}
+
+bool TenantPool::validTenant(std::string_view tenant)
+{
+    if (tenant.empty() || tenant.size() > MAX_TENANT_LENGTH)
+        return false;
+    return std::all_of(tenant.begin(),
+                       tenant.end(),
+                       [](char c)
+                       {
+                           return (c >= '0' && c <= '9') ||
+                                  (c >= 'a' && c <= 'z') ||
+                                  (c >= 'A' && c <= 'Z') || c == '-' ||
+                                  c == '_';
+                       });
+}
+
+std::shared_ptr<BaseRepository>
+TenantPool::open(const std::string &tenant) const
+{
+    BANCHOO_SPAN("TenantPool::open");
+
+    auto config = repository_config_;
+    config["db_path"] = (dir_ / (tenant + ".sqlite")).string();
+    auto repo = RepositoryFactory::create(config);
+    opens().inc();
+    BANCHOO_DEBUG("tenant {} opened", tenant);
+    return repo;
+}
+
+std::shared_ptr<BaseRepository> TenantPool::acquire(std::string_view tenant)
+{
+    if (!validTenant(tenant))
+        throw std::invalid_argument("invalid tenant id");
+
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = std::string(tenant);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            slot = it->second->slot;
+        }
+        else
+        {
+            // 밀려난 뒤에도 아직 쓰는 중이면 그 저장소를 되살린다.
+            auto old = evicted_.find(key);
+            if (old != evicted_.end())
+            {
+                slot = old->second.lock();
+                evicted_.erase(old);
+            }
+            if (!slot)
+                slot = std::make_shared<Slot>();
+            lru_.push_front({key, slot});
+            index_.emplace(std::move(key), lru_.begin());
+            evictOverflow();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (!slot->repo)
+        slot->repo = open(std::string(tenant));
+    // 저장소 대신 칸을 쥐게 해서, 쓰는 동안 밀려나도 evicted_ 에서 찾을 수
+    // 있게 한다.
+    return std::shared_ptr<BaseRepository>(slot, slot->repo.get());
+}
+
+void TenantPool::evictOverflow()
+{
+    while (lru_.size() > max_open_)
+    {
+        auto &victim = lru_.back();
+        if (victim.slot.use_count() > 1)
+            evicted_[victim.tenant] = victim.slot;
+        index_.erase(victim.tenant);
+        lru_.pop_back();
+        evictions().inc();
+    }
+
+    // 다 쓰고 닫힌 항목을 가끔 치운다.
+    if (evicted_.size() > max_open_)
+        std::erase_if(evicted_,
+                      [](const auto &e) { return e.second.expired(); });
+}
+
+std::size_t TenantPool::openCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto open = lru_.size();
+    for (const auto &[tenant, slot] : evicted_)
+        open += !slot.expired();
+    return open;
+}
+
+std::size_t TenantPool::cachedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+} // namespace banchoo::repository
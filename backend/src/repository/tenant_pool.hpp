@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+#include "repository/base_repository.hpp"
+
+namespace banchoo::repository
+{
+
+// 테넌트마다 저장소(기본은 SQLite 파일 하나)를 따로 둔다. 처음 요청이 올 때
+// 열고, 열어 둔 저장소는 LRU 로 max_open 개까지만 둔다. 넘치면 가장 오래
+// 안 쓴 것을 닫고, 다음 요청에서 다시 연다.
+class TenantPool
+{
+ public:
+    // "tenants": { "dir": "data/tenants", "max_open": 64,
+    //              "repository": { "type": "sqlite", ... } }
+    // repository 의 db_path 는 dir/<tenant>.sqlite 로 채운다. tag_index,
+    // suggest_index, stats 는 적지 않으면 끈다.
+    explicit TenantPool(const nlohmann::json &config);
+
+    // 1~64자의 영숫자, '-', '_'. 파일 이름으로 쓰므로 그 밖은 받지 않는다.
+    static bool validTenant(std::string_view tenant);
+
+    // 테넌트의 저장소. 돌려준 포인터를 쥐고 있는 동안은 LRU 에서 밀려나도
+    // 닫히지 않고, 그사이 같은 테넌트 요청은 같은 저장소를 쓴다.
+    // 잘못된 id 면 std::invalid_argument
+    std::shared_ptr<BaseRepository> acquire(std::string_view tenant);
+
+    // 열려 있는 저장소 수 (LRU 에 있는 것 + 밀려났지만 아직 쓰는 것)
+    std::size_t openCount() const;
+    std::size_t cachedCount() const;
+    std::size_t maxOpen() const
+    {
+        return max_open_;
+    }
+
+ private:
+    // 여는 동안 다른 테넌트 요청을 막지 않도록 테넌트마다 따로 잠근다.
+    struct Slot
+    {
+        std::mutex mutex;
+        std::shared_ptr<BaseRepository> repo;
+        ~Slot();
+    };
+    struct Entry
+    {
+        std::string tenant;
+        std::shared_ptr<Slot> slot;
+    };
+
+    std::shared_ptr<BaseRepository> open(const std::string &tenant) const;
+    void evictOverflow();
+
+    nlohmann::json repository_config_;
+    std::filesystem::path dir_;
+    std::size_t max_open_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_; // 앞쪽이 최근
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    // 밀려났지만 아직 요청이 쓰는 저장소. 같은 파일을 두 번 열지 않는다.
+    std::unordered_map<std::string, std::weak_ptr<Slot>> evicted_;
+};
+
+} // namespace banchoo::repository
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "stats/note_stats.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "note/time_codec.hpp"
+
+namespace banchoo::stats
+{
+
+namespace
+{
+bool isOpenTask(const note::Note &n)
+{
+    return n.type == note::NoteType::TASK && n.due_date &&
+           n.status != note::NoteStatus::DONE;
+}
+
+// map 의 개수를 delta 만큼 고치고, 0 이 되면 지운다.
+template <typename Map, typename Key>
+void adjust(Map &map, const Key &key, int delta)
+{
+    if (delta > 0)
+    {
+        ++map[key];
+        return;
+    }
+    auto it = map.find(key);
+    if (it != map.end() && --it->second == 0)
+        map.erase(it);
+}
+} // namespace
+
+void StatsAggregator::add(const note::Note &n)
+{
+    count(n, 1);
+}
+
+void StatsAggregator::remove(const note::Note &n)
+{
+    count(n, -1);
+}
+
+void StatsAggregator::count(const note::Note &n, int delta)
+{
+    auto step = static_cast<std::uint64_t>(delta); // -1 은 wrap 으로 뺀다
+    totals_.total += step;
+    totals_.by_type[static_cast<std::size_t>(n.type)] += step;
+    if (n.type == note::NoteType::TASK && n.status)
+        totals_.tasks_by_status[static_cast<std::size_t>(*n.status)] += step;
+
+    auto day = std::chrono::floor<std::chrono::days>(n.created_at);
+    adjust(per_day_, day, delta);
+
+    if (isOpenTask(n))
+    {
+        adjust(open_due_, *n.due_date, delta);
+        if (*n.due_date < cursor_)
+            overdue_ += step;
+    }
+}
+
+std::string NoteStats::toJson() const
+{
+    auto types = nlohmann::json::object();
+    for (auto type : {note::NoteType::TASK,
+                      note::NoteType::EVENT,
+                      note::NoteType::MEMO})
+        types[note::to_string(type)] =
+            by_type[static_cast<std::size_t>(type)];
+
+    auto statuses = nlohmann::json::object();
+    for (auto status : {note::NoteStatus::TODO,
+                        note::NoteStatus::DOING,
+                        note::NoteStatus::DONE})
+        statuses[note::to_string(status)] =
+            tasks_by_status[static_cast<std::size_t>(status)];
+
+    // 타임스탬프의 날짜 부분 (YYYY-MM-DD)
+    auto days = nlohmann::json::object();
+    char buf[note::TIMESTAMP_MAX_LENGTH];
+    for (const auto &[day, count] : per_day)
+    {
+        note::format_timestamp(day, buf);
+        days[std::string(buf, 10)] = count;
+    }
+
+    return nlohmann::json{{"total", total},
+                          {"by_type", std::move(types)},
+                          {"tasks_by_status", std::move(statuses)},
+                          {"overdue_tasks", overdue_tasks},
+                          {"per_day", std::move(days)}}
+        .dump();
+}
+
+NoteStats StatsAggregator::snapshot(note::TimePoint now)
+{
+    // [cursor_, now) 에 든 마감만 더한다. 시계가 거꾸로 가면 뺀다.
+    if (now > cursor_)
+    {
+        for (auto it = open_due_.lower_bound(cursor_);
+             it != open_due_.end() && it->first < now;
+             ++it)
+            overdue_ += it->second;
+    }
+    else
+    {
+        for (auto it = open_due_.lower_bound(now);
+             it != open_due_.end() && it->first < cursor_;
+             ++it)
+            overdue_ -= it->second;
+    }
+    cursor_ = now;
+
+    NoteStats stats = totals_;
+    stats.overdue_tasks = overdue_;
+    stats.per_day.assign(per_day_.begin(), per_day_.end());
+    return stats;
+}
+
+} // namespace banchoo::stats
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "note/note.hpp"
+
+namespace banchoo::stats
+{
+
+// GET /stats 가 돌려주는 집계
+struct NoteStats
+{
+    std::uint64_t total = 0;
+    std::array<std::uint64_t, 3> by_type{};         // NoteType 값 순
+    std::array<std::uint64_t, 3> tasks_by_status{}; // NoteStatus 값 순
+    // 마감이 지났는데 DONE 이 아닌 할 일
+    std::uint64_t overdue_tasks = 0;
+    // created_at 의 UTC 날짜별 노트 수 (날짜 순, 0 인 날은 없다)
+    std::vector<std::pair<std::chrono::sys_days, std::uint64_t>> per_day;
+
+    // {"total":..,"by_type":{"TASK":..},"tasks_by_status":{"TODO":..},
+    //  "overdue_tasks":..,"per_day":{"2025-04-05":..}}
+    std::string toJson() const;
+};
+
+// 노트가 들어오고 나갈 때마다 O(1) 로 (날짜별, 마감별은 O(log n)) 집계를
+// 고친다. 바뀐 노트는 remove(이전) 후 add(이후) 로 반영한다. 동기화는
+// 부르는 쪽이 맡는다.
+class StatsAggregator
+{
+ public:
+    // add/remove 가 읽는 필드
+    static constexpr note::FieldMask FIELDS =
+        note::field::TYPE | note::field::CREATED_AT | note::field::STATUS |
+        note::field::DUE_DATE;
+
+    void add(const note::Note &n);
+    void remove(const note::Note &n);
+
+    // 지금 기준의 집계. 마감 지난 할 일 수를 now 까지 당겨 오므로 const 가
+    // 아니다.
+    NoteStats snapshot(note::TimePoint now);
+
+ private:
+    void count(const note::Note &n, int delta);
+
+    NoteStats totals_; // per_day, overdue_tasks 는 비워 둔다
+    std::map<std::chrono::sys_days, std::uint64_t> per_day_;
+    // 끝나지 않은 할 일의 마감 시각별 개수와, 그중 cursor_ 이전인 개수.
+    // 시간이 흐를 때마다 새로 지나간 마감만 더한다.
+    std::map<note::TimePoint, std::uint64_t> open_due_;
+    note::TimePoint cursor_{};
+    std::uint64_t overdue_ = 0;
+};
+
+} // namespace banchoo::stats
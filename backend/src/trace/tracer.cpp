@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include "trace/tracer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::trace
+{
+
+thread_local bool Tracer::active_ = false;
+
+namespace
+{
+// 스레드별 xorshift 난수 (샘플링 판단용)
+std::uint64_t nextRandom()
+{
+    thread_local std::uint64_t state =
+        0x9E3779B97F4A7C15ULL ^
+        reinterpret_cast<std::uintptr_t>(&state) ^
+        static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+} // namespace
+
+Tracer &Tracer::instance()
+{
+    static Tracer *tracer = new Tracer();
+    return *tracer;
+}
+
+void Tracer::configure(const nlohmann::json &config)
+{
+    buffer_size_ = std::max<std::size_t>(
+        16, config.value("buffer_size", buffer_size_.load()));
+    setSampleRate(config.value("sample_rate", sampleRate()));
+    setEnabled(config.value("enabled", enabled()));
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::setSampleRate(double rate)
+{
+    sample_rate_.store(std::clamp(rate, 0.0, 1.0), std::memory_order_relaxed);
+}
+
+bool Tracer::enabled() const
+{
+    return enabled_.load(std::memory_order_relaxed);
+}
+
+double Tracer::sampleRate() const
+{
+    return sample_rate_.load(std::memory_order_relaxed);
+}
+
+void Tracer::beginRequest()
+{
+    if (!enabled())
+    {
+        active_ = false;
+        return;
+    }
+
+    // 상위 53비트를 [0, 1) 로 변환해 샘플링 비율과 비교한다.
+    double draw = static_cast<double>(nextRandom() >> 11) * 0x1.0p-53;
+    active_ = draw < sampleRate();
+}
+
+void Tracer::endRequest()
+{
+    active_ = false;
+}
+
+std::uint64_t Tracer::now()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch)
+            .count());
+}
+
+Tracer::ThreadBuffer &Tracer::localBuffer()
+{
+    thread_local ThreadBuffer *buffer = nullptr;
+    if (!buffer)
+    {
+        auto owned = std::make_unique<ThreadBuffer>();
+        owned->ring.resize(buffer_size_.load());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        owned->tid = static_cast<std::uint32_t>(buffers_.size() + 1);
+        buffer = owned.get();
+        buffers_.push_back(std::move(owned));
+    }
+    return *buffer;
+}
+
+void Tracer::record(const char *name,
+                    std::uint64_t start_ns,
+                    std::uint64_t end_ns,
+                    std::string_view detail)
+{
+    auto &buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    auto &slot = buffer.ring[buffer.written % buffer.ring.size()];
+    slot.name = name;
+    slot.start_ns = start_ns;
+    slot.duration_ns = end_ns - start_ns;
+    auto n = std::min(detail.size(), sizeof(slot.detail) - 1);
+    std::memcpy(slot.detail, detail.data(), n);
+    slot.detail[n] = '\0';
+    ++buffer.written;
+}
+
+std::string Tracer::dumpChromeTrace() const
+{
+    auto events = nlohmann::json::array();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &buffer : buffers_)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        auto size = buffer->ring.size();
+        auto count = std::min<std::uint64_t>(buffer->written, size);
+        for (std::uint64_t i = buffer->written - count; i < buffer->written;
+             ++i)
+        {
+            const auto &span = buffer->ring[i % size];
+            nlohmann::json event = {
+                {"name", span.name},
+                {"ph", "X"},
+                {"pid", 1},
+                {"tid", buffer->tid},
+                {"ts", static_cast<double>(span.start_ns) / 1000.0},
+                {"dur", static_cast<double>(span.duration_ns) / 1000.0},
+            };
+            if (span.detail[0] != '\0')
+                event["args"] = {{"detail", span.detail}};
+            events.push_back(std::move(event));
+        }
+    }
+
+    return nlohmann::json({{"traceEvents", std::move(events)},
+                           {"displayTimeUnit", "ms"}})
+        .dump();
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &buffer : buffers_)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->written = 0;
+    }
+}
+
+} // namespace banchoo::trace
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace banchoo::trace
+{
+
+struct SpanRecord
+{
+    const char *name = nullptr; // 정적 문자열만 허용
+    std::uint64_t start_ns = 0;
+    std::uint64_t duration_ns = 0;
+    char detail[40] = {};
+};
+
+// 요청 단위로 샘플링되는 경량 스팬 수집기.
+// 스팬은 스레드별 링 버퍼에 기록되고, 필요할 때 Chrome Trace Event JSON 으로
+// 내보낸다.
+class Tracer
+{
+ public:
+    static Tracer &instance();
+
+    // "trace": { "enabled", "sample_rate", "buffer_size" }
+    void configure(const nlohmann::json &config);
+
+    void setEnabled(bool enabled);
+    void setSampleRate(double rate);
+    bool enabled() const;
+    double sampleRate() const;
+
+    // 요청 시작/끝. 샘플링 여부를 현재 스레드에 기록한다.
+    void beginRequest();
+    void endRequest();
+
+    // 현재 스레드가 샘플링된 요청을 처리 중인지
+    static bool active()
+    {
+        return active_;
+    }
+
+    static std::uint64_t now();
+
+    void record(const char *name,
+                std::uint64_t start_ns,
+                std::uint64_t end_ns,
+                std::string_view detail = {});
+
+    std::string dumpChromeTrace() const;
+    void clear();
+
+ private:
+    struct ThreadBuffer
+    {
+        std::uint32_t tid = 0;
+        std::vector<SpanRecord> ring;
+        std::uint64_t written = 0;
+        mutable std::mutex mutex; // 기록 스레드와 덤프 사이에서만 경합
+    };
+
+    Tracer() = default;
+    ThreadBuffer &localBuffer();
+
+    static thread_local bool active_;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<double> sample_rate_{1.0};
+    std::atomic<std::size_t> buffer_size_{4096};
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+class ScopedSpan
+{
+ public:
+    explicit ScopedSpan(const char *name, std::string_view detail = {})
+    {
+        if (Tracer::active())
+        {
+            name_ = name;
+            detail_ = detail;
+            start_ns_ = Tracer::now();
+        }
+    }
+
+    ~ScopedSpan()
+    {
+        if (name_)
+            Tracer::instance().record(name_, start_ns_, Tracer::now(), detail_);
+    }
+
+    ScopedSpan(const ScopedSpan &) = delete;
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+ private:
+    const char *name_ = nullptr;
+    std::string_view detail_;
+    std::uint64_t start_ns_ = 0;
+};
+
+} // namespace banchoo::trace
+
+#define BANCHOO_SPAN_CONCAT_(a, b) a##b
+#define BANCHOO_SPAN_CONCAT(a, b) BANCHOO_SPAN_CONCAT_(a, b)
+
+// 현재 스코프를 하나의 스팬으로 기록한다. name 은 문자열 리터럴이어야 한다.
+#define BANCHOO_SPAN(...)                                                      \
+    ::banchoo::trace::ScopedSpan BANCHOO_SPAN_CONCAT(banchoo_span_,            \
+                                                     __LINE__)(__VA_ARGS__)
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <crow_all.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "app/admission_control.hpp"
+
+using banchoo::app::AdmissionControl;
+using banchoo::app::RouteClass;
+
+namespace
+{
+crow::request makeRequest(crow::HTTPMethod method, const std::string &url)
+{
+    crow::request req;
+    req.method = method;
+    req.url = url;
+    return req;
+}
+} // namespace
+
+TEST_CASE("AdmissionControl classifies routes from the config table")
+{
+    AdmissionControl admission;
+    admission.configure(nlohmann::json::parse(R"({
+        "admission": {
+            "classes": { "heavy_read": { "limit": 1 } },
+            "routes": { "/stats": "heavy_read", "/grep": "heavy_read" }
+        }
+    })"));
+
+    CHECK_EQ(admission.classify(makeRequest("GET"_method, "/stats")),
+             RouteClass::HEAVY_READ);
+    CHECK_EQ(admission.classify(makeRequest("GET"_method, "/grep")),
+             RouteClass::HEAVY_READ);
+    CHECK_EQ(admission.classify(makeRequest("GET"_method, "/notes")),
+             RouteClass::READ);
+    CHECK_EQ(admission.classify(makeRequest("GET"_method, "/summary")),
+             RouteClass::READ);
+    CHECK_EQ(admission.classify(makeRequest("POST"_method, "/notes")),
+             RouteClass::WRITE);
+
+    SUBCASE("unknown class is rejected")
+    {
+        AdmissionControl bad;
+        CHECK_THROWS_AS(bad.configure(nlohmann::json::parse(
+                            R"({"admission": {"routes": {"/x": "bulk"}}})")),
+                        std::invalid_argument);
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "repository/async_repository.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+
+namespace note = banchoo::note;
+using banchoo::repository::AsyncRepository;
+using banchoo::repository::BaseRepository;
+using banchoo::repository::InMemoryRepository;
+
+TEST_CASE("AsyncRepository")
+{
+    auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+
+    SUBCASE("submit runs on a storage thread and returns the result")
+    {
+        AsyncRepository io(inner, 2);
+        auto caller = std::this_thread::get_id();
+        auto created = io.submit(
+            [caller](BaseRepository &repo)
+            {
+                CHECK_NE(std::this_thread::get_id(), caller);
+                return repo.createMemo({.content = "async"});
+            });
+        auto n = created.get();
+        REQUIRE(n);
+        CHECK_EQ(n->content, "async");
+        CHECK(inner->getNote(n->id));
+        CHECK_EQ(&io.repository(), inner.get());
+    }
+
+    SUBCASE("exceptions surface through the future")
+    {
+        AsyncRepository io(inner, 1);
+        auto failed = io.submit([](BaseRepository &) -> bool
+                                { throw std::runtime_error("disk full"); });
+        CHECK_THROWS_AS(failed.get(), std::runtime_error);
+
+        // 예외가 난 뒤에도 스레드는 계속 일한다.
+        CHECK(io.submit([](BaseRepository &) { return true; }).get());
+    }
+
+    SUBCASE("then hands a ready future to the completion")
+    {
+        AsyncRepository io(inner, 1);
+        std::promise<bool> done;
+        io.then([](BaseRepository &repo)
+                { return repo.deleteNote(42); },
+                [&](std::future<bool> result)
+                {
+                    CHECK_EQ(result.wait_for(std::chrono::seconds(0)),
+                             std::future_status::ready);
+                    done.set_value(result.get());
+                });
+        CHECK_FALSE(done.get_future().get());
+    }
+
+    SUBCASE("a single thread keeps submission order")
+    {
+        AsyncRepository io(inner, 1);
+        std::vector<int> order;
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < 100; ++i)
+            futures.push_back(io.submit([&order, i](BaseRepository &)
+                                        { order.push_back(i); }));
+        for (auto &f : futures)
+            f.get();
+        REQUIRE_EQ(order.size(), 100);
+        for (int i = 0; i < 100; ++i)
+            CHECK_EQ(order[i], i);
+    }
+
+    SUBCASE("threads run jobs concurrently")
+    {
+        AsyncRepository io(inner, 4);
+        std::mutex mutex;
+        int running = 0;
+        int peak = 0;
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < 4; ++i)
+            futures.push_back(io.submit(
+                [&](BaseRepository &)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        peak = std::max(peak, ++running);
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    --running;
+                }));
+        for (auto &f : futures)
+            f.get();
+        CHECK_GT(peak, 1);
+    }
+
+    SUBCASE("destructor finishes queued jobs")
+    {
+        std::atomic<int> finished{0};
+        {
+            AsyncRepository io(inner, 1);
+            for (int i = 0; i < 50; ++i)
+                io.then(
+                    [](BaseRepository &repo)
+                    { return repo.createMemo({.content = "queued"}); },
+                    [&](std::future<note::NotePtr> result)
+                    {
+                        if (result.get())
+                            ++finished;
+                    });
+        }
+        CHECK_EQ(finished.load(), 50);
+        CHECK_EQ(inner->getAllNotes().size(), 50);
+    }
+
+    SUBCASE("needs a thread")
+    {
+        CHECK_THROWS_AS(AsyncRepository(inner, 0), std::invalid_argument);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "capture/capture_file.hpp"
+
+using banchoo::capture::CaptureReader;
+using banchoo::capture::CaptureRecord;
+using banchoo::capture::CaptureWriter;
+
+TEST_CASE("CaptureFile")
+{
+    const std::string path = "test_capture.bin";
+
+    SUBCASE("round trip")
+    {
+        {
+            CaptureWriter writer;
+            REQUIRE(writer.open(path));
+            writer.append({0, 200, "GET", "/notes/1", ""});
+            writer.append(
+                {1500000000ULL, 400, "POST", "/memos", "{\"content\":1}"});
+            writer.append({42, 200, "PROPFIND", "/notes?fields=id", "x"});
+            CHECK_EQ(writer.recordCount(), 3);
+        }
+
+        CaptureReader reader;
+        REQUIRE(reader.open(path));
+
+        auto first = reader.next();
+        REQUIRE(first);
+        CHECK_EQ(first->offset_ns, 0);
+        CHECK_EQ(first->status, 200);
+        CHECK_EQ(first->method, "GET");
+        CHECK_EQ(first->url, "/notes/1");
+        CHECK(first->body.empty());
+
+        auto second = reader.next();
+        REQUIRE(second);
+        CHECK_EQ(second->offset_ns, 1500000000ULL);
+        CHECK_EQ(second->status, 400);
+        CHECK_EQ(second->method, "POST");
+        CHECK_EQ(second->body, "{\"content\":1}");
+
+        auto third = reader.next();
+        REQUIRE(third);
+        CHECK_EQ(third->method, "PROPFIND");
+        CHECK_EQ(third->url, "/notes?fields=id");
+
+        CHECK_FALSE(reader.next());
+    }
+
+    SUBCASE("rejects foreign files")
+    {
+        std::ofstream(path) << "not a capture file";
+        CaptureReader reader;
+        CHECK_FALSE(reader.open(path));
+    }
+
+    SUBCASE("truncated record ends the stream")
+    {
+        {
+            CaptureWriter writer;
+            REQUIRE(writer.open(path));
+            writer.append({7, 200, "PUT", "/notes/3", "{\"content\":\"x\"}"});
+        }
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), {});
+        }
+        bytes.resize(bytes.size() - 3);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+
+        CaptureReader reader;
+        REQUIRE(reader.open(path));
+        CHECK_FALSE(reader.next());
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+
+using banchoo::note::Note;
+using banchoo::note::NoteStatus;
+using banchoo::note::NoteType;
+using banchoo::replication::ChangeLogReader;
+using banchoo::replication::ChangeLogWriter;
+using banchoo::replication::ChangeOp;
+
+TEST_CASE("ChangeLog")
+{
+    const std::string path = "test_changes.log";
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".tmp");
+
+    auto created = banchoo::note::TimePoint(std::chrono::seconds(1700000000));
+    Note task{.id = 7,
+              .type = NoteType::TASK,
+              .content = "write \"docs\"",
+              .created_at = created,
+              .updated_at = created + std::chrono::milliseconds(1500),
+              .status = NoteStatus::DOING,
+              .due_date = created - std::chrono::hours(24 * 365 * 60),
+              .tags = {"home", "work"}};
+
+    SUBCASE("round trip after publish")
+    {
+        ChangeLogWriter writer;
+        REQUIRE(writer.open(path));
+        writer.put(task);
+        // 공개 전에는 따라오는 쪽에 보이지 않는다.
+        CHECK_FALSE(std::filesystem::exists(path));
+        REQUIRE(writer.publish());
+        CHECK_EQ(writer.remove(7), 3);
+
+        ChangeLogReader reader;
+        REQUIRE(reader.open(path));
+        CHECK_EQ(reader.epoch(), writer.epoch());
+
+        auto put = reader.next();
+        REQUIRE(put);
+        CHECK_EQ(put->seq, 1);
+        CHECK_EQ(put->op, ChangeOp::PUT);
+        CHECK_EQ(put->note.id, 7);
+        CHECK_EQ(put->note.type, NoteType::TASK);
+        CHECK_EQ(put->note.content, task.content);
+        CHECK(put->note.created_at == task.created_at);
+        CHECK(put->note.updated_at == task.updated_at);
+        CHECK(put->note.status == task.status);
+        CHECK(put->note.due_date == task.due_date);
+        CHECK_FALSE(put->note.start_date);
+        CHECK_EQ(put->note.tags, task.tags);
+
+        auto end = reader.next();
+        REQUIRE(end);
+        CHECK_EQ(end->op, ChangeOp::SNAPSHOT_END);
+
+        auto removed = reader.next();
+        REQUIRE(removed);
+        CHECK_EQ(removed->seq, 3);
+        CHECK_EQ(removed->op, ChangeOp::REMOVE);
+        CHECK_EQ(removed->note.id, 7);
+
+        CHECK_FALSE(reader.next());
+        CHECK_EQ(reader.pendingBytes(), 0);
+    }
+
+    SUBCASE("tails records appended later")
+    {
+        ChangeLogWriter writer;
+        REQUIRE(writer.open(path));
+        REQUIRE(writer.publish());
+
+        ChangeLogReader reader;
+        REQUIRE(reader.open(path));
+        REQUIRE(reader.next());
+        CHECK_FALSE(reader.next());
+
+        writer.put(task);
+        CHECK_GT(reader.pendingBytes(), 0);
+        auto put = reader.next();
+        REQUIRE(put);
+        CHECK_EQ(put->note.content, task.content);
+        CHECK_FALSE(reader.next());
+    }
+
+    SUBCASE("waits for a partially written record")
+    {
+        std::string bytes;
+        {
+            ChangeLogWriter writer;
+            REQUIRE(writer.open(path));
+            REQUIRE(writer.publish());
+            writer.put(task);
+        }
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), {});
+        }
+        auto cut = bytes.size() - 5;
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(cut));
+        }
+
+        ChangeLogReader reader;
+        REQUIRE(reader.open(path));
+        REQUIRE(reader.next()); // SNAPSHOT_END
+        CHECK_FALSE(reader.next());
+        CHECK_FALSE(reader.next());
+
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::app);
+            out.write(bytes.data() + cut,
+                      static_cast<std::streamsize>(bytes.size() - cut));
+        }
+        auto put = reader.next();
+        REQUIRE(put);
+        CHECK_EQ(put->note.tags, task.tags);
+    }
+
+    SUBCASE("detects a replaced log")
+    {
+        ChangeLogWriter first;
+        REQUIRE(first.open(path));
+        REQUIRE(first.publish());
+
+        ChangeLogReader reader;
+        REQUIRE(reader.open(path));
+        CHECK_FALSE(reader.replaced());
+
+        // 같은 나노초에 열리지 않도록 조금 쉰다.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ChangeLogWriter second;
+        REQUIRE(second.open(path));
+        CHECK_FALSE(reader.replaced());
+        REQUIRE(second.publish());
+        CHECK(reader.replaced());
+        CHECK_EQ(ChangeLogReader::readEpoch(path), second.epoch());
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".tmp");
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <crow_all.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "repository/async_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+constexpr std::uint16_t PORT = 18191;
+constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+// 커널 송수신 버퍼(루프백에서 수 MB)에 다 들어가지 않을 만큼 크게 잡는다.
+constexpr int CHUNKS = 256;
+
+int connectTo(std::uint16_t port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    // 수신 창을 작게 해서 서버가 읽는 속도에 맞춰 보내게 한다.
+    int size = 16 * 1024;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    // 응답이 끊기거나 오지 않으면 기다리지 않고 실패하게 한다.
+    timeval timeout{.tv_sec = 10, .tv_usec = 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 100; ++i)
+    {
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+            0)
+            return fd;
+        std::this_thread::sleep_for(20ms);
+    }
+    ::close(fd);
+    return -1;
+}
+
+void sendRequest(int fd, std::string_view path)
+{
+    std::string request = "GET " + std::string(path) +
+                          " HTTP/1.1\r\nHost: localhost\r\n"
+                          "Connection: keep-alive\r\n\r\n";
+    REQUIRE(::send(fd, request.data(), request.size(), 0) ==
+            static_cast<ssize_t>(request.size()));
+}
+
+// until 로 끝나거나 연결이 닫힐 때까지 읽는다.
+std::string readUntil(int fd, std::string_view until)
+{
+    std::string data;
+    char buf[32 * 1024];
+    while (!data.ends_with(until))
+    {
+        auto n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0)
+            break;
+        data.append(buf, static_cast<std::size_t>(n));
+    }
+    return data;
+}
+
+// chunked 본문을 풀어 이어 붙인다. 마지막 조각이 없으면 std::nullopt.
+std::optional<std::string> dechunk(std::string_view body)
+{
+    std::string out;
+    while (true)
+    {
+        auto line_end = body.find("\r\n");
+        if (line_end == std::string_view::npos)
+            return std::nullopt;
+        auto size = std::stoul(std::string(body.substr(0, line_end)),
+                               nullptr,
+                               16);
+        body.remove_prefix(line_end + 2);
+        if (size == 0)
+            return body == "\r\n" ? std::optional(out) : std::nullopt;
+        if (body.size() < size + 2)
+            return std::nullopt;
+        out.append(body.substr(0, size));
+        body.remove_prefix(size + 2);
+    }
+}
+// 검사가 실패해 빠져나가도 서버를 멈춘다. 멈추지 않으면 running 의
+// 소멸자가 run() 을 기다리며 멈춰 버린다.
+struct TestServer
+{
+    crow::SimpleApp app;
+    std::future<void> running;
+
+    ~TestServer()
+    {
+        app.stop();
+    }
+};
+} // namespace
+
+TEST_CASE("chunked response to a slow reader")
+{
+    TestServer server;
+    auto &app = server.app;
+    app.loglevel(crow::LogLevel::Warning);
+
+    CROW_ROUTE(app, "/chunks")
+    (
+        []
+        {
+            crow::response res;
+            auto sent = std::make_shared<int>(0);
+            res.set_body_source(
+                [sent](std::string &chunk)
+                {
+                    chunk.assign(CHUNK_SIZE, 'x');
+                    return ++*sent < CHUNKS;
+                });
+            return res;
+        });
+    CROW_ROUTE(app, "/ping")([] { return "pong"; });
+
+    // 유휴 타이머보다 오래 걸려 받도록 1초로 줄인다.
+    server.running =
+        app.bindaddr("127.0.0.1").port(PORT).timeout(1).run_async();
+    app.wait_for_server_start();
+
+    int fd = connectTo(PORT);
+    REQUIRE(fd >= 0);
+
+    // 서버가 버퍼를 채우고 쓰기를 기다리는 동안 유휴 타이머가 지나가게 한다.
+    sendRequest(fd, "/chunks");
+    std::this_thread::sleep_for(2500ms);
+    auto response = readUntil(fd, "\r\n0\r\n\r\n");
+
+    auto header_end = response.find("\r\n\r\n");
+    REQUIRE(header_end != std::string::npos);
+    auto body = dechunk(std::string_view(response).substr(header_end + 4));
+    REQUIRE(body);
+    CHECK_EQ(body->size(), CHUNK_SIZE * CHUNKS);
+
+    // 다 보낸 뒤에는 같은 연결로 다음 요청을 받는다.
+    sendRequest(fd, "/ping");
+    CHECK(readUntil(fd, "pong").ends_with("pong"));
+
+    ::close(fd);
+}
+
+TEST_CASE("request body over the limit is rejected with 413")
+{
+    TestServer server;
+    auto &app = server.app;
+    app.loglevel(crow::LogLevel::Warning);
+
+    auto called = std::make_shared<int>(0);
+    CROW_ROUTE(app, "/upload")
+        .methods("POST"_method)(
+            [called](const crow::request &req)
+            {
+                ++*called;
+                return std::to_string(req.body.size());
+            });
+
+    server.running = app.bindaddr("127.0.0.1")
+                         .port(PORT + 1)
+                         .body_limit(1024)
+                         .run_async();
+    app.wait_for_server_start();
+
+    int fd = connectTo(PORT + 1);
+    REQUIRE(fd >= 0);
+
+    auto post = [fd](std::size_t size)
+    {
+        std::string request = "POST /upload HTTP/1.1\r\nHost: localhost\r\n"
+                              "Content-Length: " +
+                              std::to_string(size) + "\r\n\r\n" +
+                              std::string(size, 'x');
+        REQUIRE(::send(fd, request.data(), request.size(), 0) ==
+                static_cast<ssize_t>(request.size()));
+    };
+
+    post(4096);
+    CHECK(readUntil(fd, "Payload Too Large\r\n").starts_with("HTTP/1.1 413"));
+    CHECK_EQ(*called, 0);
+
+    // 버린 본문 뒤에도 같은 연결로 다음 요청을 받는다.
+    post(512);
+    CHECK(readUntil(fd, "\r\n\r\n512").starts_with("HTTP/1.1 200"));
+    CHECK_EQ(*called, 1);
+
+    ::close(fd);
+}
+
+TEST_CASE("chunked response made on a runner thread")
+{
+    banchoo::repository::AsyncRepository io(
+        std::make_shared<banchoo::repository::InMemoryRepository>(
+            nlohmann::json{}),
+        2);
+    TestServer server;
+    auto &app = server.app;
+    app.loglevel(crow::LogLevel::Warning);
+
+    // 핸들러와 조각을 만든 스레드를 남긴다. 핸들러는 io 스레드에서 돈다.
+    auto handler_thread = std::make_shared<std::thread::id>();
+    auto on_io_thread = std::make_shared<std::atomic<int>>(0);
+    CROW_ROUTE(app, "/chunks")
+    (
+        [&io, handler_thread, on_io_thread]
+        {
+            *handler_thread = std::this_thread::get_id();
+            crow::response res;
+            auto sent = std::make_shared<int>(0);
+            res.set_body_source(
+                [sent, handler_thread, on_io_thread](std::string &chunk)
+                {
+                    if (std::this_thread::get_id() == *handler_thread)
+                        ++*on_io_thread;
+                    chunk.assign(CHUNK_SIZE, 'x');
+                    return ++*sent < 8;
+                });
+            res.body_source_runner = [&io](std::function<void()> job)
+            { io.post(std::move(job)); };
+            return res;
+        });
+
+    server.running =
+        app.bindaddr("127.0.0.1").port(PORT + 2).concurrency(1).run_async();
+    app.wait_for_server_start();
+
+    int fd = connectTo(PORT + 2);
+    REQUIRE(fd >= 0);
+    sendRequest(fd, "/chunks");
+    auto response = readUntil(fd, "\r\n0\r\n\r\n");
+    auto header_end = response.find("\r\n\r\n");
+    REQUIRE(header_end != std::string::npos);
+    auto body = dechunk(std::string_view(response).substr(header_end + 4));
+    REQUIRE(body);
+    CHECK_EQ(body->size(), CHUNK_SIZE * 8);
+    CHECK_EQ(on_io_thread->load(), 0);
+
+    ::close(fd);
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "repository/compact_inmemory_repository.hpp"
+#include "repository/indexed_repository.hpp"
+#include "repository/reminder_repository.hpp"
+#include "repository/repository_factory.hpp"
+#include "repository/stats_repository.hpp"
+#include "repository/suggest_repository.hpp"
+
+using banchoo::repository::CompactInMemoryRepository;
+using banchoo::repository::IndexedRepository;
+using banchoo::repository::ReminderRepository;
+using banchoo::repository::StatsRepository;
+using banchoo::repository::SuggestRepository;
+namespace note = banchoo::note;
+
+TEST_CASE("CompactInMemoryRepository")
+{
+    CompactInMemoryRepository repo(nlohmann::json{});
+
+    SUBCASE("createNote and getNote")
+    {
+        auto created = repo.createMemo({.content = "Hello, World!"});
+        REQUIRE(created);
+
+        auto result = repo.getNote(created->id);
+        REQUIRE(result);
+        CHECK_EQ(result->id, created->id);
+        CHECK_EQ(result->type, note::NoteType::MEMO);
+        CHECK_EQ(result->content, "Hello, World!");
+        CHECK_EQ(result->created_at, created->created_at);
+        CHECK_FALSE(result->status);
+        CHECK_FALSE(result->due_date);
+
+        CHECK_FALSE(repo.getNote(created->id + 1));
+        CHECK_FALSE(repo.getNote(0));
+        CHECK_FALSE(repo.getNote(-1));
+    }
+
+    SUBCASE("optional fields round trip")
+    {
+        auto due = note::TimePoint(std::chrono::seconds(1743854400));
+        auto created = repo.createTask({.content = "task", .due_date = due});
+        auto start = due + std::chrono::hours(1);
+
+        auto result = repo.getNote(created->id);
+        REQUIRE(result);
+        CHECK_EQ(result->status, note::NoteStatus::TODO);
+        CHECK_EQ(result->due_date, due);
+        CHECK_FALSE(result->start_date);
+
+        note::Note changed = *result;
+        changed.status = note::NoteStatus::DONE;
+        changed.due_date.reset();
+        changed.start_date = start;
+        REQUIRE(repo.updateNote(std::move(changed)));
+
+        result = repo.getNote(created->id);
+        CHECK_EQ(result->status, note::NoteStatus::DONE);
+        CHECK_FALSE(result->due_date);
+        CHECK_EQ(result->start_date, start);
+    }
+
+    SUBCASE("type filters")
+    {
+        repo.createMemo({.content = "memo"});
+        repo.createTask({.content = "task"});
+        repo.createEvent({.content = "event"});
+
+        CHECK_EQ(repo.getAllNotes().size(), 3);
+        REQUIRE(repo.getAllTasks().size() == 1);
+        CHECK_EQ(repo.getAllTasks()[0]->content, "task");
+        REQUIRE(repo.getAllEvents().size() == 1);
+        CHECK_EQ(repo.getAllEvents()[0]->content, "event");
+        CHECK_EQ(repo.getAllMemos().size(), 1);
+    }
+
+    SUBCASE("update shorter and longer content")
+    {
+        auto id = repo.createMemo({.content = "0123456789"})->id;
+        auto other = repo.createMemo({.content = "other"})->id;
+
+        note::Note shorter = *repo.getNote(id);
+        shorter.content = "abc";
+        REQUIRE(repo.updateNote(std::move(shorter)));
+        CHECK_EQ(repo.getNote(id)->content, "abc");
+
+        note::Note longer = *repo.getNote(id);
+        longer.content = std::string(100, 'x');
+        REQUIRE(repo.updateNote(std::move(longer)));
+        CHECK_EQ(repo.getNote(id)->content, std::string(100, 'x'));
+        CHECK_EQ(repo.getNote(other)->content, "other");
+
+        note::Note missing{.id = 999, .content = "none"};
+        CHECK_FALSE(repo.updateNote(std::move(missing)));
+    }
+
+    SUBCASE("deleteNote reuses slots")
+    {
+        auto first = repo.createMemo({.content = "first"})->id;
+        auto second = repo.createMemo({.content = "second"})->id;
+
+        CHECK(repo.deleteNote(first));
+        CHECK_FALSE(repo.deleteNote(first));
+        CHECK_FALSE(repo.getNote(first));
+
+        auto third = repo.createMemo({.content = "third"})->id;
+        CHECK_EQ(repo.getNote(third)->content, "third");
+        CHECK_EQ(repo.getNote(second)->content, "second");
+        CHECK_EQ(repo.getAllNotes().size(), 2);
+    }
+
+    SUBCASE("arena compaction keeps live content")
+    {
+        // 큰 본문을 여러 번 갈아 끼워 아레나 정리가 일어나게 한다.
+        auto keep = repo.createMemo({.content = "keep"})->id;
+        auto id = repo.createMemo({.content = ""})->id;
+        for (int i = 0; i < 64; ++i)
+        {
+            note::Note n = *repo.getNote(id);
+            n.content = std::string(4096 + i, static_cast<char>('a' + i % 26));
+            REQUIRE(repo.updateNote(std::move(n)));
+        }
+
+        CHECK_EQ(repo.getNote(keep)->content, "keep");
+        CHECK_EQ(repo.getNote(id)->content, std::string(4096 + 63, 'l'));
+    }
+
+    SUBCASE("patchNote")
+    {
+        auto due = note::TimePoint(std::chrono::seconds(1743854400));
+        auto created = repo.createTask({.content = "task", .due_date = due});
+
+        note::Note values;
+        values.status = note::NoteStatus::DONE;
+        REQUIRE(repo.patchNote(created->id,
+                               std::move(values),
+                               note::field::STATUS | note::field::DUE_DATE));
+
+        auto patched = repo.getNote(created->id);
+        REQUIRE(patched);
+        CHECK_EQ(patched->status, note::NoteStatus::DONE);
+        CHECK_FALSE(patched->due_date);
+        CHECK_EQ(patched->content, "task");
+        CHECK_EQ(patched->created_at, created->created_at);
+
+        note::Note content{.content = "renamed"};
+        REQUIRE(repo.patchNote(
+            created->id, std::move(content), note::field::CONTENT));
+        patched = repo.getNote(created->id);
+        CHECK_EQ(patched->content, "renamed");
+        CHECK_EQ(patched->status, note::NoteStatus::DONE);
+
+        CHECK_FALSE(repo.patchNote(999, note::Note{}, note::field::STATUS));
+    }
+
+    SUBCASE("projection")
+    {
+        repo.createTask({.content = "가나다라마바사"});
+
+        auto notes = repo.getAllTasks(
+            {note::field::ID | note::field::STATUS, 3});
+        REQUIRE(notes.size() == 1);
+        CHECK_EQ(notes[0]->type, note::NoteType::TASK);
+        CHECK_EQ(notes[0]->content, "가나다");
+        CHECK_EQ(notes[0]->status, note::NoteStatus::TODO);
+        CHECK_EQ(notes[0]->created_at, note::TimePoint{});
+
+        notes = repo.getAllNotes({note::field::ID, 0});
+        REQUIRE(notes.size() == 1);
+        CHECK(notes[0]->content.empty());
+        CHECK_FALSE(notes[0]->status);
+    }
+
+    SUBCASE("invalid id")
+    {
+        note::Note n{.id = 0, .content = "x"};
+        CHECK_THROWS_AS(repo.createNote(std::move(n)), std::invalid_argument);
+    }
+}
+
+TEST_CASE("CompactInMemoryRepository compression")
+{
+    CompactInMemoryRepository repo(
+        nlohmann::json{{"compress_threshold", 1024}});
+
+    std::string text;
+    while (text.size() < 8192)
+        text += "회의록 line " + std::to_string(text.size() % 7) + "\n";
+
+    auto id = repo.createMemo({.content = text})->id;
+    auto small = repo.createMemo({.content = "short"})->id;
+    CHECK_EQ(repo.getNote(id)->content, text);
+    CHECK_EQ(repo.getNote(small)->content, "short");
+
+    auto notes = repo.getAllNotes({note::field::ID, 5});
+    REQUIRE(notes.size() == 2);
+    CHECK_EQ(notes[0]->content, "회의록 l");
+    auto scanned = repo.scanNotes(0, 1, std::nullopt, {note::field::ID, 0});
+    REQUIRE(scanned.size() == 1);
+    CHECK(scanned[0]->content.empty());
+
+    // 압축 여부가 바뀌어도 다른 필드는 그대로다.
+    note::Note task = *repo.getNote(id);
+    task.status = note::NoteStatus::DONE;
+    task.content = "now short";
+    REQUIRE(repo.updateNote(std::move(task)));
+    auto updated = repo.getNote(id);
+    CHECK_EQ(updated->content, "now short");
+    CHECK_EQ(updated->status, note::NoteStatus::DONE);
+
+    note::Note longer{.content = text};
+    REQUIRE(repo.patchNote(id, std::move(longer), note::field::CONTENT));
+    CHECK_EQ(repo.getNote(id)->content, text);
+    CHECK_EQ(repo.getNote(id)->status, note::NoteStatus::DONE);
+}
+
+TEST_CASE("CompactInMemoryRepository grepNotes")
+{
+    CompactInMemoryRepository repo(
+        nlohmann::json{{"compress_threshold", 64}});
+
+    std::string text(4096, 'x');
+    text += " needle";
+    repo.createMemo({.content = "needle"});
+    repo.createMemo({.content = "hay"});
+    repo.createMemo({.content = text});
+    repo.createMemo({.content = "needle again"});
+    repo.deleteNote(4);
+    repo.createMemo({.content = "second line\nneedle 42"});
+
+    std::string error;
+    using banchoo::index::ContentMatcher;
+    auto literal = ContentMatcher::parse("needle", false, error);
+    REQUIRE(literal);
+    CHECK_EQ(repo.grepNotes(*literal, 10), std::vector<note::Id>{1, 3, 5});
+    CHECK_EQ(repo.grepNotes(*literal, 1), std::vector<note::Id>{1});
+
+    auto regex = ContentMatcher::parse("^needle \\d+$", true, error);
+    REQUIRE(regex);
+    CHECK_EQ(repo.grepNotes(*regex, 10), std::vector<note::Id>{5});
+}
+
+TEST_CASE("CompactInMemoryRepository grepNotes during writes")
+{
+    // 잠금 밖에서 훑는 동안 다른 노트를 덮어쓰고 늘리고 아레나를 정리해도
+    // 훑던 본문은 그대로여야 한다.
+    CompactInMemoryRepository repo(nlohmann::json{});
+    std::string pad(8192, 'x');
+    std::vector<note::Id> expected;
+    for (int i = 0; i < 100; ++i)
+        expected.push_back(repo.createMemo({.content = pad + " needle"})->id);
+    std::vector<note::Id> others;
+    for (int i = 0; i < 100; ++i)
+        others.push_back(repo.createMemo({.content = pad})->id);
+
+    std::atomic<bool> done = false;
+    std::thread writer(
+        [&]
+        {
+            for (int round = 0; round < 20; ++round)
+            {
+                for (auto id : others)
+                {
+                    note::Note n = *repo.getNote(id);
+                    n.content = round % 2 == 0 ? "hay" : pad + pad;
+                    repo.updateNote(std::move(n));
+                }
+            }
+            done = true;
+        });
+
+    std::string error;
+    auto needle =
+        banchoo::index::ContentMatcher::parse("needle", false, error);
+    REQUIRE(needle);
+    int scans = 0;
+    while (!done || scans == 0)
+    {
+        CHECK_EQ(repo.grepNotes(*needle, 1000), expected);
+        ++scans;
+    }
+    writer.join();
+    CHECK_EQ(repo.grepNotes(*needle, 1000), expected);
+}
+
+TEST_CASE("CompactInMemoryRepository tags")
+{
+    CompactInMemoryRepository repo(nlohmann::json{});
+
+    auto memo = repo.createMemo({.content = "memo", .tags = {"a", "b"}});
+    auto task = repo.createTask({.content = "task", .tags = {"b"}});
+    CHECK_EQ(repo.getNote(memo->id)->tags, std::vector<std::string>{"a", "b"});
+
+    // 태그만 고르면 본문은 읽지 않는다.
+    auto notes = repo.getAllNotes({note::field::ID | note::field::TAGS, 0});
+    REQUIRE_EQ(notes.size(), 2);
+    CHECK(notes[0]->content.empty());
+    CHECK_EQ(notes[1]->tags, std::vector<std::string>{"b"});
+    CHECK(repo.getAllNotes({note::field::ID, 0})[0]->tags.empty());
+
+    note::Note retag{.tags = {"c"}};
+    REQUIRE(repo.patchNote(task->id, std::move(retag), note::field::TAGS));
+    CHECK_EQ(repo.getNote(task->id)->tags, std::vector<std::string>{"c"});
+    CHECK_EQ(repo.getNote(task->id)->content, "task");
+
+    note::Note status{.status = note::NoteStatus::DONE};
+    REQUIRE(repo.patchNote(task->id, std::move(status), note::field::STATUS));
+    CHECK_EQ(repo.getNote(task->id)->tags, std::vector<std::string>{"c"});
+
+    std::string error;
+    auto query = banchoo::index::TagQuery::parse("b OR c", error);
+    REQUIRE(query);
+    auto found = repo.findNotes(*query, std::nullopt);
+    REQUIRE_EQ(found.size(), 2);
+    CHECK_EQ(found[0]->id, memo->id);
+
+    const note::Id ids[] = {task->id, 999, memo->id};
+    auto got = repo.getNotes(ids, {note::field::ID | note::field::TAGS, 0});
+    REQUIRE_EQ(got.size(), 2);
+    CHECK_EQ(got[0]->id, task->id);
+    CHECK_EQ(got[1]->tags, std::vector<std::string>{"a", "b"});
+
+    REQUIRE(repo.deleteNote(memo->id));
+    CHECK_FALSE(repo.getNote(memo->id));
+}
+
+TEST_CASE("RepositoryFactory inmemory layout")
+{
+    using banchoo::repository::RepositoryFactory;
+
+    auto compact = RepositoryFactory::create({{"type", "inmemory"},
+                                              {"layout", "compact"},
+                                              {"instrumented", false},
+                                              {"tag_index", false},
+                                              {"stats", false}});
+    CHECK(std::dynamic_pointer_cast<CompactInMemoryRepository>(compact));
+
+    auto node = RepositoryFactory::create({{"type", "inmemory"},
+                                           {"instrumented", false},
+                                           {"tag_index", false},
+                                           {"stats", false}});
+    CHECK_FALSE(std::dynamic_pointer_cast<CompactInMemoryRepository>(node));
+
+    // 기본으로 태그 색인과 집계가 저장소를 차례로 감싼다. 접두사 색인은
+    // 켤 때만 그 사이에 들어간다.
+    auto indexed = RepositoryFactory::create({{"type", "inmemory"},
+                                              {"layout", "compact"},
+                                              {"instrumented", false},
+                                              {"stats", false}});
+    CHECK(std::dynamic_pointer_cast<IndexedRepository>(indexed));
+    auto unsuggested = RepositoryFactory::create(
+        {{"type", "inmemory"}, {"instrumented", false}, {"stats", false}});
+    CHECK_FALSE(std::dynamic_pointer_cast<SuggestRepository>(unsuggested));
+    auto suggested = RepositoryFactory::create({{"type", "inmemory"},
+                                                {"instrumented", false},
+                                                {"suggest_index", true},
+                                                {"stats", false}});
+    CHECK(std::dynamic_pointer_cast<SuggestRepository>(suggested));
+    auto counted = RepositoryFactory::create(
+        {{"type", "inmemory"}, {"instrumented", false}});
+    CHECK(std::dynamic_pointer_cast<StatsRepository>(counted));
+
+    // 알림 스케줄러를 넘기면 맨 바깥에서 알림을 맞춘다.
+    auto reminded = RepositoryFactory::create(
+        {{"type", "inmemory"}, {"instrumented", false}},
+        std::make_shared<banchoo::reminder::ReminderScheduler>());
+    CHECK(std::dynamic_pointer_cast<ReminderRepository>(reminded));
+
+    CHECK_THROWS_AS(RepositoryFactory::create(
+                        {{"type", "inmemory"}, {"layout", "packed"}}),
+                    std::invalid_argument);
+}
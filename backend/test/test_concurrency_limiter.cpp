@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+
+#include "app/concurrency_limiter.hpp"
+
+using banchoo::app::ConcurrencyLimiter;
+using namespace std::chrono_literals;
+
+TEST_CASE("ConcurrencyLimiter")
+{
+    ConcurrencyLimiter::Options options;
+    options.limit = 2;
+
+    SUBCASE("admits up to limit then rejects at once")
+    {
+        ConcurrencyLimiter limiter(options);
+        CHECK(limiter.tryAcquire());
+        CHECK(limiter.tryAcquire());
+        CHECK_EQ(limiter.inFlight(), 2);
+
+        auto start = std::chrono::steady_clock::now();
+        CHECK_FALSE(limiter.tryAcquire());
+        CHECK_LT(std::chrono::steady_clock::now() - start, 10ms);
+        CHECK_EQ(limiter.inFlight(), 2);
+    }
+
+    SUBCASE("released slot is admitted again")
+    {
+        ConcurrencyLimiter limiter(options);
+        REQUIRE(limiter.tryAcquire());
+        REQUIRE(limiter.tryAcquire());
+        REQUIRE_FALSE(limiter.tryAcquire());
+
+        limiter.release(1ms);
+        CHECK(limiter.tryAcquire());
+    }
+
+    SUBCASE("adaptive limit shrinks under slow responses")
+    {
+        options.limit = 20;
+        options.target_latency = 1ms;
+        ConcurrencyLimiter limiter(options);
+        for (int i = 0; i < 32; ++i)
+        {
+            REQUIRE(limiter.tryAcquire());
+            limiter.release(10ms);
+        }
+        CHECK_LT(limiter.limit(), 20);
+    }
+
+    SUBCASE("adaptive limit grows when requests are rejected")
+    {
+        options.limit = 4;
+        options.target_latency = 10ms;
+        ConcurrencyLimiter limiter(options);
+        for (int i = 0; i < 32; ++i)
+        {
+            REQUIRE(limiter.tryAcquire());
+            if (i == 0)
+            {
+                // 한 번은 한도를 채워 거절을 남긴다.
+                for (int j = 1; j < 4; ++j)
+                    REQUIRE(limiter.tryAcquire());
+                CHECK_FALSE(limiter.tryAcquire());
+                for (int j = 1; j < 4; ++j)
+                    limiter.release(0us);
+            }
+            limiter.release(1ms);
+        }
+        CHECK_GT(limiter.limit(), 4);
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "note/content_codec.hpp"
+
+namespace note = banchoo::note;
+
+namespace
+{
+std::string transcript(std::size_t size)
+{
+    const char *lines[] = {"김: 다음 분기 일정부터 정리하겠습니다.\n",
+                           "Lee: the migration is blocked on review.\n",
+                           "박: 회의록은 노트에 붙여 두겠습니다.\n",
+                           "Kim: action item - update the roadmap.\n"};
+    std::string text;
+    for (std::size_t i = 0; text.size() < size; ++i)
+    {
+        text += lines[(i * 7) % 4];
+        text += std::to_string(i);
+    }
+    text.resize(size);
+    return text;
+}
+
+std::string roundTrip(const std::string &src)
+{
+    std::vector<char> packed(note::max_compressed_size(src.size()));
+    auto written = note::compress_block(src, packed.data());
+    REQUIRE(written <= packed.size());
+
+    std::string out(src.size(), '\0');
+    REQUIRE(note::decompress_block(
+        {packed.data(), written}, out.data(), out.size()));
+    return out;
+}
+} // namespace
+
+TEST_CASE("ContentCodec")
+{
+    SUBCASE("block round trip")
+    {
+        CHECK_EQ(roundTrip(""), "");
+        CHECK_EQ(roundTrip("abc"), "abc");
+        CHECK_EQ(roundTrip(std::string(13, 'a')), std::string(13, 'a'));
+        CHECK_EQ(roundTrip(std::string(100000, 'z')), std::string(100000, 'z'));
+
+        auto text = transcript(300 * 1024);
+        CHECK_EQ(roundTrip(text), text);
+    }
+
+    SUBCASE("incompressible input")
+    {
+        std::mt19937 rng(42);
+        std::string noise(70000, '\0');
+        for (auto &c : noise)
+            c = static_cast<char>(rng());
+
+        CHECK_EQ(roundTrip(noise), noise);
+        CHECK_FALSE(note::pack_content(noise));
+        CHECK_FALSE(note::pack_content("short"));
+    }
+
+    SUBCASE("pack and unpack")
+    {
+        auto text = transcript(64 * 1024);
+        auto packed = note::pack_content(text);
+        REQUIRE(packed);
+        CHECK_LT(packed->size(), text.size() / 2);
+        CHECK_EQ(note::packed_content_size(*packed), text.size());
+        CHECK_EQ(note::unpack_content(*packed), text);
+
+        // 앞부분만 풀 수 있다.
+        CHECK_EQ(note::unpack_content(*packed, 10), text.substr(0, 10));
+        CHECK_EQ(note::unpack_content(*packed, 40000), text.substr(0, 40000));
+    }
+
+    SUBCASE("corrupt input")
+    {
+        auto packed = *note::pack_content(transcript(8192));
+        CHECK_THROWS_AS(note::unpack_content(packed.substr(0, 2)),
+                        std::runtime_error);
+        CHECK_THROWS_AS(note::unpack_content(packed.substr(0, 100)),
+                        std::runtime_error);
+
+        std::string out(16, '\0');
+        // 첫 시퀀스가 아직 쓰지 않은 위치를 가리킨다.
+        const char bad[] = {0x10, 'a', 0x05, 0x00, 0x00};
+        CHECK_FALSE(note::decompress_block(
+            {bad, sizeof(bad)}, out.data(), out.size()));
+    }
+}
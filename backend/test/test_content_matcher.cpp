@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "index/content_matcher.hpp"
+#include "index/parallel_scan.hpp"
+
+using banchoo::index::ContentMatcher;
+using banchoo::index::findLiteral;
+using banchoo::index::parallelScan;
+
+TEST_CASE("findLiteral")
+{
+    SUBCASE("edges")
+    {
+        CHECK_EQ(findLiteral("abc", ""), 0);
+        CHECK_EQ(findLiteral("", "a"), std::string_view::npos);
+        CHECK_EQ(findLiteral("ab", "abc"), std::string_view::npos);
+        CHECK_EQ(findLiteral("xxa", "a"), 2);
+        CHECK_EQ(findLiteral("abc", "abc"), 0);
+    }
+
+    SUBCASE("matches std::string_view::find")
+    {
+        // 16바이트 묶음 경계와 꼬리에 걸치는 경우가 고루 나오도록 길이를
+        // 바꿔 가며 작은 알파벳으로 채운다.
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> letter('a', 'c');
+        for (std::size_t size = 0; size < 80; ++size)
+        {
+            std::string haystack;
+            for (std::size_t i = 0; i < size; ++i)
+                haystack.push_back(static_cast<char>(letter(rng)));
+            for (std::size_t m = 1; m <= 5; ++m)
+            {
+                std::string needle;
+                for (std::size_t i = 0; i < m; ++i)
+                    needle.push_back(static_cast<char>(letter(rng)));
+                CHECK_EQ(findLiteral(haystack, needle),
+                         std::string_view(haystack).find(needle));
+            }
+        }
+    }
+
+    SUBCASE("utf-8")
+    {
+        std::string text(100, ' ');
+        text += "회의록";
+        CHECK_EQ(findLiteral(text, "회의"), 100);
+        CHECK_EQ(findLiteral(text, "의록"), 103);
+    }
+}
+
+TEST_CASE("ContentMatcher")
+{
+    std::string error;
+
+    SUBCASE("invalid patterns")
+    {
+        CHECK_FALSE(ContentMatcher::parse("", false, error));
+        CHECK_FALSE(
+            ContentMatcher::parse(std::string(2000, 'a'), false, error));
+        CHECK_FALSE(ContentMatcher::parse("(unclosed", true, error));
+        CHECK_FALSE(error.empty());
+    }
+
+    SUBCASE("literal")
+    {
+        // regex 를 꺼 두면 특수 문자도 그대로 찾는다.
+        auto matcher = ContentMatcher::parse("a.b", false, error);
+        REQUIRE(matcher);
+        CHECK_FALSE(matcher->isRegex());
+        CHECK(matcher->matches("xa.by"));
+        CHECK_FALSE(matcher->matches("axb"));
+
+        auto plain = ContentMatcher::parse("needle", true, error);
+        REQUIRE(plain);
+        CHECK_FALSE(plain->isRegex());
+    }
+
+    SUBCASE("regex per line")
+    {
+        auto matcher = ContentMatcher::parse("^todo: \\d+$", true, error);
+        REQUIRE(matcher);
+        CHECK(matcher->isRegex());
+        CHECK(matcher->matches("first\ntodo: 12\nlast"));
+        CHECK_FALSE(matcher->matches("todo: 12 later"));
+        CHECK_FALSE(matcher->matches("first todo: 12"));
+    }
+
+    SUBCASE("required literal")
+    {
+        auto literal = [&](const char *pattern)
+        {
+            auto matcher = ContentMatcher::parse(pattern, true, error);
+            REQUIRE(matcher);
+            return matcher->literal();
+        };
+        CHECK_EQ(literal("error \\d+ in module"), " in module");
+        CHECK_EQ(literal("colou?r"), "colo");
+        CHECK_EQ(literal("ab{2,3}cdef"), "cdef");
+        CHECK_EQ(literal("(abc)+xy"), "xy");
+        CHECK_EQ(literal("[abcdef]x"), "x");
+        CHECK_EQ(literal("cat|dog"), "");
+        // 괄호 안의 | 는 괄호 밖 글자에 상관없다.
+        CHECK_EQ(literal("(a|b)*c"), "c");
+        CHECK_EQ(literal("log(in|out) failed"), " failed");
+        CHECK_EQ(literal("회의록?"), "회의");
+
+        auto matcher = ContentMatcher::parse("colou?r", true, error);
+        REQUIRE(matcher);
+        CHECK(matcher->matches("color"));
+        CHECK(matcher->matches("colour"));
+    }
+}
+
+TEST_CASE("ContentMatcher long lines")
+{
+    // 200 KB 짜리 한 줄. std::regex 는 여기서 스택이 넘쳤다.
+    std::string error;
+    auto matcher = ContentMatcher::parse("(a|b)*c", true, error);
+    REQUIRE(matcher);
+
+    std::string line(200 * 1024, 'a');
+    CHECK_FALSE(matcher->matches(line));
+    line.push_back('c');
+    CHECK(matcher->matches(line));
+    CHECK(matcher->matches("first\n" + line + "\nlast"));
+
+    auto anchored = ContentMatcher::parse("^a+b$", true, error);
+    REQUIRE(anchored);
+    CHECK_FALSE(anchored->matches(line));
+}
+
+TEST_CASE("parallelScan")
+{
+    // 4 MiB 라고 알려 여러 스레드로 나눠 훑게 한다.
+    constexpr std::size_t COUNT = 100000;
+    constexpr std::size_t BYTES = 4 * 1024 * 1024;
+    auto every7 = [](std::size_t i) { return i % 7 == 0; };
+
+    SUBCASE("all matches in order")
+    {
+        auto hits = parallelScan(COUNT, COUNT, BYTES, every7, 4);
+        REQUIRE_EQ(hits.size(), (COUNT + 6) / 7);
+        for (std::size_t i = 0; i < hits.size(); ++i)
+            CHECK_EQ(hits[i], i * 7);
+    }
+
+    SUBCASE("limit keeps the first matches")
+    {
+        for (std::size_t threads : {1, 3, 8})
+        {
+            auto hits = parallelScan(COUNT, 10, BYTES, every7, threads);
+            REQUIRE_EQ(hits.size(), 10);
+            for (std::size_t i = 0; i < hits.size(); ++i)
+                CHECK_EQ(hits[i], i * 7);
+        }
+    }
+
+    SUBCASE("stops early")
+    {
+        std::atomic<std::size_t> visited{0};
+        auto hits = parallelScan(
+            COUNT,
+            1,
+            BYTES,
+            [&](std::size_t i)
+            {
+                visited.fetch_add(1, std::memory_order_relaxed);
+                return i == 0;
+            },
+            4);
+        CHECK_EQ(hits, std::vector<std::size_t>{0});
+        CHECK_LT(visited.load(), COUNT);
+    }
+
+    SUBCASE("rethrows")
+    {
+        CHECK_THROWS(parallelScan(
+            COUNT,
+            COUNT,
+            BYTES,
+            [](std::size_t i) -> bool
+            {
+                if (i == COUNT / 2)
+                    throw std::runtime_error("boom");
+                return false;
+            },
+            4));
+    }
+
+    SUBCASE("empty")
+    {
+        CHECK(parallelScan(0, 10, 0, every7).empty());
+        CHECK(parallelScan(COUNT, 0, BYTES, every7).empty());
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "replication/change_log.hpp"
+#include "replication/follower.hpp"
+#include "repository/base_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/replicated_repository.hpp"
+#include "repository/repository_factory.hpp"
+
+using banchoo::replication::ChangeLogWriter;
+using banchoo::replication::Follower;
+using banchoo::repository::BaseRepository;
+using banchoo::repository::InMemoryRepository;
+using banchoo::repository::ReplicatedRepository;
+using banchoo::repository::RepositoryFactory;
+
+namespace
+{
+// id 순으로 "id:content" 를 늘어놓는다.
+std::vector<std::string> dump(const BaseRepository &repo)
+{
+    std::vector<std::string> out;
+    for (const auto &n : repo.scanNotes(0, 1000))
+        out.push_back(std::to_string(n->id) + ":" + n->content);
+    return out;
+}
+
+std::shared_ptr<ReplicatedRepository>
+leaderOf(std::shared_ptr<BaseRepository> storage, const std::string &path)
+{
+    auto log = std::make_shared<ChangeLogWriter>();
+    REQUIRE(log->open(path));
+    return std::make_shared<ReplicatedRepository>(std::move(storage), log);
+}
+} // namespace
+
+TEST_CASE("Follower")
+{
+    const std::string path = "test_follower.log";
+    std::filesystem::remove(path);
+
+    // 리더가 로그를 열기 전부터 있던 노트
+    std::vector<banchoo::note::Note> existing{
+        {.id = 101, .type = banchoo::note::NoteType::MEMO, .content = "before"},
+        {.id = 102,
+         .type = banchoo::note::NoteType::TASK,
+         .content = "task",
+         .tags = {"work"}}};
+    auto storage = std::make_shared<InMemoryRepository>(nlohmann::json{});
+    storage->createNotes(existing);
+
+    auto replica =
+        RepositoryFactory::create(nlohmann::json{{"type", "inmemory"}});
+    Follower follower(replica, path);
+
+    SUBCASE("waits until the leader publishes a log")
+    {
+        CHECK_EQ(follower.poll(), 0);
+        CHECK_FALSE(follower.status().synced);
+    }
+
+    SUBCASE("applies the snapshot and later writes")
+    {
+        auto leader = leaderOf(storage, path);
+        CHECK_EQ(follower.poll(), 3);
+        CHECK(follower.status().synced);
+        CHECK_EQ(dump(*replica), dump(*leader));
+
+        auto memo = leader->createMemo({.content = "new", .tags = {"home"}});
+        leader->patchNote(
+            101, {.content = "patched"}, banchoo::note::field::CONTENT);
+        leader->deleteNote(102);
+        std::vector<banchoo::note::Note> imported{{.content = "imported"}};
+        leader->importNotes(imported);
+
+        CHECK_EQ(follower.poll(), 4);
+        CHECK_EQ(dump(*replica), dump(*leader));
+        CHECK_EQ(follower.status().seq, 7);
+        CHECK_EQ(follower.status().pending_bytes, 0);
+
+        // 팔로워의 태그 색인도 같이 맞춰진다.
+        std::string error;
+        auto query = banchoo::index::TagQuery::parse("home", error);
+        REQUIRE(query);
+        auto found = replica->findNotes(*query, std::nullopt);
+        REQUIRE_EQ(found.size(), 1);
+        CHECK_EQ(found[0]->id, memo->id);
+        CHECK_EQ(replica->getNote(memo->id)->updated_at, memo->updated_at);
+    }
+
+    SUBCASE("resyncs when the leader rewrites the log")
+    {
+        {
+            auto leader = leaderOf(storage, path);
+            follower.poll();
+            leader->createMemo({.content = "lost"});
+            follower.poll();
+        }
+        CHECK_EQ(dump(*replica).size(), 3);
+        // createNotes 가 옮겨 간 첫 노트를 다시 채운다.
+        existing[0].content = "before";
+
+        // 다시 시작한 리더는 첫 노트만 가진 채 새 로그를 쓴다.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        auto restarted = std::make_shared<InMemoryRepository>(nlohmann::json{});
+        restarted->createNotes(std::span(existing).first(1));
+        auto leader = leaderOf(restarted, path);
+
+        follower.poll();
+        CHECK(follower.status().synced);
+        CHECK_EQ(dump(*replica), dump(*leader));
+    }
+
+    SUBCASE("follows from its own thread")
+    {
+        Follower background(replica, path, std::chrono::milliseconds(5));
+        auto leader = leaderOf(storage, path);
+        background.start();
+        leader->createMemo({.content = "async"});
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (dump(*replica) != dump(*leader) &&
+               std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        background.stop();
+        CHECK_EQ(dump(*replica), dump(*leader));
+        CHECK_EQ(background.status().applied, 4);
+    }
+
+    std::filesystem::remove(path);
+}
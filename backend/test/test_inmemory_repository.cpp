@@ -6,9 +6,17 @@
 
 #include <doctest/doctest.h>
 
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 
 #include "common/logger.hpp"
+#include "index/content_matcher.hpp"
+#include "index/tag_query.hpp"
 #include "repository/inmemory_repository.hpp"
 
 TEST_CASE("InMemoryRepository")
@@ -20,17 +28,19 @@ TEST_CASE("InMemoryRepository")
     SUBCASE("createNote")
     {
         banchoo::note::Note n{.content = "Hello, World!"};
-        auto id = repo.createMemo(n);
-        CHECK_EQ(id, 1);
+        auto created = repo.createMemo(std::move(n));
+        REQUIRE(created);
+        CHECK_EQ(created->id, 1);
+        CHECK_EQ(created->content, "Hello, World!");
     }
 
     SUBCASE("getNote")
     {
         banchoo::note::Note n{.content = "Hello, World!"};
-        auto id = repo.createMemo(n);
+        auto id = repo.createMemo(std::move(n))->id;
 
         auto result = repo.getNote(id);
-        REQUIRE(result); // optional이 값 있는지 확인
+        REQUIRE(result); // 없으면 nullptr
         CHECK_EQ(result->content, "Hello, World!");
     }
 
@@ -38,42 +48,207 @@ TEST_CASE("InMemoryRepository")
     {
         banchoo::note::Note n1{.content = "Hello, World!"};
         banchoo::note::Note n2{.content = "Hello, C++!"};
-        repo.createMemo(n1);
-        repo.createMemo(n2);
+        repo.createMemo(std::move(n1));
+        repo.createMemo(std::move(n2));
 
         auto all = repo.getAllNotes();
         REQUIRE(all.size() == 2);
 
         std::sort(all.begin(),
                   all.end(),
-                  [](auto &a, auto &b) { return a.id < b.id; });
-        CHECK_EQ(all[0].content, "Hello, World!");
-        CHECK_EQ(all[1].content, "Hello, C++!");
+                  [](auto &a, auto &b) { return a->id < b->id; });
+        CHECK_EQ(all[0]->content, "Hello, World!");
+        CHECK_EQ(all[1]->content, "Hello, C++!");
+    }
+
+    SUBCASE("getAllTasks")
+    {
+        repo.createMemo({.content = "memo"});
+        repo.createTask({.content = "task"});
+        repo.createEvent({.content = "event"});
+
+        auto tasks = repo.getAllTasks();
+        REQUIRE(tasks.size() == 1);
+        CHECK_EQ(tasks[0]->content, "task");
+        CHECK_EQ(repo.getAllEvents().size(), 1);
+        CHECK_EQ(repo.getAllMemos().size(), 1);
     }
 
     SUBCASE("updateNote")
     {
         banchoo::note::Note n{.content = "Hello, World!"};
-        auto id = repo.createMemo(n);
+        auto id = repo.createMemo(std::move(n))->id;
 
         auto original = repo.getNote(id);
         REQUIRE(original);
-        original->content = "Hello, C++!";
-        CHECK(repo.updateNote(*original));
+        banchoo::note::Note changed = *original;
+        changed.content = "Hello, C++!";
+        CHECK(repo.updateNote(std::move(changed)));
 
         auto updated = repo.getNote(id);
         REQUIRE(updated);
         CHECK_EQ(updated->content, "Hello, C++!");
+        // 이미 받아 간 노트는 바뀌지 않는다.
+        CHECK_EQ(original->content, "Hello, World!");
+    }
+
+    SUBCASE("patchNote")
+    {
+        auto created = repo.createTask({.content = "task"});
+
+        banchoo::note::Note values;
+        values.status = banchoo::note::NoteStatus::DONE;
+        CHECK(repo.patchNote(
+            created->id, std::move(values), banchoo::note::field::STATUS));
+
+        auto patched = repo.getNote(created->id);
+        REQUIRE(patched);
+        CHECK_EQ(patched->status, banchoo::note::NoteStatus::DONE);
+        CHECK_EQ(patched->content, "task");
+        CHECK_EQ(patched->type, banchoo::note::NoteType::TASK);
+        CHECK_EQ(patched->created_at, created->created_at);
+        CHECK_GE(patched->updated_at, created->updated_at);
+        CHECK_EQ(created->status, banchoo::note::NoteStatus::TODO);
+
+        CHECK_FALSE(repo.patchNote(
+            999, banchoo::note::Note{}, banchoo::note::field::STATUS));
     }
 
     SUBCASE("deleteNote")
     {
         banchoo::note::Note n{.content = "Hello, World!"};
-        auto id = repo.createMemo(n);
+        auto id = repo.createMemo(std::move(n))->id;
 
         CHECK(repo.deleteNote(id));
 
         auto result = repo.getNote(id);
         CHECK_FALSE(result); // 값이 없어야 함
     }
+
+    SUBCASE("scanNotes")
+    {
+        for (int i = 0; i < 5; ++i)
+            repo.createMemo({.content = std::to_string(i)});
+        repo.deleteNote(3);
+
+        auto first = repo.scanNotes(0, 2);
+        REQUIRE(first.size() == 2);
+        CHECK_EQ(first[0]->id, 1);
+        CHECK_EQ(first[1]->id, 2);
+
+        auto rest = repo.scanNotes(first.back()->id, 10);
+        REQUIRE(rest.size() == 2);
+        CHECK_EQ(rest[0]->id, 4);
+        CHECK_EQ(rest[1]->id, 5);
+        CHECK(repo.scanNotes(5, 10).empty());
+    }
+}
+
+TEST_CASE("InMemoryRepository compression")
+{
+    namespace note = banchoo::note;
+    banchoo::repository::InMemoryRepository repo(
+        nlohmann::json{{"compress_threshold", 1024}});
+
+    std::string text;
+    while (text.size() < 8192)
+        text += "회의록 line " + std::to_string(text.size() % 7) + "\n";
+
+    auto created = repo.createMemo({.content = text});
+    CHECK_EQ(created->content, text);
+    auto small = repo.createMemo({.content = "short"})->id;
+
+    CHECK_EQ(repo.getNote(created->id)->content, text);
+    CHECK_EQ(repo.getNote(small)->content, "short");
+    CHECK_EQ(repo.scanNotes(0, 1)[0]->content, text);
+
+    // 본문이 필요 없는 목록은 압축을 풀지 않는다.
+    auto notes = repo.getAllNotes({note::field::ID, 0});
+    REQUIRE(notes.size() == 2);
+    for (const auto &n : notes)
+    {
+        if (n->id == created->id)
+            CHECK(n->content.empty());
+    }
+    notes = repo.getAllNotes({note::field::ID, 5});
+    for (const auto &n : notes)
+    {
+        if (n->id == created->id)
+            CHECK_EQ(n->content, "회의록 l");
+    }
+    auto scanned = repo.scanNotes(0, 1, std::nullopt, {note::field::ID, 0});
+    REQUIRE(scanned.size() == 1);
+    CHECK(scanned[0]->content.empty());
+    scanned = repo.scanNotes(0, 1, std::nullopt, {note::field::ID, 5});
+    CHECK_EQ(scanned[0]->content, "회의록 l");
+
+    note::Note status{.status = note::NoteStatus::DONE};
+    REQUIRE(
+        repo.patchNote(created->id, std::move(status), note::field::STATUS));
+    CHECK_EQ(repo.getNote(created->id)->content, text);
+
+    note::Note shorter{.content = "now short"};
+    REQUIRE(repo.patchNote(
+        created->id, std::move(shorter), note::field::CONTENT));
+    CHECK_EQ(repo.getNote(created->id)->content, "now short");
+}
+
+TEST_CASE("InMemoryRepository grepNotes")
+{
+    banchoo::repository::InMemoryRepository repo(
+        nlohmann::json{{"compress_threshold", 64}});
+
+    // 압축된 본문도 풀어서 찾는다.
+    std::string text(4096, 'x');
+    text += " needle";
+    repo.createMemo({.content = "needle"});
+    repo.createMemo({.content = "hay"});
+    repo.createMemo({.content = text});
+    repo.createMemo({.content = "needle again"});
+    repo.deleteNote(4);
+    repo.createMemo({.content = "second line\nneedle 42"});
+
+    std::string error;
+    using banchoo::index::ContentMatcher;
+    auto literal = ContentMatcher::parse("needle", false, error);
+    REQUIRE(literal);
+    CHECK_EQ(repo.grepNotes(*literal, 10),
+             std::vector<banchoo::note::Id>{1, 3, 5});
+    CHECK_EQ(repo.grepNotes(*literal, 2),
+             std::vector<banchoo::note::Id>{1, 3});
+
+    auto regex = ContentMatcher::parse("^needle \\d+$", true, error);
+    REQUIRE(regex);
+    CHECK_EQ(repo.grepNotes(*regex, 10), std::vector<banchoo::note::Id>{5});
+}
+
+TEST_CASE("InMemoryRepository tags")
+{
+    namespace note = banchoo::note;
+    banchoo::repository::InMemoryRepository repo(
+        nlohmann::json{{"compress_threshold", 64}});
+
+    std::string text(4096, 'x');
+    auto memo = repo.createMemo({.content = text, .tags = {"a", "b"}});
+    auto task = repo.createTask({.content = "task", .tags = {"b"}});
+    CHECK_EQ(repo.getNote(memo->id)->tags, std::vector<std::string>{"a", "b"});
+
+    // 압축된 노트도 태그만 고르면 본문을 풀지 않는다.
+    const note::Id ids[] = {memo->id, 999, task->id};
+    auto got = repo.getNotes(ids, {note::field::ID | note::field::TAGS, 0});
+    REQUIRE_EQ(got.size(), 2);
+    CHECK(got[0]->content.empty());
+    CHECK_EQ(got[0]->tags, std::vector<std::string>{"a", "b"});
+    CHECK_EQ(repo.getNotes(ids)[0]->content, text);
+
+    note::Note retag{.tags = {}};
+    REQUIRE(repo.patchNote(memo->id, std::move(retag), note::field::TAGS));
+    CHECK(repo.getNote(memo->id)->tags.empty());
+    CHECK_EQ(repo.getNote(memo->id)->content, text);
+
+    std::string error;
+    auto query = banchoo::index::TagQuery::parse("NOT a", error);
+    REQUIRE(query);
+    CHECK_EQ(repo.findNotes(*query, note::NoteType::TASK).size(), 1);
+    CHECK_EQ(repo.findNotes(*query, std::nullopt).size(), 2);
 }
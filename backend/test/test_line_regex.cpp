@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+
+#include "index/line_regex.hpp"
+
+using banchoo::index::LineRegex;
+
+namespace
+{
+// pattern 이 line 어딘가에 맞는지. 잘못된 식이면 테스트를 멈춘다.
+bool search(std::string_view pattern, std::string_view line)
+{
+    std::string error;
+    auto regex = LineRegex::compile(pattern, error);
+    REQUIRE_MESSAGE(regex, error);
+    return regex->search(line);
+}
+
+std::string compileError(std::string_view pattern)
+{
+    std::string error;
+    CHECK_FALSE(LineRegex::compile(pattern, error));
+    return error;
+}
+} // namespace
+
+TEST_CASE("LineRegex")
+{
+    SUBCASE("literals, classes and repetition")
+    {
+        CHECK(search("abc", "xxabcxx"));
+        CHECK_FALSE(search("abc", "ab c"));
+        CHECK(search("a.c", "abc"));
+        CHECK(search("colou?r", "color"));
+        CHECK(search("colou?r", "colour"));
+        CHECK(search("ab+c", "abbbc"));
+        CHECK_FALSE(search("ab+c", "ac"));
+        CHECK(search("x(ab)*y", "xababy"));
+        CHECK(search("^a{2,3}$", "aaa"));
+        CHECK_FALSE(search("^a{2,3}$", "aaaa"));
+        CHECK(search("^a{2,}$", "aaaaaa"));
+        CHECK(search("cat|dog", "hotdog"));
+        CHECK(search("[a-c]x", "bx"));
+        CHECK_FALSE(search("[^a-c]x", "bx"));
+        CHECK(search("[-a]", "-"));
+        CHECK(search("\\d+\\.\\d+", "v1.25"));
+        CHECK(search("[\\d_]", "_"));
+        CHECK_FALSE(search("\\S", " \t"));
+        CHECK(search("\\x41\\u0042", "AB"));
+        CHECK(search("a(?:b|c)d", "acd"));
+        CHECK(search("a*?b", "aab"));
+        CHECK_FALSE(search("[]", "a"));
+        CHECK(search("[^]", "a"));
+    }
+
+    SUBCASE("anchors and word boundaries")
+    {
+        CHECK(search("^todo$", "todo"));
+        CHECK_FALSE(search("^todo$", "a todo"));
+        CHECK_FALSE(search("^todo", " todo"));
+        CHECK(search("\\bcat\\b", "a cat."));
+        CHECK_FALSE(search("\\bcat\\b", "concat"));
+        CHECK(search("\\Bcat", "concat"));
+        CHECK(search("^$", ""));
+        CHECK_FALSE(search("^$", "x"));
+    }
+
+    SUBCASE("utf-8 code points")
+    {
+        CHECK(search("^회.록$", "회의록"));
+        CHECK(search("^[가-힣]+$", "반추"));
+        CHECK_FALSE(search("^[가-힣]+$", "반추!"));
+        CHECK(search("^할?일$", "일"));
+        CHECK(search("ab*c", "\xFF" "abbc"));
+    }
+
+    SUBCASE("empty loops terminate")
+    {
+        CHECK(search("(a*)*b", "aab"));
+        CHECK_FALSE(search("(a*)*b", "aaa"));
+        CHECK(search("(|a)+$", "aaa"));
+    }
+
+    SUBCASE("rejected patterns")
+    {
+        CHECK_EQ(compileError("(unclosed"), "missing ')'");
+        CHECK_EQ(compileError("a)"), "unmatched ')'");
+        CHECK_EQ(compileError("[ab"), "missing ']'");
+        CHECK_EQ(compileError("*a"), "nothing to repeat");
+        CHECK_EQ(compileError("a**"), "nothing to repeat");
+        CHECK_EQ(compileError("^*"), "nothing to repeat");
+        CHECK_EQ(compileError("a{2,1}"), "invalid repetition");
+        CHECK_EQ(compileError("a{x}"), "invalid repetition");
+        CHECK_EQ(compileError("a{2000}"), "repetition count is too large");
+        CHECK_EQ(compileError("[z-a]"), "invalid character class range");
+        CHECK_EQ(compileError("(a)\\1"), "backreferences are not supported");
+        CHECK_EQ(compileError("a(?=b)"), "lookaround is not supported");
+        CHECK_EQ(compileError("\\q"), "invalid escape");
+        CHECK_EQ(compileError("a\\"), "trailing '\\'");
+        CHECK_EQ(compileError("(a{1000}){1000}"), "pattern is too complex");
+        CHECK_EQ(compileError(std::string(40, '(') + std::string(40, ')')),
+                 "groups are nested too deeply");
+    }
+
+    SUBCASE("long lines run in linear time")
+    {
+        // 되짚는 엔진은 이런 줄에서 스택이 넘치거나 몇 초씩 걸린다.
+        std::string line(200 * 1024, 'a');
+        CHECK_FALSE(search("(a|b)*c", line));
+        CHECK_FALSE(search("(a+)+b", line));
+        CHECK_FALSE(search("(.*a){8}x", line));
+        line.push_back('c');
+        CHECK(search("(a|b)*c", line));
+        CHECK(search("^(a|b)*c$", line));
+    }
+
+    SUBCASE("agrees with std::regex on short lines")
+    {
+        // 작은 문법으로 식과 줄을 무작위로 만들어 std::regex 와 견준다.
+        // 둘 중 하나라도 받지 않는 식은 건너뛴다.
+        constexpr std::string_view PIECES[] = {
+            "a", "b", ".", "*", "+", "?", "|", "(", ")", "[ab]", "[^a]",
+            "^", "$", "\\b", "{1,2}", "(?:", "\\w"};
+        std::mt19937 rng(11);
+        std::uniform_int_distribution<std::size_t> piece(
+            0, std::size(PIECES) - 1);
+        std::uniform_int_distribution<int> length(1, 8);
+        std::uniform_int_distribution<int> letter(0, 2);
+
+        int compared = 0;
+        for (int round = 0; round < 3000; ++round)
+        {
+            std::string pattern;
+            for (int i = length(rng); i > 0; --i)
+                pattern += PIECES[piece(rng)];
+
+            std::string error;
+            auto ours = LineRegex::compile(pattern, error);
+            std::regex reference;
+            try
+            {
+                reference = std::regex(pattern, std::regex::ECMAScript);
+            }
+            catch (const std::regex_error &)
+            {
+                continue;
+            }
+            if (!ours)
+                continue;
+
+            for (int k = 0; k < 8; ++k)
+            {
+                std::string line;
+                for (int i = length(rng) - 1; i > 0; --i)
+                    line.push_back("ab "[letter(rng)]);
+                CHECK_MESSAGE(ours->search(line) ==
+                                  std::regex_search(line, reference),
+                              pattern << " on '" << line << "'");
+                ++compared;
+            }
+        }
+        CHECK_GT(compared, 1000);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "common/logger.hpp"
+
+namespace
+{
+int evaluated = 0;
+
+std::string expensive()
+{
+    ++evaluated;
+    return "expensive";
+}
+} // namespace
+
+TEST_CASE("Logger")
+{
+    SUBCASE("disabled level does not evaluate arguments")
+    {
+        auto &logger = banchoo::Logger::get();
+        auto previous = logger->level();
+        logger->set_level(spdlog::level::warn);
+
+        evaluated = 0;
+        BANCHOO_TRACE("{}", expensive());
+        BANCHOO_DEBUG("{}", expensive());
+        CHECK_EQ(evaluated, 0);
+
+        BANCHOO_WARN("{}", expensive());
+        CHECK_EQ(evaluated, 1);
+
+        logger->set_level(previous);
+    }
+
+    SUBCASE("options from config")
+    {
+        auto options = banchoo::LogOptions::fromConfig(
+            nlohmann::json{{"log_level", "warn"},
+                           {"log_async",
+                            {{"enabled", true},
+                             {"queue_size", 1024},
+                             {"overflow", "drop_new"},
+                             {"flush_interval_ms", 250}}}});
+        CHECK_EQ(options.level, "warn");
+        CHECK_FALSE(options.file.has_value());
+        CHECK(options.async);
+        CHECK_EQ(options.queue_size, 1024);
+        CHECK_EQ(options.overflow, spdlog::async_overflow_policy::discard_new);
+        CHECK_EQ(options.flush_interval.count(), 250);
+    }
+
+    SUBCASE("defaults to synchronous logging")
+    {
+        auto options = banchoo::LogOptions::fromConfig(
+            nlohmann::json{{"log_level", "info"}, {"log_file", ""}});
+        CHECK_FALSE(options.async);
+        CHECK_FALSE(options.file.has_value());
+        CHECK_EQ(options.overflow, spdlog::async_overflow_policy::block);
+    }
+
+    SUBCASE("rejects unknown overflow policy")
+    {
+        CHECK_THROWS_AS(banchoo::LogOptions::fromConfig(nlohmann::json{
+                            {"log_async", {{"overflow", "maybe"}}}}),
+                        std::invalid_argument);
+    }
+}
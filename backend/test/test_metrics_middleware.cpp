@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <crow_all.h>
+
+#include <memory>
+#include <string>
+
+#include "app/metrics_middleware.hpp"
+#include "metrics/registry.hpp"
+
+TEST_CASE("MetricsMiddleware labels requests by matched rule")
+{
+    crow::App<banchoo::app::MetricsMiddleware> app;
+    app.loglevel(crow::LogLevel::Warning);
+    CROW_ROUTE(app, "/metrics_test/<int>")([](int) { return "ok"; });
+    CROW_ROUTE(app, "/metrics_test/chunked")
+    (
+        []
+        {
+            crow::response res;
+            auto sent = std::make_shared<int>(0);
+            res.set_body_source(
+                [sent](std::string &chunk)
+                {
+                    chunk.assign(10, 'x');
+                    return ++*sent < 3;
+                });
+            return res;
+        });
+    app.validate();
+
+    auto send = [&app](const std::string &url)
+    {
+        crow::request req;
+        crow::response res;
+        req.url = url;
+        req.raw_url = url;
+
+        banchoo::app::MetricsMiddleware::context ctx;
+        auto &middleware =
+            app.get_middleware<banchoo::app::MetricsMiddleware>();
+        middleware.before_handle(req, res, ctx);
+        app.handle(req, res);
+        middleware.after_handle(req, res, ctx);
+        // 연결이 하듯 chunked 본문을 끝까지 만든다.
+        std::string chunk;
+        while (res.body_source && res.body_source(chunk))
+            chunk.clear();
+        return res.code;
+    };
+
+    CHECK_EQ(send("/metrics_test/12"), 200);
+    CHECK_EQ(send("/metrics_test/\"x\"/probe"), 404);
+    CHECK_EQ(send("/metrics_test/chunked"), 200);
+
+    auto text = banchoo::metrics::Registry::instance().renderPrometheus();
+    CHECK_NE(text.find("banchoo_http_requests_total{method=\"GET\","
+                       "route=\"/metrics_test/<int>\"}"),
+             std::string::npos);
+    CHECK_NE(text.find("banchoo_http_requests_total{method=\"GET\","
+                       "route=\"other\"}"),
+             std::string::npos);
+    CHECK_EQ(text.find("probe"), std::string::npos);
+    // chunked 본문은 보낸 조각을 모두 더한 크기로 남는다.
+    CHECK_NE(text.find("banchoo_http_response_size_bytes_sum{method=\"GET\","
+                       "route=\"/metrics_test/chunked\"} 30"),
+             std::string::npos);
+}
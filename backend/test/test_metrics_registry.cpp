@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics/registry.hpp"
+
+namespace metrics = banchoo::metrics;
+
+TEST_CASE("metrics::Registry")
+{
+    SUBCASE("bucket bounds")
+    {
+        for (std::uint64_t v : {0ULL, 1ULL, 5ULL, 100ULL, 123456ULL})
+        {
+            auto index = metrics::bucketIndex(v);
+            CHECK_LE(v, metrics::bucketUpperBound(index));
+            if (index > 0)
+                CHECK_GT(v, metrics::bucketUpperBound(index - 1));
+        }
+    }
+
+    SUBCASE("shards are merged on render")
+    {
+        auto &registry = metrics::Registry::instance();
+        auto counter =
+            registry.counter("test_events_total", "test", "kind=\"a\"");
+        auto histogram = registry.histogram("test_latency_us", "test");
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        counter.inc();
+                        histogram.observe(10);
+                    }
+                });
+        }
+        for (auto &t : threads)
+            t.join();
+
+        auto text = registry.renderPrometheus();
+        CHECK_NE(text.find("# TYPE test_events_total counter"),
+                 std::string::npos);
+        CHECK_NE(text.find("test_events_total{kind=\"a\"} 4000"),
+                 std::string::npos);
+        CHECK_NE(text.find("test_latency_us_bucket{le=\"+Inf\"} 4000"),
+                 std::string::npos);
+        CHECK_NE(text.find("test_latency_us_sum 40000"), std::string::npos);
+    }
+
+    SUBCASE("label values are escaped")
+    {
+        CHECK_EQ(metrics::label("route", "/notes"), "route=\"/notes\"");
+        CHECK_EQ(metrics::label("tenant", "a\\b\"c\nd"),
+                 "tenant=\"a\\\\b\\\"c\\nd\"");
+    }
+}
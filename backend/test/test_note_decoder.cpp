@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "app/note_decoder.hpp"
+#include "note/note.hpp"
+
+using banchoo::app::NoteDecoder;
+namespace field = banchoo::note::field;
+
+TEST_CASE("NoteDecoder")
+{
+    banchoo::note::Note n{};
+
+    SUBCASE("memo")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":"Hello","extra":{"a":[1,2]}})",
+            NoteDecoder::MEMO_SCHEMA,
+            n);
+        REQUIRE(r.ok());
+        CHECK_EQ(n.content, "Hello");
+        CHECK_EQ(r.present, field::CONTENT);
+    }
+
+    SUBCASE("task")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":"Do it","status":"DOING","due_date":"2024-05-01T09:30:00"})",
+            NoteDecoder::TASK_SCHEMA,
+            n);
+        REQUIRE(r.ok());
+        REQUIRE(n.status);
+        CHECK_EQ(*n.status, banchoo::note::NoteStatus::DOING);
+        CHECK(n.due_date);
+        CHECK_EQ(r.present,
+                 field::CONTENT | field::STATUS | field::DUE_DATE);
+    }
+
+    SUBCASE("malformed json")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":)", NoteDecoder::MEMO_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "malformed_json");
+    }
+
+    SUBCASE("not an object")
+    {
+        auto r = NoteDecoder::decode("[1]", NoteDecoder::MEMO_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_type");
+    }
+
+    SUBCASE("missing field")
+    {
+        auto r = NoteDecoder::decode("{}", NoteDecoder::MEMO_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "missing_field");
+        CHECK_EQ(r.error->field, "content");
+    }
+
+    SUBCASE("invalid type")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":42})", NoteDecoder::MEMO_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_type");
+        CHECK_EQ(r.error->field, "content");
+    }
+
+    SUBCASE("invalid status")
+    {
+        auto r = NoteDecoder::decode(R"({"content":"x","status":"LATER"})",
+                                     NoteDecoder::TASK_SCHEMA,
+                                     n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->field, "status");
+    }
+
+    SUBCASE("invalid date")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":"x","start_date":"2024-13-01T00:00:00"})",
+            NoteDecoder::EVENT_SCHEMA,
+            n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_value");
+        CHECK_EQ(r.error->field, "start_date");
+    }
+
+    SUBCASE("patch")
+    {
+        auto r = NoteDecoder::decode(R"({"status":"DONE","due_date":null})",
+                                     NoteDecoder::PATCH_SCHEMA,
+                                     n);
+        REQUIRE(r.ok());
+        CHECK_EQ(r.present,
+                 banchoo::note::field::STATUS | banchoo::note::field::DUE_DATE);
+        CHECK_EQ(n.status, banchoo::note::NoteStatus::DONE);
+        CHECK_FALSE(n.due_date);
+
+        r = NoteDecoder::decode(
+            R"({"content":null})", NoteDecoder::PATCH_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_type");
+        CHECK_EQ(r.error->field, "content");
+    }
+
+    SUBCASE("tags")
+    {
+        auto r = NoteDecoder::decode(
+            R"({"content":"x","tags":["work","urgent","work"]})",
+            NoteDecoder::TASK_SCHEMA,
+            n);
+        REQUIRE(r.ok());
+        CHECK_EQ(r.present, field::CONTENT | field::TAGS);
+        CHECK_EQ(n.tags, std::vector<std::string>{"urgent", "work"});
+
+        r = NoteDecoder::decode(R"({"tags":[]})", NoteDecoder::PATCH_SCHEMA, n);
+        REQUIRE(r.ok());
+        CHECK_EQ(r.present, field::TAGS);
+        CHECK(n.tags.empty());
+
+        const char *bad[] = {R"({"content":"x","tags":"work"})",
+                             R"({"content":"x","tags":[1]})",
+                             R"({"content":"x","tags":[["a"]]})",
+                             R"({"content":"x","tags":null})"};
+        for (const auto *body : bad)
+        {
+            r = NoteDecoder::decode(body, NoteDecoder::MEMO_SCHEMA, n);
+            REQUIRE_FALSE(r.ok());
+            CHECK_EQ(r.error->error, "invalid_type");
+            CHECK_EQ(r.error->field, "tags");
+        }
+
+        r = NoteDecoder::decode(R"({"content":"x","tags":["NOT"]})",
+                                NoteDecoder::MEMO_SCHEMA,
+                                n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_value");
+
+        std::string many = R"({"content":"x","tags":[)";
+        for (int i = 0; i <= 32; ++i)
+            many += (i ? ",\"t" : "\"t") + std::to_string(i) + "\"";
+        many += "]}";
+        r = NoteDecoder::decode(many, NoteDecoder::MEMO_SCHEMA, n);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->field, "tags");
+
+        // 받지 않는 스키마에서는 무시한다.
+        r = NoteDecoder::decode(R"({"content":"x","tags":["a"]})",
+                                NoteDecoder::UPDATE_SCHEMA,
+                                n);
+        CHECK(r.ok());
+    }
+}
+
+TEST_CASE("NoteDecoder projection")
+{
+    namespace field = banchoo::note::field;
+    banchoo::note::Projection view{field::ID | field::CONTENT, 0};
+
+    SUBCASE("absent parameters keep the default")
+    {
+        REQUIRE(NoteDecoder::decodeProjection(nullptr, nullptr, view).ok());
+        CHECK_EQ(view.fields, field::ID | field::CONTENT);
+        CHECK_EQ(view.preview, 0);
+    }
+
+    SUBCASE("fields and preview")
+    {
+        auto r = NoteDecoder::decodeProjection(
+            "id,type,status,preview", nullptr, view);
+        REQUIRE(r.ok());
+        CHECK_EQ(view.fields, field::ID | field::TYPE | field::STATUS);
+        CHECK_EQ(view.preview, NoteDecoder::DEFAULT_PREVIEW);
+
+        REQUIRE(NoteDecoder::decodeProjection("id,due_date", "12", view).ok());
+        CHECK_EQ(view.fields, field::ID | field::DUE_DATE);
+        CHECK_EQ(view.preview, 12);
+    }
+
+    SUBCASE("invalid values")
+    {
+        auto r = NoteDecoder::decodeProjection("id,title", nullptr, view);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->field, "fields");
+
+        CHECK_FALSE(NoteDecoder::decodeProjection("", nullptr, view).ok());
+        CHECK_FALSE(NoteDecoder::decodeProjection(nullptr, "0", view).ok());
+        CHECK_FALSE(NoteDecoder::decodeProjection(nullptr, "12x", view).ok());
+        r = NoteDecoder::decodeProjection(nullptr, "1001", view);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->field, "preview");
+    }
+
+    SUBCASE("tags")
+    {
+        REQUIRE(NoteDecoder::decodeProjection("id,tags", nullptr, view).ok());
+        CHECK_EQ(view.fields, field::ID | field::TAGS);
+
+        std::optional<banchoo::index::TagQuery> query;
+        REQUIRE(NoteDecoder::decodeTagQuery(nullptr, query).ok());
+        CHECK_FALSE(query);
+        REQUIRE(NoteDecoder::decodeTagQuery("work NOT done", query).ok());
+        CHECK(query);
+
+        auto r = NoteDecoder::decodeTagQuery("work AND", query);
+        REQUIRE_FALSE(r.ok());
+        CHECK_EQ(r.error->error, "invalid_value");
+        CHECK_EQ(r.error->field, "tags");
+    }
+}
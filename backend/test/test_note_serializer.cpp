@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "app/note_serializer.hpp"
+#include "note/note.hpp"
+
+using banchoo::app::NoteSerializer;
+
+TEST_CASE("NoteSerializer")
+{
+    SUBCASE("appendEscaped")
+    {
+        std::string out;
+        NoteSerializer::appendEscaped(out, "a\"b\\c\n\t\x01");
+        CHECK_EQ(out, "a\\\"b\\\\c\\n\\t\\u0001");
+    }
+
+    SUBCASE("writeNote")
+    {
+        banchoo::note::Note n{.id = 7, .content = "Hello, World!"};
+        std::string out;
+        NoteSerializer::writeNote(out, n);
+        CHECK_EQ(out, R"({"id":7,"content":"Hello, World!"})");
+    }
+
+    SUBCASE("writeNotes matches nlohmann::json")
+    {
+        std::vector<banchoo::note::NotePtr> notes = {
+            std::make_shared<const banchoo::note::Note>(banchoo::note::Note{
+                .id = 1, .content = "첫 번째 \"메모\""}),
+            std::make_shared<const banchoo::note::Note>(
+                banchoo::note::Note{.id = 2, .content = "line\nbreak"}),
+        };
+
+        auto parsed = nlohmann::json::parse(NoteSerializer::writeNotes(notes));
+        REQUIRE(parsed.is_array());
+        REQUIRE(parsed.size() == 2);
+        CHECK_EQ(parsed[0]["id"], 1);
+        CHECK_EQ(parsed[0]["content"], "첫 번째 \"메모\"");
+        CHECK_EQ(parsed[1]["content"], "line\nbreak");
+    }
+
+    SUBCASE("writeNotes empty")
+    {
+        CHECK_EQ(NoteSerializer::writeNotes({}), "[]");
+    }
+}
+
+TEST_CASE("NoteSerializer projection")
+{
+    namespace note = banchoo::note;
+
+    auto due = note::TimePoint(std::chrono::seconds(1743854400));
+    note::Note n{.id = 3,
+                 .type = note::NoteType::TASK,
+                 .content = "가나다라마",
+                 .status = note::NoteStatus::DOING,
+                 .due_date = due};
+
+    SUBCASE("utf8_prefix")
+    {
+        CHECK_EQ(note::utf8_prefix("가나다", 2), "가나");
+        CHECK_EQ(note::utf8_prefix("ab", 5), "ab");
+        CHECK_EQ(note::utf8_prefix("ab", 0), "");
+    }
+
+    SUBCASE("selected fields")
+    {
+        std::string out;
+        NoteSerializer::writeNote(
+            out,
+            n,
+            {note::field::ID | note::field::TYPE | note::field::STATUS |
+                 note::field::DUE_DATE | note::field::START_DATE,
+             2});
+        CHECK_EQ(out,
+                 R"({"id":3,"type":"TASK","preview":"가나","status":"DOING",)"
+                 R"("due_date":"2025-04-05T12:00:00Z","start_date":null})");
+    }
+
+    SUBCASE("writeNotes with view")
+    {
+        std::vector<note::NotePtr> notes = {
+            std::make_shared<const note::Note>(n)};
+        auto parsed = nlohmann::json::parse(
+            NoteSerializer::writeNotes(notes, {note::field::STATUS, 0}));
+        REQUIRE(parsed.size() == 1);
+        CHECK_EQ(parsed[0], nlohmann::json{{"status", "DOING"}});
+    }
+
+    SUBCASE("tags")
+    {
+        n.tags = {"urgent", "업무"};
+        std::string out;
+        NoteSerializer::writeNote(
+            out, n, {note::field::ID | note::field::TAGS, 0});
+        CHECK_EQ(out, R"({"id":3,"tags":["urgent","업무"]})");
+
+        n.tags.clear();
+        out.clear();
+        NoteSerializer::writeNote(out, n, {note::field::TAGS, 0});
+        CHECK_EQ(out, R"({"tags":[]})");
+    }
+}
+
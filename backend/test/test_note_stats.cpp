@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/stats_repository.hpp"
+#include "stats/note_stats.hpp"
+
+namespace note = banchoo::note;
+using banchoo::stats::NoteStats;
+using banchoo::stats::StatsAggregator;
+
+namespace
+{
+using namespace std::chrono_literals;
+
+// 2025-04-05T12:00:00Z
+const note::TimePoint NOON{std::chrono::seconds(1743854400)};
+
+note::Note task(note::Id id,
+                note::NoteStatus status,
+                std::optional<note::TimePoint> due)
+{
+    return {.id = id,
+            .type = note::NoteType::TASK,
+            .created_at = NOON,
+            .status = status,
+            .due_date = due};
+}
+
+// 기본 구현(목록 전체를 세기)과 미리 집계한 값이 같아야 한다.
+void checkSame(const NoteStats &a, const NoteStats &b)
+{
+    CHECK_EQ(a.total, b.total);
+    CHECK_EQ(a.by_type, b.by_type);
+    CHECK_EQ(a.tasks_by_status, b.tasks_by_status);
+    CHECK_EQ(a.overdue_tasks, b.overdue_tasks);
+    CHECK_EQ(a.per_day, b.per_day);
+}
+} // namespace
+
+TEST_CASE("StatsAggregator")
+{
+    StatsAggregator aggregator;
+    aggregator.add({.id = 1, .type = note::NoteType::MEMO, .created_at = NOON});
+    aggregator.add(task(2, note::NoteStatus::TODO, NOON + 1h));
+    aggregator.add(task(3, note::NoteStatus::DONE, NOON - 1h));
+    aggregator.add(task(4, note::NoteStatus::DOING, NOON - 2h));
+    aggregator.add(task(5, note::NoteStatus::TODO, std::nullopt));
+    aggregator.add(
+        {.id = 6, .type = note::NoteType::EVENT, .created_at = NOON + 24h});
+
+    SUBCASE("counts")
+    {
+        auto stats = aggregator.snapshot(NOON);
+        CHECK_EQ(stats.total, 6);
+        CHECK_EQ(stats.by_type[static_cast<int>(note::NoteType::TASK)], 4);
+        CHECK_EQ(stats.by_type[static_cast<int>(note::NoteType::MEMO)], 1);
+        CHECK_EQ(stats.tasks_by_status[0], 2); // TODO
+        CHECK_EQ(stats.tasks_by_status[1], 1); // DOING
+        CHECK_EQ(stats.tasks_by_status[2], 1); // DONE
+        REQUIRE_EQ(stats.per_day.size(), 2);
+        CHECK_EQ(stats.per_day[0].second, 5);
+        CHECK_EQ(stats.per_day[1].second, 1);
+    }
+
+    SUBCASE("overdue follows the clock")
+    {
+        // DONE 이거나 마감이 없는 할 일은 세지 않는다.
+        CHECK_EQ(aggregator.snapshot(NOON).overdue_tasks, 1);
+        CHECK_EQ(aggregator.snapshot(NOON + 2h).overdue_tasks, 2);
+        CHECK_EQ(aggregator.snapshot(NOON - 3h).overdue_tasks, 0);
+        CHECK_EQ(aggregator.snapshot(NOON + 2h).overdue_tasks, 2);
+
+        // 지난 마감의 할 일이 끝나면 빠지고, 새로 들어오면 바로 센다.
+        aggregator.remove(task(4, note::NoteStatus::DOING, NOON - 2h));
+        aggregator.add(task(4, note::NoteStatus::DONE, NOON - 2h));
+        aggregator.add(task(7, note::NoteStatus::TODO, NOON - 5h));
+        CHECK_EQ(aggregator.snapshot(NOON + 2h).overdue_tasks, 2);
+    }
+
+    SUBCASE("remove drops empty days")
+    {
+        aggregator.remove(
+            {.id = 6, .type = note::NoteType::EVENT, .created_at = NOON + 24h});
+        auto stats = aggregator.snapshot(NOON);
+        CHECK_EQ(stats.total, 5);
+        CHECK_EQ(stats.per_day.size(), 1);
+    }
+
+    SUBCASE("toJson")
+    {
+        auto json = nlohmann::json::parse(aggregator.snapshot(NOON).toJson());
+        CHECK_EQ(json["total"], 6);
+        CHECK_EQ(json["by_type"]["TASK"], 4);
+        CHECK_EQ(json["tasks_by_status"]["DOING"], 1);
+        CHECK_EQ(json["overdue_tasks"], 1);
+        CHECK_EQ(json["per_day"],
+                 nlohmann::json{{"2025-04-05", 5}, {"2025-04-06", 1}});
+    }
+}
+
+TEST_CASE("StatsRepository")
+{
+    auto inner = std::make_shared<banchoo::repository::InMemoryRepository>(
+        nlohmann::json{});
+    banchoo::repository::StatsRepository repo(inner);
+
+    auto now = std::chrono::system_clock::now();
+    auto memo = repo.createMemo({.content = "memo"});
+    auto late = repo.createTask({.content = "late", .due_date = now - 1h});
+    auto later = repo.createTask({.content = "later", .due_date = now + 1h});
+    std::vector<note::Note> batch{
+        {.type = note::NoteType::EVENT, .content = "event"},
+        {.type = note::NoteType::TASK,
+         .content = "imported",
+         .status = note::NoteStatus::DONE}};
+    repo.importNotes(batch);
+
+    auto stats = repo.noteStats(now);
+    CHECK_EQ(stats.total, 5);
+    CHECK_EQ(stats.overdue_tasks, 1);
+    CHECK_EQ(stats.tasks_by_status[0], 2);
+    checkSame(stats, inner->noteStats(now));
+
+    SUBCASE("patch")
+    {
+        note::Note done{.status = note::NoteStatus::DONE};
+        REQUIRE(repo.patchNote(late->id, std::move(done), note::field::STATUS));
+        note::Note due{.due_date = now - 2h};
+        REQUIRE(
+            repo.patchNote(later->id, std::move(due), note::field::DUE_DATE));
+        note::Note content{.content = "edited"};
+        REQUIRE(
+            repo.patchNote(memo->id, std::move(content), note::field::CONTENT));
+
+        stats = repo.noteStats(now);
+        CHECK_EQ(stats.overdue_tasks, 1);
+        CHECK_EQ(stats.tasks_by_status[2], 2);
+        checkSame(stats, inner->noteStats(now));
+    }
+
+    SUBCASE("update and delete")
+    {
+        auto replaced = *late;
+        replaced.type = note::NoteType::MEMO;
+        replaced.status.reset();
+        REQUIRE(repo.updateNote(std::move(replaced)));
+        REQUIRE(repo.deleteNote(memo->id));
+        CHECK_FALSE(repo.deleteNote(memo->id));
+        CHECK_FALSE(repo.updateNote({.id = 999, .type = note::NoteType::MEMO}));
+
+        stats = repo.noteStats(now);
+        CHECK_EQ(stats.total, 4);
+        CHECK_EQ(stats.overdue_tasks, 0);
+        checkSame(stats, inner->noteStats(now));
+    }
+
+    SUBCASE("rebuilt from storage")
+    {
+        banchoo::repository::StatsRepository again(inner);
+        checkSame(again.noteStats(now), stats);
+    }
+}
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "app/note_decoder.hpp"
+#include "app/note_serializer.hpp"
+#include "app/note_stream.hpp"
+#include "note/note.hpp"
+#include "repository/compact_inmemory_repository.hpp"
+#include "repository/forwarding_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/sqlite_repository.hpp"
+
+using banchoo::app::NoteDecoder;
+using banchoo::app::NoteExporter;
+using banchoo::app::NoteImporter;
+using banchoo::app::NoteListStream;
+using banchoo::app::NoteSerializer;
+namespace note = banchoo::note;
+namespace repository = banchoo::repository;
+
+namespace
+{
+// scanNotes 가 돌려준 노트를 그대로 복사해 둔다. 저장소가 어떤 필드를
+// 읽었는지 볼 수 있다.
+class RecordingRepository : public repository::ForwardingRepository
+{
+ public:
+    explicit RecordingRepository(
+        std::shared_ptr<repository::BaseRepository> inner)
+        : ForwardingRepository(std::move(inner))
+    {
+    }
+
+    repository::NoteList
+    scanNotes(note::Id after,
+              std::size_t limit,
+              std::optional<note::NoteType> type,
+              const note::Projection &projection,
+              std::pmr::memory_resource *mr) const override
+    {
+        auto notes = inner_->scanNotes(after, limit, type, projection, mr);
+        for (const auto &n : notes)
+            scanned.push_back(*n);
+        return notes;
+    }
+
+    mutable std::vector<note::Note> scanned;
+};
+} // namespace
+
+TEST_CASE("NoteImporter")
+{
+    banchoo::repository::InMemoryRepository repo(nlohmann::json{});
+
+    SUBCASE("lines split across chunks")
+    {
+        NoteImporter importer(repo, 2);
+        importer.feed(R"({"content":"first"})"
+                      "\n"
+                      R"({"type":"TASK","con)");
+        importer.feed(R"(tent":"second"})"
+                      "\r\n\n"
+                      R"({"type":"EVENT","content":"third",)"
+                      R"("start_date":"2025-04-05T12:00:00Z"})");
+        auto summary = importer.finish();
+
+        CHECK_EQ(summary.imported, 3);
+        CHECK_EQ(summary.failed, 0);
+
+        auto notes = repo.scanNotes(0, 10);
+        REQUIRE(notes.size() == 3);
+        CHECK_EQ(notes[0]->type, note::NoteType::MEMO);
+        CHECK_EQ(notes[0]->content, "first");
+        CHECK_NE(notes[0]->created_at, note::TimePoint{});
+        CHECK_EQ(notes[1]->type, note::NoteType::TASK);
+        CHECK_EQ(notes[1]->status, note::NoteStatus::TODO);
+        CHECK_EQ(notes[2]->type, note::NoteType::EVENT);
+        CHECK_EQ(notes[2]->start_date,
+                 note::parse_timestamp("2025-04-05T12:00:00Z"));
+    }
+
+    SUBCASE("bad lines are skipped and reported")
+    {
+        NoteImporter importer(repo);
+        importer.feed("{\"content\":\"ok\"}\n"
+                      "not json\n"
+                      "{\"content\":\"x\",\"type\":\"NOTE\"}\n"
+                      "{\"status\":\"DONE\"}\n");
+        auto summary = importer.finish();
+
+        CHECK_EQ(summary.imported, 1);
+        CHECK_EQ(summary.failed, 3);
+        REQUIRE(summary.errors.size() == 3);
+        CHECK_EQ(summary.errors[0].line, 2);
+        CHECK_EQ(summary.errors[1].error.field, "type");
+        CHECK_EQ(summary.errors[2].error.error, "missing_field");
+
+        auto json = nlohmann::json::parse(summary.toJson());
+        CHECK_EQ(json["imported"], 1);
+        CHECK_EQ(json["errors"][1]["line"], 3);
+    }
+}
+
+TEST_CASE("NoteExporter")
+{
+    auto source = std::make_shared<banchoo::repository::InMemoryRepository>(
+        nlohmann::json{});
+    for (int i = 0; i < 5; ++i)
+        source->createMemo({.content = "memo " + std::to_string(i)});
+    auto task = source->createTask({.content = "task \"quoted\""});
+    source->patchNote(
+        task->id, {.status = note::NoteStatus::DONE}, note::field::STATUS);
+
+    NoteExporter exporter(source, 2);
+    std::string body;
+    int chunks = 0;
+    while (exporter.next(body))
+        ++chunks;
+    CHECK_EQ(chunks, 3);
+    CHECK_EQ(exporter.exported(), 6);
+    CHECK_FALSE(exporter.next(body));
+
+    SUBCASE("round trip")
+    {
+        banchoo::repository::CompactInMemoryRepository target(
+            nlohmann::json{});
+        NoteImporter importer(target);
+        importer.feed(body);
+        auto summary = importer.finish();
+        CHECK_EQ(summary.imported, 6);
+        CHECK_EQ(summary.failed, 0);
+
+        auto notes = target.scanNotes(0, 10);
+        REQUIRE(notes.size() == 6);
+        CHECK_EQ(notes[0]->content, "memo 0");
+        CHECK_EQ(notes[5]->type, note::NoteType::TASK);
+        CHECK_EQ(notes[5]->content, "task \"quoted\"");
+        CHECK_EQ(notes[5]->status, note::NoteStatus::DONE);
+        CHECK_FALSE(notes[5]->due_date);
+        // 내보내기는 초 단위까지 쓴다.
+        using std::chrono::floor;
+        using std::chrono::seconds;
+        CHECK_EQ(floor<seconds>(notes[5]->created_at),
+                 floor<seconds>(task->created_at));
+    }
+
+    SUBCASE("large notes are split by bytes")
+    {
+        auto large = std::make_shared<banchoo::repository::InMemoryRepository>(
+            nlohmann::json{});
+        for (int i = 0; i < 10; ++i)
+            large->createMemo({.content = std::string(600 * 1024, 'x')});
+
+        // 첫 배치는 4개를 읽고, 그 뒤로는 한 개씩 읽는다. 마지막 배치가
+        // 꽉 찼으므로 빈 배치를 한 번 더 읽고 끝난다.
+        NoteExporter large_exporter(large, 4);
+        std::size_t chunk_count = 0;
+        std::size_t largest = 0;
+        for (bool more = true; more; ++chunk_count)
+        {
+            std::string chunk;
+            more = large_exporter.next(chunk);
+            if (chunk_count > 0)
+                largest = std::max(largest, chunk.size());
+        }
+        CHECK_EQ(large_exporter.exported(), 10);
+        CHECK_EQ(chunk_count, 8);
+        CHECK_LT(largest, NoteExporter::MAX_CHUNK_BYTES);
+    }
+}
+
+TEST_CASE("NoteListStream")
+{
+    auto source = std::make_shared<banchoo::repository::InMemoryRepository>(
+        nlohmann::json{});
+    std::vector<note::Id> all;
+    std::vector<note::Id> tasks;
+    for (int i = 0; i < 5; ++i)
+    {
+        all.push_back(
+            source->createMemo({.content = "memo " + std::to_string(i)})->id);
+        all.push_back(
+            source->createTask({.content = "task " + std::to_string(i)})->id);
+        tasks.push_back(all.back());
+    }
+
+    // 배치마다 조각을 하나씩 받아 이어 붙인다.
+    auto collect = [](NoteListStream &stream, int &chunks)
+    {
+        std::string body;
+        chunks = 0;
+        for (bool more = true; more; ++chunks)
+        {
+            std::string chunk;
+            more = stream.next(chunk);
+            body += chunk;
+        }
+        return body;
+    };
+
+    // 목록은 id 순이다.
+    SUBCASE("same body as writeNotes")
+    {
+        const note::Projection view = NoteSerializer::DEFAULT_VIEW;
+        NoteListStream stream(source, std::nullopt, view, 3);
+        int chunks = 0;
+        CHECK_EQ(collect(stream, chunks),
+                 NoteSerializer::writeNotes(source->getNotes(all, view), view));
+        CHECK_EQ(chunks, 4);
+        std::string rest;
+        CHECK_FALSE(stream.next(rest));
+        CHECK(rest.empty());
+    }
+
+    SUBCASE("only the given type")
+    {
+        const note::Projection view{.fields = note::field::ID, .preview = 4};
+        NoteListStream stream(source, note::NoteType::TASK, view, 4);
+        int chunks = 0;
+        auto expected =
+            NoteSerializer::writeNotes(source->getNotes(tasks, view), view);
+        CHECK_EQ(collect(stream, chunks), expected);
+    }
+
+    SUBCASE("large notes are split by bytes")
+    {
+        auto large = std::make_shared<banchoo::repository::InMemoryRepository>(
+            nlohmann::json{});
+        std::vector<note::Id> ids;
+        for (int i = 0; i < 10; ++i)
+        {
+            ids.push_back(
+                large->createMemo({.content = std::string(600 * 1024, 'x')})
+                    ->id);
+        }
+        const note::Projection view = NoteSerializer::DEFAULT_VIEW;
+        auto expected = NoteSerializer::writeNotes(large->getNotes(ids), view);
+
+        // 첫 배치는 4개를 읽고, 그 뒤로는 조각이 MAX_CHUNK_BYTES 안팎이
+        // 되도록 한 개씩 읽는다.
+        NoteListStream scanned(large, std::nullopt, view, 4);
+        std::string body;
+        std::size_t largest = 0;
+        for (bool more = true; more;)
+        {
+            std::string chunk;
+            more = scanned.next(chunk);
+            if (!body.empty())
+                largest = std::max(largest, chunk.size());
+            body += chunk;
+        }
+        CHECK_EQ(body, expected);
+        CHECK_LT(largest, NoteListStream::MAX_CHUNK_BYTES);
+
+        // 이미 읽은 목록도 MAX_CHUNK_BYTES 를 넘으면 나눠 쓴다.
+        NoteListStream listed(large->getNotes(ids), view);
+        int chunks = 0;
+        CHECK_EQ(collect(listed, chunks), expected);
+        CHECK_EQ(chunks, 5);
+    }
+
+    SUBCASE("empty repository")
+    {
+        auto empty = std::make_shared<banchoo::repository::InMemoryRepository>(
+            nlohmann::json{});
+        NoteListStream stream(empty, std::nullopt, {});
+        int chunks = 0;
+        CHECK_EQ(collect(stream, chunks), "[]");
+        CHECK_EQ(chunks, 1);
+    }
+}
+
+TEST_CASE("NoteListStream reads only the requested fields")
+{
+    // ?fields=id,type
+    note::Projection view = NoteSerializer::DEFAULT_VIEW;
+    REQUIRE(NoteDecoder::decodeProjection("id,type", nullptr, view).ok());
+
+    std::string text(4096, 'x');
+    auto check = [&](std::shared_ptr<repository::BaseRepository> inner)
+    {
+        inner->createMemo({.content = text, .tags = {"t"}});
+        inner->createTask({.content = "short"});
+        auto repo = std::make_shared<RecordingRepository>(inner);
+
+        NoteListStream stream(repo, std::nullopt, view);
+        std::string body;
+        while (stream.next(body))
+        {
+        }
+        CHECK_EQ(body, R"([{"id":1,"type":"MEMO"},{"id":2,"type":"TASK"}])");
+
+        // 압축해 둔 본문은 풀지 않는다.
+        REQUIRE(repo->scanned.size() == 2);
+        CHECK(repo->scanned[0].content.empty());
+        return repo->scanned;
+    };
+
+    // 저장된 노트를 그대로 공유하므로 본문 말고는 채워져 있다.
+    SUBCASE("InMemoryRepository")
+    {
+        check(std::make_shared<repository::InMemoryRepository>(
+            nlohmann::json{{"compress_threshold", 64}}));
+    }
+
+    // 고르지 않은 필드(SQLite 는 열)는 읽지 않으므로 비어 있다.
+    auto unread = [](const std::vector<note::Note> &scanned)
+    {
+        for (const auto &n : scanned)
+        {
+            CHECK(n.content.empty());
+            CHECK(n.tags.empty());
+            CHECK_EQ(n.created_at, note::TimePoint{});
+            CHECK_FALSE(n.status);
+        }
+    };
+
+    SUBCASE("CompactInMemoryRepository")
+    {
+        unread(check(std::make_shared<repository::CompactInMemoryRepository>(
+            nlohmann::json{{"compress_threshold", 64}})));
+    }
+
+    SUBCASE("SqliteRepository")
+    {
+        unread(check(std::make_shared<repository::SqliteRepository>(
+            nlohmann::json{{"db_path", ":memory:"},
+                           {"compress_threshold", 64}})));
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "reminder/reminder_scheduler.hpp"
+#include "reminder/timing_wheel.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/reminder_repository.hpp"
+
+namespace note = banchoo::note;
+using banchoo::reminder::Reminder;
+using banchoo::reminder::ReminderScheduler;
+using banchoo::reminder::ReminderSubscriber;
+
+namespace
+{
+using namespace std::chrono_literals;
+
+// 2025-04-05T12:00:00Z
+const note::TimePoint NOON{std::chrono::seconds(1743854400)};
+
+class Recorder : public ReminderSubscriber
+{
+ public:
+    void onReminder(const Reminder &reminder) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reminders_.push_back(reminder);
+        cv_.notify_all();
+    }
+
+    std::vector<note::Id> ids() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<note::Id> out;
+        for (const auto &r : reminders_)
+            out.push_back(r.id);
+        return out;
+    }
+
+    bool waitFor(std::size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock,
+                            timeout,
+                            [&] { return reminders_.size() >= count; });
+    }
+
+ private:
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Reminder> reminders_;
+};
+
+class Throwing : public ReminderSubscriber
+{
+ public:
+    void onReminder(const Reminder &) override
+    {
+        throw std::runtime_error("subscriber failed");
+    }
+};
+
+note::Note task(note::Id id,
+                std::optional<note::TimePoint> due,
+                note::NoteStatus status = note::NoteStatus::TODO)
+{
+    return {.id = id,
+            .type = note::NoteType::TASK,
+            .status = status,
+            .due_date = due};
+}
+} // namespace
+
+TEST_CASE("ReminderScheduler")
+{
+    SUBCASE("reminderOf")
+    {
+        auto r = ReminderScheduler::reminderOf(task(1, NOON));
+        REQUIRE(r);
+        CHECK_EQ(r->id, 1);
+        CHECK_EQ(r->type, note::NoteType::TASK);
+        CHECK_EQ(r->at, NOON);
+        CHECK_EQ(r->toJson(),
+                 R"({"id":1,"type":"TASK","at":"2025-04-05T12:00:00Z"})");
+
+        CHECK_FALSE(ReminderScheduler::reminderOf(task(1, std::nullopt)));
+        CHECK_FALSE(ReminderScheduler::reminderOf(
+            task(1, NOON, note::NoteStatus::DONE)));
+        CHECK_FALSE(ReminderScheduler::reminderOf(
+            {.id = 1, .type = note::NoteType::MEMO, .due_date = NOON}));
+
+        auto event = ReminderScheduler::reminderOf(
+            {.id = 2, .type = note::NoteType::EVENT, .start_date = NOON});
+        REQUIRE(event);
+        CHECK_EQ(event->at, NOON);
+    }
+
+    SUBCASE("fires due reminders in time order")
+    {
+        ReminderScheduler scheduler(1s, NOON);
+        auto recorder = std::make_shared<Recorder>();
+        scheduler.subscribe(recorder);
+
+        scheduler.update(task(1, NOON + 90s));
+        scheduler.update(task(2, NOON + 30s));
+        scheduler.update(task(3, NOON + 30500ms));
+        scheduler.update(task(4, NOON - 1s)); // 이미 지났다
+        CHECK_EQ(scheduler.pending(), 3);
+
+        CHECK_EQ(scheduler.advance(NOON + 29s), 0);
+        CHECK_EQ(scheduler.advance(NOON + 31s), 2);
+        CHECK_EQ(recorder->ids(), std::vector<note::Id>{2, 3});
+
+        // 끝낸 할 일은 알리지 않는다.
+        scheduler.update(task(1, NOON + 90s, note::NoteStatus::DONE));
+        CHECK_EQ(scheduler.advance(NOON + 1h), 0);
+        CHECK_EQ(scheduler.pending(), 0);
+    }
+
+    SUBCASE("rounds up to the tick")
+    {
+        ReminderScheduler scheduler(1s, NOON);
+        auto recorder = std::make_shared<Recorder>();
+        scheduler.subscribe(recorder);
+        scheduler.update(task(1, NOON + 1500ms));
+
+        scheduler.advance(NOON + 1999ms);
+        CHECK(recorder->ids().empty());
+        scheduler.advance(NOON + 2s);
+        CHECK_EQ(recorder->ids(), std::vector<note::Id>{1});
+    }
+
+    SUBCASE("unsubscribe and failing subscribers")
+    {
+        ReminderScheduler scheduler(1s, NOON);
+        auto recorder = std::make_shared<Recorder>();
+        auto other = std::make_shared<Recorder>();
+        scheduler.subscribe(std::make_shared<Throwing>());
+        scheduler.subscribe(recorder);
+        scheduler.subscribe(other);
+        scheduler.unsubscribe(other.get());
+
+        scheduler.update(task(1, NOON + 1s));
+        CHECK_EQ(scheduler.advance(NOON + 1s), 1);
+        CHECK_EQ(recorder->ids(), std::vector<note::Id>{1});
+        CHECK(other->ids().empty());
+    }
+
+    SUBCASE("thread fires on the wall clock")
+    {
+        ReminderScheduler scheduler(10ms);
+        auto recorder = std::make_shared<Recorder>();
+        scheduler.subscribe(recorder);
+        scheduler.update(task(1, std::chrono::system_clock::now() + 30ms));
+        scheduler.start();
+        CHECK(recorder->waitFor(1, 2s));
+        scheduler.stop();
+        CHECK_EQ(recorder->ids(), std::vector<note::Id>{1});
+    }
+}
+
+TEST_CASE("ReminderRepository")
+{
+    using banchoo::repository::InMemoryRepository;
+    using banchoo::repository::ReminderRepository;
+
+    const auto now = std::chrono::system_clock::now();
+    auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+    auto scheduler = std::make_shared<ReminderScheduler>(1s, now);
+    auto recorder = std::make_shared<Recorder>();
+    scheduler->subscribe(recorder);
+
+    SUBCASE("rebuilds from the wrapped repository")
+    {
+        std::vector<note::Note> notes{
+            task(0, now + 1h),
+            task(0, now - 1h),
+            task(0, now + 1h, note::NoteStatus::DONE),
+            {.type = note::NoteType::EVENT, .start_date = now + 2h},
+            {.type = note::NoteType::MEMO}};
+        inner->importNotes(notes);
+
+        ReminderRepository repo(inner, scheduler);
+        CHECK_EQ(scheduler->pending(), 2);
+        scheduler->advance(now + 3h);
+        CHECK_EQ(recorder->ids(),
+                 std::vector<note::Id>{notes[0].id, notes[3].id});
+    }
+
+    SUBCASE("follows writes")
+    {
+        ReminderRepository repo(inner, scheduler);
+        auto created = repo.createTask(task(0, now + 1h));
+        CHECK_EQ(scheduler->pending(), 1);
+
+        // 본문만 고치면 알림은 그대로다.
+        CHECK(repo.patchNote(
+            created->id, {.content = "x"}, note::field::CONTENT));
+        CHECK_EQ(scheduler->pending(), 1);
+
+        // 끝내면 취소되고 되돌리면 다시 걸린다.
+        CHECK(repo.patchNote(created->id,
+                             {.status = note::NoteStatus::DONE},
+                             note::field::STATUS));
+        CHECK_EQ(scheduler->pending(), 0);
+        CHECK(repo.patchNote(created->id,
+                             {.status = note::NoteStatus::DOING},
+                             note::field::STATUS));
+        CHECK_EQ(scheduler->pending(), 1);
+
+        // 마감을 옮기면 새 시각에 울린다.
+        CHECK(repo.patchNote(
+            created->id, {.due_date = now + 2h}, note::field::DUE_DATE));
+        scheduler->advance(now + 90min);
+        CHECK(recorder->ids().empty());
+        scheduler->advance(now + 2h + 1s);
+        CHECK_EQ(recorder->ids(), std::vector<note::Id>{created->id});
+
+        auto event = repo.createEvent(
+            {.type = note::NoteType::EVENT, .start_date = now + 5h});
+        CHECK_EQ(scheduler->pending(), 1);
+        CHECK(repo.deleteNote(event->id));
+        CHECK_EQ(scheduler->pending(), 0);
+        CHECK_FALSE(repo.deleteNote(event->id));
+
+        std::vector<note::Note> batch{task(0, now + 3h), task(0, now + 4h)};
+        repo.importNotes(batch);
+        CHECK_EQ(scheduler->pending(), 2);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
+#include "app/request_arena.hpp"
+
+using banchoo::app::RequestArena;
+
+TEST_CASE("RequestArena")
+{
+    SUBCASE("scopes reuse the thread buffer")
+    {
+        void *first = nullptr;
+        {
+            RequestArena::Scope arena;
+            first = arena.resource()->allocate(128);
+        }
+        {
+            RequestArena::Scope arena;
+            CHECK_EQ(arena.resource()->allocate(128), first);
+        }
+    }
+
+    SUBCASE("nested scopes release at the outermost end")
+    {
+        RequestArena::Scope outer;
+        void *a = outer.resource()->allocate(64);
+        {
+            RequestArena::Scope inner;
+            CHECK_EQ(inner.resource(), outer.resource());
+            CHECK_NE(inner.resource()->allocate(64), a);
+        }
+        CHECK_NE(outer.resource()->allocate(64), a);
+    }
+
+    SUBCASE("buffer grows after a spill")
+    {
+        // 스레드마다 버퍼가 따로이므로 새 스레드에서 처음부터 본다.
+        std::thread(
+            []
+            {
+                {
+                    RequestArena::Scope arena;
+                    CHECK_EQ(RequestArena::retainedBytes(),
+                             RequestArena::INITIAL_SIZE);
+                    std::pmr::vector<char> big(arena.resource());
+                    big.resize(RequestArena::INITIAL_SIZE * 2);
+                }
+                CHECK_GT(RequestArena::retainedBytes(),
+                         RequestArena::INITIAL_SIZE * 2);
+                CHECK_LE(RequestArena::retainedBytes(),
+                         RequestArena::MAX_RETAINED);
+            })
+            .join();
+    }
+}
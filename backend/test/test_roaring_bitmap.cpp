@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "index/roaring_bitmap.hpp"
+
+using banchoo::index::RoaringBitmap;
+
+namespace
+{
+// 배열 묶음과 비트맵 묶음이 섞이도록 묶음마다 밀도를 다르게 뽑는다.
+std::set<std::uint32_t> randomSet(std::mt19937 &rng)
+{
+    std::set<std::uint32_t> values;
+    const std::uint32_t counts[] = {10, 3000, 20000, 65536};
+    for (std::uint32_t key = 0; key < 4; ++key)
+    {
+        std::uniform_int_distribution<std::uint32_t> low(0, 65535);
+        for (std::uint32_t i = 0; i < counts[(key + rng()) % 4]; ++i)
+            values.insert((key << 16) | low(rng));
+    }
+    return values;
+}
+
+RoaringBitmap fromSet(const std::set<std::uint32_t> &values)
+{
+    RoaringBitmap bitmap;
+    for (auto v : values)
+        bitmap.add(v);
+    return bitmap;
+}
+
+std::vector<std::uint32_t> toVector(const std::set<std::uint32_t> &values)
+{
+    return {values.begin(), values.end()};
+}
+} // namespace
+
+TEST_CASE("RoaringBitmap")
+{
+    SUBCASE("add, remove, contains")
+    {
+        RoaringBitmap bitmap;
+        CHECK(bitmap.empty());
+        CHECK(bitmap.add(7));
+        CHECK_FALSE(bitmap.add(7));
+        CHECK(bitmap.add(70000));
+        CHECK(bitmap.contains(7));
+        CHECK(bitmap.contains(70000));
+        CHECK_FALSE(bitmap.contains(8));
+        CHECK_EQ(bitmap.cardinality(), 2);
+        CHECK_EQ(bitmap.toVector(), std::vector<std::uint32_t>{7, 70000});
+
+        CHECK(bitmap.remove(7));
+        CHECK_FALSE(bitmap.remove(7));
+        CHECK(bitmap.remove(70000));
+        CHECK(bitmap.empty());
+    }
+
+    SUBCASE("array and bitmap containers")
+    {
+        // 4096 개를 넘으면 비트맵 묶음으로 바뀌고, 다시 줄면 배열로 돌아온다.
+        RoaringBitmap bitmap;
+        for (std::uint32_t v = 0; v < 4096; ++v)
+            bitmap.add(v * 2);
+        bitmap.add(1);
+        CHECK_EQ(bitmap.cardinality(), 4097);
+        CHECK(bitmap.contains(1));
+        CHECK(bitmap.contains(8190));
+        CHECK_FALSE(bitmap.contains(3));
+
+        bitmap.remove(1);
+
+        RoaringBitmap same;
+        for (std::uint32_t v = 0; v < 4096; ++v)
+            same.add(v * 2);
+        CHECK(bitmap == same);
+    }
+
+    SUBCASE("set operations match std::set")
+    {
+        std::mt19937 rng(42);
+        for (int round = 0; round < 8; ++round)
+        {
+            auto a = randomSet(rng);
+            auto b = randomSet(rng);
+            auto ra = fromSet(a);
+            auto rb = fromSet(b);
+            REQUIRE_EQ(ra.toVector(), toVector(a));
+            CHECK_EQ(ra.cardinality(), a.size());
+
+            std::vector<std::uint32_t> expected;
+            std::set_intersection(a.begin(),
+                                  a.end(),
+                                  b.begin(),
+                                  b.end(),
+                                  std::back_inserter(expected));
+            CHECK_EQ((ra & rb).toVector(), expected);
+
+            expected.clear();
+            std::set_union(a.begin(),
+                           a.end(),
+                           b.begin(),
+                           b.end(),
+                           std::back_inserter(expected));
+            CHECK_EQ((ra | rb).toVector(), expected);
+
+            expected.clear();
+            std::set_difference(a.begin(),
+                                a.end(),
+                                b.begin(),
+                                b.end(),
+                                std::back_inserter(expected));
+            auto diff = ra - rb;
+            CHECK_EQ(diff.toVector(), expected);
+            CHECK_EQ(diff.cardinality(), expected.size());
+            // 결과도 값을 새로 넣어 만든 비트맵과 같은 표현이어야 한다.
+            CHECK(diff == fromSet({expected.begin(), expected.end()}));
+        }
+    }
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <sqlite/sqlite3.h>
+
+#include "note/note.hpp"
+#include "repository/sqlite_repository.hpp"
+
+using banchoo::repository::SqliteRepository;
+namespace note = banchoo::note;
+
+namespace
+{
+std::vector<note::Id> ids(const banchoo::repository::NoteList &notes)
+{
+    std::vector<note::Id> out;
+    for (const auto &n : notes)
+        out.push_back(n->id);
+    return out;
+}
+
+// 저장소가 쓴 파일을 직접 들여다보는 두 번째 연결
+class RawDb
+{
+ public:
+    explicit RawDb(const std::string &path)
+    {
+        REQUIRE_EQ(sqlite3_open(path.c_str(), &db_), SQLITE_OK);
+    }
+    ~RawDb()
+    {
+        sqlite3_close(db_);
+    }
+
+    void exec(const std::string &sql)
+    {
+        REQUIRE_EQ(sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr),
+                   SQLITE_OK);
+    }
+
+    // 첫 행 첫 열을 문자열로
+    std::string query(const std::string &sql)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        REQUIRE_EQ(sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr),
+                   SQLITE_OK);
+        std::string value;
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            const auto *text = sqlite3_column_text(stmt, 0);
+            if (text)
+                value = reinterpret_cast<const char *>(text);
+        }
+        sqlite3_finalize(stmt);
+        return value;
+    }
+
+ private:
+    sqlite3 *db_ = nullptr;
+};
+} // namespace
+
+TEST_CASE("SqliteRepository")
+{
+    SqliteRepository repo(nlohmann::json{{"db_path", ":memory:"}});
+
+    SUBCASE("round trip")
+    {
+        auto due = note::parse_timestamp("2025-04-05T12:00:00.250000Z");
+        auto created = repo.createTask(
+            {.content = "할 일", .due_date = due, .tags = {"b", "a"}});
+        REQUIRE(created);
+
+        auto stored = repo.getNote(created->id);
+        REQUIRE(stored);
+        CHECK_EQ(stored->type, note::NoteType::TASK);
+        CHECK_EQ(stored->content, "할 일");
+        CHECK_EQ(stored->due_date, due);
+        CHECK_EQ(stored->tags, std::vector<std::string>{"a", "b"});
+        CHECK_FALSE(repo.getNote(created->id + 1));
+    }
+
+    SUBCASE("patch updates only the masked columns")
+    {
+        auto task = repo.createTask({.content = "write tests"});
+        auto before = repo.getNote(task->id);
+
+        note::Note values{.content = "ignored",
+                          .status = note::NoteStatus::DONE};
+        CHECK(repo.patchNote(task->id, std::move(values), note::field::STATUS));
+
+        auto after = repo.getNote(task->id);
+        CHECK_EQ(after->status, note::NoteStatus::DONE);
+        CHECK_EQ(after->content, "write tests");
+        CHECK_EQ(after->created_at, before->created_at);
+        CHECK_GE(after->updated_at, before->updated_at);
+
+        // RETURNING 으로 행이 없으면 false
+        note::Note missing{.status = note::NoteStatus::DONE};
+        CHECK_FALSE(repo.patchNote(
+            task->id + 1, std::move(missing), note::field::STATUS));
+    }
+
+    SUBCASE("projection and preview")
+    {
+        repo.createMemo({.content = "한글 미리보기"});
+        repo.createMemo({.content = "ab"});
+
+        note::Projection preview{.fields = note::field::ID, .preview = 2};
+        auto notes = repo.getAllNotes(preview);
+        REQUIRE_EQ(notes.size(), 2);
+        CHECK_EQ(notes[0]->content, "한글");
+        CHECK_EQ(notes[1]->content, "ab");
+        // 고르지 않은 필드는 기본값으로 남는다.
+        CHECK_EQ(notes[0]->created_at, note::TimePoint{});
+
+        note::Projection tags{.fields = note::field::ID | note::field::TAGS};
+        notes = repo.getAllMemos(tags);
+        REQUIRE_EQ(notes.size(), 2);
+        CHECK(notes[0]->content.empty());
+
+        auto picked = repo.getNotes(std::vector<note::Id>{notes[1]->id, 99},
+                                    preview);
+        REQUIRE_EQ(picked.size(), 1);
+        CHECK_EQ(picked[0]->content, "ab");
+    }
+
+    SUBCASE("tags are replaced on update")
+    {
+        auto created = repo.createMemo({.content = "tagged", .tags = {"x"}});
+        auto edited = *repo.getNote(created->id);
+        edited.tags = {"y", "z"};
+        CHECK(repo.updateNote(std::move(edited)));
+        CHECK_EQ(repo.getNote(created->id)->tags,
+                 std::vector<std::string>{"y", "z"});
+
+        note::Note retag{.tags = {}};
+        CHECK(repo.patchNote(created->id, std::move(retag), note::field::TAGS));
+        CHECK(repo.getNote(created->id)->tags.empty());
+    }
+
+    SUBCASE("scanNotes pages by id")
+    {
+        std::vector<note::Id> created;
+        for (int i = 0; i < 10; ++i)
+            created.push_back(repo.createMemo({.content = "n"})->id);
+        repo.deleteNote(created[3]);
+        repo.deleteNote(created[4]);
+        created.erase(created.begin() + 3, created.begin() + 5);
+
+        std::vector<note::Id> scanned;
+        note::Id after = 0;
+        for (;;)
+        {
+            auto page = repo.scanNotes(after, 3);
+            if (page.empty())
+                break;
+            CHECK_LE(page.size(), 3);
+            for (auto id : ids(page))
+                scanned.push_back(id);
+            after = page.back()->id;
+        }
+        CHECK_EQ(scanned, created);
+    }
+
+    SUBCASE("scanNotes by type")
+    {
+        std::vector<note::Id> tasks;
+        for (int i = 0; i < 5; ++i)
+        {
+            repo.createMemo({.content = "memo"});
+            tasks.push_back(repo.createTask({.content = "task"})->id);
+        }
+
+        auto first = repo.scanNotes(0, 3, note::NoteType::TASK);
+        REQUIRE(first.size() == 3);
+        auto rest = repo.scanNotes(first.back()->id, 3, note::NoteType::TASK);
+        CHECK_EQ(ids(first),
+                 std::vector<note::Id>(tasks.begin(), tasks.begin() + 3));
+        CHECK_EQ(ids(rest),
+                 std::vector<note::Id>(tasks.begin() + 3, tasks.end()));
+    }
+
+    SUBCASE("createNotes assigns ids in order")
+    {
+        std::vector<note::Note> batch{{.content = "a"},
+                                      {.content = "b", .tags = {"t"}}};
+        repo.importNotes(batch);
+        CHECK_LT(batch[0].id, batch[1].id);
+        CHECK_EQ(repo.getNote(batch[1].id)->tags,
+                 std::vector<std::string>{"t"});
+    }
+}
+
+TEST_CASE("SqliteRepository storage format")
+{
+    // 테이블을 직접 읽고 써야 하는 경우는 파일 db 에 두 번째 연결을 연다.
+    const std::string path = "test_sqlite_repository.sqlite";
+    std::filesystem::remove(path);
+
+    SUBCASE("compressed BLOB content next to TEXT rows")
+    {
+        SqliteRepository repo(
+            nlohmann::json{{"db_path", path}, {"compress_threshold", 64}});
+        std::string long_content(4096, 'x');
+        auto packed = repo.createMemo({.content = long_content});
+        auto plain = repo.createMemo({.content = "short"});
+
+        RawDb raw(path);
+        CHECK_EQ(raw.query("SELECT typeof(content) FROM notes WHERE id = " +
+                           std::to_string(packed->id)),
+                 "blob");
+        CHECK_EQ(raw.query("SELECT typeof(content) FROM notes WHERE id = " +
+                           std::to_string(plain->id)),
+                 "text");
+
+        CHECK_EQ(repo.getNote(packed->id)->content, long_content);
+        note::Projection preview{.fields = note::field::ID, .preview = 3};
+        auto notes = repo.getAllNotes(preview);
+        REQUIRE_EQ(notes.size(), 2);
+        CHECK_EQ(notes[0]->content, "xxx");
+        CHECK_EQ(notes[1]->content, "sho");
+    }
+
+    SUBCASE("updateNote compresses the new content")
+    {
+        SqliteRepository repo(
+            nlohmann::json{{"db_path", path}, {"compress_threshold", 64}});
+        auto stored = repo.createMemo({.content = std::string(4096, 'x')});
+
+        std::string long_content;
+        for (int i = 0; long_content.size() < 8192; ++i)
+            long_content += std::to_string(i) + ' ';
+        auto updated = *stored;
+        updated.content = long_content;
+        REQUIRE(repo.updateNote(std::move(updated)));
+
+        RawDb raw(path);
+        CHECK_EQ(raw.query("SELECT typeof(content) FROM notes WHERE id = " +
+                           std::to_string(stored->id)),
+                 "blob");
+        CHECK_EQ(repo.getNote(stored->id)->content, long_content);
+    }
+
+    SUBCASE("rows written by the old format")
+    {
+        SqliteRepository repo(nlohmann::json{{"db_path", path}});
+        RawDb raw(path);
+        raw.exec("INSERT INTO notes (type, content, created_at, updated_at)"
+                 " VALUES ('MEMO', 'legacy', '2025-04-05 21:00:00',"
+                 " '2025-04-05 21:00:00')");
+
+        auto notes = repo.getAllNotes();
+        REQUIRE_EQ(notes.size(), 1);
+        CHECK_EQ(notes[0]->content, "legacy");
+        // 예전 행은 현지 시각이다.
+        CHECK_EQ(notes[0]->created_at,
+                 note::parse_timestamp("2025-04-05 21:00:00"));
+    }
+
+    SUBCASE("deleting a note removes its tag links")
+    {
+        SqliteRepository repo(nlohmann::json{{"db_path", path}});
+        auto kept = repo.createMemo({.content = "kept", .tags = {"shared"}});
+        auto gone =
+            repo.createMemo({.content = "gone", .tags = {"shared", "own"}});
+        RawDb raw(path);
+        CHECK_EQ(raw.query("SELECT count(*) FROM note_tags"), "3");
+
+        CHECK(repo.deleteNote(gone->id));
+        CHECK_EQ(raw.query("SELECT count(*) FROM note_tags"), "1");
+        CHECK_EQ(repo.getNote(kept->id)->tags,
+                 std::vector<std::string>{"shared"});
+    }
+
+    SUBCASE("a failed batch is rolled back")
+    {
+        SqliteRepository repo(nlohmann::json{{"db_path", path}});
+        RawDb raw(path);
+        raw.exec("CREATE TRIGGER reject BEFORE INSERT ON notes"
+                 " WHEN NEW.content = 'boom'"
+                 " BEGIN SELECT RAISE(ABORT, 'rejected'); END");
+
+        std::vector<note::Note> batch{{.content = "first", .tags = {"t"}},
+                                      {.content = "boom"}};
+        CHECK_THROWS_AS(repo.importNotes(batch), std::runtime_error);
+        CHECK(repo.getAllNotes().empty());
+        CHECK_EQ(raw.query("SELECT count(*) FROM note_tags"), "0");
+
+        // 되돌린 뒤에도 연결은 계속 쓸 수 있다.
+        CHECK(repo.createMemo({.content = "after"}));
+        CHECK_EQ(repo.getAllNotes().size(), 1);
+    }
+
+    SUBCASE("writes from several threads do not share a transaction")
+    {
+        // 한 스레드는 실패할 배치를 계속 넣고, 다른 스레드는 한 건씩 넣는다.
+        // 한 건 쓰기가 남의 트랜잭션에 끼면 함께 되돌려지거나 다른 행의 id
+        // 를 받는다.
+        SqliteRepository repo(nlohmann::json{{"db_path", path}});
+        RawDb raw(path);
+        raw.exec("CREATE TRIGGER reject BEFORE INSERT ON notes"
+                 " WHEN NEW.content = 'boom'"
+                 " BEGIN SELECT RAISE(ABORT, 'rejected'); END");
+
+        constexpr int WRITES = 200;
+        std::thread batches(
+            [&]
+            {
+                for (int i = 0; i < WRITES; ++i)
+                {
+                    std::vector<note::Note> batch{{.content = "batched"},
+                                                  {.content = "boom"}};
+                    CHECK_THROWS(repo.importNotes(batch));
+                }
+            });
+        std::vector<std::pair<note::Id, std::string>> written;
+        for (int i = 0; i < WRITES; ++i)
+        {
+            auto content = "single " + std::to_string(i);
+            written.emplace_back(repo.createMemo({.content = content})->id,
+                                 content);
+        }
+        batches.join();
+
+        CHECK_EQ(repo.getAllNotes().size(), WRITES);
+        for (const auto &[id, content] : written)
+        {
+            auto stored = repo.getNote(id);
+            REQUIRE(stored);
+            CHECK_EQ(stored->content, content);
+        }
+    }
+
+    std::filesystem::remove(path);
+}
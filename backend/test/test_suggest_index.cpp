@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "index/suggest_index.hpp"
+#include "note/note.hpp"
+#include "repository/inmemory_repository.hpp"
+#include "repository/suggest_repository.hpp"
+
+using banchoo::index::normalizePrefix;
+using banchoo::index::SuggestIndex;
+using banchoo::index::suggestTerms;
+namespace note = banchoo::note;
+
+namespace
+{
+using Ids = std::vector<note::Id>;
+
+note::TimePoint at(int seconds)
+{
+    return note::TimePoint(std::chrono::seconds(seconds));
+}
+
+std::string prefix(std::string_view text)
+{
+    std::string out;
+    REQUIRE(normalizePrefix(text, out));
+    return out;
+}
+
+bool hasTerm(const std::vector<std::string> &terms, std::string_view term)
+{
+    return std::find(terms.begin(), terms.end(), term) != terms.end();
+}
+} // namespace
+
+TEST_CASE("suggestTerms")
+{
+    SUBCASE("words and tags")
+    {
+        const std::vector<std::string> tags{"Work-Log"};
+        auto terms = suggestTerms("Hello, hello WORLD_42 (x)", tags);
+        CHECK_EQ(terms,
+                 std::vector<std::string>{
+                     "42", "hello", "work-log", "world", "x"});
+    }
+
+    SUBCASE("hangul is split into keystrokes")
+    {
+        auto terms = suggestTerms("닭 한국어", {});
+        CHECK(hasTerm(terms, "ㄷㅏㄹㄱ"));
+        CHECK(hasTerm(terms, "ㅎㅏㄴㄱㅜㄱㅇㅓ"));
+        // 두 음절 이상이면 초성 단어도 넣는다.
+        CHECK(hasTerm(terms, "ㅎㄱㅇ"));
+        CHECK_FALSE(hasTerm(terms, "ㄷ"));
+
+        // 겹모음도 두 번 누른다.
+        CHECK(hasTerm(suggestTerms("과", {}), "ㄱㅗㅏ"));
+    }
+
+    SUBCASE("long words and broken utf-8")
+    {
+        auto terms = suggestTerms(std::string(100, 'a') + " b\xff" "c", {});
+        CHECK_EQ(terms,
+                 std::vector<std::string>{std::string(32, 'a'), "b", "c"});
+    }
+}
+
+TEST_CASE("normalizePrefix")
+{
+    std::string out;
+    CHECK(normalizePrefix("  Hel ", out));
+    CHECK_EQ(out, "hel");
+    CHECK(normalizePrefix("한", out));
+    CHECK_EQ(out, "ㅎㅏㄴ");
+    CHECK_FALSE(normalizePrefix("two words", out));
+    CHECK_FALSE(normalizePrefix(" ,. ", out));
+
+    // 입력 중인 음절도 완성된 단어의 앞부분이다.
+    auto terms = suggestTerms("한국", {});
+    CHECK(std::any_of(terms.begin(),
+                      terms.end(),
+                      [&](const std::string &term)
+                      { return term.starts_with(prefix("한구")); }));
+}
+
+TEST_CASE("SuggestIndex")
+{
+    SuggestIndex index;
+    auto put = [&](note::Id id, int seconds, const char *content)
+    { index.put(id, at(seconds), suggestTerms(content, {})); };
+
+    put(1, 10, "meeting notes");
+    put(2, 30, "memo about meetings");
+    put(3, 20, "unrelated");
+    put(4, 40, "회의록 메모");
+
+    CHECK_EQ(index.suggest(prefix("mee"), 10), Ids{2, 1});
+    CHECK_EQ(index.suggest(prefix("me"), 1), Ids{2});
+    CHECK_EQ(index.suggest(prefix("ㅎㅇ"), 10), Ids{4});
+    CHECK_EQ(index.suggest(prefix("회"), 10), Ids{4});
+    CHECK(index.suggest(prefix("zzz"), 10).empty());
+    CHECK(index.suggest(prefix("mee"), 0).empty());
+
+    // 수정하면 단어와 순서가 함께 바뀐다.
+    put(1, 50, "met someone");
+    CHECK_EQ(index.suggest(prefix("me"), 10), Ids{1, 2});
+    CHECK_EQ(index.suggest(prefix("mee"), 10), Ids{2});
+
+    index.touch(2, at(60));
+    CHECK_EQ(index.suggest(prefix("me"), 10), Ids{2, 1});
+
+    index.remove(2);
+    CHECK_EQ(index.suggest(prefix("me"), 10), Ids{1});
+    CHECK_EQ(index.noteCount(), 3);
+}
+
+TEST_CASE("SuggestIndex matches a full scan")
+{
+    // 단어가 적어 짧은 접두사 노드는 미리 골라 둔 목록을 쓴다. 무작위로
+    // 쓰고 지우면서 노트를 모두 훑은 결과와 비교한다.
+    const std::vector<std::string> words{
+        "alpha", "alpine", "beta", "bet", "gamma", "회의", "회식", "일정"};
+    std::mt19937 rng(17);
+    std::uniform_int_distribution<std::size_t> word(0, words.size() - 1);
+    std::uniform_int_distribution<note::Id> pick(1, 6000);
+
+    SuggestIndex index;
+    std::map<note::Id, std::pair<int, std::vector<std::string>>> notes;
+    int clock = 0;
+    auto write = [&](note::Id id)
+    {
+        std::string content = words[word(rng)] + " " + words[word(rng)];
+        auto terms = suggestTerms(content, {});
+        // 같은 시각의 노트도 있도록 시계를 가끔만 넘긴다.
+        clock += static_cast<int>(rng() % 2);
+        index.put(id, at(clock), terms);
+        notes[id] = {clock, terms};
+    };
+    auto check = [&]
+    {
+        const char *prefixes[] = {
+            "a", "al", "alp", "b", "bet", "회", "ㅇ", "ㅎㅅ"};
+        for (const char *text : prefixes)
+        {
+            auto p = prefix(text);
+            std::vector<std::pair<int, note::Id>> expected;
+            for (const auto &[id, n] : notes)
+            {
+                if (std::any_of(n.second.begin(),
+                                n.second.end(),
+                                [&](const std::string &t)
+                                { return t.starts_with(p); }))
+                    expected.emplace_back(n.first, id);
+            }
+            std::sort(expected.rbegin(), expected.rend());
+            Ids ids;
+            for (std::size_t i = 0;
+                 i < expected.size() && i < SuggestIndex::MAX_LIMIT;
+                 ++i)
+                ids.push_back(expected[i].second);
+            CHECK_EQ(index.suggest(p, SuggestIndex::MAX_LIMIT), ids);
+        }
+    };
+
+    for (note::Id id = 1; id <= 5000; ++id)
+        write(id);
+    check();
+
+    for (int round = 0; round < 4; ++round)
+    {
+        for (int i = 0; i < 3000; ++i)
+        {
+            auto id = pick(rng);
+            switch (rng() % 3)
+            {
+            case 0:
+                write(id);
+                break;
+            case 1:
+                if (notes.count(id))
+                {
+                    index.touch(id, at(++clock));
+                    notes[id].first = clock;
+                }
+                break;
+            default:
+                index.remove(id);
+                notes.erase(id);
+                break;
+            }
+        }
+        check();
+    }
+
+    // 최근 노트를 잇달아 지워도 골라 둔 목록을 다시 채운다.
+    std::vector<std::pair<int, note::Id>> order;
+    for (const auto &[id, n] : notes)
+        order.emplace_back(n.first, id);
+    std::sort(order.rbegin(), order.rend());
+    for (std::size_t i = 0; i < 1000 && i < order.size(); ++i)
+    {
+        index.remove(order[i].second);
+        notes.erase(order[i].second);
+    }
+    check();
+}
+
+TEST_CASE("SuggestRepository")
+{
+    using banchoo::repository::InMemoryRepository;
+    using banchoo::repository::SuggestRepository;
+
+    SUBCASE("indexes existing notes")
+    {
+        auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+        inner->createMemo({.content = "before"});
+        SuggestRepository repo(inner);
+        CHECK_EQ(repo.suggestNotes(prefix("bef"), 10).size(), 1);
+    }
+
+    auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+    SuggestRepository repo(inner);
+    auto first = repo.createMemo({.content = "project kickoff"});
+    auto second = repo.createTask({.content = "draft", .tags = {"project"}});
+    std::vector<note::Note> batch{
+        {.content = "프로젝트 회의", .updated_at = at(1)}};
+    repo.importNotes(batch);
+
+    CHECK_EQ(repo.suggestNotes(prefix("proj"), 10),
+             Ids{second->id, first->id});
+    CHECK_EQ(repo.suggestNotes(prefix("ㅍㄹ"), 10), Ids{batch[0].id});
+
+    // 저장소의 기본 구현(목록을 훑어 거르기)과 결과가 같아야 한다.
+    CHECK_EQ(inner->suggestNotes(prefix("proj"), 10),
+             Ids{second->id, first->id});
+
+    // 본문을 고치지 않아도 최근 순서는 바뀐다.
+    note::Note done{.status = note::NoteStatus::DONE};
+    REQUIRE(repo.patchNote(first->id, std::move(done), note::field::STATUS));
+    CHECK_EQ(repo.suggestNotes(prefix("proj"), 10),
+             Ids{first->id, second->id});
+
+    note::Note retag{.tags = {}};
+    REQUIRE(repo.patchNote(second->id, std::move(retag), note::field::TAGS));
+    CHECK_EQ(repo.suggestNotes(prefix("proj"), 10), Ids{first->id});
+    CHECK_EQ(repo.suggestNotes(prefix("dra"), 10), Ids{second->id});
+
+    note::Note rewrite = *repo.getNote(first->id);
+    rewrite.content = "renamed";
+    REQUIRE(repo.updateNote(std::move(rewrite)));
+    CHECK(repo.suggestNotes(prefix("proj"), 10).empty());
+
+    REQUIRE(repo.deleteNote(second->id));
+    CHECK(repo.suggestNotes(prefix("dra"), 10).empty());
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "index/tag_index.hpp"
+#include "index/tag_query.hpp"
+#include "note/note.hpp"
+#include "repository/indexed_repository.hpp"
+#include "repository/inmemory_repository.hpp"
+
+namespace note = banchoo::note;
+using banchoo::index::TagIndex;
+using banchoo::index::TagQuery;
+
+namespace
+{
+TagQuery query(const char *text)
+{
+    std::string error;
+    auto parsed = TagQuery::parse(text, error);
+    REQUIRE_MESSAGE(parsed.has_value(), error);
+    return *parsed;
+}
+
+std::string parseError(const char *text)
+{
+    std::string error;
+    CHECK_FALSE(TagQuery::parse(text, error).has_value());
+    return error;
+}
+
+std::vector<std::uint32_t> ids(const TagIndex &index,
+                               const char *text,
+                               std::optional<note::NoteType> type = {})
+{
+    return index.evaluate(query(text), type).toVector();
+}
+} // namespace
+
+TEST_CASE("TagQuery")
+{
+    SUBCASE("parse errors")
+    {
+        CHECK_EQ(parseError(""), "tags expression is empty");
+        CHECK_EQ(parseError("work AND"), "tags expression ends unexpectedly");
+        CHECK_EQ(parseError("(work"), "missing ')'");
+        CHECK_EQ(parseError("work)"), "unexpected ')'");
+        CHECK_EQ(parseError("OR work"), "expected a tag");
+        CHECK_EQ(parseError("work AND #x"), "invalid tag");
+        CHECK_EQ(parseError((std::string(40, '(') + "a" + std::string(40, ')'))
+                                .c_str()),
+                 "tags expression is nested too deeply");
+    }
+
+    SUBCASE("matches")
+    {
+        std::vector<std::string> tags{"home", "urgent", "work"};
+        CHECK(query("work").matches(tags));
+        CHECK(query("work AND urgent").matches(tags));
+        CHECK(query("work urgent").matches(tags));
+        CHECK(query("work,urgent").matches(tags));
+        CHECK_FALSE(query("work NOT urgent").matches(tags));
+        CHECK(query("done OR home").matches(tags));
+        CHECK(query("NOT done").matches(tags));
+        // NOT > AND > OR
+        CHECK(query("done AND work OR home").matches(tags));
+        CHECK_FALSE(query("done AND (work OR home)").matches(tags));
+        CHECK(query("NOT (done OR later) work").matches(tags));
+    }
+}
+
+TEST_CASE("TagIndex")
+{
+    TagIndex index;
+    index.add(1, note::NoteType::MEMO, std::vector<std::string>{"work"});
+    index.add(2,
+              note::NoteType::TASK,
+              std::vector<std::string>{"urgent", "work"});
+    index.add(3,
+              note::NoteType::TASK,
+              std::vector<std::string>{"done", "urgent", "work"});
+    index.add(4, note::NoteType::EVENT, std::vector<std::string>{"home"});
+    index.add(5, note::NoteType::MEMO, std::vector<std::string>{});
+    CHECK_EQ(index.tagCount(), 4);
+
+    using V = std::vector<std::uint32_t>;
+    SUBCASE("evaluate")
+    {
+        CHECK_EQ(ids(index, "work"), V{1, 2, 3});
+        CHECK_EQ(ids(index, "work AND urgent NOT done"), V{2});
+        CHECK_EQ(ids(index, "urgent OR home"), V{2, 3, 4});
+        CHECK_EQ(ids(index, "NOT work"), V{4, 5});
+        CHECK_EQ(ids(index, "missing"), V{});
+        CHECK_EQ(ids(index, "missing OR home"), V{4});
+        CHECK_EQ(ids(index, "work", note::NoteType::TASK), V{2, 3});
+        CHECK_EQ(ids(index, "NOT urgent", note::NoteType::MEMO), V{1, 5});
+    }
+
+    SUBCASE("setTags and remove")
+    {
+        index.setTags(3, std::vector<std::string>{"home"});
+        CHECK_EQ(ids(index, "work"), V{1, 2});
+        CHECK_EQ(ids(index, "home"), V{3, 4});
+        // 더 이상 쓰는 노트가 없는 태그는 지운다.
+        CHECK_EQ(index.tagCount(), 3);
+
+        index.remove(2);
+        CHECK_EQ(ids(index, "urgent"), V{});
+        CHECK_EQ(ids(index, "NOT home"), V{1, 5});
+        CHECK_EQ(ids(index, "NOT home", note::NoteType::TASK), V{});
+
+        // 없는 id 는 무시한다.
+        index.setTags(42, std::vector<std::string>{"work"});
+        CHECK_EQ(ids(index, "work"), V{1});
+    }
+}
+
+TEST_CASE("IndexedRepository")
+{
+    using banchoo::repository::IndexedRepository;
+    using banchoo::repository::InMemoryRepository;
+
+    SUBCASE("indexes existing notes")
+    {
+        auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+        inner->createMemo({.content = "before", .tags = {"old"}});
+        IndexedRepository repo(inner);
+        CHECK_EQ(repo.findNotes(query("old"), std::nullopt).size(), 1);
+    }
+
+    auto inner = std::make_shared<InMemoryRepository>(nlohmann::json{});
+    IndexedRepository repo(inner);
+    auto memo = repo.createMemo({.content = "memo", .tags = {"a", "b"}});
+    auto task = repo.createTask({.content = "task", .tags = {"a"}});
+    std::vector<note::Note> batch{{.content = "x", .tags = {"b"}},
+                                  {.content = "y", .tags = {"c"}}};
+    repo.importNotes(batch);
+
+    auto a = query("a");
+    auto found = repo.findNotes(a, std::nullopt);
+    REQUIRE_EQ(found.size(), 2);
+    CHECK_EQ(found[0]->id, memo->id);
+    CHECK_EQ(found[1]->id, task->id);
+    CHECK_EQ(found[0]->tags, std::vector<std::string>{"a", "b"});
+    CHECK_EQ(repo.findNotes(a, note::NoteType::TASK).size(), 1);
+    CHECK_EQ(repo.findNotes(query("b NOT a"), std::nullopt).size(), 1);
+
+    // 저장소의 기본 구현(목록을 훑어 거르기)과 결과가 같아야 한다.
+    CHECK_EQ(inner->findNotes(a, std::nullopt).size(), 2);
+
+    note::Note retag{.tags = {"c"}};
+    REQUIRE(repo.patchNote(memo->id, std::move(retag), note::field::TAGS));
+    CHECK_EQ(repo.findNotes(a, std::nullopt).size(), 1);
+    CHECK_EQ(repo.findNotes(query("c"), std::nullopt).size(), 2);
+    CHECK_EQ(repo.getNote(memo->id)->tags, std::vector<std::string>{"c"});
+    CHECK_EQ(repo.getNote(memo->id)->content, "memo");
+
+    REQUIRE(repo.deleteNote(task->id));
+    CHECK(repo.findNotes(a, std::nullopt).empty());
+
+    auto ids = repo.findNotes(query("c"), std::nullopt, {note::field::ID, 0});
+    REQUIRE_EQ(ids.size(), 2);
+    CHECK_EQ(ids[0]->id, memo->id);
+}
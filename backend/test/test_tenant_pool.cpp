@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "note/note.hpp"
+#include "repository/sqlite_repository.hpp"
+#include "repository/tenant_pool.hpp"
+
+using banchoo::repository::SqliteRepository;
+using banchoo::repository::TenantPool;
+
+TEST_CASE("TenantPool")
+{
+    const std::string dir = "test_tenants";
+    std::filesystem::remove_all(dir);
+
+    SUBCASE("validTenant")
+    {
+        CHECK(TenantPool::validTenant("alice"));
+        CHECK(TenantPool::validTenant("team-42_a"));
+        CHECK(TenantPool::validTenant(std::string(64, 'a')));
+        CHECK_FALSE(TenantPool::validTenant(""));
+        CHECK_FALSE(TenantPool::validTenant(std::string(65, 'a')));
+        CHECK_FALSE(TenantPool::validTenant("../etc"));
+        CHECK_FALSE(TenantPool::validTenant("a.b"));
+        CHECK_FALSE(TenantPool::validTenant("a\"b"));
+    }
+
+    SUBCASE("opens one database per tenant lazily")
+    {
+        TenantPool pool({{"dir", dir}, {"max_open", 4}});
+        CHECK_EQ(pool.openCount(), 0);
+        CHECK_FALSE(std::filesystem::exists(dir + "/alice.sqlite"));
+
+        auto alice = pool.acquire("alice");
+        auto bob = pool.acquire("bob");
+        CHECK(std::filesystem::exists(dir + "/alice.sqlite"));
+        CHECK_EQ(pool.acquire("alice"), alice);
+        CHECK_NE(alice, bob);
+        CHECK_EQ(pool.openCount(), 2);
+
+        alice->createMemo({.content = "alice's"});
+        CHECK_EQ(alice->getAllNotes().size(), 1);
+        CHECK(bob->getAllNotes().empty());
+
+        CHECK_THROWS_AS(pool.acquire("../bob"), std::invalid_argument);
+    }
+
+    SUBCASE("caps open handles and reopens evicted tenants")
+    {
+        TenantPool pool({{"dir", dir}, {"max_open", 2}});
+        pool.acquire("a")->createMemo({.content = "kept"});
+        pool.acquire("b");
+        pool.acquire("c");
+        CHECK_EQ(pool.cachedCount(), 2);
+        CHECK_EQ(pool.openCount(), 2);
+
+        // a 는 닫혔다가 다시 열린다. 데이터는 파일에 남아 있다.
+        auto notes = pool.acquire("a")->getAllNotes();
+        REQUIRE_EQ(notes.size(), 1);
+        CHECK_EQ(notes.front()->content, "kept");
+        CHECK_EQ(pool.openCount(), 2);
+    }
+
+    SUBCASE("a tenant in use is not opened twice")
+    {
+        TenantPool pool({{"dir", dir}, {"max_open", 1}});
+        auto a = pool.acquire("a");
+        pool.acquire("b");
+        CHECK_EQ(pool.cachedCount(), 1);
+        // a 는 밀려났지만 아직 쓰고 있으므로 열린 채다.
+        CHECK_EQ(pool.openCount(), 2);
+
+        CHECK_EQ(pool.acquire("a"), a);
+        a.reset();
+        pool.acquire("b");
+        CHECK_EQ(pool.openCount(), 1);
+    }
+
+    SUBCASE("reopening a tenant does not rebuild in-memory indexes")
+    {
+        // 색인과 집계를 켜지 않았으면 저장소를 그대로 쓴다.
+        TenantPool pool(
+            {{"dir", dir},
+             {"repository", {{"type", "sqlite"}, {"instrumented", false}}}});
+        CHECK(std::dynamic_pointer_cast<SqliteRepository>(pool.acquire("a")));
+
+        TenantPool indexed({{"dir", dir},
+                            {"repository",
+                             {{"type", "sqlite"},
+                              {"instrumented", false},
+                              {"stats", true}}}});
+        CHECK_FALSE(
+            std::dynamic_pointer_cast<SqliteRepository>(indexed.acquire("a")));
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "note/time_codec.hpp"
+
+using namespace std::chrono;
+using banchoo::note::append_timestamp;
+using banchoo::note::parse_timestamp;
+using banchoo::note::TimePoint;
+
+namespace
+{
+TimePoint at(long long seconds, long long nanos = 0)
+{
+    return TimePoint(duration_cast<TimePoint::duration>(
+        std::chrono::seconds(seconds) + nanoseconds(nanos)));
+}
+
+std::string format(TimePoint tp, int digits = 0)
+{
+    std::string out;
+    append_timestamp(out, tp, digits);
+    return out;
+}
+
+// 테스트 동안만 TZ 를 바꾼다.
+class ScopedTimeZone
+{
+ public:
+    explicit ScopedTimeZone(const char *tz)
+    {
+        if (const char *old = std::getenv("TZ"))
+            old_ = old;
+        ::setenv("TZ", tz, 1);
+        ::tzset();
+    }
+    ~ScopedTimeZone()
+    {
+        if (old_)
+            ::setenv("TZ", old_->c_str(), 1);
+        else
+            ::unsetenv("TZ");
+        ::tzset();
+    }
+
+ private:
+    std::optional<std::string> old_;
+};
+} // namespace
+
+TEST_CASE("TimeCodec")
+{
+    SUBCASE("format")
+    {
+        CHECK_EQ(format(at(0)), "1970-01-01T00:00:00Z");
+        CHECK_EQ(format(at(1743854400)), "2025-04-05T12:00:00Z");
+        CHECK_EQ(format(at(951782400)), "2000-02-29T00:00:00Z");
+        CHECK_EQ(format(at(1743854400, 123456789), 3),
+                 "2025-04-05T12:00:00.123Z");
+        CHECK_EQ(format(at(1743854400, 1000), 9),
+                 "2025-04-05T12:00:00.000001000Z");
+        CHECK_EQ(format(at(-1)), "1969-12-31T23:59:59Z");
+    }
+
+    SUBCASE("cached prefix follows the second")
+    {
+        CHECK_EQ(format(at(1743854400, 10), 6), "2025-04-05T12:00:00.000000Z");
+        CHECK_EQ(format(at(1743854400, 999999999), 6),
+                 "2025-04-05T12:00:00.999999Z");
+        CHECK_EQ(format(at(1743854401)), "2025-04-05T12:00:01Z");
+        CHECK_EQ(format(at(1743854400)), "2025-04-05T12:00:00Z");
+    }
+
+    SUBCASE("parse")
+    {
+        CHECK_EQ(parse_timestamp("2025-04-05T12:00:00Z"), at(1743854400));
+        CHECK_EQ(parse_timestamp("2025-04-05t12:00:00z"), at(1743854400));
+        CHECK_EQ(parse_timestamp("2025-04-05T21:00:00+09:00"), at(1743854400));
+        CHECK_EQ(parse_timestamp("2025-04-05T07:30:00-04:30"), at(1743854400));
+        CHECK_EQ(parse_timestamp("2025-04-05T12:00:00.5Z"),
+                 at(1743854400, 500000000));
+        CHECK_EQ(parse_timestamp("2025-04-05T12:00:00.1234567891Z"),
+                 at(1743854400, 123456789));
+        CHECK_EQ(parse_timestamp("2000-02-29T00:00:00Z"), at(951782400));
+    }
+
+    SUBCASE("no offset means local time")
+    {
+        // 예전 to_string 은 localtime 으로 "YYYY-MM-DD HH:MM:SS" 를 썼다.
+        ScopedTimeZone kst("KST-9");
+        CHECK_EQ(parse_timestamp("2025-04-05 21:00:00"), at(1743854400));
+        CHECK_EQ(parse_timestamp("2025-04-05T21:00:00.5"),
+                 at(1743854400, 500000000));
+        CHECK_EQ(parse_timestamp("2025-04-05T21:00:00Z"),
+                 at(1743854400 + 9 * 3600));
+
+        ScopedTimeZone utc("UTC0");
+        CHECK_EQ(parse_timestamp("2025-04-05 12:00:00"), at(1743854400));
+    }
+
+    SUBCASE("rejects malformed input")
+    {
+        CHECK_FALSE(parse_timestamp(""));
+        CHECK_FALSE(parse_timestamp("2025-04-05"));
+        CHECK_FALSE(parse_timestamp("2025-13-01T00:00:00Z"));
+        CHECK_FALSE(parse_timestamp("2025-02-29T00:00:00Z"));
+        CHECK_FALSE(parse_timestamp("2025-04-31T00:00:00Z"));
+        CHECK_FALSE(parse_timestamp("2025-04-05T24:00:00Z"));
+        CHECK_FALSE(parse_timestamp("2025-04-05T12:00:00."));
+        CHECK_FALSE(parse_timestamp("2025-04-05T12:00:00+0900"));
+        CHECK_FALSE(parse_timestamp("2025-04-05T12:00:00Zjunk"));
+        CHECK_FALSE(parse_timestamp("2025/04/05T12:00:00Z"));
+    }
+
+    SUBCASE("round trip")
+    {
+        auto now = system_clock::now();
+        auto micros = time_point_cast<microseconds>(now);
+        CHECK_EQ(parse_timestamp(format(micros, 6)), TimePoint(micros));
+    }
+
+    SUBCASE("thread safe")
+    {
+        std::vector<std::thread> threads;
+        std::vector<int> mismatches(4, 0);
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back(
+                [t, &mismatches]
+                {
+                    for (int i = 0; i < 2000; ++i)
+                    {
+                        auto tp = at(1743854400LL + t * 100000 + i);
+                        if (parse_timestamp(format(tp)) != tp)
+                            ++mismatches[t];
+                    }
+                });
+        }
+        for (auto &th : threads)
+            th.join();
+        CHECK_EQ(mismatches, std::vector<int>(4, 0));
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "note/note.hpp"
+#include "reminder/timing_wheel.hpp"
+
+namespace note = banchoo::note;
+using banchoo::reminder::Reminder;
+using banchoo::reminder::TimingWheel;
+
+namespace
+{
+std::vector<note::Id> ids(const std::vector<Reminder> &due)
+{
+    std::vector<note::Id> out;
+    for (const auto &r : due)
+        out.push_back(r.id);
+    return out;
+}
+} // namespace
+
+TEST_CASE("TimingWheel")
+{
+    TimingWheel wheel(1000);
+    std::vector<Reminder> due;
+
+    SUBCASE("fires at the deadline tick")
+    {
+        wheel.schedule({.id = 1}, 1001);
+        wheel.schedule({.id = 2}, 1063);
+        wheel.schedule({.id = 3}, 1064);
+        CHECK_EQ(wheel.size(), 3);
+
+        wheel.advance(1000, due);
+        CHECK(due.empty());
+        wheel.advance(1001, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1});
+        wheel.advance(1063, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1, 2});
+        wheel.advance(1064, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1, 2, 3});
+        CHECK_EQ(wheel.size(), 0);
+    }
+
+    SUBCASE("past deadlines fire on the next tick")
+    {
+        wheel.schedule({.id = 1}, 10);
+        wheel.advance(1001, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1});
+    }
+
+    SUBCASE("reschedule replaces and cancel removes")
+    {
+        wheel.schedule({.id = 1}, 5000);
+        wheel.schedule({.id = 1}, 1002);
+        wheel.schedule({.id = 2}, 1002);
+        CHECK_EQ(wheel.size(), 2);
+        CHECK(wheel.cancel(2));
+        CHECK_FALSE(wheel.cancel(2));
+        CHECK_EQ(wheel.size(), 1);
+
+        wheel.advance(6000, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1});
+    }
+
+    SUBCASE("same tick is ordered by time")
+    {
+        const note::TimePoint t{};
+        wheel.schedule({.id = 1, .at = t + std::chrono::seconds(2)}, 1010);
+        wheel.schedule({.id = 2, .at = t + std::chrono::seconds(1)}, 1010);
+        wheel.advance(1010, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{2, 1});
+    }
+
+    SUBCASE("idle wheel jumps ahead")
+    {
+        wheel.advance(1ULL << 40, due);
+        CHECK_EQ(wheel.now(), 1ULL << 40);
+        wheel.schedule({.id = 1}, (1ULL << 40) + 1);
+        wheel.advance((1ULL << 40) + 1, due);
+        CHECK_EQ(ids(due), std::vector<note::Id>{1});
+    }
+
+    SUBCASE("random deadlines across levels match a sorted schedule")
+    {
+        std::mt19937_64 rng(7);
+        std::multimap<TimingWheel::Tick, note::Id> expected;
+        for (note::Id id = 1; id <= 2000; ++id)
+        {
+            // 1 ~ 64^3 틱 뒤. 세 단계에 걸친다.
+            auto deadline = 1000 + 1 + rng() % (64 * 64 * 64);
+            wheel.schedule({.id = id}, deadline);
+            expected.emplace(deadline, id);
+        }
+        // 일부를 취소하고 일부는 다른 시각으로 옮긴다.
+        for (auto it = expected.begin(); it != expected.end();)
+        {
+            if (it->second % 7 == 0)
+            {
+                CHECK(wheel.cancel(it->second));
+                it = expected.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        std::uint64_t now = 1000;
+        auto next = expected.begin();
+        while (next != expected.end())
+        {
+            now += 1 + rng() % 500;
+            due.clear();
+            wheel.advance(now, due);
+
+            std::vector<note::Id> want;
+            for (; next != expected.end() && next->first <= now; ++next)
+                want.push_back(next->second);
+            REQUIRE_EQ(due.size(), want.size());
+            // 틱 안의 순서는 시각(여기서는 모두 같음)만 따르므로 틱 단위로
+            // 모아서 비교한다.
+            auto got = ids(due);
+            std::multiset<note::Id> got_set(got.begin(), got.end());
+            std::multiset<note::Id> want_set(want.begin(), want.end());
+            CHECK_EQ(got_set, want_set);
+        }
+        CHECK_EQ(wheel.size(), 0);
+    }
+}
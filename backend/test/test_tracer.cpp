@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 Lee Sangwon
+ * This file is part of the Banchoo Project.
+ * Licensed under the MIT License.
+ */
+
+#include <doctest/doctest.h>
+
+#include <nlohmann/json.hpp>
+
+#include "trace/tracer.hpp"
+
+using banchoo::trace::Tracer;
+
+TEST_CASE("Tracer")
+{
+    auto &tracer = Tracer::instance();
+    tracer.clear();
+
+    SUBCASE("disabled tracer records nothing")
+    {
+        tracer.setEnabled(false);
+        tracer.beginRequest();
+        {
+            BANCHOO_SPAN("ignored");
+        }
+        tracer.endRequest();
+
+        auto dump = nlohmann::json::parse(tracer.dumpChromeTrace());
+        CHECK(dump["traceEvents"].empty());
+    }
+
+    SUBCASE("sampled request records spans")
+    {
+        tracer.setEnabled(true);
+        tracer.setSampleRate(1.0);
+        tracer.beginRequest();
+        {
+            BANCHOO_SPAN("outer", "detail");
+            BANCHOO_SPAN("inner");
+        }
+        tracer.endRequest();
+        {
+            BANCHOO_SPAN("outside request");
+        }
+
+        auto dump = nlohmann::json::parse(tracer.dumpChromeTrace());
+        REQUIRE_EQ(dump["traceEvents"].size(), 2);
+        CHECK_EQ(dump["traceEvents"][0]["name"], "inner");
+        CHECK_EQ(dump["traceEvents"][1]["name"], "outer");
+        CHECK_EQ(dump["traceEvents"][1]["ph"], "X");
+        CHECK_EQ(dump["traceEvents"][1]["args"]["detail"], "detail");
+        tracer.setEnabled(false);
+    }
+}
@@ -2582,6 +2582,8 @@ namespace crow
         void* middleware_context{};
         void* middleware_container{};
         boost::asio::io_service* io_service{};
+        // banchoo: 매칭된 라우트 규칙(예: "/notes/<int>"). 매칭되지 않았으면 nullptr.
+        const std::string* rule{};
 
         /// Construct an empty request. (sets the method to `GET`)
         request():
@@ -2948,6 +2950,20 @@ namespace crow
         bool skip_body = false;            ///< Whether this is a response to a HEAD request.
         bool manual_length_header = false; ///< Whether Crow should automatically add a "Content-Length" header.
 
+        // banchoo: 본문 전체를 메모리에 올리지 않고 조각씩 만들어 chunked 로 보낸다.
+        // body_source 는 chunk 에 다음 조각을 채우고, 보낼 조각이 더 있으면 true 를 돌려준다.
+        std::function<bool(std::string&)> body_source;
+        // banchoo: 있으면 body_source 를 io 스레드에서 부르지 않고 runner 에 넘긴다.
+        // runner 는 받은 작업을 다른 스레드에서 돌리기만 하면 되고, 작업이 끝나면
+        // 연결이 io 스레드로 돌아와 그 조각을 보낸다.
+        std::function<void(std::function<void()>)> body_source_runner;
+
+        void set_body_source(std::function<bool(std::string&)> source)
+        {
+            body_source = std::move(source);
+            set_header("Transfer-Encoding", "chunked");
+        }
+
         /// Set the value of an existing header in the response.
         void set_header(std::string key, std::string value)
         {
@@ -3015,6 +3031,8 @@ namespace crow
             headers = std::move(r.headers);
             completed_ = r.completed_;
             file_info = std::move(r.file_info);
+            body_source = std::move(r.body_source);
+            body_source_runner = std::move(r.body_source_runner);
             return *this;
         }
 
@@ -3031,6 +3049,8 @@ namespace crow
             headers.clear();
             completed_ = false;
             file_info = static_file_info{};
+            body_source = nullptr;
+            body_source_runner = nullptr;
         }
 
         /// Return a "Temporary Redirect" response.
@@ -6444,6 +6464,15 @@ namespace crow
         static int on_body(http_parser* self_, const char* at, size_t length)
         {
             HTTPParser* self = static_cast<HTTPParser*>(self_);
+            // banchoo: 한도를 넘은 본문은 더 쌓지 않고 끝까지 읽어 버린다.
+            if (self->body_too_large)
+                return 0;
+            if (self->body_limit && self->body.size() + length > self->body_limit)
+            {
+                self->body_too_large = true;
+                std::string().swap(self->body);
+                return 0;
+            }
             self->body.insert(self->body.end(), at, at + length);
             return 0;
         }
@@ -6500,6 +6529,7 @@ namespace crow
             headers.clear();
             url_params.clear();
             body.clear();
+            body_too_large = false;
             header_building_state = 0;
             qs_point = 0;
             http_major = 0;
@@ -6548,6 +6578,9 @@ namespace crow
         ci_map headers;
         query_string url_params; ///< What comes after the `?` in the URL.
         std::string body;
+        // banchoo: 0 이 아니면 본문이 이 바이트를 넘을 때 body_too_large 를 세운다.
+        size_t body_limit = 0;
+        bool body_too_large = false;
         bool keep_alive;       ///< Whether or not the server should send a `connection: Keep-Alive` header to the client.
         bool close_connection; ///< Whether or not the server should shut down the TCP connection once a response is sent.
 
@@ -10818,6 +10851,7 @@ namespace crow
             }
 
             CROW_LOG_DEBUG << "Matched rule '" << rules[rule_index]->rule_ << "' " << static_cast<uint32_t>(req.method) << " / " << rules[rule_index]->get_methods();
+            req.rule = &rules[rule_index]->rule_;
 
             // any uncaught exceptions become 500s
             try
@@ -11250,6 +11284,7 @@ namespace crow
           res_stream_threshold_(handler->stream_threshold()),
           queue_length_(queue_length)
         {
+            parser_.body_limit = handler->body_limit();
 #ifdef CROW_ENABLE_DEBUG
             connectionCount++;
             CROW_LOG_DEBUG << "Connection (" << this << ") allocated, total: " << connectionCount;
@@ -11277,6 +11312,10 @@ namespace crow
             adaptor_.start([this](const boost::system::error_code& ec) {
                 if (!ec)
                 {
+                    // banchoo: keep-alive 응답이 Nagle + delayed ACK 로 40ms 씩 묶이지 않게 한다.
+                    boost::system::error_code ignored;
+                    adaptor_.raw_socket().set_option(tcp::no_delay(true), ignored);
+
                     start_deadline();
 
                     do_read();
@@ -11339,6 +11378,13 @@ namespace crow
                 }
             }
 
+            // banchoo: body_limit 를 넘은 요청은 핸들러에 넘기지 않는다.
+            if (parser_.body_too_large)
+            {
+                is_invalid_request = true;
+                res = response(413);
+            }
+
             CROW_LOG_INFO << "Request: " << boost::lexical_cast<std::string>(adaptor_.remote_endpoint()) << " " << this << " HTTP/" << (char)(req.http_ver_major + '0') << "." << (char)(req.http_ver_minor + '0') << ' ' << method_name(req.method) << " " << req.url;
 
 
@@ -11442,6 +11488,10 @@ namespace crow
             {
                 do_write_static();
             }
+            else if (res.body_source)
+            {
+                do_write_chunked();
+            }
             else
             {
                 do_write_general();
@@ -11529,7 +11579,7 @@ namespace crow
                 buffers_.emplace_back(crlf.data(), crlf.size());
             }
 
-            if (!res.manual_length_header && !res.headers.count("content-length"))
+            if (!res.manual_length_header && !res.headers.count("content-length") && !res.body_source)
             {
                 content_length_ = std::to_string(res.body.size());
                 static std::string content_length_tag = "Content-Length: ";
@@ -11592,6 +11642,136 @@ namespace crow
             buffers_.clear();
         }
 
+        // banchoo: body_source 가 만드는 조각을 하나씩 chunked 인코딩으로 보낸다.
+        // 조각 하나를 async_write 로 걸고, 다 쓰면 다음 조각을 만든다. io 스레드를
+        // 쓰기 대기로 막지 않고 보내는 동안 조각 하나만 메모리에 둔다.
+        // body_source_runner 가 있으면 조각은 그 스레드에서 만들고 보내기만 io
+        // 스레드에서 한다. 그동안 연결은 쓰는 중으로 남아 지워지지 않는다.
+        // 보내는 동안에는 유휴 타이머를 멈추고 다음 요청도 읽지 않는다. 느린
+        // 클라이언트가 5초 안에 다 받지 못해도 끊기지 않고, 파이프라인으로 온
+        // 요청이 보내는 중인 res 와 buffers_ 를 덮어쓰지 않는다. 읽기와 타이머는
+        // finish_chunked 가 다시 시작한다.
+        void do_write_chunked()
+        {
+            cancel_deadline_timer();
+            is_writing = true;
+            chunk_source_ = std::move(res.body_source);
+            chunk_runner_ = std::move(res.body_source_runner);
+            chunk_more_ = true;
+            boost::asio::async_write(
+              adaptor_.socket(), buffers_,
+              [this](const boost::system::error_code& ec, std::size_t /*bytes_transferred*/) {
+                  res.clear();
+                  buffers_.clear();
+                  if (ec)
+                  {
+                      CROW_LOG_ERROR << ec << " - happened while sending chunked headers";
+                      finish_chunked(true);
+                      return;
+                  }
+                  do_write_next_chunk();
+              });
+        }
+
+        void do_write_next_chunk()
+        {
+            if (!chunk_runner_)
+            {
+                send_next_chunk(make_next_chunk());
+                return;
+            }
+            auto& service = adaptor_.get_io_service();
+            chunk_runner_([this, &service] {
+                bool made = make_next_chunk();
+                service.post([this, made] { send_next_chunk(made); });
+            });
+        }
+
+        // chunk_buffer_ 에 다음 조각을 채운다. body_source 가 던지면 false.
+        bool make_next_chunk()
+        {
+            chunk_buffer_.clear();
+            try
+            {
+                while (chunk_buffer_.empty() && chunk_more_)
+                    chunk_more_ = chunk_source_(chunk_buffer_);
+                return true;
+            }
+            catch (const std::exception& e)
+            {
+                CROW_LOG_ERROR << "body_source threw: " << e.what();
+            }
+            catch (...)
+            {
+                CROW_LOG_ERROR << "body_source threw an unknown exception";
+            }
+            return false;
+        }
+
+        void send_next_chunk(bool made)
+        {
+            static const std::string last_chunk = "0\r\n\r\n";
+
+            if (!made)
+            {
+                // 헤더는 이미 나갔으므로 오류 응답을 보낼 수 없다. 마지막 조각 없이
+                // 연결을 닫아 받는 쪽이 본문이 잘렸음을 알게 한다.
+                finish_chunked(true);
+                return;
+            }
+
+            std::vector<asio::const_buffer> buffers;
+            if (!chunk_buffer_.empty())
+            {
+                char size_line[24];
+                int n = std::snprintf(size_line, sizeof(size_line), "%zx\r\n", chunk_buffer_.size());
+                chunk_size_line_.assign(size_line, static_cast<std::size_t>(n));
+                buffers.push_back(boost::asio::buffer(chunk_size_line_));
+                buffers.push_back(boost::asio::buffer(chunk_buffer_));
+                buffers.push_back(boost::asio::buffer(crlf));
+            }
+            if (!chunk_more_)
+                buffers.push_back(boost::asio::buffer(last_chunk));
+
+            boost::asio::async_write(
+              adaptor_.socket(), buffers,
+              [this](const boost::system::error_code& ec, std::size_t /*bytes_transferred*/) {
+                  if (ec)
+                  {
+                      CROW_LOG_ERROR << ec << " - happened while sending chunked body";
+                      finish_chunked(true);
+                  }
+                  else if (chunk_more_)
+                      do_write_next_chunk();
+                  else
+                      finish_chunked(false);
+              });
+        }
+
+        void finish_chunked(bool failed)
+        {
+            chunk_source_ = nullptr;
+            chunk_runner_ = nullptr;
+            std::string().swap(chunk_buffer_);
+            is_writing = false;
+            if (failed || close_connection_)
+            {
+                // 읽기를 미뤄 둔 상태면 걸려 있는 읽기가 없다.
+                if (need_to_start_read_after_complete_)
+                    is_reading = false;
+                adaptor_.shutdown_readwrite();
+                adaptor_.close();
+                CROW_LOG_DEBUG << this << " from write (chunked)";
+                check_destroy();
+            }
+            else if (need_to_start_read_after_complete_)
+            {
+                need_to_start_read_after_complete_ = false;
+                start_deadline();
+                do_read();
+            }
+        }
+
         void do_write_general()
         {
             if (res.body.length() < res_stream_threshold_)
@@ -11614,26 +11794,12 @@ namespace crow
                 boost::asio::write(adaptor_.socket(), buffers_); // Write the response start / headers
                 if (res.body.length() > 0)
                 {
-                    std::string buf;
+                    // banchoo: 16KB 씩 substr 로 잘라 남은 본문을 매번 복사하면 본문
+                    // 크기의 제곱만큼 복사한다. 본문을 그대로 한 번에 쓴다.
                     std::vector<asio::const_buffer> buffers;
-
-                    while (res.body.length() > 16384)
-                    {
-                        //buf.reserve(16385);
-                        buf = res.body.substr(0, 16384);
-                        res.body = res.body.substr(16384);
-                        buffers.clear();
-                        buffers.push_back(boost::asio::buffer(buf));
-                        do_write_sync(buffers);
-                    }
-                    // Collect whatever is left (less than 16KB) and send it down the socket
-                    // buf.reserve(is.length());
-                    buf = res.body;
-                    res.body.clear();
-
-                    buffers.clear();
-                    buffers.push_back(boost::asio::buffer(buf));
+                    buffers.push_back(boost::asio::buffer(res.body));
                     do_write_sync(buffers);
+                    res.body.clear();
                 }
                 is_writing = false;
                 if (close_connection_)
@@ -11682,9 +11848,19 @@ namespace crow
                       cancel_deadline_timer();
                       parser_.done();
                       is_reading = false;
-                      check_destroy();
+                      // banchoo: 핸들러가 응답을 나중에 끝내는 중이면 연결을 지우지 않는다.
+                      // 응답을 다 쓰고 나면 do_write 가 닫고 지운다.
+                      if (!need_to_call_after_handlers_)
+                          check_destroy();
                       // adaptor will close after write
                   }
+                  else if (chunk_source_)
+                  {
+                      // banchoo: chunked 본문을 보내는 중이다. 다 보내면
+                      // finish_chunked 가 타이머와 읽기를 다시 시작한다.
+                      is_reading = false;
+                      need_to_start_read_after_complete_ = true;
+                  }
                   else if (!need_to_call_after_handlers_)
                   {
                       start_deadline();
@@ -11794,6 +11970,12 @@ namespace crow
         std::string content_length_;
         std::string date_str_;
         std::string res_body_copy_;
+        // banchoo: do_write_chunked 가 보내는 중인 본문의 상태
+        std::function<bool(std::string&)> chunk_source_;
+        std::function<void(std::function<void()>)> chunk_runner_;
+        std::string chunk_buffer_;
+        std::string chunk_size_line_;
+        bool chunk_more_{};
 
         detail::task_timer::identifier_type task_id_;
 
@@ -12281,6 +12463,18 @@ namespace crow
             return res_stream_threshold_;
         }
 
+        // banchoo: 요청 본문 크기 한도. 넘으면 본문을 버리고 413 으로 답한다. 0 이면 제한 없음.
+        self_t& body_limit(size_t limit)
+        {
+            body_limit_ = limit;
+            return *this;
+        }
+
+        size_t body_limit() const
+        {
+            return body_limit_;
+        }
+
         self_t& register_blueprint(Blueprint& blueprint)
         {
             router_.register_blueprint(blueprint);
@@ -12551,6 +12745,7 @@ namespace crow
         std::string server_name_ = std::string("Crow/") + VERSION;
         std::string bindaddr_ = "0.0.0.0";
         size_t res_stream_threshold_ = 1048576;
+        size_t body_limit_ = 0; // banchoo
         Router router_;
 
 #ifdef CROW_ENABLE_COMPRESSION
@@ -0,0 +1,47 @@
+import os
+import signal
+import subprocess
+import sys
+import time
+
+# 사용법: python loadgen_smoke.py <build dir> [banchoo_loadgen 옵션...]
+# build dir 의 config.json 으로 banchoo_server 를 띄우고 부하를 건 뒤 종료한다.
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: loadgen_smoke.py <build dir> [loadgen args...]")
+        return 2
+
+    build_dir = os.path.abspath(sys.argv[1])
+    loadgen_args = sys.argv[2:] or [
+        "--duration-s=3", "--warmup-s=1", "--connections=4", "--preload=300"
+    ]
+
+    print("⏳ Starting banchoo_server...")
+    server = subprocess.Popen([os.path.join(build_dir, "banchoo_server")],
+                              cwd=build_dir)
+    try:
+        time.sleep(0.2)
+        if server.poll() is not None:
+            raise RuntimeError("❌ Server exited early.")
+
+        print("🚨 Running banchoo_loadgen " + " ".join(loadgen_args))
+        result = subprocess.run(
+            [os.path.join(build_dir, "banchoo_loadgen"), *loadgen_args])
+    finally:
+        server.send_signal(signal.SIGINT)
+        try:
+            server.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            server.kill()
+
+    if result.returncode != 0:
+        print("❌ Load generator reported errors.")
+        return result.returncode
+    print("✅ Load run finished!")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())